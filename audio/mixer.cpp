@@ -117,8 +117,15 @@ public:
 	/**
 	 * Notifies the channel that the global sound type
 	 * volume settings changed.
+	 *
+	 * @param volume new volume of the channel's sound type
+	 * @param mute   whether the channel's sound type is muted
 	 */
-	void notifyGlobalVolChange() { updateChannelVolumes(); }
+	void notifyGlobalVolChange(int volume, bool mute) {
+		_typeVolume = volume;
+		_typeMuted = mute;
+		updateChannelVolumes();
+	}
 
 	/**
 	 * Queries how long the channel has been playing.
@@ -156,6 +163,8 @@ private:
 
 	byte _volume;
 	int8 _balance;
+	int _typeVolume;
+	bool _typeMuted;
 
 	void updateChannelVolumes();
 	st_volume_t _volL, _volR;
@@ -177,7 +186,8 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _commandMutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _commandHead(0), _commandTail(0) {
 
 	assert(sampleRate > 0);
 
@@ -186,6 +196,9 @@ MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
 }
 
 MixerImpl::~MixerImpl() {
+	// Take over channels which have not been started yet
+	processCommands();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
 }
@@ -208,29 +221,99 @@ uint MixerImpl::getOutputBufSize() const {
 	return _outBufSize;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
-	int index = -1;
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == nullptr) {
-			index = i;
-			break;
+void MixerImpl::postCommand(Command::Type type, int index, uint32 handle, int value, Channel *chan) {
+	// The caller holds _commandMutex and made sure there is enough space
+	const uint32 head = _commandHead.load(std::memory_order_relaxed);
+	assert(head - _commandTail.load(std::memory_order_acquire) < COMMAND_QUEUE_SIZE);
+
+	Command &cmd = _commands[head % COMMAND_QUEUE_SIZE];
+	cmd.type = type;
+	cmd.index = index;
+	cmd.handle = handle;
+	cmd.value = value;
+	cmd.chan = chan;
+
+	_commandHead.store(head + 1, std::memory_order_release);
+}
+
+void MixerImpl::waitForCommandSpace(uint count) {
+	// The caller holds _commandMutex. If the mixer thread is not keeping up
+	// (or not running at all), apply the pending commands ourselves. The
+	// command mutex is released meanwhile, so we never wait for _mutex while
+	// holding it.
+	while (COMMAND_QUEUE_SIZE - (_commandHead.load(std::memory_order_relaxed) - _commandTail.load(std::memory_order_acquire)) < count) {
+		_commandMutex.unlock();
+		{
+			Common::StackLock lock(_mutex);
+			processCommands();
 		}
+		_commandMutex.lock();
 	}
-	if (index == -1) {
-		warning("MixerImpl::out of mixer slots");
-		delete chan;
-		return;
+}
+
+void MixerImpl::processCommands() {
+	// Must be called with _mutex held. This never waits for anything.
+	uint32 tail = _commandTail.load(std::memory_order_relaxed);
+	const uint32 head = _commandHead.load(std::memory_order_acquire);
+
+	for (; tail != head; ++tail) {
+		const Command &cmd = _commands[tail % COMMAND_QUEUE_SIZE];
+
+		if (cmd.type == Command::kPlay) {
+			assert(!_channels[cmd.index]);
+			_channels[cmd.index] = cmd.chan;
+			continue;
+		} else if (cmd.type == Command::kPauseAll) {
+			for (int i = 0; i != NUM_CHANNELS; i++) {
+				if (_channels[i])
+					_channels[i]->pause(cmd.value != 0);
+			}
+			continue;
+		} else if (cmd.type == Command::kSoundTypeChanged) {
+			for (int i = 0; i != NUM_CHANNELS; i++) {
+				if (_channels[i] && _channels[i]->getType() == cmd.index)
+					_channels[i]->notifyGlobalVolChange(cmd.value, cmd.handle != 0);
+			}
+			continue;
+		}
+
+		// Simply ignore requests for sounds that already terminated
+		Channel *chan = _channels[cmd.index];
+		if (!chan || chan->getHandle()._val != cmd.handle)
+			continue;
+
+		switch (cmd.type) {
+		case Command::kSetVolume:
+			chan->setVolume(cmd.value);
+			break;
+		case Command::kSetBalance:
+			chan->setBalance(cmd.value);
+			break;
+		case Command::kPause:
+			chan->pause(cmd.value != 0);
+			break;
+		case Command::kLoop:
+			chan->loop();
+			break;
+		default:
+			break;
+		}
 	}
 
-	_channels[index] = chan;
+	_commandTail.store(tail, std::memory_order_release);
+}
 
-	SoundHandle chanHandle;
-	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+int MixerImpl::findChannelState(SoundHandle handle) const {
+	const int index = handle._val % NUM_CHANNELS;
+	if (_channelStates[index].handle.load(std::memory_order_acquire) != handle._val)
+		return -1;
+	return index;
+}
 
-	chan->setHandle(chanHandle);
-	_handleSeed++;
-	if (handle)
-		*handle = chanHandle;
+void MixerImpl::removeChannel(int index) {
+	// Must be called with _mutex held
+	_channels[index] = nullptr;
+	_channelStates[index].handle.store(0xFFFFFFFF, std::memory_order_release);
 }
 
 void MixerImpl::playStream(
@@ -241,8 +324,6 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
-	Common::StackLock lock(_mutex);
-
 	if (stream == nullptr) {
 		warning("stream is 0");
 		return;
@@ -251,31 +332,67 @@ void MixerImpl::playStream(
 
 	assert(_mixerReady);
 
+#ifdef AUDIO_REVERSE_STEREO
+	reverseStereo = !reverseStereo;
+#endif
+
+	// Create the channel. Setting up the rate converter can take a while,
+	// so this is done before locking anything.
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+
+	Common::StackLock lock(_commandMutex);
+	waitForCommandSpace(1);
+
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != nullptr && _channels[i]->getId() == id) {
+			if (_channelStates[i].handle.load(std::memory_order_acquire) != 0xFFFFFFFF && _channelStates[i].id == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
 				// keep in mind here is QueuingAudioStream.
 				// Thus, as a quick rule of thumb, you should never, ever,
 				// try to play QueuingAudioStreams with a sound id.
-				if (autofreeStream == DisposeAfterUse::YES)
-					delete stream;
+				delete chan;
 				return;
 			}
 	}
 
-#ifdef AUDIO_REVERSE_STEREO
-	reverseStereo = !reverseStereo;
-#endif
+	int index = -1;
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		if (_channelStates[i].handle.load(std::memory_order_acquire) == 0xFFFFFFFF) {
+			index = i;
+			break;
+		}
+	}
+	if (index == -1) {
+		warning("MixerImpl::out of mixer slots");
+		delete chan;
+		return;
+	}
 
-	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	SoundHandle chanHandle;
+	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+	_handleSeed++;
+
+	const SoundTypeSettings &settings = _soundTypeSettings[type];
+	chan->setHandle(chanHandle);
+	chan->notifyGlobalVolChange(settings.volume, settings.mute);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
-	insertChannel(handle, chan);
+
+	ChannelState &state = _channelStates[index];
+	state.id = id;
+	state.type = type;
+	state.permanent = permanent;
+	state.volume = volume;
+	state.balance = balance;
+	state.handle.store(chanHandle._val, std::memory_order_release);
+
+	postCommand(Command::kPlay, index, chanHandle._val, 0, chan);
+
+	if (handle)
+		*handle = chanHandle;
 }
 
 int MixerImpl::mixCallback(byte *samples, uint len) {
@@ -288,6 +405,9 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	// Apply what the engine requested since the last buffer
+	processCommands();
+
 	//  zero the buf
 	memset(buf, 0, len);
 
@@ -306,7 +426,7 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
 				delete _channels[i];
-				_channels[i] = nullptr;
+				removeChannel(i);
 			} else if (!_channels[i]->isPaused()) {
 				tmp = _channels[i]->mix(buf, len);
 
@@ -319,45 +439,75 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 }
 
 void MixerImpl::stopAll() {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+	Channel *stopped[NUM_CHANNELS];
+	int numStopped = 0;
+
+	{
+		Common::StackLock lock(_mutex);
+		processCommands();
+
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
+				stopped[numStopped++] = _channels[i];
+				removeChannel(i);
+			}
 		}
 	}
+
+	// Streams can take a while to tear down, so do not keep the mixer waiting
+	for (int i = 0; i < numStopped; i++)
+		delete stopped[i];
 }
 
 void MixerImpl::stopID(int id) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+	Channel *stopped[NUM_CHANNELS];
+	int numStopped = 0;
+
+	{
+		Common::StackLock lock(_mutex);
+		processCommands();
+
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != nullptr && _channels[i]->getId() == id) {
+				stopped[numStopped++] = _channels[i];
+				removeChannel(i);
+			}
 		}
 	}
+
+	for (int i = 0; i < numStopped; i++)
+		delete stopped[i];
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannelState(handle);
+	if (index == -1)
 		return;
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+	Channel *chan;
+	{
+		Common::StackLock lock(_mutex);
+		processCommands();
+
+		chan = _channels[index];
+		if (!chan || chan->getHandle()._val != handle._val)
+			return;
+
+		removeChannel(index);
+	}
+
+	delete chan;
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	Common::StackLock lock(_commandMutex);
+	waitForCommandSpace(1);
+
+	_soundTypeSettings[type].mute = mute;
+	postCommand(Command::kSoundTypeChanged, type, mute, _soundTypeSettings[type].volume);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -366,39 +516,47 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
+	waitForCommandSpace(1);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannelState(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->setVolume(volume);
+	_channelStates[index].volume = volume;
+	postCommand(Command::kSetVolume, index, handle._val, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_commandMutex);
+
+	const int index = findChannelState(handle);
+	if (index == -1)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return _channelStates[index].volume;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
+	waitForCommandSpace(1);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannelState(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->setBalance(balance);
+	_channelStates[index].balance = balance;
+	postCommand(Command::kSetBalance, index, handle._val, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_commandMutex);
+
+	const int index = findChannelState(handle);
+	if (index == -1)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return _channelStates[index].balance;
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -408,6 +566,8 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
+	// Channels which have not been picked up by the mixer thread yet did
+	// not play anything either
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return Timestamp(0, _sampleRate);
@@ -416,81 +576,81 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 }
 
 void MixerImpl::loopChannel(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
+	waitForCommandSpace(1);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannelState(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->loop();
+	postCommand(Command::kLoop, index, handle._val, 0);
 }
 
 void MixerImpl::pauseAll(bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr) {
-			_channels[i]->pause(paused);
-		}
-	}
+	Common::StackLock lock(_commandMutex);
+	waitForCommandSpace(1);
+
+	postCommand(Command::kPauseAll, 0, 0, paused);
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
+	waitForCommandSpace(1);
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+		const uint32 chanHandle = _channelStates[i].handle.load(std::memory_order_acquire);
+		if (chanHandle != 0xFFFFFFFF && _channelStates[i].id == id) {
+			postCommand(Command::kPause, i, chanHandle, paused);
 			return;
 		}
 	}
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
+	waitForCommandSpace(1);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannelState(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->pause(paused);
+	postCommand(Command::kPause, index, handle._val, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (_channelStates[i].handle.load(std::memory_order_acquire) != 0xFFFFFFFF && _channelStates[i].id == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	Common::StackLock lock(_commandMutex);
+	const int index = findChannelState(handle);
+	if (index != -1)
+		return _channelStates[index].id;
 	return 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findChannelState(handle) != -1;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (_channelStates[i].handle.load(std::memory_order_acquire) != 0xFFFFFFFF && _channelStates[i].type == type)
 			return true;
 	return false;
 }
@@ -504,13 +664,11 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
-	_soundTypeSettings[type].volume = volume;
+	Common::StackLock lock(_commandMutex);
+	waitForCommandSpace(1);
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	_soundTypeSettings[type].volume = volume;
+	postCommand(Command::kSoundTypeChanged, type, _soundTypeSettings[type].mute, volume);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -527,7 +685,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
+	  _balance(0), _typeVolume(Mixer::kMaxMixerVolume), _typeMuted(false), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
 	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
 	  _stream(stream, autofreeStream) {
 	assert(mixer);
@@ -568,8 +726,8 @@ void Channel::updateChannelVolumes() {
 	// volume is in the range 0 - kMaxMixerVolume.
 	// Hence, the vol_l/vol_r values will be in that range, too
 
-	if (!_mixer->isSoundTypeMuted(_type)) {
-		int vol = _mixer->getVolumeForSoundType(_type) * _volume;
+	if (!_typeMuted) {
+		int vol = _typeVolume * _volume;
 
 		if (_balance == 0) {
 			_volL = vol / Mixer::kMaxChannelVolume;
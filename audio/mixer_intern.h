@@ -26,6 +26,8 @@
 #include "common/mutex.h"
 #include "audio/mixer.h"
 
+#include <atomic>
+
 namespace Audio {
 
 /**
@@ -49,6 +51,12 @@ namespace Audio {
  * 4) Change the mixer into ready mode via setReady(true).
  * 5) Start audio processing (e.g. by resuming the audio thread, if applicable).
  *
+ * Starting sounds and changing their volume, balance or pause state never
+ * waits for the mixer thread: such requests are put into a command queue,
+ * which mixCallback() applies at the start of the next buffer. Only
+ * stopping sounds still synchronizes with the mixer thread, since callers
+ * may free the data of a stream as soon as it has been stopped.
+ *
  * In the future, we might make it possible for backends to provide
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
@@ -58,10 +66,14 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		COMMAND_QUEUE_SIZE = 256
 	};
 
+	/** Held by the mixer thread while mixing. */
 	Common::Mutex _mutex;
+	/** Serializes the engine threads submitting commands. */
+	Common::Mutex _commandMutex;
 
 	const uint _sampleRate;
 	const bool _stereo;
@@ -77,8 +89,60 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
+
+	/** The channels being mixed, only accessed with _mutex held. */
 	Channel *_channels[NUM_CHANNELS];
 
+	/**
+	 * What the engine threads know about a channel slot. Only handle is
+	 * written by the mixer thread, when a sound ends or is stopped; the
+	 * other fields are guarded by _commandMutex.
+	 */
+	struct ChannelState {
+		ChannelState() : handle(0xFFFFFFFF), id(-1), type(kPlainSoundType), permanent(false), volume(kMaxChannelVolume), balance(0) {}
+
+		std::atomic<uint32> handle;
+		int id;
+		SoundType type;
+		bool permanent;
+		byte volume;
+		int8 balance;
+	};
+
+	ChannelState _channelStates[NUM_CHANNELS];
+
+	/** A request from an engine thread, applied by the mixer thread. */
+	struct Command {
+		enum Type {
+			kPlay,
+			kSetVolume,
+			kSetBalance,
+			kPause,
+			kPauseAll,
+			kLoop,
+			kSoundTypeChanged
+		};
+
+		Type type;
+		int index;     ///< channel slot, or sound type for kSoundTypeChanged
+		uint32 handle; ///< channel handle, or mute flag for kSoundTypeChanged
+		int value;
+		Channel *chan; ///< the new channel for kPlay
+	};
+
+	/**
+	 * Single consumer ring buffer of commands. _commandHead is only advanced
+	 * with _commandMutex held, _commandTail only with _mutex held.
+	 */
+	Command _commands[COMMAND_QUEUE_SIZE];
+	std::atomic<uint32> _commandHead;
+	std::atomic<uint32> _commandTail;
+
+	void postCommand(Command::Type type, int index, uint32 handle, int value, Channel *chan = nullptr);
+	void waitForCommandSpace(uint count);
+	void processCommands();
+	int findChannelState(SoundHandle handle) const;
+	void removeChannel(int index);
 
 public:
 
@@ -133,9 +197,6 @@ public:
 	virtual bool getOutputStereo() const;
 	virtual uint getOutputBufSize() const;
 
-protected:
-	void insertChannel(SoundHandle *handle, Channel *chan);
-
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
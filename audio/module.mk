@@ -108,5 +108,23 @@ MODULE_OBJS += \
 	rwopl3.o
 endif
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	rate_sse2.o
+$(MODULE)/rate_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	rate_avx2.o
+$(MODULE)/rate_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	rate_neon.o
+$(MODULE)/rate_neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
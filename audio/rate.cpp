@@ -29,8 +29,13 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
+#include "common/array.h"
+#include "common/config-manager.h"
 #include "common/frac.h"
+#include "common/math.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -56,6 +61,84 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+#pragma mark -
+
+void mixStereo_Scalar(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t volA, st_volume_t volB) {
+	for (; frames > 0; --frames) {
+		clampedAdd(obuf[0], (in[0] * (int)volA) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(obuf[1], (in[1] * (int)volB) / Audio::Mixer::kMaxMixerVolume);
+		obuf += 2;
+		in += 2;
+	}
+}
+
+void interpolate_Scalar(st_sample_t *out, const st_sample_t *pairs, const uint16 *frac, st_size_t count) {
+	for (; count > 0; --count) {
+		*out++ = (st_sample_t)(pairs[0] + (((pairs[1] - pairs[0]) * (int)*frac++ + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+		pairs += 2;
+	}
+}
+
+const RateKernels &getRateKernels() {
+	static const RateKernels scalarKernels = { mixStereo_Scalar, interpolate_Scalar };
+
+	// The vector kernels saturate on signed samples, which does not match
+	// what clampedAdd() does for unsigned output.
+#ifndef OUTPUT_UNSIGNED_AUDIO
+	if (g_system) {
+#ifdef SCUMMVM_AVX2
+		static const RateKernels avx2Kernels = { mixStereo_AVX2, interpolate_AVX2 };
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+			return avx2Kernels;
+#endif
+#ifdef SCUMMVM_SSE2
+		static const RateKernels sse2Kernels = { mixStereo_SSE2, interpolate_SSE2 };
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			return sse2Kernels;
+#endif
+#ifdef SCUMMVM_NEON
+		static const RateKernels neonKernels = { mixStereo_NEON, interpolate_NEON };
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			return neonKernels;
+#endif
+	}
+#endif
+
+	return scalarKernels;
+}
+
+/**
+ * Stores one input frame into a staging buffer in output channel order.
+ */
+template<bool reverseStereo>
+static inline void stageFrame(st_sample_t *dst, st_sample_t in0, st_sample_t in1) {
+	dst[reverseStereo    ] = in0;
+	dst[reverseStereo ^ 1] = in1;
+}
+
+/**
+ * Mixes staged frames into the output buffer. volA and volB are the volumes
+ * of the first and second staged channel respectively.
+ */
+template<bool outStereo>
+static inline void mixStaged(const RateKernels &kernels, st_sample_t *obuf, const st_sample_t *staged, st_size_t frames, st_volume_t volA, st_volume_t volB) {
+	if (outStereo) {
+		kernels.mixStereo(obuf, staged, frames, volA, volB);
+	} else {
+		for (; frames > 0; --frames) {
+			st_sample_t out0, out1;
+			out0 = (staged[0] * (int)volA) / Audio::Mixer::kMaxMixerVolume;
+			out1 = (staged[1] * (int)volB) / Audio::Mixer::kMaxMixerVolume;
+
+			// output mono channel
+			clampedAdd(*obuf++, (out0 + out1) / 2);
+			staged += 2;
+		}
+	}
+}
+
+#pragma mark -
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -69,6 +152,10 @@ protected:
 	const st_sample_t *inPtr;
 	int inLen;
 
+	/** selected frames in output channel order, waiting to be mixed */
+	st_sample_t stageBuf[INTERMEDIATE_BUFFER_SIZE * 2];
+	const RateKernels &_kernels;
+
 	/** position of how far output is ahead of input */
 	/** Holds what would have been opos-ipos */
 	long opos;
@@ -89,7 +176,7 @@ public:
  * Prepare processing.
  */
 template<bool inStereo, bool outStereo, bool reverseStereo>
-SimpleRateConverter<inStereo, outStereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate, st_rate_t outrate) {
+SimpleRateConverter<inStereo, outStereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate, st_rate_t outrate) : _kernels(getRateKernels()) {
 	if ((inrate % outrate) != 0) {
 		error("Input rate must be a multiple of output rate to use rate effect");
 	}
@@ -117,49 +204,49 @@ int SimpleRateConverter<inStereo, outStereo, reverseStereo>::flow(AudioStream &i
 	ostart = obuf;
 	oend = obuf + osamp * (outStereo ? 2 : 1);
 
-	while (obuf < oend) {
-
-		// read enough input samples so that opos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / (outStereo ? 2 : 1);
-			}
-			inLen -= (inStereo ? 2 : 1);
-			opos--;
-			if (opos >= 0) {
-				inPtr += (inStereo ? 2 : 1);
-			}
-		} while (opos >= 0);
-
-		st_sample_t in0, in1;
-		in0 = *inPtr++;
-		in1 = (inStereo ? *inPtr++ : in0);
-
-		// Increment output position
-		opos += opos_inc;
-
-		st_sample_t out0, out1;
-		out0 = (in0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume;
-		out1 = (in1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume;
+	const st_volume_t volA = reverseStereo ? vol_r : vol_l;
+	const st_volume_t volB = reverseStereo ? vol_l : vol_r;
+
+	bool endOfInput = false;
+	while (obuf < oend && !endOfInput) {
+		const st_size_t maxFrames = MIN<st_size_t>((oend - obuf) / (outStereo ? 2 : 1), INTERMEDIATE_BUFFER_SIZE);
+		st_size_t frames = 0;
+
+		while (frames < maxFrames) {
+			// read enough input samples so that opos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (inStereo ? 2 : 1);
+				opos--;
+				if (opos >= 0) {
+					inPtr += (inStereo ? 2 : 1);
+				}
+			} while (opos >= 0);
+
+			if (endOfInput)
+				break;
 
-		if (outStereo) {
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], out0);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], out1);
+			st_sample_t in0, in1;
+			in0 = *inPtr++;
+			in1 = (inStereo ? *inPtr++ : in0);
 
-			obuf += 2;
-		} else {
-			// output mono channel
-			clampedAdd(obuf[0], (out0 + out1) / 2);
+			// Increment output position
+			opos += opos_inc;
 
-			obuf += 1;
+			stageFrame<reverseStereo>(stageBuf + frames * 2, in0, in1);
+			frames++;
 		}
+
+		mixStaged<outStereo>(_kernels, obuf, stageBuf, frames, volA, volB);
+		obuf += frames * (outStereo ? 2 : 1);
 	}
 	return (obuf - ostart) / (outStereo ? 2 : 1);
 }
@@ -193,6 +280,14 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	/** (last, current) input sample pairs for each output sample, in output channel order */
+	st_sample_t pairBuf[INTERMEDIATE_BUFFER_SIZE * 4];
+	/** interpolation position for each output sample */
+	uint16 fracBuf[INTERMEDIATE_BUFFER_SIZE * 2];
+	/** interpolated frames, waiting to be mixed */
+	st_sample_t stageBuf[INTERMEDIATE_BUFFER_SIZE * 2];
+	const RateKernels &_kernels;
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override;
@@ -206,7 +301,7 @@ public:
  * Prepare processing.
  */
 template<bool inStereo, bool outStereo, bool reverseStereo>
-LinearRateConverter<inStereo, outStereo, reverseStereo>::LinearRateConverter(st_rate_t inrate, st_rate_t outrate) {
+LinearRateConverter<inStereo, outStereo, reverseStereo>::LinearRateConverter(st_rate_t inrate, st_rate_t outrate) : _kernels(getRateKernels()) {
 	if (inrate >= 131072 || outrate >= 131072) {
 		error("rate effect can only handle rates < 131072");
 	}
@@ -237,59 +332,285 @@ int LinearRateConverter<inStereo, outStereo, reverseStereo>::flow(AudioStream &i
 	ostart = obuf;
 	oend = obuf + osamp * (outStereo ? 2 : 1);
 
-	while (obuf < oend) {
-
-		// read enough input samples so that opos < 0
-		while ((frac_t)FRAC_ONE_LOW <= opos) {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / (outStereo ? 2 : 1);
+	const st_volume_t volA = reverseStereo ? vol_r : vol_l;
+	const st_volume_t volB = reverseStereo ? vol_l : vol_r;
+
+	bool endOfInput = false;
+	while (obuf < oend && !endOfInput) {
+		const st_size_t maxFrames = MIN<st_size_t>((oend - obuf) / (outStereo ? 2 : 1), INTERMEDIATE_BUFFER_SIZE);
+		st_size_t frames = 0;
+
+		// Gather the interpolation inputs for a batch of output frames first,
+		// so that the interpolation itself can run on whole blocks.
+		while (frames < maxFrames) {
+			// read enough input samples so that opos < 0
+			while ((frac_t)FRAC_ONE_LOW <= opos) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (inStereo ? 2 : 1);
+				ilast0 = icur0;
+				icur0 = *inPtr++;
+				if (inStereo) {
+					ilast1 = icur1;
+					icur1 = *inPtr++;
+				}
+				opos -= FRAC_ONE_LOW;
 			}
-			inLen -= (inStereo ? 2 : 1);
-			ilast0 = icur0;
-			icur0 = *inPtr++;
-			if (inStereo) {
-				ilast1 = icur1;
-				icur1 = *inPtr++;
+
+			if (endOfInput)
+				break;
+
+			// Loop as long as the outpos trails behind, and as long as there is
+			// still space in the output buffer.
+			while (opos < (frac_t)FRAC_ONE_LOW && frames < maxFrames) {
+				st_sample_t *pair = pairBuf + frames * 4;
+				pair[reverseStereo * 2    ] = ilast0;
+				pair[reverseStereo * 2 + 1] = icur0;
+				pair[(reverseStereo ^ 1) * 2    ] = (inStereo ? ilast1 : ilast0);
+				pair[(reverseStereo ^ 1) * 2 + 1] = (inStereo ? icur1 : icur0);
+				fracBuf[frames * 2] = fracBuf[frames * 2 + 1] = (uint16)opos;
+				frames++;
+
+				// Increment output position
+				opos += opos_inc;
 			}
-			opos -= FRAC_ONE_LOW;
 		}
 
-		// Loop as long as the outpos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
-			// interpolate
-			st_sample_t in0, in1;
-			in0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			in1 = (inStereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						  in0);
+		// interpolate
+		_kernels.interpolate(stageBuf, pairBuf, fracBuf, frames * 2);
 
-			st_sample_t out0, out1;
-			out0 = (in0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume;
-			out1 = (in1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume;
+		mixStaged<outStereo>(_kernels, obuf, stageBuf, frames, volA, volB);
+		obuf += frames * (outStereo ? 2 : 1);
+	}
+	return (obuf - ostart) / (outStereo ? 2 : 1);
+}
 
-			if (outStereo) {
-				// output left channel
-				clampedAdd(obuf[reverseStereo    ], out0);
 
-				// output right channel
-				clampedAdd(obuf[reverseStereo ^ 1], out1);
+/**
+ * Parameters of the windowed-sinc filters used by FIRRateConverter for
+ * each quality level. The tap count is for upsampling; when downsampling it
+ * is scaled by the rate ratio to keep the transition band narrow.
+ */
+struct FIRQualityParams {
+	uint taps;
+	uint phaseBits;
+	double rolloff;
+	double kaiserBeta;
+};
 
-				obuf += 2;
-			} else {
-				// output mono channel
-				clampedAdd(obuf[0], (out0 + out1) / 2);
+static const FIRQualityParams firQualityParams[] = {
+	{  8, 5, 0.85, 5.0 }, // kResamplerFIRFast
+	{ 16, 7, 0.90, 7.0 }, // kResamplerFIRBalanced
+	{ 32, 9, 0.94, 9.0 }  // kResamplerFIRBest
+};
 
-				obuf += 1;
+enum {
+	FIR_MAX_TAPS = 128,
+	FIR_COEF_BITS = 15
+};
+
+/** Zeroth order modified Bessel function of the first kind. */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	const double halfX = x / 2.0;
+	for (int k = 1; k < 50 && term > sum * 1e-12; k++) {
+		term *= (halfX / k) * (halfX / k);
+		sum += term;
+	}
+	return sum;
+}
+
+/**
+ * Builds the polyphase coefficient table of a Kaiser windowed sinc low-pass
+ * filter. Phase p holds the taps for an output position p / phases samples
+ * past the centre of the filter window. Each phase is normalized to unity
+ * gain.
+ */
+static void generateFIRTable(Common::Array<int16> &table, uint taps, uint phases, double cutoff, double beta) {
+	table.resize(taps * phases);
+
+	const double center = taps / 2 - 1;
+	const double halfWidth = taps / 2;
+	const double i0Beta = besselI0(beta);
+	double coefs[FIR_MAX_TAPS];
+
+	for (uint p = 0; p < phases; p++) {
+		const double f = (double)p / phases;
+		double sum = 0.0;
+
+		for (uint j = 0; j < taps; j++) {
+			const double d = (j - center) - f;
+			const double x = d / halfWidth;
+			const double window = (x >= -1.0 && x <= 1.0) ? besselI0(beta * sqrt(1.0 - x * x)) / i0Beta : 0.0;
+			const double arg = 2.0 * cutoff * d;
+			const double sinc = (arg == 0.0) ? 1.0 : sin(M_PI * arg) / (M_PI * arg);
+
+			coefs[j] = 2.0 * cutoff * sinc * window;
+			sum += coefs[j];
+		}
+
+		int16 *dst = &table[p * taps];
+		int total = 0;
+		uint largest = 0;
+		for (uint j = 0; j < taps; j++) {
+			dst[j] = (int16)floor(coefs[j] / sum * (1 << FIR_COEF_BITS) + 0.5);
+			total += dst[j];
+			if (ABS(dst[j]) > ABS(dst[largest]))
+				largest = j;
+		}
+
+		// Put the rounding error onto the largest tap so DC passes unchanged
+		dst[largest] += (1 << FIR_COEF_BITS) - total;
+	}
+}
+
+/**
+ * Audio rate converter based on a polyphase windowed-sinc FIR filter.
+ *
+ * Unlike the linear interpolation converter, this properly band-limits the
+ * signal and hence avoids most of the aliasing and imaging artifacts when
+ * converting low rate game audio to the output rate. The output is delayed
+ * by half the filter length.
+ */
+template<bool inStereo, bool outStereo, bool reverseStereo>
+class FIRRateConverter : public RateConverter {
+protected:
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	const st_sample_t *inPtr;
+	int inLen;
+
+	/** filtered frames in output channel order, waiting to be mixed */
+	st_sample_t stageBuf[INTERMEDIATE_BUFFER_SIZE * 2];
+	const RateKernels &_kernels;
+
+	Common::Array<int16> _coefs;
+	uint _taps;
+	uint _phaseShift;
+
+	/**
+	 * The last _taps input samples of each channel. Every sample is stored
+	 * twice, so the filter window is always contiguous.
+	 */
+	st_sample_t _history[2][FIR_MAX_TAPS * 2];
+	uint _historyPos;
+
+	/** fractional position of the output stream between two input samples */
+	uint32 _fracPos;
+	/** position increment per output sample, as integer and fractional part */
+	uint32 _incInt, _incFrac;
+	/** input samples to consume before producing the next output sample */
+	uint32 _pending;
+
+	void pushSample(st_sample_t in0, st_sample_t in1) {
+		_history[0][_historyPos] = _history[0][_historyPos + _taps] = in0;
+		_history[1][_historyPos] = _history[1][_historyPos + _taps] = in1;
+		if (++_historyPos == _taps)
+			_historyPos = 0;
+	}
+
+	st_sample_t filter(const st_sample_t *window, const int16 *coefs) const {
+		int acc = 1 << (FIR_COEF_BITS - 1);
+		for (uint j = 0; j < _taps; j++)
+			acc += window[j] * coefs[j];
+		return (st_sample_t)CLIP<int>(acc >> FIR_COEF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+	}
+
+public:
+	FIRRateConverter(st_rate_t inrate, st_rate_t outrate, ResamplerQuality quality);
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override;
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) override {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+FIRRateConverter<inStereo, outStereo, reverseStereo>::FIRRateConverter(st_rate_t inrate, st_rate_t outrate, ResamplerQuality quality) : _kernels(getRateKernels()) {
+	assert(quality >= kResamplerFIRFast && quality <= kResamplerFIRBest);
+	const FIRQualityParams &params = firQualityParams[quality - kResamplerFIRFast];
+
+	double cutoff = 0.5 * params.rolloff;
+	_taps = params.taps;
+	if (inrate > outrate) {
+		cutoff = cutoff * outrate / inrate;
+		_taps = MIN<uint>((_taps * inrate + outrate - 1) / outrate, FIR_MAX_TAPS);
+		_taps = (_taps + 1) & ~1;
+	}
+
+	_phaseShift = 32 - params.phaseBits;
+	generateFIRTable(_coefs, _taps, 1 << params.phaseBits, cutoff, params.kaiserBeta);
+
+	memset(_history, 0, sizeof(_history));
+	_historyPos = 0;
+
+	_incInt = inrate / outrate;
+	_incFrac = (uint32)(((uint64)(inrate % outrate) << 32) / outrate);
+	_fracPos = 0;
+	// Fill the window up to its centre, so the first output sample lines
+	// up with the first input sample.
+	_pending = _taps / 2 + 1;
+
+	inLen = 0;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int FIRRateConverter<inStereo, outStereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * (outStereo ? 2 : 1);
+
+	const st_volume_t volA = reverseStereo ? vol_r : vol_l;
+	const st_volume_t volB = reverseStereo ? vol_l : vol_r;
+
+	bool endOfInput = false;
+	while (obuf < oend && !endOfInput) {
+		const st_size_t maxFrames = MIN<st_size_t>((oend - obuf) / (outStereo ? 2 : 1), INTERMEDIATE_BUFFER_SIZE);
+		st_size_t frames = 0;
+
+		while (frames < maxFrames) {
+			// Feed the filter window up to the next output position
+			while (_pending > 0) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (inStereo ? 2 : 1);
+				st_sample_t in0 = *inPtr++;
+				st_sample_t in1 = (inStereo ? *inPtr++ : in0);
+				pushSample(in0, in1);
+				_pending--;
 			}
 
+			if (endOfInput)
+				break;
+
+			const int16 *coefs = &_coefs[(_fracPos >> _phaseShift) * _taps];
+			st_sample_t out0, out1;
+			out0 = filter(&_history[0][_historyPos], coefs);
+			out1 = (inStereo ? filter(&_history[1][_historyPos], coefs) : out0);
+			stageFrame<reverseStereo>(stageBuf + frames * 2, out0, out1);
+			frames++;
+
 			// Increment output position
-			opos += opos_inc;
+			const uint32 fracPos = _fracPos + _incFrac;
+			_pending = _incInt + (fracPos < _fracPos ? 1 : 0);
+			_fracPos = fracPos;
 		}
+
+		mixStaged<outStereo>(_kernels, obuf, stageBuf, frames, volA, volB);
+		obuf += frames * (outStereo ? 2 : 1);
 	}
 	return (obuf - ostart) / (outStereo ? 2 : 1);
 }
@@ -305,8 +626,10 @@ template<bool inStereo, bool outStereo, bool reverseStereo>
 class CopyRateConverter : public RateConverter {
 	st_sample_t *_buffer;
 	st_size_t _bufferSize;
+	st_sample_t _stageBuf[INTERMEDIATE_BUFFER_SIZE * 2];
+	const RateKernels &_kernels;
 public:
-	CopyRateConverter() : _buffer(nullptr), _bufferSize(0) {}
+	CopyRateConverter() : _buffer(nullptr), _bufferSize(0), _kernels(getRateKernels()) {}
 	~CopyRateConverter() {
 		free(_buffer);
 	}
@@ -335,31 +658,32 @@ public:
 		// Read up to 'osamp' samples into our temporary buffer
 		len = input.readBuffer(_buffer, osamp);
 
+		const st_volume_t volA = reverseStereo ? vol_r : vol_l;
+		const st_volume_t volB = reverseStereo ? vol_l : vol_r;
+
 		// Mix the data into the output buffer
 		ptr = _buffer;
-		for (; len > 0; len -= (inStereo ? 2 : 1)) {
-			st_sample_t in0, in1;
-			in0 = *ptr++;
-			in1 = (inStereo ? *ptr++ : in0);
-
-			st_sample_t out0, out1;
-			out0 = (in0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume;
-			out1 = (in1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume;
-
-			if (outStereo) {
-				// output left channel
-				clampedAdd(obuf[reverseStereo    ], out0);
-
-				// output right channel
-				clampedAdd(obuf[reverseStereo ^ 1], out1);
+		if (inStereo && outStereo && !reverseStereo) {
+			// The input is already laid out like the output
+			_kernels.mixStereo(obuf, ptr, len / 2, volA, volB);
+			obuf += len;
+			return (obuf - ostart) / 2;
+		}
 
-				obuf += 2;
-			} else {
-				// output mono channel
-				clampedAdd(obuf[0], (out0 + out1) / 2);
+		st_size_t frames = len / (inStereo ? 2 : 1);
+		while (frames > 0) {
+			const st_size_t chunk = MIN<st_size_t>(frames, INTERMEDIATE_BUFFER_SIZE);
 
-				obuf += 1;
+			for (st_size_t i = 0; i < chunk; i++) {
+				st_sample_t in0, in1;
+				in0 = *ptr++;
+				in1 = (inStereo ? *ptr++ : in0);
+				stageFrame<reverseStereo>(_stageBuf + i * 2, in0, in1);
 			}
+
+			mixStaged<outStereo>(_kernels, obuf, _stageBuf, chunk, volA, volB);
+			obuf += chunk * (outStereo ? 2 : 1);
+			frames -= chunk;
 		}
 		return (obuf - ostart) / (outStereo ? 2 : 1);
 	}
@@ -373,9 +697,11 @@ public:
 #pragma mark -
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, ResamplerQuality quality) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
+		if (quality != kResamplerLinear) {
+			return new FIRRateConverter<inStereo, outStereo, reverseStereo>(inrate, outrate, quality);
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<inStereo, outStereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<inStereo, outStereo, reverseStereo>(inrate, outrate);
@@ -385,24 +711,39 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 	}
 }
 
+ResamplerQuality getResamplerQuality() {
+	const Common::String quality = ConfMan.get("resampler_quality");
+	if (quality.equalsIgnoreCase("fast"))
+		return kResamplerFIRFast;
+	else if (quality.equalsIgnoreCase("balanced"))
+		return kResamplerFIRBalanced;
+	else if (quality.equalsIgnoreCase("best"))
+		return kResamplerFIRBest;
+	return kResamplerLinear;
+}
+
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool instereo, bool outstereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool instereo, bool outstereo, bool reverseStereo, ResamplerQuality quality) {
 	if (instereo) {
 		if (outstereo) {
 			if (reverseStereo)
-				return makeRateConverter<true, true, true>(inrate, outrate);
+				return makeRateConverter<true, true, true>(inrate, outrate, quality);
 			else
-				return makeRateConverter<true, true, false>(inrate, outrate);
+				return makeRateConverter<true, true, false>(inrate, outrate, quality);
 		} else
-			return makeRateConverter<true, false, false>(inrate, outrate);
+			return makeRateConverter<true, false, false>(inrate, outrate, quality);
 	} else {
 		if (outstereo) {
-			return makeRateConverter<false, true, false>(inrate, outrate);
+			return makeRateConverter<false, true, false>(inrate, outrate, quality);
 		} else
-			return makeRateConverter<false, false, false>(inrate, outrate);
+			return makeRateConverter<false, false, false>(inrate, outrate, quality);
 	}
 }
 
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool instereo, bool outstereo, bool reverseStereo) {
+	return makeRateConverter(inrate, outrate, instereo, outstereo, reverseStereo, getResamplerQuality());
+}
+
 } // End of namespace Audio
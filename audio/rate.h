@@ -71,6 +71,17 @@ static inline void clampedAdd(int16& a, int b) {
 #endif
 }
 
+/**
+ * Resampling methods available to the rate converters, in order of
+ * increasing quality and CPU usage.
+ */
+enum ResamplerQuality {
+	kResamplerLinear,      ///< Linear interpolation.
+	kResamplerFIRFast,     ///< Short windowed-sinc filter.
+	kResamplerFIRBalanced, ///< Medium windowed-sinc filter.
+	kResamplerFIRBest      ///< Long windowed-sinc filter.
+};
+
 class RateConverter {
 public:
 	RateConverter() {}
@@ -84,6 +95,21 @@ public:
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
 };
 
+/**
+ * Returns the resampler quality selected with the "resampler_quality"
+ * configuration key: linear (default), fast, balanced or best.
+ */
+ResamplerQuality getResamplerQuality();
+
+/**
+ * Create a RateConverter for the specified rates, using the given method.
+ */
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool instereo, bool outstereo, bool reverseStereo, ResamplerQuality quality);
+
+/**
+ * Create a RateConverter for the specified rates, using the method selected
+ * by the user.
+ */
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool instereo, bool outstereo, bool reverseStereo);
 /** @} */
 } // End of namespace Audio
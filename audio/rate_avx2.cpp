@@ -0,0 +1,80 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/rate_intern.h"
+
+#include <immintrin.h>
+
+namespace Audio {
+
+/** Divides 32-bit products by kMaxMixerVolume (256), truncating towards zero. */
+static inline __m256i divideByMaxVolume(__m256i p) {
+	const __m256i bias = _mm256_and_si256(_mm256_srai_epi32(p, 31), _mm256_set1_epi32(255));
+	return _mm256_srai_epi32(_mm256_add_epi32(p, bias), 8);
+}
+
+void mixStereo_AVX2(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t volA, st_volume_t volB) {
+	const __m256i vol = _mm256_set_epi16(volB, volA, volB, volA, volB, volA, volB, volA,
+	                                     volB, volA, volB, volA, volB, volA, volB, volA);
+
+	st_size_t i = 0;
+	for (; i + 8 <= frames; i += 8) {
+		const __m256i src = _mm256_loadu_si256((const __m256i *)(in + i * 2));
+		const __m256i lo = _mm256_mullo_epi16(src, vol);
+		const __m256i hi = _mm256_mulhi_epi16(src, vol);
+		// Unpacking and packing both work within 128-bit lanes, so the
+		// sample order is preserved.
+		const __m256i p0 = divideByMaxVolume(_mm256_unpacklo_epi16(lo, hi));
+		const __m256i p1 = divideByMaxVolume(_mm256_unpackhi_epi16(lo, hi));
+
+		__m256i *dst = (__m256i *)(obuf + i * 2);
+		_mm256_storeu_si256(dst, _mm256_adds_epi16(_mm256_loadu_si256(dst), _mm256_packs_epi32(p0, p1)));
+	}
+
+	if (i < frames)
+		mixStereo_Scalar(obuf + i * 2, in + i * 2, frames - i, volA, volB);
+}
+
+void interpolate_AVX2(st_sample_t *out, const st_sample_t *pairs, const uint16 *frac, st_size_t count) {
+	const __m128i maxFrac = _mm_set1_epi16(0x7FFF);
+	const __m256i half = _mm256_set1_epi32(0x4000);
+
+	st_size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i f = _mm_loadu_si128((const __m128i *)(frac + i));
+		const __m128i inv = _mm_sub_epi16(maxFrac, f);
+		const __m256i weights = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(inv, f)),
+		                                                _mm_unpackhi_epi16(inv, f), 1);
+		const __m256i pair = _mm256_loadu_si256((const __m256i *)(pairs + i * 2));
+
+		// See interpolate_SSE2 for the rearranged formula.
+		__m256i r = _mm256_madd_epi16(pair, weights);
+		r = _mm256_add_epi32(r, _mm256_srai_epi32(_mm256_slli_epi32(pair, 16), 16));
+		r = _mm256_srai_epi32(_mm256_add_epi32(r, half), 15);
+
+		_mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1)));
+	}
+
+	if (i < count)
+		interpolate_Scalar(out + i, pairs + i * 2, frac + i, count - i);
+}
+
+} // End of namespace Audio
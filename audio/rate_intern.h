@@ -0,0 +1,83 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * Mixes interleaved sample pairs into the output buffer:
+ *
+ *   obuf[2 * i]     += in[2 * i]     * volA / Mixer::kMaxMixerVolume
+ *   obuf[2 * i + 1] += in[2 * i + 1] * volB / Mixer::kMaxMixerVolume
+ *
+ * The division truncates towards zero and the additions are clamped, exactly
+ * like clampedAdd() does.
+ */
+typedef void (*MixStereoProc)(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t volA, st_volume_t volB);
+
+/**
+ * Linearly interpolates between pairs of samples:
+ *
+ *   out[i] = pairs[2 * i] + (((pairs[2 * i + 1] - pairs[2 * i]) * frac[i] + 0x4000) >> 15)
+ *
+ * frac[i] must be in the range [0, 0x7FFF].
+ */
+typedef void (*InterpolateProc)(st_sample_t *out, const st_sample_t *pairs, const uint16 *frac, st_size_t count);
+
+/**
+ * The set of inner loops used by the rate converters. All implementations
+ * produce bit-identical output.
+ */
+struct RateKernels {
+	MixStereoProc mixStereo;
+	InterpolateProc interpolate;
+};
+
+void mixStereo_Scalar(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t volA, st_volume_t volB);
+void interpolate_Scalar(st_sample_t *out, const st_sample_t *pairs, const uint16 *frac, st_size_t count);
+
+#ifdef SCUMMVM_SSE2
+void mixStereo_SSE2(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t volA, st_volume_t volB);
+void interpolate_SSE2(st_sample_t *out, const st_sample_t *pairs, const uint16 *frac, st_size_t count);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void mixStereo_AVX2(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t volA, st_volume_t volB);
+void interpolate_AVX2(st_sample_t *out, const st_sample_t *pairs, const uint16 *frac, st_size_t count);
+#endif
+
+#ifdef SCUMMVM_NEON
+void mixStereo_NEON(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t volA, st_volume_t volB);
+void interpolate_NEON(st_sample_t *out, const st_sample_t *pairs, const uint16 *frac, st_size_t count);
+#endif
+
+/**
+ * Returns the fastest set of kernels supported by the CPU we are running on.
+ */
+const RateKernels &getRateKernels();
+
+} // End of namespace Audio
+
+#endif
@@ -0,0 +1,79 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/rate_intern.h"
+
+#include <arm_neon.h>
+
+namespace Audio {
+
+/** Divides 32-bit products by kMaxMixerVolume (256), truncating towards zero. */
+static inline int32x4_t divideByMaxVolume(int32x4_t p) {
+	const int32x4_t bias = vandq_s32(vshrq_n_s32(p, 31), vdupq_n_s32(255));
+	return vshrq_n_s32(vaddq_s32(p, bias), 8);
+}
+
+void mixStereo_NEON(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t volA, st_volume_t volB) {
+	const int16_t volPattern[4] = { (int16_t)volA, (int16_t)volB, (int16_t)volA, (int16_t)volB };
+	const int16x4_t vol = vld1_s16(volPattern);
+
+	st_size_t i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		const int16x8_t src = vld1q_s16(in + i * 2);
+		const int32x4_t p0 = divideByMaxVolume(vmull_s16(vget_low_s16(src), vol));
+		const int32x4_t p1 = divideByMaxVolume(vmull_s16(vget_high_s16(src), vol));
+
+		int16_t *dst = obuf + i * 2;
+		vst1q_s16(dst, vqaddq_s16(vld1q_s16(dst), vcombine_s16(vqmovn_s32(p0), vqmovn_s32(p1))));
+	}
+
+	if (i < frames)
+		mixStereo_Scalar(obuf + i * 2, in + i * 2, frames - i, volA, volB);
+}
+
+void interpolate_NEON(st_sample_t *out, const st_sample_t *pairs, const uint16 *frac, st_size_t count) {
+	const int16x8_t maxFrac = vdupq_n_s16(0x7FFF);
+	const int32x4_t half = vdupq_n_s32(0x4000);
+
+	st_size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const int16x8x2_t pair = vld2q_s16(pairs + i * 2);
+		const int16x8_t last = pair.val[0];
+		const int16x8_t cur = pair.val[1];
+		const int16x8_t f = vreinterpretq_s16_u16(vld1q_u16(frac + i));
+		const int16x8_t inv = vsubq_s16(maxFrac, f);
+
+		// See interpolate_SSE2 for the rearranged formula.
+		int32x4_t r0 = vmull_s16(vget_low_s16(last), vget_low_s16(inv));
+		int32x4_t r1 = vmull_s16(vget_high_s16(last), vget_high_s16(inv));
+		r0 = vmlal_s16(r0, vget_low_s16(cur), vget_low_s16(f));
+		r1 = vmlal_s16(r1, vget_high_s16(cur), vget_high_s16(f));
+		r0 = vaddq_s32(vaddq_s32(r0, vmovl_s16(vget_low_s16(last))), half);
+		r1 = vaddq_s32(vaddq_s32(r1, vmovl_s16(vget_high_s16(last))), half);
+
+		vst1q_s16(out + i, vcombine_s16(vmovn_s32(vshrq_n_s32(r0, 15)), vmovn_s32(vshrq_n_s32(r1, 15))));
+	}
+
+	if (i < count)
+		interpolate_Scalar(out + i, pairs + i * 2, frac + i, count - i);
+}
+
+} // End of namespace Audio
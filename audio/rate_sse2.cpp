@@ -0,0 +1,80 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/rate_intern.h"
+
+#include <emmintrin.h>
+
+namespace Audio {
+
+/** Divides 32-bit products by kMaxMixerVolume (256), truncating towards zero. */
+static inline __m128i divideByMaxVolume(__m128i p) {
+	const __m128i bias = _mm_and_si128(_mm_srai_epi32(p, 31), _mm_set1_epi32(255));
+	return _mm_srai_epi32(_mm_add_epi32(p, bias), 8);
+}
+
+void mixStereo_SSE2(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t volA, st_volume_t volB) {
+	const __m128i vol = _mm_set_epi16(volB, volA, volB, volA, volB, volA, volB, volA);
+
+	st_size_t i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)(in + i * 2));
+		const __m128i lo = _mm_mullo_epi16(src, vol);
+		const __m128i hi = _mm_mulhi_epi16(src, vol);
+		const __m128i p0 = divideByMaxVolume(_mm_unpacklo_epi16(lo, hi));
+		const __m128i p1 = divideByMaxVolume(_mm_unpackhi_epi16(lo, hi));
+
+		__m128i *dst = (__m128i *)(obuf + i * 2);
+		_mm_storeu_si128(dst, _mm_adds_epi16(_mm_loadu_si128(dst), _mm_packs_epi32(p0, p1)));
+	}
+
+	if (i < frames)
+		mixStereo_Scalar(obuf + i * 2, in + i * 2, frames - i, volA, volB);
+}
+
+void interpolate_SSE2(st_sample_t *out, const st_sample_t *pairs, const uint16 *frac, st_size_t count) {
+	const __m128i maxFrac = _mm_set1_epi16(0x7FFF);
+	const __m128i half = _mm_set1_epi32(0x4000);
+
+	st_size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i f = _mm_loadu_si128((const __m128i *)(frac + i));
+		const __m128i inv = _mm_sub_epi16(maxFrac, f);
+		const __m128i pair0 = _mm_loadu_si128((const __m128i *)(pairs + i * 2));
+		const __m128i pair1 = _mm_loadu_si128((const __m128i *)(pairs + i * 2 + 8));
+
+		// last * (0x7FFF - frac) + cur * frac + last is the same as
+		// (last << 15) + (cur - last) * frac, but fits into 16-bit factors.
+		__m128i r0 = _mm_madd_epi16(pair0, _mm_unpacklo_epi16(inv, f));
+		__m128i r1 = _mm_madd_epi16(pair1, _mm_unpackhi_epi16(inv, f));
+		r0 = _mm_add_epi32(r0, _mm_srai_epi32(_mm_slli_epi32(pair0, 16), 16));
+		r1 = _mm_add_epi32(r1, _mm_srai_epi32(_mm_slli_epi32(pair1, 16), 16));
+		r0 = _mm_srai_epi32(_mm_add_epi32(r0, half), 15);
+		r1 = _mm_srai_epi32(_mm_add_epi32(r1, half), 15);
+
+		_mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(r0, r1));
+	}
+
+	if (i < count)
+		interpolate_Scalar(out + i, pairs + i * 2, frac + i, count - i);
+}
+
+} // End of namespace Audio
@@ -34,6 +34,7 @@
 #include "common/events.h"
 #include "common/file.h"
 #include "common/system.h"
+#include "common/thread.h"
 #include "common/util.h"
 #include "common/archive.h"
 #include "common/textconsole.h"
@@ -119,6 +120,35 @@ private:
 
 	int _outputRate;
 
+	/**
+	 * @name Render-ahead mode
+	 * The synth renders into a ring buffer on its own thread, up to
+	 * _renderAhead frames ahead of what the mixer has played. MIDI events
+	 * are queued to be played as far ahead, so that they are placed as
+	 * accurately as when rendering on the mixer thread.
+	 * @{
+	 */
+	uint32 _renderAhead; ///< Also the size of the ring buffer, in frames
+	int16 *_renderBuffer;
+	uint32 _mixerPos;    ///< Frames played. Guarded by _mutex and _renderMutex, read under either
+	uint32 _renderPos;   ///< Frames rendered. Guarded by _renderMutex
+	uint32 _synthBase;   ///< The synth's sample count when rendering started
+	bool _renderQuit;    ///< Guarded by _renderMutex
+	Common::ThreadInternal *_renderThread;
+	Common::MutexInternal *_renderMutex;
+	Common::ConditionVariableInternal *_renderPlayed;
+	Common::ConditionVariableInternal *_renderDone;
+
+	bool startRenderThread(uint32 frames);
+	void stopRenderThread();
+	static void renderThreadEntry(void *data);
+	void renderLoop();
+	uint32 getEventTimestamp();
+	/** @} */
+
+	void playSysex(const byte *msg, uint16 length);
+	void writeSysex(byte channel, const byte *data, uint16 length);
+
 protected:
 	void generateSamples(int16 *buf, int len) override;
 
@@ -156,6 +186,13 @@ MidiDriver_MT32::MidiDriver_MT32(Audio::Mixer *mixer) : MidiDriver_Emulated(mixe
 	_outputRate = 0;
 	_controlData = nullptr;
 	_pcmData = nullptr;
+	_renderAhead = 0;
+	_renderBuffer = nullptr;
+	_mixerPos = _renderPos = _synthBase = 0;
+	_renderQuit = false;
+	_renderThread = nullptr;
+	_renderMutex = nullptr;
+	_renderPlayed = _renderDone = nullptr;
 }
 
 MidiDriver_MT32::~MidiDriver_MT32() {
@@ -215,6 +252,12 @@ int MidiDriver_MT32::open() {
 
 	MidiDriver_Emulated::open();
 
+	// Rendering ahead delays the music, so it is only done on request.
+	// It needs room for the frames the mixer asks for between two ticks.
+	const int renderAhead = ConfMan.hasKey("mt32_render_ahead") ? ConfMan.getInt("mt32_render_ahead") : 0;
+	if (renderAhead > 0)
+		startRenderThread(MAX<uint32>(_outputRate * renderAhead / 1000, 2 * _outputRate / _baseFreq + 1));
+
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 
 	return 0;
@@ -224,7 +267,10 @@ void MidiDriver_MT32::send(uint32 b) {
 	midiDriverCommonSend(b);
 
 	Common::StackLock lock(_mutex);
-	_service.playMsg(b);
+	if (_renderThread)
+		_service.playMsgAt(b, getEventTimestamp());
+	else
+		_service.playMsg(b);
 }
 
 // Indiana Jones and the Fate of Atlantis (including the demo) uses
@@ -235,14 +281,14 @@ void MidiDriver_MT32::setPitchBendRange(byte channel, uint range) {
 	}
 	byte benderRangeSysex[4] = { 0, 0, 4, (uint8)range };
 	Common::StackLock lock(_mutex);
-	_service.writeSysex(channel, benderRangeSysex, 4);
+	writeSysex(channel, benderRangeSysex, 4);
 }
 
 void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
 	midiDriverCommonSysEx(msg, length);
 	if (msg[0] == 0xf0) {
 		Common::StackLock lock(_mutex);
-		_service.playSysex(msg, length);
+		playSysex(msg, length);
 	} else {
 		enum {
 			SYSEX_CMD_DT1 = 0x12,
@@ -251,7 +297,7 @@ void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
 
 		if (msg[3] == SYSEX_CMD_DT1 || msg[3] == SYSEX_CMD_DAT) {
 			Common::StackLock lock(_mutex);
-			_service.writeSysex(msg[1], msg + 4, length - 5);
+			writeSysex(msg[1], msg + 4, length - 5);
 		} else {
 			warning("Unused sysEx command %d", msg[3]);
 		}
@@ -268,6 +314,8 @@ void MidiDriver_MT32::close() {
 	// Detach the mixer callback handler
 	_mixer->stopHandle(_mixerSoundHandle);
 
+	stopRenderThread();
+
 	Common::StackLock lock(_mutex);
 	_service.closeSynth();
 	_service.freeContext();
@@ -277,9 +325,146 @@ void MidiDriver_MT32::close() {
 	_pcmData = nullptr;
 }
 
+void MidiDriver_MT32::playSysex(const byte *msg, uint16 length) {
+	if (_renderThread)
+		_service.playSysexAt(msg, length, getEventTimestamp());
+	else
+		_service.playSysex(msg, length);
+}
+
+void MidiDriver_MT32::writeSysex(byte channel, const byte *data, uint16 length) {
+	if (!_renderThread) {
+		_service.writeSysex(channel, data, length);
+		return;
+	}
+
+	// Writing to the synth directly would race with the render thread, so
+	// the data is queued as a DT1 message instead
+	byte *sysex = new byte[length + 7];
+	byte checksum = 0;
+	sysex[0] = 0xf0;
+	sysex[1] = 0x41;
+	sysex[2] = channel;
+	sysex[3] = 0x16;
+	sysex[4] = 0x12;
+	for (uint16 i = 0; i < length; ++i) {
+		sysex[5 + i] = data[i];
+		checksum -= data[i];
+	}
+	sysex[5 + length] = checksum & 0x7f;
+	sysex[6 + length] = 0xf7;
+	_service.playSysexAt(sysex, length + 7, getEventTimestamp());
+	delete[] sysex;
+}
+
 void MidiDriver_MT32::generateSamples(int16 *data, int len) {
+	if (!_renderThread) {
+		Common::StackLock lock(_mutex);
+		_service.renderBit16s(data, len);
+		return;
+	}
+
+	// The render thread can always get len frames ahead, as it may render
+	// more than two ticks ahead
+	_renderMutex->lock();
+	while (_renderPos - _mixerPos < (uint32)len)
+		_renderDone->wait(_renderMutex);
+	_renderMutex->unlock();
+
+	// The render thread doesn't touch the frames which haven't been played
+	const uint32 start = _mixerPos % _renderAhead;
+	const uint32 first = MIN<uint32>(len, _renderAhead - start);
+	memcpy(data, _renderBuffer + start * 2, first * 2 * sizeof(int16));
+	memcpy(data + first * 2, _renderBuffer, (len - first) * 2 * sizeof(int16));
+
 	Common::StackLock lock(_mutex);
-	_service.renderBit16s(data, len);
+	_renderMutex->lock();
+	_mixerPos += len;
+	_renderPlayed->signal();
+	_renderMutex->unlock();
+}
+
+/**
+ * Returns the synth timestamp of the frame which is played _renderAhead
+ * frames after the current one. The render thread hasn't got there yet.
+ * Must be called with _mutex locked.
+ */
+uint32 MidiDriver_MT32::getEventTimestamp() {
+	return _synthBase + _service.convertOutputToSynthTimestamp(_mixerPos + _renderAhead);
+}
+
+bool MidiDriver_MT32::startRenderThread(uint32 frames) {
+	_renderPlayed = g_system->createConditionVariable();
+	_renderDone = g_system->createConditionVariable();
+	if (_renderPlayed && _renderDone) {
+		_renderMutex = g_system->createMutex();
+		_renderAhead = frames;
+		_renderBuffer = new int16[frames * 2];
+		_mixerPos = _renderPos = 0;
+		_synthBase = _service.getInternalRenderedSampleCount();
+		_renderQuit = false;
+		_renderThread = g_system->createThread(renderThreadEntry, this);
+		if (_renderThread)
+			return true;
+	}
+
+	delete _renderPlayed;
+	delete _renderDone;
+	delete _renderMutex;
+	delete[] _renderBuffer;
+	_renderPlayed = _renderDone = nullptr;
+	_renderMutex = nullptr;
+	_renderBuffer = nullptr;
+	return false;
+}
+
+void MidiDriver_MT32::stopRenderThread() {
+	if (!_renderThread)
+		return;
+
+	_renderMutex->lock();
+	_renderQuit = true;
+	_renderPlayed->signal();
+	_renderMutex->unlock();
+
+	_renderThread->join();
+	delete _renderThread;
+	_renderThread = nullptr;
+
+	delete _renderPlayed;
+	delete _renderDone;
+	delete _renderMutex;
+	delete[] _renderBuffer;
+	_renderPlayed = _renderDone = nullptr;
+	_renderMutex = nullptr;
+	_renderBuffer = nullptr;
+}
+
+void MidiDriver_MT32::renderThreadEntry(void *data) {
+	((MidiDriver_MT32 *)data)->renderLoop();
+}
+
+void MidiDriver_MT32::renderLoop() {
+	_renderMutex->lock();
+	while (!_renderQuit) {
+		const uint32 target = _mixerPos + _renderAhead;
+		if (_renderPos == target) {
+			_renderPlayed->wait(_renderMutex);
+			continue;
+		}
+
+		// Up to the end of the ring buffer at most
+		const uint32 start = _renderPos % _renderAhead;
+		const uint32 len = MIN<uint32>(target - _renderPos, _renderAhead - start);
+		_renderMutex->unlock();
+
+		_service.renderBit16s(_renderBuffer + start * 2, len);
+
+		_renderMutex->lock();
+		_renderPos += len;
+		_renderDone->signal();
+	}
+	_renderMutex->unlock();
 }
 
 uint32 MidiDriver_MT32::property(int prop, uint32 param) {
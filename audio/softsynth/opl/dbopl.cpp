@@ -172,6 +172,8 @@ static Bit16u MulTable[ 384 ];
 
 static Bit8u KslTable[ 8 * 16 ];
 static Bit8u TremoloTable[ TREMOLO_TABLE ];
+//The noise value after 8 steps, for the noise values below 256
+static Bit32u NoiseStepTable[ 256 ];
 //Start of a channel behind the chip struct start
 static Bit16u ChanOffsetTable[32];
 //Start of an operator behind the chip struct start
@@ -598,6 +600,95 @@ INLINE Bits Operator::GetSample( Bits modulation ) {
 	}
 }
 
+//Fills in the volumes of the next samples until the envelope changes its state,
+//that sample is left to TemplateVolume(). Works on copies of the members, the
+//compiler can't tell that the stores to vol don't change them.
+template< Operator::State yes>
+INLINE Bitu Operator::TemplateVolumes( Bitu samples, Bit32u* vol ) {
+	const Bit32u level = currentLevel;
+	const Bit32u add = ( yes == ATTACK ) ? attackAdd : ( yes == DECAY ) ? decayAdd : releaseAdd;
+	const Bit32s limit = ( yes == DECAY ) ? sustainLevel : ENV_MAX;
+	Bit32s v = volume;
+	Bit32u index = rateIndex;
+	Bitu i = 0;
+	for ( ; i < samples; i++ ) {
+		const Bit32u nextIndex = index + add;
+		const Bit32s change = nextIndex >> RATE_SH;
+		Bit32s next = v;
+		if ( yes == ATTACK ) {
+			if ( change ) {
+				next += ( (~v) * change ) >> 3;
+				if ( next < ENV_MIN )
+					break;
+			}
+		} else {
+			next += change;
+			if ( GCC_UNLIKELY(next >= limit) )
+				break;
+		}
+		index = nextIndex & RATE_MASK;
+		v = next;
+		vol[ i ] = level + v;
+	}
+	volume = v;
+	rateIndex = index;
+	return i;
+}
+
+//Fills in the volumes of the next samples, the same as calling ForwardVolume() for each
+INLINE void Operator::ForwardVolumes( Bitu samples, Bit32u* vol ) {
+	Bitu i = 0;
+	while ( i < samples ) {
+		switch ( state ) {
+		case OFF:
+			for ( ; i < samples; i++ )
+				vol[ i ] = currentLevel + ENV_MAX;
+			return;
+		case SUSTAIN:
+			if ( reg20 & MASK_SUSTAIN ) {
+				for ( ; i < samples; i++ )
+					vol[ i ] = currentLevel + volume;
+				return;
+			}
+			//Not sustaining, does a regular release
+			i += TemplateVolumes< RELEASE >( samples - i, vol + i );
+			break;
+		case RELEASE:
+			i += TemplateVolumes< RELEASE >( samples - i, vol + i );
+			break;
+		case DECAY:
+			i += TemplateVolumes< DECAY >( samples - i, vol + i );
+			break;
+		case ATTACK:
+			i += TemplateVolumes< ATTACK >( samples - i, vol + i );
+			break;
+		default:
+			break;
+		}
+		//The state changes on this sample
+		if ( i < samples ) {
+			vol[ i ] = ForwardVolume();
+			i++;
+		}
+	}
+}
+
+//Fills in the wave indices of the next samples, the same as calling ForwardWave() for each
+INLINE void Operator::ForwardWaves( Bitu samples, Bit32u* index ) {
+	//Every index only depends on the start, so this loop gets vectorized
+	const Bit32u start = waveIndex;
+	for ( Bitu i = 0; i < samples; i++ )
+		index[ i ] = ( start + ( i + 1 ) * waveCurrent ) >> WAVE_SH;
+	waveIndex = start + samples * waveCurrent;
+}
+
+//GetSample() for a volume and wave index from the above
+INLINE Bits Operator::GetBatchSample( Bitu vol, Bitu index, Bits modulation ) {
+	if ( ENV_SILENT( vol ) )
+		return 0;
+	return GetWave( index + modulation, vol );
+}
+
 Operator::Operator() {
 	chanData = 0;
 	freqMul = 0;
@@ -843,6 +934,83 @@ INLINE void Channel::GeneratePercussion( Chip* chip, Bit32s* output ) {
 	}
 }
 
+template<SynthMode mode>
+INLINE void Channel::BatchTemplate( Bitu samples, const Bit32u (*vol)[ BATCH_SAMPLES ], const Bit32u (*index)[ BATCH_SAMPLES ], Bit32s* output ) {
+	//Local copies, the stores to output could change them otherwise
+	Bit32s old0 = old[0];
+	Bit32s old1 = old[1];
+	for ( Bitu i = 0; i < samples; i++ ) {
+		//Do unsigned shift so we can shift out all bits but still stay in 10 bit range otherwise
+		Bit32s mod = (Bit32u)((old0 + old1)) >> feedback;
+		old0 = old1;
+		old1 = Op(0)->GetBatchSample( vol[ 0 ][ i ], index[ 0 ][ i ], mod );
+		Bit32s sample;
+		Bit32s out0 = old0;
+		if ( mode == sm2AM || mode == sm3AM ) {
+			sample = out0 + Op(1)->GetBatchSample( vol[ 1 ][ i ], index[ 1 ][ i ], 0 );
+		} else if ( mode == sm2FM || mode == sm3FM ) {
+			sample = Op(1)->GetBatchSample( vol[ 1 ][ i ], index[ 1 ][ i ], out0 );
+		} else if ( mode == sm3FMFM ) {
+			Bits next = Op(1)->GetBatchSample( vol[ 1 ][ i ], index[ 1 ][ i ], out0 );
+			next = Op(2)->GetBatchSample( vol[ 2 ][ i ], index[ 2 ][ i ], next );
+			sample = Op(3)->GetBatchSample( vol[ 3 ][ i ], index[ 3 ][ i ], next );
+		} else if ( mode == sm3AMFM ) {
+			sample = out0;
+			Bits next = Op(1)->GetBatchSample( vol[ 1 ][ i ], index[ 1 ][ i ], 0 );
+			next = Op(2)->GetBatchSample( vol[ 2 ][ i ], index[ 2 ][ i ], next );
+			sample += Op(3)->GetBatchSample( vol[ 3 ][ i ], index[ 3 ][ i ], next );
+		} else if ( mode == sm3FMAM ) {
+			sample = Op(1)->GetBatchSample( vol[ 1 ][ i ], index[ 1 ][ i ], out0 );
+			Bits next = Op(2)->GetBatchSample( vol[ 2 ][ i ], index[ 2 ][ i ], 0 );
+			sample += Op(3)->GetBatchSample( vol[ 3 ][ i ], index[ 3 ][ i ], next );
+		} else if ( mode == sm3AMAM ) {
+			sample = out0;
+			Bits next = Op(1)->GetBatchSample( vol[ 1 ][ i ], index[ 1 ][ i ], 0 );
+			sample += Op(2)->GetBatchSample( vol[ 2 ][ i ], index[ 2 ][ i ], next );
+			sample += Op(3)->GetBatchSample( vol[ 3 ][ i ], index[ 3 ][ i ], 0 );
+		}
+		switch( mode ) {
+		case sm2AM:
+		case sm2FM:
+			output[ i ] += sample;
+			break;
+		case sm3AM:
+		case sm3FM:
+		case sm3FMFM:
+		case sm3AMFM:
+		case sm3FMAM:
+		case sm3AMAM:
+			output[ i * 2 + 0 ] += sample & maskLeft;
+			output[ i * 2 + 1 ] += sample & maskRight;
+			break;
+		case sm2Percussion:
+			// This case was not handled in the DOSBox code either
+			// thus we leave this blank.
+			// TODO: Consider checking this.
+			break;
+		case sm3Percussion:
+			// This case was not handled in the DOSBox code either
+			// thus we leave this blank.
+			// TODO: Consider checking this.
+			break;
+		case sm4Start:
+			// This case was not handled in the DOSBox code either
+			// thus we leave this blank.
+			// TODO: Consider checking this.
+			break;
+		case sm6Start:
+			// This case was not handled in the DOSBox code either
+			// thus we leave this blank.
+			// TODO: Consider checking this.
+			break;
+		default:
+			break;
+		}
+	}
+	old[0] = old0;
+	old[1] = old1;
+}
+
 template<SynthMode mode>
 Channel* Channel::BlockTemplate( Chip* chip, Bit32u samples, Bit32s* output ) {
 	switch( mode ) {
@@ -918,81 +1086,28 @@ Channel* Channel::BlockTemplate( Chip* chip, Bit32u samples, Bit32s* output ) {
 		Op( 4 )->Prepare( chip );
 		Op( 5 )->Prepare( chip );
 	}
-	for ( Bitu i = 0; i < samples; i++ ) {
-		//Early out for percussion handlers
-		if ( mode == sm2Percussion ) {
+	if ( mode == sm2Percussion ) {
+		for ( Bitu i = 0; i < samples; i++ )
 			GeneratePercussion<false>( chip, output + i );
-			continue;	//Prevent some unitialized value bitching
-		} else if ( mode == sm3Percussion ) {
+	} else if ( mode == sm3Percussion ) {
+		for ( Bitu i = 0; i < samples; i++ )
 			GeneratePercussion<true>( chip, output + i * 2 );
-			continue;	//Prevent some unitialized value bitching
-		}
-
-		//Do unsigned shift so we can shift out all bits but still stay in 10 bit range otherwise
-		Bit32s mod = (Bit32u)((old[0] + old[1])) >> feedback;
-		old[0] = old[1];
-		old[1] = Op(0)->GetSample( mod );
-		Bit32s sample;
-		Bit32s out0 = old[0];
-		if ( mode == sm2AM || mode == sm3AM ) {
-			sample = out0 + Op(1)->GetSample( 0 );
-		} else if ( mode == sm2FM || mode == sm3FM ) {
-			sample = Op(1)->GetSample( out0 );
-		} else if ( mode == sm3FMFM ) {
-			Bits next = Op(1)->GetSample( out0 );
-			next = Op(2)->GetSample( next );
-			sample = Op(3)->GetSample( next );
-		} else if ( mode == sm3AMFM ) {
-			sample = out0;
-			Bits next = Op(1)->GetSample( 0 );
-			next = Op(2)->GetSample( next );
-			sample += Op(3)->GetSample( next );
-		} else if ( mode == sm3FMAM ) {
-			sample = Op(1)->GetSample( out0 );
-			Bits next = Op(2)->GetSample( 0 );
-			sample += Op(3)->GetSample( next );
-		} else if ( mode == sm3AMAM ) {
-			sample = out0;
-			Bits next = Op(1)->GetSample( 0 );
-			sample += Op(2)->GetSample( next );
-			sample += Op(3)->GetSample( 0 );
-		}
-		switch( mode ) {
-		case sm2AM:
-		case sm2FM:
-			output[ i ] += sample;
-			break;
-		case sm3AM:
-		case sm3FM:
-		case sm3FMFM:
-		case sm3AMFM:
-		case sm3FMAM:
-		case sm3AMAM:
-			output[ i * 2 + 0 ] += sample & maskLeft;
-			output[ i * 2 + 1 ] += sample & maskRight;
-			break;
-		case sm2Percussion:
-			// This case was not handled in the DOSBox code either
-			// thus we leave this blank.
-			// TODO: Consider checking this.
-			break;
-		case sm3Percussion:
-			// This case was not handled in the DOSBox code either
-			// thus we leave this blank.
-			// TODO: Consider checking this.
-			break;
-		case sm4Start:
-			// This case was not handled in the DOSBox code either
-			// thus we leave this blank.
-			// TODO: Consider checking this.
-			break;
-		case sm6Start:
-			// This case was not handled in the DOSBox code either
-			// thus we leave this blank.
-			// TODO: Consider checking this.
-			break;
-		default:
-			break;
+	} else {
+		//The envelopes and wave indices of the operators don't depend on each other,
+		//so they are generated for a batch of samples at once and only the modulation
+		//is done sample by sample
+		const Bitu ops = ( mode > sm4Start ) ? 4 : 2;
+		Bit32u vol[ 4 ][ BATCH_SAMPLES ];
+		Bit32u index[ 4 ][ BATCH_SAMPLES ];
+		for ( Bitu i = 0; i < samples; i += BATCH_SAMPLES ) {
+			Bitu count = samples - i;
+			if ( count > BATCH_SAMPLES )
+				count = BATCH_SAMPLES;
+			for ( Bitu o = 0; o < ops; o++ ) {
+				Op( o )->ForwardVolumes( count, vol[ o ] );
+				Op( o )->ForwardWaves( count, index[ o ] );
+			}
+			BatchTemplate<mode>( count, vol, index, ( mode == sm2AM || mode == sm2FM ) ? output + i : output + i * 2 );
 		}
 	}
 	switch( mode ) {
@@ -1041,6 +1156,11 @@ INLINE Bit32u Chip::ForwardNoise() {
 	noiseCounter += noiseAdd;
 	Bitu count = noiseCounter >> LFO_SH;
 	noiseCounter &= WAVE_MASK;
+	//The steps are linear, so 8 of them can be done at once by stepping
+	//the lowest 8 bits through a table
+	for ( ; count >= 8; count -= 8 ) {
+		noiseValue = ( noiseValue >> 8 ) ^ NoiseStepTable[ noiseValue & 0xff ];
+	}
 	for ( ; count > 0; --count ) {
 		//Noise calculation from mame
 		noiseValue ^= ( 0x800302 ) & ( 0 - (noiseValue & 1 ) );
@@ -1497,6 +1617,15 @@ void InitTables( void ) {
 		Bitu blah = reinterpret_cast<size_t>( &(chip->chan[ index ]) );
 		ChanOffsetTable[i] = blah;
 	}
+	//Noise values after 8 steps of Chip::ForwardNoise
+	for ( Bitu i = 0; i < 256; i++ ) {
+		Bit32u value = i;
+		for ( int step = 0; step < 8; step++ ) {
+			value ^= ( 0x800302 ) & ( 0 - (value & 1 ) );
+			value >>= 1;
+		}
+		NoiseStepTable[i] = value;
+	}
 	//Same for operators
 	for ( Bitu i = 0; i < 64; i++ ) {
 		if ( i % 8 >= 6 || ( (i / 8) % 4 == 3 ) ) {
@@ -58,6 +58,9 @@ typedef uint32 Bit32u;
 #define INLINE inline
 // -------------------------------
 
+//Samples of the operators generated at once
+#define BATCH_SAMPLES 64
+
 struct Chip;
 struct Operator;
 struct Channel;
@@ -178,6 +181,13 @@ public:
 
 	Bits GetSample( Bits modulation );
 	Bits GetWave( Bitu index, Bitu vol );
+
+	//Batched versions of the above, a run of samples at once
+	template< State state>
+	Bitu TemplateVolumes( Bitu samples, Bit32u* vol );
+	void ForwardVolumes( Bitu samples, Bit32u* vol );
+	void ForwardWaves( Bitu samples, Bit32u* index );
+	Bits GetBatchSample( Bitu vol, Bitu index, Bits modulation );
 public:
 	Operator();
 };
@@ -215,6 +225,9 @@ struct Channel {
 	//Generate blocks of data in specific modes
 	template<SynthMode mode>
 	Channel* BlockTemplate( Chip* chip, Bit32u samples, Bit32s* output );
+	//Combine batches of operator samples in the non percussion modes
+	template<SynthMode mode>
+	void BatchTemplate( Bitu samples, const Bit32u (*vol)[ BATCH_SAMPLES ], const Bit32u (*index)[ BATCH_SAMPLES ], Bit32s* output );
 	Channel();
 };
 
@@ -25,6 +25,7 @@
 
 #include "common/system.h"
 #include "common/config-manager.h"
+#include "common/savefile.h"
 #include "common/translation.h"
 #include "backends/events/default/default-events.h"
 #include "backends/keymapper/action.h"
@@ -86,6 +87,10 @@ bool DefaultEventManager::pollEvent(Common::Event &event) {
 		// Handle autosaves if enabled
 		g_engine->handleAutoSave();
 
+	// Report the save files written in the background
+	if (g_system->getSavefileManager())
+		g_system->getSavefileManager()->handleWrittenSaves();
+
 	if (_eventQueue.empty()) {
 		return false;
 	}
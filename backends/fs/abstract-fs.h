@@ -172,6 +172,21 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Returns the time the object referred by this path was last modified,
+	 * in seconds since the Unix epoch.
+	 *
+	 * @return the modification time, or 0 if it is unknown
+	 */
+	virtual int64 getModificationTime() const { return 0; }
+
+	/**
+	 * Returns the size of the file referred by this path, without opening it.
+	 *
+	 * @return the size in bytes, or -1 if it is unknown
+	 */
+	virtual int64 getFileSize() const { return -1; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -182,6 +197,15 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a read stream over the file mapped into memory, for game data
+	 * which is not written while it is read. The default implementation
+	 * does not map files.
+	 *
+	 * @return pointer to the stream object, 0 if the file is not mapped
+	 */
+	virtual Common::SeekableReadStream *createMappedReadStream() { return nullptr; }
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -197,6 +221,15 @@ public:
 	* @return true if the directory is created successfully
 	*/
 	virtual bool createDirectory() = 0;
+
+	/**
+	 * Renames the file referred by this node to the path of the given node,
+	 * replacing the file there in one step.
+	 *
+	 * @return true if the file was renamed, false on failure or if this is
+	 *         not supported
+	 */
+	virtual bool renameTo(const AbstractFSNode &target) { return false; }
 };
 
 
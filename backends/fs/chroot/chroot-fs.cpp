@@ -95,6 +95,10 @@ Common::SeekableReadStream *ChRootFilesystemNode::createReadStream() {
 	return _realNode->createReadStream();
 }
 
+Common::SeekableReadStream *ChRootFilesystemNode::createMappedReadStream() {
+	return _realNode->createMappedReadStream();
+}
+
 Common::SeekableWriteStream *ChRootFilesystemNode::createWriteStream() {
 	return _realNode->createWriteStream();
 }
@@ -103,6 +107,10 @@ bool ChRootFilesystemNode::createDirectory() {
 	return _realNode->createDirectory();
 }
 
+bool ChRootFilesystemNode::renameTo(const AbstractFSNode &target) {
+	return _realNode->renameTo(*((const ChRootFilesystemNode &)target)._realNode);
+}
+
 Common::String ChRootFilesystemNode::addPathComponent(const Common::String &path, const Common::String &component) {
 	const char sep = '/';
 	if (path.lastChar() == sep && component.firstChar() == sep) {
@@ -47,8 +47,10 @@ public:
 	AbstractFSNode *getParent() const override;
 
 	Common::SeekableReadStream *createReadStream() override;
+	Common::SeekableReadStream *createMappedReadStream() override;
 	Common::SeekableWriteStream *createWriteStream() override;
 	bool createDirectory() override;
+	bool renameTo(const AbstractFSNode &target) override;
 
 private:
 	static Common::String addPathComponent(const Common::String &path, const Common::String &component);
@@ -78,6 +78,22 @@ bool POSIXFilesystemNode::isWritable() const {
 	return retVal;
 }
 
+int64 POSIXFilesystemNode::getModificationTime() const {
+	struct stat st;
+
+	if (stat(_path.c_str(), &st) != 0)
+		return 0;
+	return st.st_mtime;
+}
+
+int64 POSIXFilesystemNode::getFileSize() const {
+	struct stat st;
+
+	if (stat(_path.c_str(), &st) != 0 || S_ISDIR(st.st_mode))
+		return -1;
+	return st.st_size;
+}
+
 void POSIXFilesystemNode::setFlags() {
 	struct stat st;
 
@@ -303,6 +319,13 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return PosixIoStream::makeFromPath(getPath(), false);
 }
 
+#ifdef HAS_MMAP
+Common::SeekableReadStream *POSIXFilesystemNode::createMappedReadStream() {
+	// Files which are not mapped are read through createReadStream()
+	return PosixMappedReadStream::makeFromPath(getPath());
+}
+#endif
+
 Common::SeekableWriteStream *POSIXFilesystemNode::createWriteStream() {
 	return PosixIoStream::makeFromPath(getPath(), true);
 }
@@ -325,6 +348,11 @@ bool POSIXFilesystemNode::createDirectory() {
 	return _isValid && _isDirectory;
 }
 
+bool POSIXFilesystemNode::renameTo(const AbstractFSNode &target) {
+	// rename() replaces the target atomically
+	return rename(_path.c_str(), target.getPath().c_str()) == 0;
+}
+
 namespace Posix {
 
 bool assureDirectoryExists(const Common::String &dir, const char *prefix) {
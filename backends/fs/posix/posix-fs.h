@@ -60,14 +60,20 @@ public:
 	bool isDirectory() const override { return _isDirectory; }
 	bool isReadable() const override;
 	bool isWritable() const override;
+	int64 getModificationTime() const override;
+	int64 getFileSize() const override;
 
 	AbstractFSNode *getChild(const Common::String &n) const override;
 	bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const override;
 	AbstractFSNode *getParent() const override;
 
 	Common::SeekableReadStream *createReadStream() override;
+#ifdef HAS_MMAP
+	Common::SeekableReadStream *createMappedReadStream() override;
+#endif
 	Common::SeekableWriteStream *createWriteStream() override;
 	bool createDirectory() override;
+	bool renameTo(const AbstractFSNode &target) override;
 
 protected:
 	/**
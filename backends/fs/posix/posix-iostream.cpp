@@ -25,6 +25,12 @@
 
 #include <sys/stat.h>
 
+#ifdef HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #if defined(ANDROID_PLAIN_PORT)
 #include "backends/platform/android/jni-android.h"
 #include <unistd.h>
@@ -124,3 +130,34 @@ int64 PosixIoStream::size() const {
 
 	return st.st_size;
 }
+
+#ifdef HAS_MMAP
+PosixMappedReadStream *PosixMappedReadStream::makeFromPath(const Common::String &path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+
+	void *mapping = MAP_FAILED;
+	struct stat st;
+	// Truncating the file while it is mapped makes reads raise SIGBUS, see
+	// the class description
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= kMinMappedSize && st.st_size <= kMaxMappedSize)
+		mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping stays valid after the descriptor is closed
+	close(fd);
+
+	if (mapping == MAP_FAILED)
+		return nullptr;
+
+	return new PosixMappedReadStream(mapping, st.st_size);
+}
+
+PosixMappedReadStream::PosixMappedReadStream(void *mapping, uint32 size) :
+	Common::MemoryReadStream((const byte *)mapping, size), _mapping(mapping), _mappingSize(size) {
+}
+
+PosixMappedReadStream::~PosixMappedReadStream() {
+	munmap(_mapping, _mappingSize);
+}
+#endif
@@ -23,6 +23,7 @@
 #define BACKENDS_FS_POSIX_POSIXIOSTREAM_H
 
 #include "backends/fs/stdiostream.h"
+#include "common/memstream.h"
 
 /**
  * A file input / output stream using POSIX interfaces
@@ -44,4 +45,39 @@ public:
 	int64 size() const override;
 };
 
+#ifdef HAS_MMAP
+/**
+ * A read stream over a file mapped into memory. Reads are plain copies from
+ * the mapping, and getMemoryView() gives access to the mapped bytes.
+ *
+ * The file must not be truncated while the stream is open: reading the
+ * mapped pages past the new end of the file raises SIGBUS instead of
+ * failing the read. This is why only game data, which is not written while
+ * it is read, gets mapped, through FSNode::createMappedReadStream().
+ */
+class PosixMappedReadStream final : public Common::MemoryReadStream {
+public:
+	/** Files smaller than this are cheaper to read with stdio. */
+	static const int64 kMinMappedSize = 64 * 1024;
+	/**
+	 * Larger files are read with stdio, to not use up the address space.
+	 * 32-bit hosts only have a few GiB of it.
+	 */
+	static const int64 kMaxMappedSize = (sizeof(void *) > 4) ? 256 * 1024 * 1024 : 32 * 1024 * 1024;
+
+	/**
+	 * Maps the file at path, or returns nullptr if it is too small or too
+	 * large, or the mapping fails.
+	 */
+	static PosixMappedReadStream *makeFromPath(const Common::String &path);
+	~PosixMappedReadStream() override;
+
+private:
+	PosixMappedReadStream(void *mapping, uint32 size);
+
+	void *_mapping;
+	uint32 _mappingSize;
+};
+#endif
+
 #endif
@@ -234,4 +234,12 @@ bool WindowsFilesystemNode::createDirectory() {
 	return _isValid && _isDirectory;
 }
 
+bool WindowsFilesystemNode::renameTo(const AbstractFSNode &target) {
+	// charToTchar() converts into a static buffer
+	TCHAR targetPath[MAX_PATH];
+	_tcsncpy(targetPath, charToTchar(target.getPath().c_str()), MAX_PATH - 1);
+	targetPath[MAX_PATH - 1] = 0;
+	return MoveFileEx(charToTchar(_path.c_str()), targetPath, MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
 #endif //#ifdef WIN32
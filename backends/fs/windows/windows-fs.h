@@ -80,6 +80,7 @@ public:
 	Common::SeekableReadStream *createReadStream() override;
 	Common::SeekableWriteStream *createWriteStream() override;
 	bool createDirectory() override;
+	bool renameTo(const AbstractFSNode &target) override;
 
 private:
 	/**
@@ -30,6 +30,7 @@
 #include "common/translation.h"
 #include "common/util.h"
 #include "common/file.h"
+#include "common/workerpool.h"
 #include "common/frac.h"
 #ifdef USE_RGB_COLOR
 #include "common/list.h"
@@ -136,7 +137,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #endif
 	_transactionMode(kTransactionNone),
 	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr),
-	_needRestoreAfterOverlay(false) {
+	_scalerPool(nullptr), _needRestoreAfterOverlay(false) {
 
 	// allocate palette storage
 	_currentPalette = (SDL_Color *)calloc(sizeof(SDL_Color), 256);
@@ -159,6 +160,15 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_scaler = nullptr;
 	_maxExtraPixels = ScalerMan.getMaxExtraPixels();
 
+	const uint scalerThreads = ConfMan.hasKey("scaler_threads") ? MAX(ConfMan.getInt("scaler_threads"), 0) : 1;
+	if (scalerThreads != 1) {
+		_scalerPool = new Common::WorkerPool(scalerThreads);
+		if (_scalerPool->getThreadCount() <= 1) {
+			delete _scalerPool;
+			_scalerPool = nullptr;
+		}
+	}
+
 	_videoMode.fullscreen = ConfMan.getBool("fullscreen");
 	_videoMode.filtering = ConfMan.getBool("filtering");
 #if SDL_VERSION_ATLEAST(2, 0, 0)
@@ -172,6 +182,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	unloadGFXMode();
 	delete _scaler;
+	delete _scalerPool;
 	if (_mouseOrigSurface) {
 		SDL_FreeSurface(_mouseOrigSurface);
 		if (_mouseOrigSurface == _mouseSurface) {
@@ -1074,6 +1085,58 @@ void SurfaceSdlGraphicsManager::updateScreen() {
 	internUpdateScreen();
 }
 
+namespace {
+
+/** A dirty rect to be scaled in bands of rows. */
+struct ScalerBandTask {
+	Scaler *scaler;
+	const byte *srcPtr;
+	byte *dstPtr;
+	uint32 srcPitch, dstPitch;
+	int width, height, x, y;
+	uint bands;
+};
+
+void scaleBand(void *data, uint index) {
+	const ScalerBandTask &task = *(const ScalerBandTask *)data;
+	const int first = task.height * index / task.bands;
+	const int last = task.height * (index + 1) / task.bands;
+
+	// The scalers read the rows around their band from the source, which
+	// holds the whole rect and the extraPixels() rows beyond it, so the
+	// bands come out exactly like scaling the rect at once
+	task.scaler->scale(task.srcPtr + first * task.srcPitch, task.srcPitch,
+		task.dstPtr + first * task.scaler->getFactor() * task.dstPitch, task.dstPitch,
+		task.width, last - first, task.x, task.y + first);
+}
+
+} // End of anonymous namespace
+
+void SurfaceSdlGraphicsManager::scaleRect(const byte *srcPtr, uint32 srcPitch, byte *dstPtr, uint32 dstPitch, int width, int height, int x, int y) {
+	// Smaller bands aren't worth waking the threads for
+	const int minBandHeight = 16;
+
+	// Scalers comparing with the old source keep state between the calls
+	const uint bands = (_scalerPool && !_useOldSrc && _scaler->getFactor() > 1) ? MIN<uint>(_scalerPool->getThreadCount(), height / minBandHeight) : 1;
+	if (bands <= 1) {
+		_scaler->scale(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+		return;
+	}
+
+	ScalerBandTask task;
+	task.scaler = _scaler;
+	task.srcPtr = srcPtr;
+	task.dstPtr = dstPtr;
+	task.srcPitch = srcPitch;
+	task.dstPitch = dstPitch;
+	task.width = width;
+	task.height = height;
+	task.x = x;
+	task.y = y;
+	task.bands = bands;
+	_scalerPool->parallelFor(bands, scaleBand, &task);
+}
+
 void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	SDL_Surface *srcSurf, *origSurf;
 	int height, width;
@@ -1227,7 +1290,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				if (_videoMode.aspectRatioCorrection && !_overlayInGUI)
 					dst_y = real2Aspect(dst_y);
 
-				_scaler->scale((byte *)srcSurf->pixels + (r->x + _maxExtraPixels) * 2 + (r->y + _maxExtraPixels) * srcPitch, srcPitch,
+				scaleRect((byte *)srcSurf->pixels + (r->x + _maxExtraPixels) * 2 + (r->y + _maxExtraPixels) * srcPitch, srcPitch,
 					(byte *)_hwScreen->pixels + dst_x * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h, r->x, r->y);
 			}
 
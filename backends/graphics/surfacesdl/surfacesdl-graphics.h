@@ -34,6 +34,10 @@
 
 #include "backends/platform/sdl/sdl-sys.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 #ifndef RELEASE_BUILD
 // Define this to allow for focus rectangle debugging
 #define USE_SDL_DEBUG_FOCUSRECT
@@ -327,6 +331,8 @@ protected:
 	Scaler *_scaler;
 	uint _maxExtraPixels;
 	uint _extraPixels;
+	/** Threads scaling the bands of large dirty rects, if there are several */
+	Common::WorkerPool *_scalerPool;
 
 	bool _screenIsLocked;
 	Graphics::Surface _framebuffer;
@@ -425,6 +431,12 @@ private:
 	void setFullscreenMode(bool enable);
 	void handleScalerHotkeys(uint mode, int factor);
 
+	/**
+	 * Scales a dirty rect like Scaler::scale(), split in bands of rows
+	 * scaled in parallel if it is large enough and the scaler allows it.
+	 */
+	void scaleRect(const byte *srcPtr, uint32 srcPitch, byte *dstPtr, uint32 dstPitch, int width, int height, int x, int y);
+
 	/**
 	 * Converts the given point from the overlay's coordinate space to the
 	 * game's coordinate space.
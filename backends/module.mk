@@ -25,6 +25,7 @@ MODULE_OBJS := \
 	midi/timidity.o \
 	saves/savefile.o \
 	saves/default/default-saves.o \
+	saves/default/save-writer.o \
 	timer/default/default-timer.o
 
 ifdef USE_CLOUD
@@ -348,6 +349,10 @@ endif
 ifeq ($(BACKEND),null)
 MODULE_OBJS += \
 	mixer/null/null-mixer.o
+ifdef HAS_PTHREADS
+MODULE_OBJS += \
+	mutex/pthread/pthread-mutex.o
+endif
 endif
 
 ifeq ($(BACKEND),opendingux)
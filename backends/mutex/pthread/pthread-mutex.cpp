@@ -23,7 +23,7 @@
 
 #include "common/scummsys.h"
 
-#if defined(__ANDROID__) || defined(IPHONE)
+#if defined(__ANDROID__) || defined(IPHONE) || defined(HAS_PTHREADS)
 
 #include "backends/mutex/pthread/pthread-mutex.h"
 
@@ -40,6 +40,8 @@ public:
 	bool lock() override;
 	bool unlock() override;
 
+	pthread_mutex_t *getPthreadMutex() { return &_mutex; }
+
 private:
 	pthread_mutex_t _mutex;
 };
@@ -83,4 +85,109 @@ Common::MutexInternal *createPthreadMutexInternal() {
 	return new PthreadMutexInternal();
 }
 
+/**
+ * pthreads condition variable implementation
+ */
+class PthreadConditionVariableInternal final : public Common::ConditionVariableInternal {
+public:
+	PthreadConditionVariableInternal();
+	~PthreadConditionVariableInternal() override;
+
+	bool wait(Common::MutexInternal *mutex) override;
+	bool signal() override;
+	bool broadcast() override;
+
+private:
+	pthread_cond_t _cond;
+};
+
+PthreadConditionVariableInternal::PthreadConditionVariableInternal() {
+	if (pthread_cond_init(&_cond, nullptr) != 0) {
+		warning("pthread_cond_init() failed");
+	}
+}
+
+PthreadConditionVariableInternal::~PthreadConditionVariableInternal() {
+	if (pthread_cond_destroy(&_cond) != 0)
+		warning("pthread_cond_destroy() failed");
+}
+
+bool PthreadConditionVariableInternal::wait(Common::MutexInternal *mutex) {
+	if (pthread_cond_wait(&_cond, static_cast<PthreadMutexInternal *>(mutex)->getPthreadMutex()) != 0) {
+		warning("pthread_cond_wait() failed");
+		return false;
+	} else {
+		return true;
+	}
+}
+
+bool PthreadConditionVariableInternal::signal() {
+	return pthread_cond_signal(&_cond) == 0;
+}
+
+bool PthreadConditionVariableInternal::broadcast() {
+	return pthread_cond_broadcast(&_cond) == 0;
+}
+
+Common::ConditionVariableInternal *createPthreadConditionVariableInternal() {
+	return new PthreadConditionVariableInternal();
+}
+
+/**
+ * pthreads thread implementation
+ */
+class PthreadThreadInternal final : public Common::ThreadInternal {
+public:
+	PthreadThreadInternal(Common::ThreadProc proc, void *data);
+	~PthreadThreadInternal() override;
+
+	bool isValid() const { return _valid; }
+	bool join() override;
+
+private:
+	static void *threadEntry(void *data);
+
+	pthread_t _thread;
+	bool _valid;
+	Common::ThreadProc _proc;
+	void *_data;
+};
+
+PthreadThreadInternal::PthreadThreadInternal(Common::ThreadProc proc, void *data) : _proc(proc), _data(data) {
+	_valid = (pthread_create(&_thread, nullptr, threadEntry, this) == 0);
+}
+
+PthreadThreadInternal::~PthreadThreadInternal() {
+	assert(!_valid);
+}
+
+bool PthreadThreadInternal::join() {
+	if (!_valid)
+		return false;
+
+	_valid = false;
+	if (pthread_join(_thread, nullptr) != 0) {
+		warning("pthread_join() failed");
+		return false;
+	} else {
+		return true;
+	}
+}
+
+void *PthreadThreadInternal::threadEntry(void *data) {
+	PthreadThreadInternal *thread = (PthreadThreadInternal *)data;
+	thread->_proc(thread->_data);
+	return nullptr;
+}
+
+Common::ThreadInternal *createPthreadThreadInternal(Common::ThreadProc proc, void *data) {
+	PthreadThreadInternal *thread = new PthreadThreadInternal(proc, data);
+	if (!thread->isValid()) {
+		warning("pthread_create() failed");
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
 #endif
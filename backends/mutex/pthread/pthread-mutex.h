@@ -23,7 +23,10 @@
 #define BACKENDS_MUTEX_PTHREAD_H
 
 #include "common/mutex.h"
+#include "common/thread.h"
 
 Common::MutexInternal *createPthreadMutexInternal();
+Common::ConditionVariableInternal *createPthreadConditionVariableInternal();
+Common::ThreadInternal *createPthreadThreadInternal(Common::ThreadProc proc, void *data);
 
 #endif
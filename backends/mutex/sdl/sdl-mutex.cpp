@@ -26,6 +26,8 @@
 #include "backends/mutex/sdl/sdl-mutex.h"
 #include "backends/platform/sdl/sdl-sys.h"
 
+#include "common/textconsole.h"
+
 /**
  * SDL mutex manager
  */
@@ -37,6 +39,8 @@ public:
 	bool lock() override { return (SDL_mutexP(_mutex) == 0); }
 	bool unlock() override { return (SDL_mutexV(_mutex) == 0); }
 
+	SDL_mutex *getSdlMutex() const { return _mutex; }
+
 private:
 	SDL_mutex *_mutex;
 };
@@ -45,4 +49,72 @@ Common::MutexInternal *createSdlMutexInternal() {
 	return new SdlMutexInternal();
 }
 
+/**
+ * SDL condition variable
+ */
+class SdlConditionVariableInternal final : public Common::ConditionVariableInternal {
+public:
+	SdlConditionVariableInternal() { _cond = SDL_CreateCond(); }
+	~SdlConditionVariableInternal() override { SDL_DestroyCond(_cond); }
+
+	bool wait(Common::MutexInternal *mutex) override {
+		return (SDL_CondWait(_cond, static_cast<SdlMutexInternal *>(mutex)->getSdlMutex()) == 0);
+	}
+	bool signal() override { return (SDL_CondSignal(_cond) == 0); }
+	bool broadcast() override { return (SDL_CondBroadcast(_cond) == 0); }
+
+private:
+	SDL_cond *_cond;
+};
+
+Common::ConditionVariableInternal *createSdlConditionVariableInternal() {
+	return new SdlConditionVariableInternal();
+}
+
+/**
+ * SDL thread
+ */
+class SdlThreadInternal final : public Common::ThreadInternal {
+public:
+	SdlThreadInternal(Common::ThreadProc proc, void *data) : _proc(proc), _data(data) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		_thread = SDL_CreateThread(threadEntry, "ScummVM worker", this);
+#else
+		_thread = SDL_CreateThread(threadEntry, this);
+#endif
+	}
+	~SdlThreadInternal() override { assert(!_thread); }
+
+	bool isValid() const { return _thread != nullptr; }
+
+	bool join() override {
+		if (!_thread)
+			return false;
+		SDL_WaitThread(_thread, nullptr);
+		_thread = nullptr;
+		return true;
+	}
+
+private:
+	static int SDLCALL threadEntry(void *data) {
+		SdlThreadInternal *thread = (SdlThreadInternal *)data;
+		thread->_proc(thread->_data);
+		return 0;
+	}
+
+	SDL_Thread *_thread;
+	Common::ThreadProc _proc;
+	void *_data;
+};
+
+Common::ThreadInternal *createSdlThreadInternal(Common::ThreadProc proc, void *data) {
+	SdlThreadInternal *thread = new SdlThreadInternal(proc, data);
+	if (!thread->isValid()) {
+		warning("SDL_CreateThread() failed: %s", SDL_GetError());
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
 #endif
@@ -23,7 +23,10 @@
 #define BACKENDS_MUTEX_SDL_H
 
 #include "common/mutex.h"
+#include "common/thread.h"
 
 Common::MutexInternal *createSdlMutexInternal();
+Common::ConditionVariableInternal *createSdlConditionVariableInternal();
+Common::ThreadInternal *createSdlThreadInternal(Common::ThreadProc proc, void *data);
 
 #endif
@@ -49,6 +49,9 @@ typedef void (*sighandler_t)(int);
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
 #include "backends/mutex/null/null-mutex.h"
+#ifdef HAS_PTHREADS
+#include "backends/mutex/pthread/pthread-mutex.h"
+#endif
 #include "base/main.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
@@ -82,9 +85,16 @@ public:
 
 	virtual void initBackend();
 
+	virtual bool hasFeature(Feature f);
+
 	virtual bool pollEvent(Common::Event &event);
 
 	virtual Common::MutexInternal *createMutex();
+#ifdef HAS_PTHREADS
+	virtual Common::ThreadInternal *createThread(void (*proc)(void *data), void *data);
+	virtual Common::ConditionVariableInternal *createConditionVariable();
+	virtual uint getCPUCount();
+#endif
 	virtual uint32 getMillis(bool skipRecord = false);
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
@@ -157,6 +167,20 @@ void OSystem_NULL::initBackend() {
 	BaseBackend::initBackend();
 }
 
+bool OSystem_NULL::hasFeature(Feature f) {
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	if (f == kFeatureCpuSSE2) return __builtin_cpu_supports("sse2");
+	if (f == kFeatureCpuAVX2) return __builtin_cpu_supports("avx2");
+#endif
+#ifdef SCUMMVM_NEON
+	if (f == kFeatureCpuNEON) return true;
+#endif
+	// There may be no graphics manager to ask, when used by the tests
+	if (f == kFeatureCpuSSE2 || f == kFeatureCpuAVX2 || f == kFeatureCpuNEON)
+		return false;
+	return ModularGraphicsBackend::hasFeature(f);
+}
+
 bool OSystem_NULL::pollEvent(Common::Event &event) {
 #ifndef NULL_DRIVER_USE_FOR_TEST
 	((DefaultTimerManager *)getTimerManager())->checkTimers();
@@ -185,8 +209,27 @@ bool OSystem_NULL::pollEvent(Common::Event &event) {
 }
 
 Common::MutexInternal *OSystem_NULL::createMutex() {
+#ifdef HAS_PTHREADS
+	return createPthreadMutexInternal();
+#else
 	return new NullMutexInternal();
+#endif
+}
+
+#ifdef HAS_PTHREADS
+Common::ThreadInternal *OSystem_NULL::createThread(void (*proc)(void *data), void *data) {
+	return createPthreadThreadInternal(proc, data);
+}
+
+Common::ConditionVariableInternal *OSystem_NULL::createConditionVariable() {
+	return createPthreadConditionVariableInternal();
+}
+
+uint OSystem_NULL::getCPUCount() {
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (uint)count : 1;
 }
+#endif
 
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
 #ifdef POSIX
@@ -260,6 +260,29 @@ Common::String OSystem_POSIX::getDefaultIconsPath() {
 	return Common::String::format("%s/%s", prefix, iconsPath.c_str());
 }
 
+Common::String OSystem_POSIX::getDefaultCachePath() {
+	Common::String cachePath;
+
+	// The same XDG cache directory as for the icons above
+	const char *prefix = getenv("XDG_CACHE_HOME");
+	if (prefix == nullptr || !*prefix) {
+		prefix = getenv("HOME");
+		if (prefix == nullptr) {
+			return Common::String();
+		}
+
+		cachePath = ".cache/";
+	}
+
+	cachePath += "scummvm";
+
+	if (!Posix::assureDirectoryExists(cachePath, prefix)) {
+		return Common::String();
+	}
+
+	return Common::String::format("%s/%s", prefix, cachePath.c_str());
+}
+
 Common::String OSystem_POSIX::getScreenshotsPath() {
 	// If the user has configured a screenshots path, use it
 	const Common::String path = OSystem_SDL::getScreenshotsPath();
@@ -38,6 +38,7 @@ public:
 	// Default paths
 	Common::String getDefaultIconsPath() override;
 	Common::String getScreenshotsPath() override;
+	Common::String getDefaultCachePath() override;
 
 protected:
 	Common::String getDefaultConfigFileName() override;
@@ -170,6 +170,9 @@ void OSystem_SDL::init() {
 		_taskbarManager = new Common::TaskbarManager();
 #endif
 
+	// Registered before the config file is loaded, which keeps a snapshot
+	// of its parsed domains in the cache directory
+	ConfMan.registerDefault("cachepath", this->getDefaultCachePath());
 }
 
 bool OSystem_SDL::hasFeature(Feature f) {
@@ -178,6 +181,15 @@ bool OSystem_SDL::hasFeature(Feature f) {
 #endif
 #if SDL_VERSION_ATLEAST(2, 0, 14)
 	if (f == kFeatureOpenUrl) return true;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (f == kFeatureCpuSSE2) return SDL_HasSSE2();
+#endif
+#if defined(SCUMMVM_AVX2) && SDL_VERSION_ATLEAST(2, 0, 4)
+	if (f == kFeatureCpuAVX2) return SDL_HasAVX2();
+#endif
+#if defined(SCUMMVM_NEON) && SDL_VERSION_ATLEAST(2, 0, 6)
+	if (f == kFeatureCpuNEON) return SDL_HasNEON();
 #endif
 	if (f == kFeatureJoystickDeadzone || f == kFeatureKbdMouseSpeed) {
 		return _eventSource->isJoystickConnected();
@@ -694,6 +706,22 @@ Common::MutexInternal *OSystem_SDL::createMutex() {
 	return createSdlMutexInternal();
 }
 
+Common::ThreadInternal *OSystem_SDL::createThread(void (*proc)(void *data), void *data) {
+	return createSdlThreadInternal(proc, data);
+}
+
+Common::ConditionVariableInternal *OSystem_SDL::createConditionVariable() {
+	return createSdlConditionVariableInternal();
+}
+
+uint OSystem_SDL::getCPUCount() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	return MAX(SDL_GetCPUCount(), 1);
+#else
+	return 1;
+#endif
+}
+
 uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	uint32 millis = SDL_GetTicks();
 
@@ -770,6 +798,12 @@ Common::String OSystem_SDL::getDefaultIconsPath() {
 	return path;
 }
 
+//Not specified in base class
+Common::String OSystem_SDL::getDefaultCachePath() {
+	// Caches of data derived from game files are disabled by default
+	return Common::String();
+}
+
 //Not specified in base class
 Common::String OSystem_SDL::getScreenshotsPath() {
 	Common::String path = ConfMan.get("screenshotpath");
@@ -83,6 +83,9 @@ public:
 	void setWindowCaption(const Common::U32String &caption) override;
 	void addSysArchivesToSearchSet(Common::SearchSet &s, int priority = 0) override;
 	Common::MutexInternal *createMutex() override;
+	Common::ThreadInternal *createThread(void (*proc)(void *data), void *data) override;
+	Common::ConditionVariableInternal *createConditionVariable() override;
+	uint getCPUCount() override;
 	uint32 getMillis(bool skipRecord = false) override;
 	void delayMillis(uint msecs) override;
 	void getTimeAndDate(TimeDate &td, bool skipRecord = false) const override;
@@ -93,6 +96,7 @@ public:
 	// Default paths
 	virtual Common::String getDefaultIconsPath();
 	virtual Common::String getScreenshotsPath();
+	virtual Common::String getDefaultCachePath();
 
 #if defined(USE_OPENGL_GAME) || defined(USE_OPENGL_SHADERS)
 	Common::Array<uint> getSupportedAntiAliasingLevels() const override;
@@ -37,6 +37,8 @@
 #include "common/archive.h"
 #include "common/config-manager.h"
 #include "common/compression/zlib.h"
+#include "common/memstream.h"
+#include "common/translation.h"
 
 #include <errno.h>	// for removeSavefile()
 
@@ -44,6 +46,42 @@
 const char *DefaultSaveFileManager::TIMESTAMPS_FILENAME = "timestamps";
 #endif
 
+/**
+ * A save file which is collected in memory, and handed over to the writer
+ * thread when it gets finalized.
+ */
+class DefaultSaveFileManager::AsyncSaveFile : public Common::OutSaveFile {
+public:
+	AsyncSaveFile(DefaultSaveFileManager *manager, PendingSave *save)
+		: Common::OutSaveFile(new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO)), _manager(manager), _save(save) {}
+
+	~AsyncSaveFile() override {
+		finalize();
+	}
+
+	void finalize() override {
+		if (!_save)
+			return;
+
+		// The writer thread frees the data
+		Common::MemoryWriteStreamDynamic *const buffer = (Common::MemoryWriteStreamDynamic *)_wrapped;
+		_save->data = buffer->getData();
+		_save->size = buffer->size();
+		_manager->queueSave(_save);
+		_save = nullptr;
+	}
+
+	uint32 write(const void *dataPtr, uint32 dataSize) override {
+		if (!_save)
+			return 0;
+		return _wrapped->write(dataPtr, dataSize);
+	}
+
+private:
+	DefaultSaveFileManager *_manager;
+	PendingSave *_save;
+};
+
 DefaultSaveFileManager::DefaultSaveFileManager() {
 }
 
@@ -51,6 +89,9 @@ DefaultSaveFileManager::DefaultSaveFileManager(const Common::String &defaultSave
 	ConfMan.registerDefault("savepath", defaultSavepath);
 }
 
+DefaultSaveFileManager::~DefaultSaveFileManager() {
+}
+
 
 void DefaultSaveFileManager::checkPath(const Common::FSNode &dir) {
 	clearError();
@@ -92,6 +133,8 @@ Common::StringArray DefaultSaveFileManager::listSavefiles(const Common::String &
 }
 
 Common::InSaveFile *DefaultSaveFileManager::openRawFile(const Common::String &filename) {
+	waitForPendingSaves();
+
 	// Assure the savefile name cache is up-to-date.
 	assureCached(getSavePath());
 	if (getError().getCode() != Common::kNoError)
@@ -107,7 +150,23 @@ Common::InSaveFile *DefaultSaveFileManager::openRawFile(const Common::String &fi
 	}
 }
 
+int64 DefaultSaveFileManager::getSavefileModificationTime(const Common::String &filename) {
+	waitForPendingSaves();
+
+	// Assure the savefile name cache is up-to-date.
+	assureCached(getSavePath());
+	if (getError().getCode() != Common::kNoError)
+		return 0;
+
+	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
+	if (file == _saveFileCache.end())
+		return 0;
+	return file->_value.getModificationTime();
+}
+
 Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String &filename) {
+	waitForPendingSaves();
+
 	// Assure the savefile name cache is up-to-date.
 	assureCached(getSavePath());
 	if (getError().getCode() != Common::kNoError)
@@ -129,16 +188,16 @@ Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String
 	}
 }
 
-Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String &filename, bool compress) {
+bool DefaultSaveFileManager::getNodeForSaving(const Common::String &filename, Common::FSNode &fileNode) {
 	// Assure the savefile name cache is up-to-date.
 	const Common::String savePathName = getSavePath();
 	assureCached(savePathName);
 	if (getError().getCode() != Common::kNoError)
-		return nullptr;
+		return false;
 
 	for (Common::StringArray::const_iterator i = _lockedFiles.begin(), end = _lockedFiles.end(); i != end; ++i) {
 		if (filename == *i) {
-			return nullptr; //file is locked, no saving available
+			return false; //file is locked, no saving available
 		}
 	}
 
@@ -151,7 +210,6 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 
 	// Obtain node.
 	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
-	Common::FSNode fileNode;
 
 	// If the file did not exist before, we add it to the cache.
 	if (file == _saveFileCache.end()) {
@@ -160,12 +218,40 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 	} else {
 		fileNode = file->_value;
 	}
+	return true;
+}
+
+/**
+ * Returns whether compressed saves are written in the block format of
+ * wrapBlockCompressedWriteStream(). Releases which predate it cannot read it,
+ * so gzip stays the default.
+ */
+static bool useBlockCompressedSaves() {
+	return ConfMan.hasKey("block_compressed_saves") && ConfMan.getBool("block_compressed_saves");
+}
+
+static Common::WriteStream *wrapSaveWriteStream(Common::WriteStream *stream, bool blockCompress) {
+	if (blockCompress)
+		return Common::wrapBlockCompressedWriteStream(stream);
+	return Common::wrapCompressedWriteStream(stream);
+}
+
+Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String &filename, bool compress) {
+	if (ConfMan.hasKey("async_saves") && ConfMan.getBool("async_saves") && SaveFileWriter::isSupported())
+		return openForSavingAsync(filename, compress);
+
+	// Don't let an older save file written in the background replace this one
+	waitForPendingSaves();
+
+	Common::FSNode fileNode;
+	if (!getNodeForSaving(filename, fileNode))
+		return nullptr;
 
 	// Open the file for saving.
 	Common::SeekableWriteStream *const sf = fileNode.createWriteStream();
 	if (!sf)
 		return nullptr;
-	Common::OutSaveFile *const result = new Common::OutSaveFile(compress ? Common::wrapCompressedWriteStream(sf) : sf);
+	Common::OutSaveFile *const result = new Common::OutSaveFile(compress ? wrapSaveWriteStream(sf, useBlockCompressedSaves()) : sf);
 
 	// Add file to cache now that it exists.
 	_saveFileCache[filename] = Common::FSNode(fileNode.getPath());
@@ -173,7 +259,79 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 	return result;
 }
 
+Common::OutSaveFile *DefaultSaveFileManager::openForSavingAsync(const Common::String &filename, bool compress, Common::SaveCompletionProc proc, void *procData) {
+	// Written right away, and proc is called from finalize()
+	if (!SaveFileWriter::isSupported())
+		return Common::SaveFileManager::openForSavingAsync(filename, compress, proc, procData);
+
+	Common::FSNode fileNode;
+	if (!getNodeForSaving(filename, fileNode))
+		return nullptr;
+
+	// Copies of the strings, as they are used on the writer thread
+	PendingSave *const save = new PendingSave();
+	save->name = Common::String(filename.c_str());
+	save->path = Common::String(fileNode.getPath().c_str());
+	save->data = nullptr;
+	save->size = 0;
+	save->compress = compress;
+	save->blockCompress = compress && useBlockCompressedSaves();
+	save->proc = proc;
+	save->procData = procData;
+	save->success = false;
+
+	// Loading the file waits until it has been written, and handleWrittenSaves()
+	// replaces the node then.
+	_saveFileCache[filename] = fileNode;
+
+	return new AsyncSaveFile(this, save);
+}
+
+void DefaultSaveFileManager::waitForPendingSaves() {
+	_writer.waitForPendingSaves();
+	handleWrittenSaves();
+}
+
+void DefaultSaveFileManager::queueSave(PendingSave *save) {
+	if (!_writer.queueSave(save))
+		handleWrittenSaves();
+}
+
+void DefaultSaveFileManager::handleWrittenSaves() {
+	Common::List<PendingSave *> saves;
+	_writer.takeWrittenSaves(saves);
+
+	bool written = false;
+	for (Common::List<PendingSave *>::iterator it = saves.begin(); it != saves.end(); ++it) {
+		PendingSave *save = *it;
+		if (save->success) {
+			// The node was created before the file existed
+			SaveFileCache::iterator file = _saveFileCache.find(save->name);
+			if (file != _saveFileCache.end() && file->_value.getPath() == save->path)
+				file->_value = Common::FSNode(save->path);
+			written = true;
+		} else {
+			// The game has already reported the save as done, so tell the user
+			warning("DefaultSaveFileManager: Failed to write savefile '%s'", save->name.c_str());
+			setError(Common::kWritingFailed, "Failed to write savefile '" + save->name + "'");
+			g_system->displayMessageOnOSD(Common::U32String::format(_("Failed to save game to '%s'"), save->name.c_str()));
+		}
+		if (save->proc)
+			save->proc(save->name, save->success, save->procData);
+		delete save;
+	}
+
+#if defined(USE_CLOUD) && defined(USE_LIBCURL)
+	if (written)
+		CloudMan.syncSaves();
+#else
+	(void)written;
+#endif
+}
+
 bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
+	waitForPendingSaves();
+
 	// Assure the savefile name cache is up-to-date.
 	assureCached(getSavePath());
 	if (getError().getCode() != Common::kNoError)
@@ -251,6 +409,8 @@ Common::String DefaultSaveFileManager::getSavePath() const {
 }
 
 void DefaultSaveFileManager::assureCached(const Common::String &savePathName) {
+	handleWrittenSaves();
+
 	// Check that path exists and is usable.
 	checkPath(Common::FSNode(savePathName));
 
@@ -264,6 +424,9 @@ void DefaultSaveFileManager::assureCached(const Common::String &savePathName) {
 		return;
 	}
 
+	// The directory must not be listed while save files are written to it
+	waitForPendingSaves();
+
 	_saveFileCache.clear();
 	_cachedDirectory.clear();
 
@@ -27,6 +27,9 @@
 #include "common/str.h"
 #include "common/fs.h"
 #include "common/hash-str.h"
+#include "common/list.h"
+
+#include "backends/saves/default/save-writer.h"
 
 /**
  * Provides a default savefile manager implementation for common platforms.
@@ -35,12 +38,17 @@ class DefaultSaveFileManager : public Common::SaveFileManager {
 public:
 	DefaultSaveFileManager();
 	DefaultSaveFileManager(const Common::String &defaultSavepath);
+	~DefaultSaveFileManager() override;
 
 	void updateSavefilesList(Common::StringArray &lockedFiles) override;
 	Common::StringArray listSavefiles(const Common::String &pattern) override;
 	Common::InSaveFile *openRawFile(const Common::String &filename) override;
+	int64 getSavefileModificationTime(const Common::String &filename) override;
 	Common::InSaveFile *openForLoading(const Common::String &filename) override;
 	Common::OutSaveFile *openForSaving(const Common::String &filename, bool compress = true) override;
+	Common::OutSaveFile *openForSavingAsync(const Common::String &filename, bool compress = true, Common::SaveCompletionProc proc = nullptr, void *procData = nullptr) override;
+	void waitForPendingSaves() override;
+	void handleWrittenSaves() override;
 	bool removeSavefile(const Common::String &filename) override;
 	bool exists(const Common::String &filename) override;
 
@@ -104,6 +112,25 @@ private:
 	 * The currently cached directory.
 	 */
 	Common::String _cachedDirectory;
+
+	class AsyncSaveFile;
+
+	/** A save file collected in memory by openForSavingAsync(). */
+	typedef SaveFileWriter::PendingSave PendingSave;
+
+	/**
+	 * Looks up the node for saving the given file, and adds it to the cache.
+	 * Returns false if the file cannot be saved.
+	 */
+	bool getNodeForSaving(const Common::String &filename, Common::FSNode &fileNode);
+
+	/**
+	 * Hands a save file over to the writer thread, or writes and reports
+	 * it right away if there is none.
+	 */
+	void queueSave(PendingSave *save);
+
+	SaveFileWriter _writer;
 };
 
 #endif
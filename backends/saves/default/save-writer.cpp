@@ -0,0 +1,178 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "backends/saves/default/save-writer.h"
+
+#include "common/compression/zlib.h"
+#include "common/fs.h"
+#include "common/system.h"
+#include "common/thread.h"
+
+SaveFileWriter::SaveFileWriter()
+	: _writerThread(nullptr), _writerMutex(nullptr), _writerQueued(nullptr), _writerDone(nullptr), _writerQuit(false) {
+}
+
+bool SaveFileWriter::isSupported() {
+	// The file system nodes which implement renameTo()
+#if defined(POSIX) || defined(WIN32)
+	return true;
+#else
+	return false;
+#endif
+}
+
+SaveFileWriter::~SaveFileWriter() {
+	stopWriterThread();
+
+	for (Common::List<PendingSave *>::iterator it = _writtenSaves.begin(); it != _writtenSaves.end(); ++it)
+		delete *it;
+}
+
+bool SaveFileWriter::queueSave(PendingSave *save) {
+	if (_writerThread || startWriterThread()) {
+		_writerMutex->lock();
+		_pendingSaves.push_back(save);
+		_writerQueued->signal();
+		_writerMutex->unlock();
+		return true;
+	}
+
+	save->success = writeSave(*save);
+	free(save->data);
+	save->data = nullptr;
+	_writtenSaves.push_back(save);
+	return false;
+}
+
+void SaveFileWriter::waitForPendingSaves() {
+	if (!_writerThread)
+		return;
+
+	_writerMutex->lock();
+	while (!_pendingSaves.empty())
+		_writerDone->wait(_writerMutex);
+	_writerMutex->unlock();
+}
+
+void SaveFileWriter::takeWrittenSaves(Common::List<PendingSave *> &saves) {
+	if (_writerMutex)
+		_writerMutex->lock();
+	for (Common::List<PendingSave *>::iterator it = _writtenSaves.begin(); it != _writtenSaves.end(); ++it)
+		saves.push_back(*it);
+	_writtenSaves.clear();
+	if (_writerMutex)
+		_writerMutex->unlock();
+}
+
+bool SaveFileWriter::writeSave(const PendingSave &save) {
+	// Keep the previous save file until the new one is complete
+	const Common::String tempPath = save.path + ".tmp";
+	const Common::FSNode tempNode(tempPath);
+	Common::SeekableWriteStream *const sf = tempNode.createWriteStream();
+	if (!sf)
+		return false;
+
+	Common::WriteStream *out = sf;
+	if (save.compress)
+		out = save.blockCompress ? Common::wrapBlockCompressedWriteStream(sf) : Common::wrapCompressedWriteStream(sf);
+	out->write(save.data, save.size);
+	out->finalize();
+	const bool success = !out->err();
+	delete out;
+
+	if (success && tempNode.renameTo(Common::FSNode(save.path)))
+		return true;
+
+	// Deleted like DefaultSaveFileManager::removeFile() deletes save files
+	remove(tempPath.c_str());
+	return false;
+}
+
+bool SaveFileWriter::startWriterThread() {
+	_writerQueued = g_system->createConditionVariable();
+	_writerDone = g_system->createConditionVariable();
+	if (_writerQueued && _writerDone) {
+		_writerMutex = g_system->createMutex();
+		_writerQuit = false;
+		Common::String::initMemoryPoolMutex();
+		_writerThread = g_system->createThread(writerThreadEntry, this);
+		if (_writerThread)
+			return true;
+	}
+
+	delete _writerQueued;
+	delete _writerDone;
+	delete _writerMutex;
+	_writerQueued = _writerDone = nullptr;
+	_writerMutex = nullptr;
+	return false;
+}
+
+void SaveFileWriter::stopWriterThread() {
+	if (!_writerThread)
+		return;
+
+	// The writer thread finishes the queued save files before it returns
+	_writerMutex->lock();
+	_writerQuit = true;
+	_writerQueued->broadcast();
+	_writerMutex->unlock();
+
+	_writerThread->join();
+	delete _writerThread;
+	_writerThread = nullptr;
+
+	delete _writerQueued;
+	delete _writerDone;
+	delete _writerMutex;
+	_writerQueued = _writerDone = nullptr;
+	_writerMutex = nullptr;
+}
+
+void SaveFileWriter::writerThreadEntry(void *data) {
+	((SaveFileWriter *)data)->writerLoop();
+}
+
+void SaveFileWriter::writerLoop() {
+	_writerMutex->lock();
+	while (true) {
+		if (_pendingSaves.empty()) {
+			if (_writerQuit)
+				break;
+			_writerQueued->wait(_writerMutex);
+			continue;
+		}
+
+		// Stays queued until it is written, for waitForPendingSaves()
+		PendingSave *save = _pendingSaves.front();
+		_writerMutex->unlock();
+
+		save->success = writeSave(*save);
+		free(save->data);
+		save->data = nullptr;
+
+		_writerMutex->lock();
+		_pendingSaves.pop_front();
+		_writtenSaves.push_back(save);
+		_writerDone->broadcast();
+	}
+	_writerMutex->unlock();
+}
@@ -0,0 +1,110 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKEND_SAVES_SAVE_WRITER_H
+#define BACKEND_SAVES_SAVE_WRITER_H
+
+#include "common/scummsys.h"
+#include "common/list.h"
+#include "common/savefile.h"
+#include "common/str.h"
+
+namespace Common {
+class ConditionVariableInternal;
+class MutexInternal;
+class ThreadInternal;
+}
+
+/**
+ * Writes save files on a background thread, for
+ * DefaultSaveFileManager::openForSavingAsync().
+ *
+ * Each save file is written to a temporary file next to it first, which
+ * then replaces the previous save file with FSNode::renameTo(). A failed
+ * write thus keeps the previous save file intact.
+ */
+class SaveFileWriter {
+public:
+	/**
+	 * A save file collected in memory. The strings are not shared with
+	 * the main thread.
+	 */
+	struct PendingSave {
+		Common::String name;
+		Common::String path;
+		byte *data;	///< Allocated with malloc(), freed once written
+		uint32 size;
+		bool compress;
+		bool blockCompress;	///< Looked up on the main thread, as ConfMan is not thread safe
+		Common::SaveCompletionProc proc;
+		void *procData;
+		bool success;
+	};
+
+	SaveFileWriter();
+
+	/**
+	 * Whether the file system of this platform replaces files in one step,
+	 * which writing save files in the background relies on.
+	 */
+	static bool isSupported();
+
+	/** Writes the queued save files before it returns. */
+	~SaveFileWriter();
+
+	/**
+	 * Hands a save file over to the writer thread. If no thread can be
+	 * started, the file is written right away.
+	 *
+	 * @return Whether the file is written on the writer thread.
+	 */
+	bool queueSave(PendingSave *save);
+
+	/** Waits until all the queued save files have been written. */
+	void waitForPendingSaves();
+
+	/**
+	 * Appends the save files written since the last call to @p saves, in
+	 * the order they were queued. The caller takes ownership of them.
+	 */
+	void takeWrittenSaves(Common::List<PendingSave *> &saves);
+
+private:
+	/** Writes a save file to a temporary file, which then replaces the save file. */
+	static bool writeSave(const PendingSave &save);
+
+	bool startWriterThread();
+	void stopWriterThread();
+	static void writerThreadEntry(void *data);
+	void writerLoop();
+
+	/** Queued save files, the first one is written by the writer thread. */
+	Common::List<PendingSave *> _pendingSaves;
+	/** Save files written since the last takeWrittenSaves() call. */
+	Common::List<PendingSave *> _writtenSaves;
+	Common::ThreadInternal *_writerThread;
+	Common::MutexInternal *_writerMutex;
+	Common::ConditionVariableInternal *_writerQueued;
+	Common::ConditionVariableInternal *_writerDone;
+	bool _writerQuit; ///< Guarded by _writerMutex
+};
+
+#endif
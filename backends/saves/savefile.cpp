@@ -79,6 +79,49 @@ int64 OutSaveFile::size() const {
 	}
 }
 
+namespace {
+
+/**
+ * Reports the completion of a save file which is written on the calling
+ * thread, for openForSavingAsync() in save file managers without a
+ * background writer.
+ */
+class CompletingOutSaveFile : public OutSaveFile {
+public:
+	CompletingOutSaveFile(OutSaveFile *file, const String &name, SaveCompletionProc proc, void *procData)
+		: OutSaveFile(file), _name(name), _proc(proc), _procData(procData) {}
+
+	~CompletingOutSaveFile() override {
+		if (_proc)
+			finalize();
+	}
+
+	void finalize() override {
+		// The wrapped save file syncs the cloud storage
+		_wrapped->finalize();
+
+		if (_proc) {
+			const SaveCompletionProc proc = _proc;
+			_proc = nullptr;
+			proc(_name, !_wrapped->err(), _procData);
+		}
+	}
+
+private:
+	String _name;
+	SaveCompletionProc _proc;
+	void *_procData;
+};
+
+} // End of anonymous namespace
+
+OutSaveFile *SaveFileManager::openForSavingAsync(const String &name, bool compress, SaveCompletionProc proc, void *procData) {
+	OutSaveFile *const file = openForSaving(name, compress);
+	if (!file || !proc)
+		return file;
+	return new CompletingOutSaveFile(file, name, proc, procData);
+}
+
 bool SaveFileManager::copySavefile(const String &oldFilename, const String &newFilename, bool compress) {
 	InSaveFile *inFile = nullptr;
 	OutSaveFile *outFile = nullptr;
@@ -25,6 +25,7 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_exit
 
 #include "engines/advancedDetector.h"
+#include "engines/detectionPrefetcher.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
 #include "base/plugins.h"
@@ -1306,14 +1307,17 @@ static DetectedGames getGameList(const Common::FSNode &dir) {
 	return detectionResults.listRecognizedGames();
 }
 
-static DetectedGames recListGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
+static DetectedGames recListGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive, DetectionPrefetcher *prefetcher) {
+	if (prefetcher)
+		prefetcher->claimDirectory(dir);
+
 	DetectedGames list = getGameList(dir);
 
 	if (recursive) {
 		Common::FSList files;
 		dir.getChildren(files, Common::FSNode::kListDirectoriesOnly);
 		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			DetectedGames rec = recListGames(*file, engineId, gameId, recursive);
+			DetectedGames rec = recListGames(*file, engineId, gameId, recursive, prefetcher);
 			for (DetectedGames::const_iterator game = rec.begin(); game != rec.end(); ++game) {
 				if ((game->engineId == engineId && game->gameId == gameId)
 				    || gameId.empty())
@@ -1330,7 +1334,9 @@ static Common::String detectGames(const Common::String &path, const Common::Stri
 	bool noPath = path.empty();
 	//Current directory
 	Common::FSNode dir(path);
-	DetectedGames candidates = recListGames(dir, engineId, gameId, recursive);
+	// Hash the files of the directories further down while detecting the games in one
+	Common::ScopedPtr<DetectionPrefetcher> prefetcher(recursive ? new DetectionPrefetcher(dir) : nullptr);
+	DetectedGames candidates = recListGames(dir, engineId, gameId, recursive, prefetcher.get());
 
 	if (candidates.empty()) {
 		printf("WARNING: ScummVM could not find any game in %s\n", dir.getPath().c_str());
@@ -1355,7 +1361,10 @@ static Common::String detectGames(const Common::String &path, const Common::Stri
 	return buildQualifiedGameName(candidates[0].engineId, candidates[0].gameId);
 }
 
-static int recAddGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
+static int recAddGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive, DetectionPrefetcher *prefetcher) {
+	if (prefetcher)
+		prefetcher->claimDirectory(dir);
+
 	int count = 0;
 	DetectedGames list = getGameList(dir);
 	for (DetectedGames::const_iterator v = list.begin(); v != list.end(); ++v) {
@@ -1387,7 +1396,7 @@ static int recAddGames(const Common::FSNode &dir, const Common::String &engineId
 		Common::FSList files;
 		if (dir.getChildren(files, Common::FSNode::kListDirectoriesOnly)) {
 			for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-				count += recAddGames(*file, engineId, gameId, recursive);
+				count += recAddGames(*file, engineId, gameId, recursive, prefetcher);
 			}
 		}
 	}
@@ -1477,7 +1486,8 @@ static void calcMD5Mac(Common::Path &filePath, int32 length) {
 static bool addGames(const Common::String &path, const Common::String &engineId, const Common::String &gameId, bool recursive) {
 	//Current directory
 	Common::FSNode dir(path);
-	int added = recAddGames(dir, engineId, gameId, recursive);
+	Common::ScopedPtr<DetectionPrefetcher> prefetcher(recursive ? new DetectionPrefetcher(dir) : nullptr);
+	int added = recAddGames(dir, engineId, gameId, recursive, prefetcher.get());
 	printf("Added %d games\n", added);
 	if (added == 0 && !recursive) {
 		printf("Consider using --recursive to search inside subdirectories\n");
@@ -30,6 +30,7 @@
 // FIXME: Avoid using printf
 #define FORBIDDEN_SYMBOL_EXCEPTION_printf
 
+#include "engines/advancedDetector.h"
 #include "engines/engine.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
@@ -52,6 +53,7 @@
 #include "common/translation.h"
 #include "common/text-to-speech.h"
 #include "common/osd_message_queue.h"
+#include "common/workerpool.h"
 
 #include "gui/gui-manager.h"
 #include "gui/error.h"
@@ -474,6 +476,9 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 		if (res.getCode() != Common::kNoError)
 			warning("%s", res.getDesc().c_str());
 
+		// Writes the detection cache
+		MD5CacheManager::destroy();
+
 		PluginManager::instance().unloadDetectionPlugin();
 		PluginManager::instance().unloadAllPlugins();
 		PluginManager::destroy();
@@ -706,6 +711,9 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	Cloud::CloudManager::destroy();
 #endif
 #endif
+	// Writes the detection cache
+	MD5CacheManager::destroy();
+
 	PluginManager::instance().unloadDetectionPlugin();
 	PluginManager::instance().unloadAllPlugins();
 	PluginManager::destroy();
@@ -728,6 +736,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 #endif
 	EngineManager::destroy();
 	Graphics::YUVToRGBManager::destroy();
+	Common::SharedWorkerPool::destroy();
 
 	return 0;
 }
@@ -741,6 +741,9 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 		}
 	}
 
+	// Keep the hashes of the files for the next detection of this directory
+	MD5Man.flush();
+
 	return DetectionResults(candidates);
 }
 
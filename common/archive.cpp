@@ -61,11 +61,62 @@ int Archive::listMatchingMembers(ArchiveMemberList &list, const Path &pattern) c
 	return matches;
 }
 
+int Archive::createReadStreamsForMembers(const Array<Path> &paths, Array<SeekableReadStream *> &streams) const {
+	int count = 0;
+
+	for (uint i = 0; i < paths.size(); ++i) {
+		streams.push_back(createReadStreamForMember(paths[i]));
+		if (streams.back())
+			++count;
+	}
+
+	return count;
+}
+
 SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMember(const Path &path) const {
-	String translated = translatePath(path);
+	return createReadStreamForContents(translatePath(path), nullptr);
+}
+
+int MemcachingCaseInsensitiveArchive::createReadStreamsForMembers(const Array<Path> &paths, Array<SeekableReadStream *> &streams) const {
+	Array<String> translated;
+	Array<String> missing;
+	HashMap<String, SharedArchiveContents, IgnoreCase_Hash, IgnoreCase_EqualTo> contents;
+
+	// Read all the members which aren't cached at once
+	for (uint i = 0; i < paths.size(); ++i) {
+		translated.push_back(translatePath(paths[i]));
+		const String &name = translated.back();
+		if ((!_cache.contains(name) || _cache[name].isExpired()) && !contents.contains(name)) {
+			contents[name] = SharedArchiveContents();
+			missing.push_back(name);
+		}
+	}
+
+	Array<SharedArchiveContents> missingContents;
+	readContentsForPaths(missing, missingContents);
+	for (uint i = 0; i < missing.size(); ++i)
+		contents[missing[i]] = missingContents[i];
+
+	int count = 0;
+	for (uint i = 0; i < translated.size(); ++i) {
+		const String &name = translated[i];
+		streams.push_back(createReadStreamForContents(name, contents.contains(name) ? &contents[name] : nullptr));
+		if (streams.back())
+			++count;
+	}
+
+	return count;
+}
+
+void MemcachingCaseInsensitiveArchive::readContentsForPaths(const Array<String> &translatedPaths, Array<SharedArchiveContents> &contents) const {
+	for (uint i = 0; i < translatedPaths.size(); ++i)
+		contents.push_back(readContentsForPath(translatedPaths[i]));
+}
+
+SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForContents(const String &translated, const SharedArchiveContents *contents) const {
 	bool isNew = false;
 	if (!_cache.contains(translated)) {
-		_cache[translated] = readContentsForPath(translated);
+		_cache[translated] = contents ? *contents : readContentsForPath(translated);
 		isNew = true;
 	}
 
@@ -79,7 +130,7 @@ SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMember(
 	// Check whether the entry is still valid as WeakPtr might have expired.
 	if (!entry->makeStrong()) {
 		// If it's expired, recreate the entry.
-		_cache[translated] = readContentsForPath(translated);
+		_cache[translated] = contents ? *contents : readContentsForPath(translated);
 		entry = &_cache[translated];
 		isNew = true;
 	}
@@ -23,6 +23,7 @@
 #define COMMON_ARCHIVE_H
 
 #include "common/str.h"
+#include "common/array.h"
 #include "common/list.h"
 #include "common/path.h"
 #include "common/ptr.h"
@@ -139,6 +140,17 @@ public:
 	 * @return The newly created input stream.
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const Path &path) const = 0;
+
+	/**
+	 * Create streams for several members at once. Archives which have to
+	 * decompress their members may do that in parallel, so this is faster
+	 * than calling createReadStreamForMember() for every member.
+	 * Must only append to streams, and not remove elements from it. For a
+	 * member which does not exist, 0 is appended.
+	 *
+	 * @return The number of streams created.
+	 */
+	virtual int createReadStreamsForMembers(const Array<Path> &paths, Array<SeekableReadStream *> &streams) const;
 };
 
 class MemcachingCaseInsensitiveArchive;
@@ -177,6 +189,10 @@ private:
 		_strongRef = nullptr;
 	}
 
+	bool isExpired() const {
+		return !_strongRef && _contentSize != 0 && !_missingFile && _weakRef.expired();
+	}
+
 	SharedPtr<byte> _strongRef;
 	WeakPtr<byte> _weakRef;
 	uint32 _contentSize;
@@ -192,6 +208,7 @@ class MemcachingCaseInsensitiveArchive : public Archive {
 public:
 	MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize = 512) : _maxStronglyCachedSize(maxStronglyCachedSize) {}
 	SeekableReadStream *createReadStreamForMember(const Path &path) const;
+	int createReadStreamsForMembers(const Array<Path> &paths, Array<SeekableReadStream *> &streams) const;
 
 	virtual String translatePath(const Path &path) const {
 		// Most of users of this class implement DOS-like archives.
@@ -201,7 +218,16 @@ public:
 
 	virtual SharedArchiveContents readContentsForPath(const String& translatedPath) const = 0;
 
+	/**
+	 * Read the contents of several members, appending them to contents in
+	 * the same order. The default implementation calls readContentsForPath()
+	 * for every member.
+	 */
+	virtual void readContentsForPaths(const Array<String> &translatedPaths, Array<SharedArchiveContents> &contents) const;
+
 private:
+	SeekableReadStream *createReadStreamForContents(const String &translated, const SharedArchiveContents *contents) const;
+
 	mutable HashMap<String, SharedArchiveContents, IgnoreCase_Hash, IgnoreCase_EqualTo> _cache;
 	uint32 _maxStronglyCachedSize;
 };
@@ -40,8 +40,9 @@ void lockMemoryPoolMutex() {
 	// The Mutex class can only be used once g_system is set and initialized,
 	// but we may use the String class earlier than that (it is for example
 	// used in the OSystem_POSIX constructor). However in those early stages
-	// we can hope we don't have multiple threads either.
-	if (!g_system || !g_system->backendInitialized())
+	// we can hope we don't have multiple threads either, unless they were
+	// started after a call to initMemoryPoolMutex().
+	if (!g_refCountPoolMutex && (!g_system || !g_system->backendInitialized()))
 		return;
 	if (!g_refCountPoolMutex)
 		g_refCountPoolMutex = new Mutex();
@@ -53,6 +54,11 @@ void unlockMemoryPoolMutex() {
 		g_refCountPoolMutex->unlock();
 }
 
+TEMPLATE void BASESTRING::initMemoryPoolMutex() {
+	if (!g_refCountPoolMutex)
+		g_refCountPoolMutex = new Mutex();
+}
+
 TEMPLATE void BASESTRING::releaseMemoryPoolMutex() {
 	if (g_refCountPoolMutex){
 		delete g_refCountPoolMutex;
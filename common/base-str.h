@@ -31,6 +31,12 @@ namespace Common {
 template<class T>
 class BaseString {
 public:
+	/**
+	 * Make strings lock the pool of their reference counts even before the
+	 * backend is initialized. This has to be called before starting threads
+	 * that early, and needs a backend which can create mutexes by then.
+	 */
+	static void initMemoryPoolMutex();
 	static void releaseMemoryPoolMutex();
 
 	static const uint32 npos = 0xFFFFFFFF;
@@ -82,11 +82,13 @@ typedef long z_off_t;
 typedef unsigned char Byte;
 typedef Byte Bytef;
 
+#include "common/config-manager.h"
 #include "common/crc.h"
 #include "common/fs.h"
 #include "common/compression/gzio.h"
 #include "common/compression/unzip.h"
 #include "common/memstream.h"
+#include "common/workerpool.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -309,6 +311,13 @@ typedef struct {
 typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_Hash,
 	Common::IgnoreCase_EqualTo> ZipHash;
 
+/* unz_file_data contain the compressed data of a file in the zipfile, which
+	can be decompressed without accessing the zipfile */
+typedef struct {
+	unz_file_info file_info;		/* public info about the file */
+	byte *compressed_data;			/* the data, owned until decompressed */
+} unz_file_data;
+
 /* unz_s contain internal information about the zipfile
 */
 typedef struct {
@@ -420,6 +429,8 @@ static uLong unzlocal_SearchCentralDir(Common::SeekableReadStream &fin) {
 	return uPosFound;
 }
 
+static void unzlocal_BuildHash(unz_s *us);
+
 /*
   Open a Zip file. path contain the full pathname (by example,
 	 on a Windows NT computer "c:\\test\\zlib109.zip" or on an Unix computer
@@ -507,7 +518,15 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		                    (us->offset_central_dir + us->size_central_dir);
 	us->central_pos = central_pos;
 
-	err = unzGoToFirstFile((unzFile)us);
+	unzlocal_BuildHash(us);
+	return (unzFile)us;
+}
+
+/*
+  Fill the hash with the details of all the files in the central dir
+*/
+static void unzlocal_BuildHash(unz_s *us) {
+	int err = unzGoToFirstFile((unzFile)us);
 
 	while (err == UNZ_OK) {
 		// Get the file details
@@ -528,6 +547,127 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		// Move to the next file
 		err = unzGoToNextFile((unzFile)us);
 	}
+}
+
+#define UNZ_INDEX_VERSION 1
+
+/*
+  Write the hash and the details of the central dir to an index, from which
+	unzOpenIndexed() can open the zipfile again without reading its central
+	dir. The archive is identified by its path, size and modification time.
+*/
+static void unzWriteIndex(unzFile file, Common::WriteStream &index, const Common::String &path, int64 mtime) {
+	const unz_s *s = (const unz_s *)file;
+
+	index.writeUint32BE(MKTAG('Z', 'I', 'D', 'X'));
+	index.writeUint32LE(UNZ_INDEX_VERSION);
+	index.writeUint16LE(path.size());
+	index.writeString(path);
+	index.writeUint64LE(s->_stream->size());
+	index.writeSint64LE(mtime);
+
+	index.writeUint32LE(s->gi.number_entry);
+	index.writeUint32LE(s->gi.size_comment);
+	index.writeUint32LE(s->byte_before_the_zipfile);
+	index.writeUint32LE(s->central_pos);
+	index.writeUint32LE(s->size_central_dir);
+	index.writeUint32LE(s->offset_central_dir);
+	index.writeUint32LE(s->current_file_ok);
+
+	index.writeUint32LE(s->_hash.size());
+	for (ZipHash::const_iterator i = s->_hash.begin(); i != s->_hash.end(); ++i) {
+		const cached_file_in_zip &fe = i->_value;
+		index.writeUint16LE(i->_key.size());
+		index.writeString(i->_key);
+		index.writeUint32LE(fe.num_file);
+		index.writeUint32LE(fe.pos_in_central_dir);
+		index.writeUint32LE(fe.current_file_ok);
+		index.writeUint32LE(fe.cur_file_info.version);
+		index.writeUint32LE(fe.cur_file_info.version_needed);
+		index.writeUint32LE(fe.cur_file_info.flag);
+		index.writeUint32LE(fe.cur_file_info.compression_method);
+		index.writeUint32LE(fe.cur_file_info.dosDate);
+		index.writeUint32LE(fe.cur_file_info.crc);
+		index.writeUint32LE(fe.cur_file_info.compressed_size);
+		index.writeUint32LE(fe.cur_file_info.uncompressed_size);
+		index.writeUint32LE(fe.cur_file_info.size_filename);
+		index.writeUint32LE(fe.cur_file_info.size_file_extra);
+		index.writeUint32LE(fe.cur_file_info.size_file_comment);
+		index.writeUint32LE(fe.cur_file_info.disk_num_start);
+		index.writeUint32LE(fe.cur_file_info.internal_fa);
+		index.writeUint32LE(fe.cur_file_info.external_fa);
+		index.writeUint32LE(fe.cur_file_info_internal.offset_curfile);
+	}
+}
+
+/*
+  Open a zipfile using an index written by unzWriteIndex().
+	If the index doesn't belong to the zipfile or can't be read, the return
+	  value is NULL, and the stream is NOT deleted, so that the caller can
+	  still open the zipfile with unzOpen().
+*/
+static unzFile unzOpenIndexed(Common::SeekableReadStream *stream, Common::SeekableReadStream &index, const Common::String &path, int64 mtime) {
+	if (index.readUint32BE() != MKTAG('Z', 'I', 'D', 'X') || index.readUint32LE() != UNZ_INDEX_VERSION)
+		return nullptr;
+	if (index.readString(0, index.readUint16LE()) != path)
+		return nullptr;
+	if (index.readUint64LE() != (uint64)stream->size() || index.readSint64LE() != mtime)
+		return nullptr;
+
+	unz_s *us = new unz_s;
+	us->_stream = stream;
+	us->gi.number_entry = index.readUint32LE();
+	us->gi.size_comment = index.readUint32LE();
+	us->byte_before_the_zipfile = index.readUint32LE();
+	us->central_pos = index.readUint32LE();
+	us->size_central_dir = index.readUint32LE();
+	us->offset_central_dir = index.readUint32LE();
+	us->current_file_ok = index.readUint32LE();
+	us->num_file = 0;
+	us->pos_in_central_dir = us->offset_central_dir;
+
+	for (uint32 files = index.readUint32LE(); files > 0 && !index.eos(); --files) {
+		const Common::String name = index.readString(0, index.readUint16LE());
+
+		cached_file_in_zip fe;
+		fe.num_file = index.readUint32LE();
+		fe.pos_in_central_dir = index.readUint32LE();
+		fe.current_file_ok = index.readUint32LE();
+		fe.cur_file_info.version = index.readUint32LE();
+		fe.cur_file_info.version_needed = index.readUint32LE();
+		fe.cur_file_info.flag = index.readUint32LE();
+		fe.cur_file_info.compression_method = index.readUint32LE();
+		fe.cur_file_info.dosDate = index.readUint32LE();
+		fe.cur_file_info.crc = index.readUint32LE();
+		fe.cur_file_info.compressed_size = index.readUint32LE();
+		fe.cur_file_info.uncompressed_size = index.readUint32LE();
+		fe.cur_file_info.size_filename = index.readUint32LE();
+		fe.cur_file_info.size_file_extra = index.readUint32LE();
+		fe.cur_file_info.size_file_comment = index.readUint32LE();
+		fe.cur_file_info.disk_num_start = index.readUint32LE();
+		fe.cur_file_info.internal_fa = index.readUint32LE();
+		fe.cur_file_info.external_fa = index.readUint32LE();
+		fe.cur_file_info_internal.offset_curfile = index.readUint32LE();
+
+		us->_hash[name] = fe;
+	}
+
+	// A truncated index, e.g. if ScummVM was quit while writing it
+	if (index.eos() || index.err()) {
+		delete us;
+		return nullptr;
+	}
+
+	// Like after unzOpen(), the current file is the last one in the dir
+	for (ZipHash::const_iterator i = us->_hash.begin(); i != us->_hash.end(); ++i) {
+		if (i->_value.num_file + 1 == us->gi.number_entry) {
+			us->num_file = i->_value.num_file;
+			us->pos_in_central_dir = i->_value.pos_in_central_dir;
+			us->cur_file_info = i->_value.cur_file_info;
+			us->cur_file_info_internal = i->_value.cur_file_info_internal;
+		}
+	}
+
 	return (unzFile)us;
 }
 
@@ -899,62 +1039,91 @@ static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s *s, uInt *piSizeVar,
 }
 
 /*
-  Open for reading data the current file in the zipfile.
-  If there is no error and the file is opened, the return value is UNZ_OK.
+  Read the still compressed data of the current file in the zipfile, so that
+	it can be decompressed with unzDecompressFileData() without accessing the
+	zipfile.
+  return UNZ_OK if there is no problem.
 */
-Common::SharedArchiveContents unzOpenCurrentFile (unzFile file, const Common::CRC32 &crc) {
+static int unzReadCurrentFileData(unzFile file, unz_file_data *data) {
 	uInt iSizeVar;
 	unz_s *s;
 	uLong offset_local_extrafield;  /* offset of the local extra field */
 	uInt  size_local_extrafield;    /* size of the local extra field */
 
+	data->compressed_data = nullptr;
 	if (file == nullptr)
-		return Common::SharedArchiveContents();
+		return UNZ_PARAMERROR;
 	s = (unz_s *)file;
 	if (!s->current_file_ok)
-		return Common::SharedArchiveContents();
+		return UNZ_PARAMERROR;
 
 	if (unzlocal_CheckCurrentFileCoherencyHeader(s, &iSizeVar,
 				&offset_local_extrafield, &size_local_extrafield) != UNZ_OK)
-		return Common::SharedArchiveContents();
+		return UNZ_BADZIPFILE;
 
 	if (s->cur_file_info.compression_method != 0 && s->cur_file_info.compression_method != Z_DEFLATED) {
 		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
-		return Common::SharedArchiveContents();
+		return UNZ_BADZIPFILE;
 	}
 
-	uint32 crc32_wait = s->cur_file_info.crc;
-
-	byte *compressedBuffer = new byte[s->cur_file_info.compressed_size];
+	data->file_info = s->cur_file_info;
+	data->compressed_data = new byte[s->cur_file_info.compressed_size];
 	s->_stream->seek(s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar);
-	s->_stream->read(compressedBuffer, s->cur_file_info.compressed_size);
+	s->_stream->read(data->compressed_data, s->cur_file_info.compressed_size);
+	return UNZ_OK;
+}
+
+/*
+  Decompress the data read by unzReadCurrentFileData() and check its CRC.
+  This doesn't access the zipfile, so several files can be decompressed on
+	different threads at the same time.
+*/
+static Common::SharedArchiveContents unzDecompressFileData(unz_file_data *data, const Common::CRC32 &crc) {
+	byte *compressedBuffer = data->compressed_data;
+	data->compressed_data = nullptr;
+	if (compressedBuffer == nullptr)
+		return Common::SharedArchiveContents();
+
+	uint32 crc32_wait = data->file_info.crc;
 	byte *uncompressedBuffer = nullptr;
 
-	switch (s->cur_file_info.compression_method) {
+	switch (data->file_info.compression_method) {
 	case 0: // Store
 		uncompressedBuffer = compressedBuffer;
 		break;
 	case Z_DEFLATED:
-		uncompressedBuffer = new byte[s->cur_file_info.uncompressed_size];
-		assert(s->cur_file_info.uncompressed_size == 0 || uncompressedBuffer != nullptr);
-		Common::GzioReadStream::deflateDecompress(uncompressedBuffer, s->cur_file_info.uncompressed_size, compressedBuffer, s->cur_file_info.compressed_size);
+		uncompressedBuffer = new byte[data->file_info.uncompressed_size];
+		assert(data->file_info.uncompressed_size == 0 || uncompressedBuffer != nullptr);
+		Common::GzioReadStream::deflateDecompress(uncompressedBuffer, data->file_info.uncompressed_size, compressedBuffer, data->file_info.compressed_size);
 		delete[] compressedBuffer;
 		compressedBuffer = nullptr;
 		break;
 	default:
-		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
+		warning("Unknown compression algoritthm %d", (int)data->file_info.compression_method);
 		delete[] compressedBuffer;
 		return Common::SharedArchiveContents();
 	}
 
-	uint32 crc32_data = crc.crcFast(uncompressedBuffer, s->cur_file_info.uncompressed_size);
+	uint32 crc32_data = crc.crcFast(uncompressedBuffer, data->file_info.uncompressed_size);
 	if (crc32_data != crc32_wait) {
 		delete[] uncompressedBuffer;
 		warning("CRC32 mismatch: %08x, %08x", crc32_data, crc32_wait);
 		return Common::SharedArchiveContents();
 	}
 
-	return Common::SharedArchiveContents(uncompressedBuffer, s->cur_file_info.uncompressed_size);
+	return Common::SharedArchiveContents(uncompressedBuffer, data->file_info.uncompressed_size);
+}
+
+/*
+  Open for reading data the current file in the zipfile.
+  If there is no error and the file is opened, the return value is UNZ_OK.
+*/
+Common::SharedArchiveContents unzOpenCurrentFile (unzFile file, const Common::CRC32 &crc) {
+	unz_file_data data;
+	if (unzReadCurrentFileData(file, &data) != UNZ_OK)
+		return Common::SharedArchiveContents();
+
+	return unzDecompressFileData(&data, crc);
 }
 
 
@@ -965,6 +1134,14 @@ class ZipArchive : public MemcachingCaseInsensitiveArchive {
 	unzFile _zipFile;
 	Common::CRC32 _crc;
 
+	struct DecompressionJob {
+		const Common::CRC32 *crc;
+		Array<unz_file_data> data;
+		Array<SharedArchiveContents> contents;
+	};
+
+	static void decompressMember(void *data, uint index);
+
 public:
 	ZipArchive(unzFile zipFile);
 
@@ -975,6 +1152,7 @@ public:
 	int listMembers(ArchiveMemberList &list) const override;
 	const ArchiveMemberPtr getMember(const Path &path) const override;
 	Common::SharedArchiveContents readContentsForPath(const Common::String& translated) const override;
+	void readContentsForPaths(const Array<String> &translatedPaths, Array<SharedArchiveContents> &contents) const override;
 	Common::String translatePath(const Common::Path &path) const override {
 		return path.toString();
 	}
@@ -1039,12 +1217,102 @@ Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Stri
 	return unzOpenCurrentFile(_zipFile, _crc);
 }
 
+void ZipArchive::readContentsForPaths(const Array<String> &translatedPaths, Array<SharedArchiveContents> &contents) const {
+	if (translatedPaths.size() <= 1) {
+		MemcachingCaseInsensitiveArchive::readContentsForPaths(translatedPaths, contents);
+		return;
+	}
+
+	// The zipfile can only be read from one thread, so only the
+	// decompression is spread over the worker threads
+	DecompressionJob job;
+	job.crc = &_crc;
+	job.data.resize(translatedPaths.size());
+	job.contents.resize(translatedPaths.size());
+	for (uint i = 0; i < translatedPaths.size(); ++i) {
+		job.data[i].compressed_data = nullptr;
+		if (unzLocateFile(_zipFile, translatedPaths[i].c_str(), 2) == UNZ_OK)
+			unzReadCurrentFileData(_zipFile, &job.data[i]);
+	}
+
+	SharedWorkerPool::instance().parallelFor(job.data.size(), decompressMember, &job);
+
+	for (uint i = 0; i < job.contents.size(); ++i)
+		contents.push_back(job.contents[i]);
+}
+
+void ZipArchive::decompressMember(void *data, uint index) {
+	DecompressionJob *job = (DecompressionJob *)data;
+	job->contents[index] = unzDecompressFileData(&job->data[index], *job->crc);
+}
+
+enum {
+	/** The number of index files kept in the cache directory. */
+	kZipIndexSlots = 256
+};
+
+/**
+ * Finds the node of the file holding the index of the given archive in the
+ * cache directory. Returns false if there is no cache directory.
+ */
+static bool getZipIndexNode(const FSNode &node, FSNode &indexNode) {
+	if (!ConfMan.hasKey("cachepath") || ConfMan.get("cachepath").empty())
+		return false;
+
+	FSNode cacheDir = FSNode(ConfMan.get("cachepath")).getChild("zipindex");
+	if (!cacheDir.exists() && !cacheDir.createDirectory())
+		return false;
+
+	// The archives share a fixed number of index files, so that the
+	// directory doesn't grow. The path is stored in the index, so that
+	// collisions are detected, and the index of the last archive opened
+	// stays in the file.
+	indexNode = cacheDir.getChild(String::format("%02x.idx", (uint32)hashit(node.getPath().c_str()) % kZipIndexSlots));
+	return true;
+}
+
 Archive *makeZipArchive(const String &name) {
 	return makeZipArchive(SearchMan.createReadStreamForMember(name));
 }
 
 Archive *makeZipArchive(const FSNode &node) {
-	return makeZipArchive(node.createReadStream());
+	SeekableReadStream *stream = node.createReadStream();
+	if (!stream)
+		return nullptr;
+
+	// Archives which are on disk can have their central directory cached,
+	// as long as they don't change
+	const int64 mtime = node.getModificationTime();
+	FSNode indexNode;
+	if (!mtime || !getZipIndexNode(node, indexNode))
+		return makeZipArchive(stream);
+
+	ScopedPtr<SeekableReadStream> index;
+	if (indexNode.exists())
+		index.reset(indexNode.createReadStream());
+
+	MemoryWriteStreamDynamic newIndex(DisposeAfterUse::YES);
+	Archive *archive = makeZipArchive(stream, node.getPath(), mtime, index.get(), &newIndex);
+
+	// The old index may be mapped into memory, so it is closed before it is
+	// replaced
+	index.reset();
+	if (archive && newIndex.size()) {
+		// Written to a temporary file which then replaces the old index, so
+		// that other instances never read a partly written index
+		FSNode tempNode = indexNode.getParent().getChild(indexNode.getName() + ".tmp");
+		ScopedPtr<WriteStream> indexFile(tempNode.createWriteStream());
+		if (indexFile) {
+			indexFile->write(newIndex.getData(), newIndex.size());
+			indexFile->finalize();
+			const bool written = !indexFile->err();
+			indexFile.reset();
+			if (written)
+				tempNode.renameTo(indexNode);
+		}
+	}
+
+	return archive;
 }
 
 Archive *makeZipArchive(SeekableReadStream *stream) {
@@ -1059,4 +1327,23 @@ Archive *makeZipArchive(SeekableReadStream *stream) {
 	return new ZipArchive(zipFile);
 }
 
+Archive *makeZipArchive(SeekableReadStream *stream, const String &path, int64 mtime, SeekableReadStream *index, WriteStream *newIndex) {
+	if (!stream)
+		return nullptr;
+
+	unzFile zipFile = nullptr;
+	if (index)
+		zipFile = unzOpenIndexed(stream, *index, path, mtime);
+
+	if (!zipFile) {
+		zipFile = unzOpen(stream);
+		if (!zipFile)
+			return nullptr;
+		if (newIndex)
+			unzWriteIndex(zipFile, *newIndex, path, mtime);
+	}
+
+	return new ZipArchive(zipFile);
+}
+
 } // End of namespace Common
@@ -38,6 +38,7 @@ namespace Common {
 class Archive;
 class FSNode;
 class SeekableReadStream;
+class WriteStream;
 
 /**
  * This factory method creates an Archive instance corresponding to the content
@@ -65,6 +66,19 @@ Archive *makeZipArchive(const FSNode &node);
  */
 Archive *makeZipArchive(SeekableReadStream *stream);
 
+/**
+ * Like makeZipArchive(SeekableReadStream *), but the central directory of the
+ * archive is taken from an index if possible, which is faster for archives
+ * with many members. The index is identified by the path, size and
+ * modification time of the archive. If index is 0 or does not match, the
+ * central directory is read, and a new index is written to newIndex.
+ *
+ * makeZipArchive(const FSNode &) keeps the indexes in the cache directory.
+ *
+ * May return 0 in case of a failure. In this case stream will still be deleted.
+ */
+Archive *makeZipArchive(SeekableReadStream *stream, const String &path, int64 mtime, SeekableReadStream *index, WriteStream *newIndex);
+
 /** @} */
 
 } // End of namespace Common
@@ -23,11 +23,13 @@
 #define FORBIDDEN_SYMBOL_ALLOW_ALL
 
 #include "common/compression/zlib.h"
+#include "common/array.h"
 #include "common/ptr.h"
 #include "common/util.h"
 #include "common/stream.h"
 #include "common/debug.h"
 #include "common/textconsole.h"
+#include "common/workerpool.h"
 
 #if defined(USE_ZLIB)
   #ifdef __MORPHOS__
@@ -41,6 +43,11 @@
   #if ZLIB_VERNUM < 0x1204
   #error Version 1.2.0.4 or newer of zlib is required for this code
   #endif
+
+  // GZipReadStream needs inflateGetDictionary() for its seek index
+  #if ZLIB_VERNUM >= 0x1280
+  #define GZIP_SEEK_INDEX
+  #endif
 #endif
 
 
@@ -227,7 +234,8 @@ static bool _shownBackwardSeekingWarning = false;
 class GZipReadStream : public SeekableReadStream {
 protected:
 	enum {
-		BUFSIZE = 16384		// 1 << MAX_WBITS
+		BUFSIZE = 16384,		// 1 << MAX_WBITS
+		WINDOWSIZE = 32768
 	};
 
 	byte	_buf[BUFSIZE];
@@ -239,6 +247,87 @@ protected:
 	uint32 _origSize;
 	bool _eos;
 
+#ifdef GZIP_SEEK_INDEX
+	/**
+	 * A point at a deflate block boundary where decompression can be
+	 * resumed, so that seeking doesn't have to start over from the
+	 * beginning of the stream.
+	 */
+	struct Checkpoint {
+		uint32 out;      ///< Position in the uncompressed data
+		int64 in;        ///< Number of compressed bytes consumed by inflate
+		int bits;        ///< Number of bits of the last consumed byte which still have to be decompressed
+		byte *window;    ///< The uncompressed data preceding the checkpoint
+		uInt windowSize;
+	};
+
+	/** Distance between checkpoints in the uncompressed data. */
+	static const uint32 kCheckpointInterval = 512 * 1024;
+
+	/** Checkpoints found while decompressing, ordered by position. */
+	Array<Checkpoint> _checkpoints;
+
+	void addCheckpoint(uint32 out) {
+		// Only at the boundaries of blocks which aren't the last one
+		if (!(_stream.data_type & 128) || (_stream.data_type & 64))
+			return;
+		if (out < (_checkpoints.empty() ? kCheckpointInterval : _checkpoints.back().out + kCheckpointInterval))
+			return;
+
+		Checkpoint checkpoint;
+		checkpoint.out = out;
+		checkpoint.in = _wrapped->pos() - _stream.avail_in;
+		checkpoint.bits = _stream.data_type & 7;
+		checkpoint.window = new byte[WINDOWSIZE];
+		checkpoint.windowSize = WINDOWSIZE;
+		if (inflateGetDictionary(&_stream, checkpoint.window, &checkpoint.windowSize) != Z_OK) {
+			delete[] checkpoint.window;
+			return;
+		}
+		_checkpoints.push_back(checkpoint);
+	}
+
+	/** Returns the last checkpoint at or before pos, or nullptr if there is none. */
+	const Checkpoint *findCheckpoint(uint32 pos) const {
+		const Checkpoint *found = nullptr;
+		for (uint i = 0; i < _checkpoints.size() && _checkpoints[i].out <= pos; ++i)
+			found = &_checkpoints[i];
+		return found;
+	}
+
+	bool restoreCheckpoint(const Checkpoint &checkpoint) {
+		// The stream continues as raw deflate data from here on
+		_zlibErr = inflateReset2(&_stream, -MAX_WBITS);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		_wrapped->seek(checkpoint.in - (checkpoint.bits ? 1 : 0), SEEK_SET);
+		if (checkpoint.bits)
+			_zlibErr = inflatePrime(&_stream, checkpoint.bits, _wrapped->readByte() >> (8 - checkpoint.bits));
+		if (_zlibErr == Z_OK)
+			_zlibErr = inflateSetDictionary(&_stream, checkpoint.window, checkpoint.windowSize);
+
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+		_pos = checkpoint.out;
+		return _zlibErr == Z_OK;
+	}
+#endif
+
+	bool restart() {
+		_pos = 0;
+		_wrapped->seek(0, SEEK_SET);
+#ifdef GZIP_SEEK_INDEX
+		// A checkpoint may have left the stream in raw deflate mode
+		_zlibErr = inflateReset2(&_stream, MAX_WBITS + 32);
+#else
+		_zlibErr = inflateReset(&_stream);
+#endif
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+		return _zlibErr == Z_OK;
+	}
+
 public:
 
 	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0) : _wrapped(w), _stream() {
@@ -279,6 +368,10 @@ public:
 
 	~GZipReadStream() {
 		inflateEnd(&_stream);
+#ifdef GZIP_SEEK_INDEX
+		for (uint i = 0; i < _checkpoints.size(); ++i)
+			delete[] _checkpoints[i].window;
+#endif
 	}
 
 	bool err() const override { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
@@ -298,7 +391,15 @@ public:
 				_stream.next_in = _buf;
 				_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
 			}
+#ifdef GZIP_SEEK_INDEX
+			// Stop at every block boundary, to see whether it makes a good
+			// checkpoint
+			_zlibErr = inflate(&_stream, Z_BLOCK);
+			if (_zlibErr == Z_OK)
+				addCheckpoint(_pos + dataSize - _stream.avail_out);
+#else
 			_zlibErr = inflate(&_stream, Z_NO_FLUSH);
+#endif
 		}
 
 		// Update the position counter
@@ -338,6 +439,16 @@ public:
 
 		assert(newPos >= 0);
 
+#ifdef GZIP_SEEK_INDEX
+		// Resume from the closest checkpoint, if that saves decompressing
+		// data. Checkpoints only exist for data decompressed before.
+		const Checkpoint *checkpoint = findCheckpoint(newPos);
+		if (checkpoint && (checkpoint->out > _pos || (uint32)newPos < _pos)) {
+			if (!restoreCheckpoint(*checkpoint))
+				return false; // FIXME: STREAM REWRITE
+		}
+#endif
+
 		if ((uint32)newPos < _pos) {
 			// To search backward, we have to restart the whole decompression
 			// from the start of the file. A rather wasteful operation, best
@@ -353,13 +464,8 @@ public:
 			}
 #endif
 
-			_pos = 0;
-			_wrapped->seek(0, SEEK_SET);
-			_zlibErr = inflateReset(&_stream);
-			if (_zlibErr != Z_OK)
+			if (!restart())
 				return false; // FIXME: STREAM REWRITE
-			_stream.next_in = _buf;
-			_stream.avail_in = 0;
 		}
 
 		offset = newPos - _pos;
@@ -489,6 +595,362 @@ public:
 
 #endif	// USE_ZLIB
 
+/**
+ * Streams written by wrapBlockCompressedWriteStream() consist of blocks
+ * which are compressed on their own, with an index of the blocks at the
+ * end, so that any of them can be decompressed directly:
+ *
+ * - 'ZBLK', the format version and the uncompressed size of the blocks
+ * - the blocks, as zlib streams or, if they do not compress, as they are
+ * - for every block the number of bytes it takes, with kBlockStored set
+ *   for the blocks which are not compressed
+ * - the uncompressed size, the number of blocks and 'ZIDX'
+ *
+ * All the numbers are 32 bit big endian.
+ */
+enum {
+	kBlockStreamTag = MKTAG('Z','B','L','K'),
+	kBlockIndexTag = MKTAG('Z','I','D','X'),
+	kBlockStreamVersion = 1,
+	kBlockStreamHeaderSize = 12,
+	kBlockStreamTrailerSize = 12,
+	kBlockStored = 0x80000000,
+	kMaxBlockSize = 16 * 1024 * 1024
+};
+
+/**
+ * Reads the index of a block compressed stream. Returns false if the
+ * stream is not one.
+ */
+static bool readBlockIndex(SeekableReadStream &stream, uint32 &blockSize, uint32 &size, Array<uint32> &index) {
+	const int64 fileSize = stream.size();
+	if (fileSize < kBlockStreamHeaderSize + kBlockStreamTrailerSize)
+		return false;
+
+	stream.seek(0, SEEK_SET);
+	if (stream.readUint32BE() != kBlockStreamTag || stream.readUint32BE() != kBlockStreamVersion)
+		return false;
+	blockSize = stream.readUint32BE();
+	if (blockSize == 0 || blockSize > kMaxBlockSize)
+		return false;
+
+	stream.seek(fileSize - kBlockStreamTrailerSize, SEEK_SET);
+	size = stream.readUint32BE();
+	const uint32 count = stream.readUint32BE();
+	if (stream.readUint32BE() != kBlockIndexTag || count != ((uint64)size + blockSize - 1) / blockSize)
+		return false;
+
+	const int64 indexPos = fileSize - kBlockStreamTrailerSize - 4 * (int64)count;
+	if (indexPos < kBlockStreamHeaderSize)
+		return false;
+
+	stream.seek(indexPos, SEEK_SET);
+	index.resize(count);
+	int64 packedSize = 0;
+	for (uint32 i = 0; i < count; ++i) {
+		index[i] = stream.readUint32BE();
+		packedSize += index[i] & ~kBlockStored;
+
+		// Blocks which are not compressed are stored whole
+		const uint32 length = MIN(size - i * blockSize, blockSize);
+		if ((index[i] & kBlockStored) && (index[i] & ~kBlockStored) != length)
+			return false;
+	}
+	return !stream.err() && packedSize == indexPos - kBlockStreamHeaderSize;
+}
+
+#if defined(USE_ZLIB)
+
+enum {
+	kBlockSize = 64 * 1024,
+	// Number of blocks compressed or decompressed at once
+	kMaxParallelBlocks = 8
+};
+
+/**
+ * Provides random access to a block compressed stream. Only the blocks
+ * which are read get decompressed. Sequential reads decompress several
+ * blocks ahead, spread over the threads of a worker pool.
+ */
+class ZlibBlockReadStream : public SeekableReadStream {
+protected:
+	ScopedPtr<SeekableReadStream> _wrapped;
+	uint32 _blockSize;
+	uint32 _size;
+	uint32 _pos;
+	/** Where the blocks start in the wrapped stream, and where the index starts. */
+	Array<uint32> _offsets;
+	Array<bool> _stored;
+
+	/** The decompressed blocks, from block _windowStart on. */
+	byte *_window;
+	uint _windowCapacity;
+	uint32 _windowStart;
+	uint _windowCount;
+	/** Number of blocks to decompress next time the reads continue after the window. */
+	uint _readAhead;
+
+	byte *_packed;
+	uint32 _packedCapacity;
+	bool _blockFailed[kMaxParallelBlocks];
+
+	bool _eos;
+	bool _err;
+
+	uint32 blockLength(uint32 block) const {
+		return MIN(_size - block * _blockSize, _blockSize);
+	}
+
+	static void decompressBlock(void *data, uint index) {
+		ZlibBlockReadStream *stream = (ZlibBlockReadStream *)data;
+		const uint32 block = stream->_windowStart + index;
+		const byte *src = stream->_packed + (stream->_offsets[block] - stream->_offsets[stream->_windowStart]);
+		const uint32 packedSize = stream->_offsets[block + 1] - stream->_offsets[block];
+		byte *dst = stream->_window + index * stream->_blockSize;
+		const uint32 length = stream->blockLength(block);
+
+		if (stream->_stored[block]) {
+			memcpy(dst, src, length);
+			stream->_blockFailed[index] = false;
+			return;
+		}
+
+		uLongf dstLen = length;
+		stream->_blockFailed[index] = (::uncompress(dst, &dstLen, src, packedSize) != Z_OK || dstLen != length);
+	}
+
+	bool loadBlocks(uint32 first) {
+		if (_windowCount && first == _windowStart + _windowCount)
+			_readAhead = MIN<uint>(_readAhead * 2, kMaxParallelBlocks);
+		else
+			_readAhead = 1;
+		const uint count = MIN<uint32>(_readAhead, _offsets.size() - 1 - first);
+
+		if (count > _windowCapacity) {
+			free(_window);
+			_window = (byte *)malloc(count * _blockSize);
+			_windowCapacity = count;
+		}
+		const uint32 packedSize = _offsets[first + count] - _offsets[first];
+		if (packedSize > _packedCapacity) {
+			free(_packed);
+			_packed = (byte *)malloc(packedSize);
+			_packedCapacity = packedSize;
+		}
+
+		_windowCount = 0;
+		if (!_window || !_packed || !_wrapped->seek(_offsets[first], SEEK_SET) ||
+				_wrapped->read(_packed, packedSize) != packedSize) {
+			_err = true;
+			return false;
+		}
+
+		_windowStart = first;
+		if (count > 1) {
+			SharedWorkerPool::instance().parallelFor(count, decompressBlock, this);
+		} else {
+			decompressBlock(this, 0);
+		}
+
+		for (uint i = 0; i < count; ++i) {
+			if (_blockFailed[i]) {
+				_err = true;
+				return false;
+			}
+		}
+		_windowCount = count;
+		return true;
+	}
+
+public:
+	ZlibBlockReadStream(SeekableReadStream *w, uint32 blockSize, uint32 size, const Array<uint32> &index)
+		: _wrapped(w), _blockSize(blockSize), _size(size), _pos(0), _window(nullptr), _windowCapacity(0),
+		  _windowStart(0), _windowCount(0), _readAhead(1), _packed(nullptr), _packedCapacity(0), _eos(false), _err(false) {
+		_offsets.resize(index.size() + 1);
+		_stored.resize(index.size());
+		_offsets[0] = kBlockStreamHeaderSize;
+		for (uint i = 0; i < index.size(); ++i) {
+			_offsets[i + 1] = _offsets[i] + (index[i] & ~kBlockStored);
+			_stored[i] = (index[i] & kBlockStored) != 0;
+		}
+	}
+
+	~ZlibBlockReadStream() {
+		free(_window);
+		free(_packed);
+	}
+
+	bool err() const override { return _err || _wrapped->err(); }
+	void clearErr() override {
+		_err = false;
+		_wrapped->clearErr();
+	}
+
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		byte *dst = (byte *)dataPtr;
+		uint32 done = 0;
+		while (done < dataSize) {
+			if (_pos >= _size) {
+				_eos = true;
+				break;
+			}
+
+			const uint32 block = _pos / _blockSize;
+			if ((block < _windowStart || block >= _windowStart + _windowCount) && !loadBlocks(block))
+				break;
+
+			const uint32 windowEnd = MIN<uint64>((uint64)(_windowStart + _windowCount) * _blockSize, _size);
+			const uint32 length = MIN(dataSize - done, windowEnd - _pos);
+			memcpy(dst + done, _window + (_pos - _windowStart * _blockSize), length);
+			done += length;
+			_pos += length;
+		}
+		return done;
+	}
+
+	bool eos() const override { return _eos; }
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+
+	bool seek(int64 offset, int whence = SEEK_SET) override {
+		int64 newPos = offset;
+		if (whence == SEEK_CUR)
+			newPos += _pos;
+		else if (whence == SEEK_END)
+			newPos += _size;
+
+		if (newPos < 0 || newPos > _size)
+			return false;
+		_pos = newPos;
+		_eos = false;
+		return true;
+	}
+};
+
+/**
+ * Compresses the data in blocks of kBlockSize, in the format read by
+ * ZlibBlockReadStream. The blocks are compressed in batches, spread over
+ * the threads of a worker pool.
+ */
+class ZlibBlockWriteStream : public WriteStream {
+protected:
+	ScopedPtr<WriteStream> _wrapped;
+	/** Data for up to kMaxParallelBlocks blocks. */
+	byte *_input;
+	uint32 _inputSize;
+	/** Room for each of the blocks of the input once compressed. */
+	byte *_output;
+	uLong _outputBound;
+	/** Compressed size of each block, or 0 if it is stored. */
+	uLongf _outputSize[kMaxParallelBlocks];
+	Array<uint32> _index;
+	uint32 _pos;
+	bool _err;
+	bool _finalized;
+
+	static void compressBlock(void *data, uint index) {
+		ZlibBlockWriteStream *stream = (ZlibBlockWriteStream *)data;
+		const byte *src = stream->_input + index * kBlockSize;
+		const uint32 length = MIN<uint32>(stream->_inputSize - index * kBlockSize, kBlockSize);
+
+		uLongf packedSize = stream->_outputBound;
+		if (compress2(stream->_output + index * stream->_outputBound, &packedSize, src, length, Z_DEFAULT_COMPRESSION) != Z_OK || packedSize >= length)
+			packedSize = 0;
+		stream->_outputSize[index] = packedSize;
+	}
+
+	void writeBlocks() {
+		if (!_inputSize || _err)
+			return;
+
+		const uint count = (_inputSize + kBlockSize - 1) / kBlockSize;
+		if (!_output) {
+			_output = (byte *)malloc(kMaxParallelBlocks * _outputBound);
+			if (!_output) {
+				_err = true;
+				return;
+			}
+		}
+		if (count > 1) {
+			SharedWorkerPool::instance().parallelFor(count, compressBlock, this);
+		} else {
+			compressBlock(this, 0);
+		}
+
+		for (uint i = 0; i < count; ++i) {
+			const uint32 length = MIN<uint32>(_inputSize - i * kBlockSize, kBlockSize);
+			if (_outputSize[i]) {
+				_index.push_back(_outputSize[i]);
+				_err |= (_wrapped->write(_output + i * _outputBound, _outputSize[i]) != _outputSize[i]);
+			} else {
+				_index.push_back(length | kBlockStored);
+				_err |= (_wrapped->write(_input + i * kBlockSize, length) != length);
+			}
+		}
+		_inputSize = 0;
+	}
+
+public:
+	ZlibBlockWriteStream(WriteStream *w) : _wrapped(w), _inputSize(0), _output(nullptr),
+			_outputBound(compressBound(kBlockSize)), _pos(0), _err(false), _finalized(false) {
+		assert(w != nullptr);
+		_input = (byte *)malloc(kMaxParallelBlocks * kBlockSize);
+		_err = !_input;
+
+		_wrapped->writeUint32BE(kBlockStreamTag);
+		_wrapped->writeUint32BE(kBlockStreamVersion);
+		_wrapped->writeUint32BE(kBlockSize);
+	}
+
+	~ZlibBlockWriteStream() {
+		finalize();
+		free(_input);
+		free(_output);
+	}
+
+	bool err() const override { return _err || _wrapped->err(); }
+	void clearErr() override { _wrapped->clearErr(); }
+
+	void finalize() override {
+		if (_finalized)
+			return;
+		_finalized = true;
+
+		writeBlocks();
+		for (uint i = 0; i < _index.size(); ++i)
+			_wrapped->writeUint32BE(_index[i]);
+		_wrapped->writeUint32BE(_pos);
+		_wrapped->writeUint32BE(_index.size());
+		_wrapped->writeUint32BE(kBlockIndexTag);
+
+		// Finalize the wrapped savefile, too
+		_wrapped->finalize();
+	}
+
+	uint32 write(const void *dataPtr, uint32 dataSize) override {
+		if (err() || _finalized)
+			return 0;
+
+		const byte *src = (const byte *)dataPtr;
+		uint32 done = 0;
+		while (done < dataSize && !_err) {
+			const uint32 length = MIN<uint32>(dataSize - done, kMaxParallelBlocks * kBlockSize - _inputSize);
+			memcpy(_input + _inputSize, src + done, length);
+			_inputSize += length;
+			done += length;
+			if (_inputSize == kMaxParallelBlocks * kBlockSize)
+				writeBlocks();
+		}
+
+		_pos += done;
+		return done;
+	}
+
+	int64 pos() const override { return _pos; }
+};
+
+#endif	// USE_ZLIB
+
 SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize) {
 	if (toBeWrapped) {
 		if (toBeWrapped->eos() || toBeWrapped->err() || toBeWrapped->size() < 2) {
@@ -500,6 +962,24 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, ui
 				     ((header & 0x0F00) == 0x0800 &&
 				      header % 31 == 0));
 		toBeWrapped->seek(-2, SEEK_CUR);
+
+		if (header == (kBlockStreamTag >> 16)) {
+			// Anything else starting with the tag is left as it is
+			const int64 start = toBeWrapped->pos();
+			uint32 blockSize, size;
+			Array<uint32> index;
+			if (readBlockIndex(*toBeWrapped, blockSize, size, index)) {
+#if defined(USE_ZLIB)
+				return new ZlibBlockReadStream(toBeWrapped, blockSize, size, index);
+#else
+				delete toBeWrapped;
+				return nullptr;
+#endif
+			}
+			toBeWrapped->clearErr();
+			toBeWrapped->seek(start, SEEK_SET);
+		}
+
 		if (isCompressed) {
 #if defined(USE_ZLIB)
 			return new GZipReadStream(toBeWrapped, knownSize);
@@ -520,5 +1000,13 @@ WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped) {
 	return toBeWrapped;
 }
 
+WriteStream *wrapBlockCompressedWriteStream(WriteStream *toBeWrapped) {
+#if defined(USE_ZLIB)
+	if (toBeWrapped)
+		return new ZlibBlockWriteStream(toBeWrapped);
+#endif
+	return toBeWrapped;
+}
+
 
 } // End of namespace Common
@@ -121,8 +121,9 @@ bool inflateZlibHeaderless(Common::WriteStream *dst, Common::SeekableReadStream
 /**
  * Take an arbitrary SeekableReadStream and wrap it in a custom stream which
  * provides transparent on-the-fly decompression. Assumes the data it
- * retrieves from the wrapped stream to be either uncompressed or in gzip
- * format. In the former case, the original stream is returned unmodified
+ * retrieves from the wrapped stream to be either uncompressed, in gzip
+ * format or written by wrapBlockCompressedWriteStream(). In the first case,
+ * the original stream is returned unmodified
  * (and in particular, not wrapped). In the latter case the stream is
  * returned wrapped, unless there is no ZLIB support, then NULL is returned
  * and the old stream is destroyed.
@@ -153,6 +154,19 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, ui
  */
 WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped);
 
+/**
+ * Take an arbitrary WriteStream and wrap it in a custom stream which provides
+ * transparent on-the-fly compression, like wrapCompressedWriteStream() does.
+ * The data is however compressed in independent blocks, with an index of
+ * the blocks at the end. Reading it back through wrapCompressedReadStream()
+ * then only decompresses the blocks which are read, so that seeking is
+ * cheap, and the blocks can be compressed and decompressed in parallel.
+ *
+ * This requires a seekable stream for reading, and is not understood by
+ * tools expecting gzip data.
+ */
+WriteStream *wrapBlockCompressedWriteStream(WriteStream *toBeWrapped);
+
 /** @} */
 
 } // End of namespace Common
@@ -20,9 +20,12 @@
  */
 
 #include "common/config-manager.h"
+#include "common/crc.h"
 #include "common/debug.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 
@@ -50,7 +53,11 @@ char const *const ConfigManager::kCloudDomain = "cloud";
 #pragma mark -
 
 
-ConfigManager::ConfigManager() : _activeDomain(nullptr) {
+/** The version of the snapshots written by writeSnapshot(). */
+#define CONFIG_SNAPSHOT_VERSION 2
+
+ConfigManager::ConfigManager() : _activeDomain(nullptr), _fileExists(false), _lookupActiveDomain(nullptr) {
+	memset(_lookupGenerations, 0, sizeof(_lookupGenerations));
 }
 
 void ConfigManager::defragment() {
@@ -75,18 +82,18 @@ void ConfigManager::copyFrom(ConfigManager &source) {
 	_activeDomainName = source._activeDomainName;
 	_activeDomain = &_gameDomains[_activeDomainName];
 	_filename = source._filename;
+	_fileExists = source._fileExists;
 }
 
 
 void ConfigManager::loadDefaultConfigFile() {
 	// Open the default config file
-	assert(g_system);
-	SeekableReadStream *stream = g_system->createConfigReadStream();
 	_filename.clear(); // clear the filename to indicate that we are using the default config file
+	SeekableReadStream *stream = createConfigReadStream();
 
 	// ... load it, if available ...
 	if (stream) {
-		loadFromStream(*stream);
+		loadFromFile(*stream);
 
 		// ... and close it again.
 		delete stream;
@@ -102,16 +109,58 @@ void ConfigManager::loadDefaultConfigFile() {
 void ConfigManager::loadConfigFile(const String &filename) {
 	_filename = filename;
 
-	FSNode node(filename);
-	File cfg_file;
-	if (!cfg_file.open(node)) {
+	ScopedPtr<SeekableReadStream> stream(createConfigReadStream());
+	if (!stream) {
 		debug("Creating configuration file: %s", filename.c_str());
 	} else {
 		debug("Using configuration file: %s", _filename.c_str());
-		loadFromStream(cfg_file);
+		loadFromFile(*stream);
 	}
 }
 
+SeekableReadStream *ConfigManager::createConfigReadStream() const {
+	// The same file flushToDisk() writes to
+	if (_filename.empty()) {
+		assert(g_system);
+		return g_system->createConfigReadStream();
+	}
+
+	FSNode node(_filename);
+	if (!node.exists() || node.isDirectory())
+		return nullptr;
+	return node.createReadStream();
+}
+
+void ConfigManager::loadFromFile(SeekableReadStream &stream) {
+	_fileExists = true;
+
+	const int64 size = stream.size();
+	if (size < 0 || size > 0x7FFFFFFF) {
+		loadFromStream(stream);
+		return;
+	}
+
+	// The parsed domains are kept in a snapshot, which is used for as long
+	// as the text of the file is the same. Hashing the text is a lot
+	// cheaper than parsing it.
+	byte *text = new byte[size];
+	if (stream.read(text, size) != size) {
+		delete[] text;
+		stream.seek(0);
+		loadFromStream(stream);
+		return;
+	}
+
+	const uint32 crc = CRC32().crcFast(text, size);
+	if (!loadSnapshot(size, crc)) {
+		MemoryReadStream textStream(text, size);
+		loadFromStream(textStream);
+		writeSnapshot(size, crc, false);
+	}
+
+	delete[] text;
+}
+
 /**
  * Add a ready-made domain based on its name and contents
  * The domain name should not already exist in the ConfigManager.
@@ -151,12 +200,7 @@ void ConfigManager::addDomain(const String &domainName, const ConfigManager::Dom
 }
 
 
-void ConfigManager::loadFromStream(SeekableReadStream &stream) {
-	String domainName;
-	String comment;
-	Domain domain;
-	int lineno = 0;
-
+void ConfigManager::clearDomains() {
 	_appDomain.clear();
 	_gameDomains.clear();
 	_miscDomains.clear();
@@ -168,6 +212,15 @@ void ConfigManager::loadFromStream(SeekableReadStream &stream) {
 #ifdef USE_CLOUD
 	_cloudDomain.clear();
 #endif
+}
+
+void ConfigManager::loadFromStream(SeekableReadStream &stream) {
+	String domainName;
+	String comment;
+	Domain domain;
+	int lineno = 0;
+
+	clearDomains();
 
 	// TODO: Detect if a domain occurs multiple times (or likewise, if
 	// a key occurs multiple times inside one domain).
@@ -250,8 +303,80 @@ void ConfigManager::loadFromStream(SeekableReadStream &stream) {
 	addDomain(domainName, domain); // Add the last domain found
 }
 
+void ConfigManager::getSavedDomains(Array<String> &names, Array<const Domain *> &domains) const {
+	// The application domain comes first
+	names.push_back(kApplicationDomain);
+	domains.push_back(&_appDomain);
+
+	// Then the keymapper domain
+	names.push_back(kKeymapperDomain);
+	domains.push_back(&_keymapperDomain);
+#ifdef USE_CLOUD
+	// Then the cloud domain
+	names.push_back(kCloudDomain);
+	domains.push_back(&_cloudDomain);
+#endif
+
+	DomainMap::const_iterator d;
+
+	// The miscellaneous domains next
+	for (d = _miscDomains.begin(); d != _miscDomains.end(); ++d) {
+		names.push_back(d->_key);
+		domains.push_back(&d->_value);
+	}
+
+	// Then the domains in _domainSaveOrder, in that order.
+	// Note: It's possible for _domainSaveOrder to list domains which
+	// are not present anymore, so we validate each name.
+	Array<String>::const_iterator i;
+	for (i = _domainSaveOrder.begin(); i != _domainSaveOrder.end(); ++i) {
+		d = _gameDomains.find(*i);
+		if (d != _gameDomains.end()) {
+			names.push_back(*i);
+			domains.push_back(&d->_value);
+		}
+	}
+
+	// And finally the domains which haven't been listed yet
+	for (d = _gameDomains.begin(); d != _gameDomains.end(); ++d) {
+		if (find(_domainSaveOrder.begin(), _domainSaveOrder.end(), d->_key) == _domainSaveOrder.end()) {
+			names.push_back(d->_key);
+			domains.push_back(&d->_value);
+		}
+	}
+}
+
 void ConfigManager::flushToDisk() {
 #ifndef __DC__
+	// Only the domains which changed since the last call are serialized
+	// again, the text of the others is reused. Since the text of an ini
+	// file can't be patched in place, the file is still written as a
+	// whole, unless it already holds the same text.
+	Array<String> names;
+	Array<const Domain *> domains;
+	getSavedDomains(names, domains);
+
+	String text;
+	DomainTextMap domainTexts;
+	for (uint i = 0; i < names.size(); ++i) {
+		DomainText &domainText = domainTexts[names[i]];
+		DomainTextMap::const_iterator old = _domainTexts.find(names[i]);
+		if (old != _domainTexts.end() && old->_value.generation == domains[i]->getGeneration()) {
+			domainText = old->_value;
+		} else {
+			MemoryWriteStreamDynamic domainStream(DisposeAfterUse::YES);
+			writeDomain(domainStream, names[i], *domains[i]);
+			domainText.generation = domains[i]->getGeneration();
+			domainText.text = String((const char *)domainStream.getData(), domainStream.size());
+		}
+		text += domainText.text;
+	}
+	// This also drops the domains which are gone
+	_domainTexts = domainTexts;
+
+	if (configFileHolds(text))
+		return;
+
 	WriteStream *stream;
 
 	if (_filename.empty()) {
@@ -273,42 +398,33 @@ void ConfigManager::flushToDisk() {
 		stream = dump;
 	}
 
-	// Write the application domain
-	writeDomain(*stream, kApplicationDomain, _appDomain);
-
-	// Write the keymapper domain
-	writeDomain(*stream, kKeymapperDomain, _keymapperDomain);
-#ifdef USE_CLOUD
-	// Write the cloud domain
-	writeDomain(*stream, kCloudDomain, _cloudDomain);
-#endif
-
-	DomainMap::const_iterator d;
+	stream->writeString(text);
+	stream->finalize();
+	const bool written = !stream->err();
+	delete stream;
 
-	// Write the miscellaneous domains next
-	for (d = _miscDomains.begin(); d != _miscDomains.end(); ++d) {
-		writeDomain(*stream, d->_key, d->_value);
+	if (written) {
+		_fileExists = true;
+		writeSnapshot(text.size(), CRC32().crcFast((const byte *)text.c_str(), text.size()), true);
 	}
 
-	// First write the domains in _domainSaveOrder, in that order.
-	// Note: It's possible for _domainSaveOrder to list domains which
-	// are not present anymore, so we validate each name.
-	Array<String>::const_iterator i;
-	for (i = _domainSaveOrder.begin(); i != _domainSaveOrder.end(); ++i) {
-		if (_gameDomains.contains(*i)) {
-			writeDomain(*stream, *i, _gameDomains[*i]);
-		}
-	}
+#endif // !__DC__
+}
 
-	// Now write the domains which haven't been written yet
-	for (d = _gameDomains.begin(); d != _gameDomains.end(); ++d) {
-		if (find(_domainSaveOrder.begin(), _domainSaveOrder.end(), d->_key) == _domainSaveOrder.end())
-			writeDomain(*stream, d->_key, d->_value);
-	}
+bool ConfigManager::configFileHolds(const String &text) const {
+	if (!_fileExists)
+		return false;
 
-	delete stream;
+	// Reading the file back is a lot cheaper than writing it, and unlike
+	// its modification time, tells for sure whether it was edited
+	ScopedPtr<SeekableReadStream> stream(createConfigReadStream());
+	if (!stream || stream->size() != (int64)text.size())
+		return false;
 
-#endif // !__DC__
+	byte *fileText = new byte[text.size()];
+	const bool same = stream->read(fileText, text.size()) == text.size() && !memcmp(fileText, text.c_str(), text.size());
+	delete[] fileText;
+	return same;
 }
 
 void ConfigManager::writeDomain(WriteStream &stream, const String &name, const Domain &domain) {
@@ -353,6 +469,143 @@ void ConfigManager::writeDomain(WriteStream &stream, const String &name, const D
 	stream.writeByte('\n');
 }
 
+static void writeSnapshotString(WriteStream &stream, const String &str) {
+	stream.writeUint32LE(str.size());
+	stream.writeString(str);
+}
+
+static String readSnapshotString(SeekableReadStream &stream) {
+	const uint32 size = stream.readUint32LE();
+	if (!stream.eos() && size > stream.size() - stream.pos()) {
+		// Corrupted, make the caller see the end of the stream
+		stream.seek(0, SEEK_END);
+		stream.readByte();
+	}
+	if (stream.eos())
+		return String();
+	return stream.readString(0, size);
+}
+
+bool ConfigManager::getSnapshotNode(FSNode &node) const {
+	// The snapshot is loaded before the config file could set cachepath,
+	// so it is kept in the default cache directory of the backend
+	const String &cachePath = _defaultsDomain.getValOrDefault("cachepath");
+	if (cachePath.empty())
+		return false;
+
+	// Config files given on the command line get a snapshot of their own
+	String name = "config.cache";
+	if (!_filename.empty())
+		name = String::format("config-%08x.cache", CRC32().crcFast((const byte *)_filename.c_str(), _filename.size()));
+
+	node = FSNode(cachePath).getChild(name);
+	return true;
+}
+
+/*
+	A snapshot holds the domains of a config file in the order they would
+	be written to it, so that loading it gives the same domains as parsing
+	the file. The text of the file is identified by its size and CRC.
+*/
+void ConfigManager::writeSnapshot(uint32 textSize, uint32 textCrc, bool savedOnly) {
+	FSNode node;
+	if (!getSnapshotNode(node))
+		return;
+
+	// Written to a temporary file which then replaces the snapshot, so that
+	// other instances never read a partly written one
+	const FSNode tempNode = node.getParent().getChild(node.getName() + ".tmp");
+	ScopedPtr<WriteStream> snapshot(tempNode.createWriteStream());
+	if (!snapshot)
+		return;
+
+	snapshot->writeUint32BE(MKTAG('S', 'C', 'F', 'G'));
+	snapshot->writeUint32LE(CONFIG_SNAPSHOT_VERSION);
+	snapshot->writeUint32LE(textSize);
+	snapshot->writeUint32LE(textCrc);
+
+	Array<String> names;
+	Array<const Domain *> domains;
+	getSavedDomains(names, domains);
+
+	// A snapshot made after writing the file only holds what writeDomain()
+	// wrote to it
+	Array<uint> saved;
+	for (uint i = 0; i < domains.size(); ++i) {
+		if (!savedOnly || (!domains[i]->empty() && !domains[i]->contains("id_came_from_command_line")))
+			saved.push_back(i);
+	}
+
+	snapshot->writeUint32LE(saved.size());
+	for (uint i = 0; i < saved.size(); ++i) {
+		const Domain &domain = *domains[saved[i]];
+		writeSnapshotString(*snapshot, names[saved[i]]);
+		writeSnapshotString(*snapshot, domain.getDomainComment());
+
+		uint32 entries = 0;
+		Domain::const_iterator x;
+		for (x = domain.begin(); x != domain.end(); ++x) {
+			if (!savedOnly || !x->_value.empty())
+				entries++;
+		}
+
+		snapshot->writeUint32LE(entries);
+		for (x = domain.begin(); x != domain.end(); ++x) {
+			if (!savedOnly || !x->_value.empty()) {
+				writeSnapshotString(*snapshot, x->_key);
+				writeSnapshotString(*snapshot, x->_value);
+				writeSnapshotString(*snapshot, domain.getKVComment(x->_key));
+			}
+		}
+	}
+
+	snapshot->finalize();
+	const bool written = !snapshot->err();
+	snapshot.reset();
+	if (written)
+		tempNode.renameTo(node);
+}
+
+bool ConfigManager::loadSnapshot(uint32 textSize, uint32 textCrc) {
+	FSNode node;
+	if (!getSnapshotNode(node) || !node.exists())
+		return false;
+
+	ScopedPtr<SeekableReadStream> snapshot(node.createReadStream());
+	if (!snapshot)
+		return false;
+
+	if (snapshot->readUint32BE() != MKTAG('S', 'C', 'F', 'G') || snapshot->readUint32LE() != CONFIG_SNAPSHOT_VERSION)
+		return false;
+	if (snapshot->readUint32LE() != textSize || snapshot->readUint32LE() != textCrc)
+		return false;
+
+	Array<String> names;
+	Array<Domain> domains;
+	for (uint32 count = snapshot->readUint32LE(); count > 0 && !snapshot->eos(); --count) {
+		names.push_back(readSnapshotString(*snapshot));
+		domains.push_back(Domain());
+
+		Domain &domain = domains.back();
+		domain.setDomainComment(readSnapshotString(*snapshot));
+		for (uint32 entries = snapshot->readUint32LE(); entries > 0 && !snapshot->eos(); --entries) {
+			const String key = readSnapshotString(*snapshot);
+			domain.setVal(key, readSnapshotString(*snapshot));
+			domain.setKVComment(key, readSnapshotString(*snapshot));
+		}
+	}
+
+	// A truncated snapshot is ignored, and the file parsed instead
+	if (snapshot->eos() || snapshot->err())
+		return false;
+
+	clearDomains();
+	for (uint i = 0; i < names.size(); ++i)
+		addDomain(names[i], domains[i]);
+
+	return true;
+}
+
 
 #pragma mark -
 
@@ -464,17 +717,42 @@ void ConfigManager::removeKey(const String &key, const String &domName) {
 #pragma mark -
 
 
+void ConfigManager::validateLookupCache() const {
+	const uint32 generations[ARRAYSIZE(_lookupGenerations)] = {
+		_transientDomain.getGeneration(),
+		_sessionDomain.getGeneration(),
+		_activeDomain ? _activeDomain->getGeneration() : 0,
+		_appDomain.getGeneration(),
+		_defaultsDomain.getGeneration()
+	};
+	if (_lookupActiveDomain == _activeDomain && !memcmp(generations, _lookupGenerations, sizeof(generations)))
+		return;
+
+	_lookupCache.clear();
+	_lookupActiveDomain = _activeDomain;
+	memcpy(_lookupGenerations, generations, sizeof(generations));
+}
+
 const String &ConfigManager::get(const String &key) const {
+	validateLookupCache();
+	LookupCache::const_iterator cached = _lookupCache.find(key);
+	if (cached != _lookupCache.end())
+		return *cached->_value;
+
+	const String *value;
 	if (_transientDomain.contains(key))
-		return _transientDomain[key];
+		value = &_transientDomain[key];
 	else if (_sessionDomain.contains(key))
-		return _sessionDomain[key]; 
+		value = &_sessionDomain[key];
 	else if (_activeDomain && _activeDomain->contains(key))
-		return (*_activeDomain)[key];
+		value = &(*_activeDomain)[key];
 	else if (_appDomain.contains(key))
-		return _appDomain[key];
+		value = &_appDomain[key];
+	else
+		value = &_defaultsDomain.getValOrDefault(key);
 
-	return _defaultsDomain.getValOrDefault(key);
+	_lookupCache[key] = value;
+	return *value;
 }
 
 const String &ConfigManager::get(const String &key, const String &domName) const {
@@ -738,7 +1016,18 @@ bool ConfigManager::isKeyTemporary(const String &key) const {
 
 #pragma mark -
 
+uint32 ConfigManager::Domain::_lastGeneration = 0;
+
+ConfigManager::Domain &ConfigManager::Domain::operator=(const Domain &other) {
+	_entries = other._entries;
+	_keyValueComments = other._keyValueComments;
+	_domainComment = other._domainComment;
+	touch();
+	return *this;
+}
+
 void ConfigManager::Domain::setDomainComment(const String &comment) {
+	touch();
 	_domainComment = comment;
 }
 const String &ConfigManager::Domain::getDomainComment() const {
@@ -746,6 +1035,7 @@ const String &ConfigManager::Domain::getDomainComment() const {
 }
 
 void ConfigManager::Domain::setKVComment(const String &key, const String &comment) {
+	touch();
 	_keyValueComments[key] = comment;
 }
 const String &ConfigManager::Domain::getKVComment(const String &key) const {
@@ -40,6 +40,7 @@ namespace Common {
  * @{
  */
 
+class FSNode;
 class WriteStream;
 class SeekableReadStream;
 
@@ -60,8 +61,22 @@ public:
 		StringMap _entries;
 		StringMap _keyValueComments;
 		String _domainComment;
+		uint32 _generation;
+
+		static uint32 _lastGeneration;
+		void touch() { _generation = ++_lastGeneration; }
 
 	public:
+		Domain() { touch(); }
+		Domain(const Domain &other) : _entries(other._entries), _keyValueComments(other._keyValueComments), _domainComment(other._domainComment) { touch(); }
+		Domain &operator=(const Domain &other);
+
+		/**
+		 * Return a number which changes whenever the domain is modified.
+		 * No two domains, including copies, share the same generation.
+		 */
+		uint32         getGeneration() const { return _generation; }
+
 		typedef StringMap::const_iterator const_iterator;
 		const_iterator begin() const { return _entries.begin(); } /*!< Return the beginning position of configuration entries. */
 		const_iterator end()   const { return _entries.end(); }   /*!< Return the ending position of configuration entries. */
@@ -78,10 +93,10 @@ public:
 		 */
 		const String &operator[](const String &key) const { return _entries[key]; }
 
-		void           setVal(const String &key, const String &value) { _entries.setVal(key, value); } /*!< Assign a @p value to a @p key. */
+		void           setVal(const String &key, const String &value) { touch(); _entries.setVal(key, value); } /*!< Assign a @p value to a @p key. */
 
-		String &getOrCreateVal(const String &key) { return _entries.getOrCreateVal(key); }
-		String        &getVal(const String &key) { return _entries.getVal(key); } /*!< Retrieve the value of a @p key. */
+		String &getOrCreateVal(const String &key) { touch(); return _entries.getOrCreateVal(key); }
+		String        &getVal(const String &key) { touch(); return _entries.getVal(key); } /*!< Retrieve the value of a @p key. */
 		const String  &getVal(const String &key) const { return _entries.getVal(key); } /*!< @overload */
 		 /**
 		  * Retrieve the value of @p key if it exists and leave the referenced variable unchanged if the key does not exist.
@@ -91,9 +106,9 @@ public:
 		const String &getValOrDefault(const String &key) const { return _entries.getValOrDefault(key); }
 		bool tryGetVal(const String &key, String &out) const { return _entries.tryGetVal(key, out); }
 
-		void           clear() { _entries.clear(); } /*!< Clear all configuration entries in the domain. */
+		void           clear() { touch(); _entries.clear(); } /*!< Clear all configuration entries in the domain. */
 
-		void           erase(const String &key) { _entries.erase(key); } /*!< Remove a key from the domain. */
+		void           erase(const String &key) { touch(); _entries.erase(key); } /*!< Remove a key from the domain. */
 
 		void           setDomainComment(const String &comment); /*!< Add a @p comment for this configuration domain. */
 		const String  &getDomainComment() const; /*!< Retrieve the comment of this configuration domain. */
@@ -222,10 +237,19 @@ private:
 	friend class Singleton<SingletonBaseType>;
 	ConfigManager();
 
+	SeekableReadStream	*createConfigReadStream() const;
+	void			loadFromFile(SeekableReadStream &stream);
 	void			loadFromStream(SeekableReadStream &stream);
+	void			clearDomains();
 	void			addDomain(const String &domainName, const Domain &domain);
+	void			getSavedDomains(Array<String> &names, Array<const Domain *> &domains) const;
 	void			writeDomain(WriteStream &stream, const String &name, const Domain &domain);
+	bool			configFileHolds(const String &text) const;
+	bool			getSnapshotNode(FSNode &node) const;
+	void			writeSnapshot(uint32 textSize, uint32 textCrc, bool savedOnly);
+	bool			loadSnapshot(uint32 textSize, uint32 textCrc);
 	void			renameDomain(const String &oldName, const String &newName, DomainMap &map);
+	void			validateLookupCache() const;
 
 	Domain			_transientDomain;
 	DomainMap		_gameDomains;
@@ -247,6 +271,24 @@ private:
 	Domain *		_activeDomain;
 
 	String			_filename;
+	bool			_fileExists; // Whether the config file has been read or written
+
+	// The text writeDomain() last gave for the saved domains, so that
+	// flushToDisk() only serializes the domains which changed since
+	struct DomainText {
+		uint32 generation;
+		String text;
+	};
+	typedef HashMap<String, DomainText, IgnoreCase_Hash, IgnoreCase_EqualTo> DomainTextMap;
+	DomainTextMap	_domainTexts;
+
+	// The values get() found, which stay valid for as long as none of the
+	// domains it searches changes. This takes one hash lookup instead of
+	// one or two for each domain.
+	typedef HashMap<String, const String *, IgnoreCase_Hash, IgnoreCase_EqualTo> LookupCache;
+	mutable LookupCache		_lookupCache;
+	mutable const Domain	*_lookupActiveDomain;
+	mutable uint32			_lookupGenerations[5];
 };
 
 /** @} */
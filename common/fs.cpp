@@ -131,6 +131,14 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+int64 FSNode::getModificationTime() const {
+	return _realNode ? _realNode->getModificationTime() : 0;
+}
+
+int64 FSNode::getFileSize() const {
+	return _realNode ? _realNode->getFileSize() : -1;
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -146,6 +154,14 @@ SeekableReadStream *FSNode::createReadStream() const {
 	return _realNode->createReadStream();
 }
 
+SeekableReadStream *FSNode::createMappedReadStream() const {
+	// createReadStream() warns about missing files when called next
+	if (_realNode == nullptr || !_realNode->exists() || _realNode->isDirectory())
+		return nullptr;
+
+	return _realNode->createMappedReadStream();
+}
+
 SeekableWriteStream *FSNode::createWriteStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -158,6 +174,13 @@ SeekableWriteStream *FSNode::createWriteStream() const {
 	return _realNode->createWriteStream();
 }
 
+bool FSNode::renameTo(const FSNode &target) const {
+	if (!_realNode || !target._realNode)
+		return false;
+
+	return _realNode->renameTo(*target._realNode);
+}
+
 bool FSNode::createDirectory() const {
 	if (_realNode == nullptr)
 		return false;
@@ -255,7 +278,10 @@ SeekableReadStream *FSDirectory::createReadStreamForMember(const Path &path) con
 	FSNode *node = lookupCache(_fileCache, path);
 	if (!node)
 		return nullptr;
-	SeekableReadStream *stream = node->createReadStream();
+	// Game data is not written while it is read, so it can be mapped
+	SeekableReadStream *stream = node->createMappedReadStream();
+	if (!stream)
+		stream = node->createReadStream();
 	if (!stream)
 		warning("FSDirectory::createReadStreamForMember: Can't create stream for file '%s'", Common::toPrintable(path.toString()).c_str());
 
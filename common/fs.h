@@ -226,6 +226,25 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Return the time the object referred by this node was last modified,
+	 * in seconds since the Unix epoch.
+	 *
+	 * This is meant for validating caches of data derived from files, so
+	 * not all backends support it.
+	 *
+	 * @return The modification time, or 0 if it is unknown.
+	 */
+	int64 getModificationTime() const;
+
+	/**
+	 * Return the size of the file referred by this node, without opening
+	 * it. Like getModificationTime(), this is not supported by all backends.
+	 *
+	 * @return The size in bytes, or -1 if it is unknown.
+	 */
+	int64 getFileSize() const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -235,6 +254,16 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Create a SeekableReadStream over the file referred by this node
+	 * mapped into memory, if the backend can map it. Only use this for
+	 * files which are not written while the stream is open, like game
+	 * data, and use createReadStream() if 0 is returned.
+	 *
+	 * @return Pointer to the stream object, 0 if the file is not mapped.
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Create a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -252,6 +281,17 @@ public:
 	 * @return True if the directory was created, false otherwise.
 	 */
 	bool createDirectory() const;
+
+	/**
+	 * Rename the file referred by this node to the path of the given node.
+	 * A file already there is replaced in one step, so readers see either
+	 * the old or the new file, which makes this the way to update files
+	 * safely: write a temporary file, then rename it. Like
+	 * getModificationTime(), this is not supported by all backends.
+	 *
+	 * @return True if the file was renamed, false otherwise.
+	 */
+	bool renameTo(const FSNode &target) const;
 };
 
 /**
@@ -0,0 +1,136 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/md5_intern.h"
+
+#include <immintrin.h>
+
+namespace Common {
+
+namespace {
+
+/** Turns four rows of four words into four columns. */
+inline void transpose(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+	const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+	const __m128i t1 = _mm_unpackhi_epi32(r0, r1);
+	const __m128i t2 = _mm_unpacklo_epi32(r2, r3);
+	const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+	r0 = _mm_unpacklo_epi64(t0, t2);
+	r1 = _mm_unpackhi_epi64(t0, t2);
+	r2 = _mm_unpacklo_epi64(t1, t3);
+	r3 = _mm_unpackhi_epi64(t1, t3);
+}
+
+/** Loads eight words of each lane at @p offset, and turns them into eight vectors of one word of every lane. */
+inline void loadLanes(const uint8 *const *data, uint offset, __m256i *X) {
+	__m256i r[8];
+	for (int i = 0; i < 8; ++i)
+		r[i] = _mm256_loadu_si256((const __m256i *)(data[i] + offset));
+
+	// Within each half, like transpose()
+	const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+	const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+	const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+	const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+	const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+	const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+	const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+	const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+	const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+	const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+	const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+	const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+	const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+	const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+	const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+	const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+	// Then the low halves hold the first four words and the high halves the others
+	X[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+	X[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+	X[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+	X[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+	X[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+	X[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+	X[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+	X[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+inline __m256i combine(__m128i low, __m128i high) {
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+}
+
+} // End of anonymous namespace
+
+#define MD5_F(x, y, z) _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z)))
+#define MD5_G(x, y, z) _mm256_xor_si256(y, _mm256_and_si256(z, _mm256_xor_si256(x, y)))
+#define MD5_H(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define MD5_I(x, y, z) _mm256_xor_si256(y, _mm256_or_si256(x, _mm256_xor_si256(z, ones)))
+
+#define MD5_STEP(f, a, b, c, d, k, s, t) { \
+	a = _mm256_add_epi32(a, _mm256_add_epi32(f(b, c, d), _mm256_add_epi32(X[k], _mm256_set1_epi32((int)(t))))); \
+	a = _mm256_add_epi32(_mm256_or_si256(_mm256_slli_epi32(a, s), _mm256_srli_epi32(a, 32 - s)), b); \
+}
+
+void md5ProcessLanes_AVX2(uint32 *const *state, const uint8 *const *data, uint blocks) {
+	const __m256i ones = _mm256_set1_epi32(-1);
+
+	__m128i s[8];
+	for (int i = 0; i < 8; ++i)
+		s[i] = _mm_loadu_si128((const __m128i *)state[i]);
+	transpose(s[0], s[1], s[2], s[3]);
+	transpose(s[4], s[5], s[6], s[7]);
+
+	__m256i A = combine(s[0], s[4]);
+	__m256i B = combine(s[1], s[5]);
+	__m256i C = combine(s[2], s[6]);
+	__m256i D = combine(s[3], s[7]);
+
+	for (uint block = 0; block < blocks; ++block) {
+		__m256i X[16];
+		loadLanes(data, block * 64, X);
+		loadLanes(data, block * 64 + 32, X + 8);
+
+		const __m256i AA = A, BB = B, CC = C, DD = D;
+
+		MD5_STEPS;
+
+		A = _mm256_add_epi32(A, AA);
+		B = _mm256_add_epi32(B, BB);
+		C = _mm256_add_epi32(C, CC);
+		D = _mm256_add_epi32(D, DD);
+	}
+
+	s[0] = _mm256_castsi256_si128(A);
+	s[1] = _mm256_castsi256_si128(B);
+	s[2] = _mm256_castsi256_si128(C);
+	s[3] = _mm256_castsi256_si128(D);
+	s[4] = _mm256_extracti128_si256(A, 1);
+	s[5] = _mm256_extracti128_si256(B, 1);
+	s[6] = _mm256_extracti128_si256(C, 1);
+	s[7] = _mm256_extracti128_si256(D, 1);
+	transpose(s[0], s[1], s[2], s[3]);
+	transpose(s[4], s[5], s[6], s[7]);
+	for (int i = 0; i < 8; ++i)
+		_mm_storeu_si128((__m128i *)state[i], s[i]);
+}
+
+} // End of namespace Common
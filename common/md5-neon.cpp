@@ -0,0 +1,94 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/md5_intern.h"
+
+#include <arm_neon.h>
+
+namespace Common {
+
+namespace {
+
+/** Turns four rows of four words into four columns. */
+inline void transpose(uint32x4_t &r0, uint32x4_t &r1, uint32x4_t &r2, uint32x4_t &r3) {
+	const uint32x4x2_t t01 = vtrnq_u32(r0, r1);
+	const uint32x4x2_t t23 = vtrnq_u32(r2, r3);
+	r0 = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+	r1 = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+	r2 = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+	r3 = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+}
+
+/** Loads four little endian words, without any alignment requirement. */
+inline uint32x4_t loadWords(const uint8 *data) {
+	return vreinterpretq_u32_u8(vld1q_u8(data));
+}
+
+} // End of anonymous namespace
+
+// F and G are bitwise selects, I uses the OR-NOT instruction
+#define MD5_F(x, y, z) vbslq_u32(x, y, z)
+#define MD5_G(x, y, z) vbslq_u32(z, x, y)
+#define MD5_H(x, y, z) veorq_u32(veorq_u32(x, y), z)
+#define MD5_I(x, y, z) veorq_u32(y, vornq_u32(x, z))
+
+#define MD5_STEP(f, a, b, c, d, k, s, t) { \
+	a = vaddq_u32(a, vaddq_u32(f(b, c, d), vaddq_u32(X[k], vdupq_n_u32(t)))); \
+	a = vaddq_u32(vsriq_n_u32(vshlq_n_u32(a, s), a, 32 - s), b); \
+}
+
+void md5ProcessLanes_NEON(uint32 *const *state, const uint8 *const *data, uint blocks) {
+	uint32x4_t A = vld1q_u32(state[0]);
+	uint32x4_t B = vld1q_u32(state[1]);
+	uint32x4_t C = vld1q_u32(state[2]);
+	uint32x4_t D = vld1q_u32(state[3]);
+	transpose(A, B, C, D);
+
+	for (uint block = 0; block < blocks; ++block) {
+		uint32x4_t X[16];
+		for (int i = 0; i < 16; i += 4) {
+			const uint offset = block * 64 + i * 4;
+			X[i] = loadWords(data[0] + offset);
+			X[i + 1] = loadWords(data[1] + offset);
+			X[i + 2] = loadWords(data[2] + offset);
+			X[i + 3] = loadWords(data[3] + offset);
+			transpose(X[i], X[i + 1], X[i + 2], X[i + 3]);
+		}
+
+		const uint32x4_t AA = A, BB = B, CC = C, DD = D;
+
+		MD5_STEPS;
+
+		A = vaddq_u32(A, AA);
+		B = vaddq_u32(B, BB);
+		C = vaddq_u32(C, CC);
+		D = vaddq_u32(D, DD);
+	}
+
+	transpose(A, B, C, D);
+	vst1q_u32(state[0], A);
+	vst1q_u32(state[1], B);
+	vst1q_u32(state[2], C);
+	vst1q_u32(state[3], D);
+}
+
+} // End of namespace Common
@@ -0,0 +1,91 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/md5_intern.h"
+
+#include <emmintrin.h>
+
+namespace Common {
+
+namespace {
+
+/** Turns four rows of four words into four columns. */
+inline void transpose(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+	const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+	const __m128i t1 = _mm_unpackhi_epi32(r0, r1);
+	const __m128i t2 = _mm_unpacklo_epi32(r2, r3);
+	const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+	r0 = _mm_unpacklo_epi64(t0, t2);
+	r1 = _mm_unpackhi_epi64(t0, t2);
+	r2 = _mm_unpacklo_epi64(t1, t3);
+	r3 = _mm_unpackhi_epi64(t1, t3);
+}
+
+} // End of anonymous namespace
+
+#define MD5_F(x, y, z) _mm_xor_si128(z, _mm_and_si128(x, _mm_xor_si128(y, z)))
+#define MD5_G(x, y, z) _mm_xor_si128(y, _mm_and_si128(z, _mm_xor_si128(x, y)))
+#define MD5_H(x, y, z) _mm_xor_si128(_mm_xor_si128(x, y), z)
+#define MD5_I(x, y, z) _mm_xor_si128(y, _mm_or_si128(x, _mm_xor_si128(z, ones)))
+
+#define MD5_STEP(f, a, b, c, d, k, s, t) { \
+	a = _mm_add_epi32(a, _mm_add_epi32(f(b, c, d), _mm_add_epi32(X[k], _mm_set1_epi32((int)(t))))); \
+	a = _mm_add_epi32(_mm_or_si128(_mm_slli_epi32(a, s), _mm_srli_epi32(a, 32 - s)), b); \
+}
+
+void md5ProcessLanes_SSE2(uint32 *const *state, const uint8 *const *data, uint blocks) {
+	const __m128i ones = _mm_set1_epi32(-1);
+
+	__m128i A = _mm_loadu_si128((const __m128i *)state[0]);
+	__m128i B = _mm_loadu_si128((const __m128i *)state[1]);
+	__m128i C = _mm_loadu_si128((const __m128i *)state[2]);
+	__m128i D = _mm_loadu_si128((const __m128i *)state[3]);
+	transpose(A, B, C, D);
+
+	for (uint block = 0; block < blocks; ++block) {
+		__m128i X[16];
+		for (int i = 0; i < 16; i += 4) {
+			const uint offset = block * 64 + i * 4;
+			X[i] = _mm_loadu_si128((const __m128i *)(data[0] + offset));
+			X[i + 1] = _mm_loadu_si128((const __m128i *)(data[1] + offset));
+			X[i + 2] = _mm_loadu_si128((const __m128i *)(data[2] + offset));
+			X[i + 3] = _mm_loadu_si128((const __m128i *)(data[3] + offset));
+			transpose(X[i], X[i + 1], X[i + 2], X[i + 3]);
+		}
+
+		const __m128i AA = A, BB = B, CC = C, DD = D;
+
+		MD5_STEPS;
+
+		A = _mm_add_epi32(A, AA);
+		B = _mm_add_epi32(B, BB);
+		C = _mm_add_epi32(C, CC);
+		D = _mm_add_epi32(D, DD);
+	}
+
+	transpose(A, B, C, D);
+	_mm_storeu_si128((__m128i *)state[0], A);
+	_mm_storeu_si128((__m128i *)state[1], B);
+	_mm_storeu_si128((__m128i *)state[2], C);
+	_mm_storeu_si128((__m128i *)state[3], D);
+}
+
+} // End of namespace Common
@@ -26,9 +26,11 @@
  */
 
 #include "common/md5.h"
+#include "common/md5_intern.h"
 #include "common/endian.h"
 #include "common/str.h"
 #include "common/stream.h"
+#include "common/system.h"
 
 namespace Common {
 
@@ -42,6 +44,13 @@ static void md5_starts(md5_context *ctx);
 static void md5_update(md5_context *ctx, const uint8 *input, uint32 length);
 static void md5_finish(md5_context *ctx, uint8 digest[16]);
 
+enum {
+	// How much is read from a stream at once. Being a multiple of the block
+	// size, whole blocks get hashed without copying them first.
+	kMD5ChunkSize = 4096,
+	kMD5MaxLanes = 8
+};
+
 
 #define GET_UINT32(n, b, i)	(n) = READ_LE_UINT32(b + i)
 #define PUT_UINT32(n, b, i)	WRITE_LE_UINT32(b + i, n)
@@ -178,6 +187,22 @@ static void md5_process(md5_context *ctx, const uint8 data[64]) {
 	ctx->state[3] += D;
 }
 
+void md5ProcessLanes_Scalar(uint32 *const *state, const uint8 *const *data, uint blocks) {
+	md5_context ctx;
+	memcpy(ctx.state, state[0], sizeof(ctx.state));
+	for (uint block = 0; block < blocks; ++block)
+		md5_process(&ctx, data[0] + block * 64);
+	memcpy(state[0], ctx.state, sizeof(ctx.state));
+}
+
+static void md5_add_length(md5_context *ctx, uint32 length) {
+	ctx->total[0] += length;
+	ctx->total[0] &= 0xFFFFFFFF;
+
+	if (ctx->total[0] < length)
+		ctx->total[1]++;
+}
+
 void md5_update(md5_context *ctx, const uint8 *input, uint32 length) {
 	uint32 left, fill;
 
@@ -187,11 +212,7 @@ void md5_update(md5_context *ctx, const uint8 *input, uint32 length) {
 	left = ctx->total[0] & 0x3F;
 	fill = 64 - left;
 
-	ctx->total[0] += length;
-	ctx->total[0] &= 0xFFFFFFFF;
-
-	if (ctx->total[0] < length)
-		ctx->total[1]++;
+	md5_add_length(ctx, length);
 
 	if (left && length >= fill) {
 		memcpy((void *)(ctx->buffer + left), (const void *)input, fill);
@@ -250,7 +271,7 @@ bool computeStreamMD5(ReadStream &stream, uint8 digest[16], uint32 length) {
 #else
 	md5_context ctx;
 	int i;
-	unsigned char buf[1000];
+	unsigned char buf[kMD5ChunkSize];
 	bool restricted = (length != 0);
 	uint32 readlen;
 
@@ -279,16 +300,169 @@ bool computeStreamMD5(ReadStream &stream, uint8 digest[16], uint32 length) {
 	return true;
 }
 
-String computeStreamMD5AsString(ReadStream &stream, uint32 length) {
+static String md5_to_string(const uint8 digest[16]) {
 	String md5;
+	for (int i = 0; i < 16; i++) {
+		md5 += String::format("%02x", (int)digest[i]);
+	}
+	return md5;
+}
+
+String computeStreamMD5AsString(ReadStream &stream, uint32 length) {
 	uint8 digest[16];
-	if (computeStreamMD5(stream, digest, length)) {
-		for (int i = 0; i < 16; i++) {
-			md5 += String::format("%02x", (int)digest[i]);
+	if (computeStreamMD5(stream, digest, length))
+		return md5_to_string(digest);
+
+	return String();
+}
+
+MD5ProcessLanesProc getMD5ProcessLanes(uint &lanes) {
+	if (!g_system)
+		return nullptr;
+
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		lanes = 8;
+		return md5ProcessLanes_AVX2;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		lanes = 4;
+		return md5ProcessLanes_SSE2;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		lanes = 4;
+		return md5ProcessLanes_NEON;
+	}
+#endif
+
+	return nullptr;
+}
+
+/** A stream hashed by computeStreamsMD5(), with the data read from it but not hashed yet. */
+struct md5_lane {
+	md5_context ctx;
+	ReadStream *stream;
+	uint32 left;
+	uint32 pos, size;
+	bool done;
+	uint8 buffer[kMD5ChunkSize];
+};
+
+/** Reads from the stream of the lane until it has a whole block or the stream ends. */
+static void md5_fill_lane(md5_lane *lane, bool restricted) {
+	if (lane->done || lane->size - lane->pos >= 64)
+		return;
+
+	memmove(lane->buffer, lane->buffer + lane->pos, lane->size - lane->pos);
+	lane->size -= lane->pos;
+	lane->pos = 0;
+
+	while (!lane->done && lane->size < 64) {
+		uint32 readlen = kMD5ChunkSize - lane->size;
+		if (restricted && readlen > lane->left)
+			readlen = lane->left;
+
+		const uint32 i = lane->stream->read(lane->buffer + lane->size, readlen);
+		lane->size += i;
+		if (restricted)
+			lane->left -= i;
+		if (i == 0 || (restricted && lane->left == 0))
+			lane->done = true;
+	}
+}
+
+void computeStreamsMD5(ReadStream *const *streams, uint count, uint8 (*digests)[16], uint32 length) {
+#ifdef DISABLE_MD5
+	memset(digests, 0, count * 16);
+#else
+	uint lanes = 1;
+	MD5ProcessLanesProc processLanes = getMD5ProcessLanes(lanes);
+	if (!processLanes || count <= 1) {
+		for (uint i = 0; i < count; ++i)
+			computeStreamMD5(*streams[i], digests[i], length);
+		return;
+	}
+
+	const bool restricted = (length != 0);
+	md5_lane *lane = new md5_lane[lanes];
+
+	// Lanes without data hash zeros into a state nobody looks at
+	static const uint8 idleData[kMD5ChunkSize] = { 0 };
+	uint32 idleState[4];
+	uint32 *state[kMD5MaxLanes];
+	const uint8 *data[kMD5MaxLanes];
+
+	for (uint first = 0; first < count; first += lanes) {
+		const uint used = MIN(lanes, count - first);
+		for (uint i = 0; i < used; ++i) {
+			md5_starts(&lane[i].ctx);
+			lane[i].stream = streams[first + i];
+			lane[i].left = length;
+			lane[i].pos = lane[i].size = 0;
+			lane[i].done = false;
+		}
+
+		while (true) {
+			uint ready = 0, blocks = kMD5ChunkSize / 64;
+			for (uint i = 0; i < used; ++i) {
+				md5_fill_lane(&lane[i], restricted);
+				const uint available = (lane[i].size - lane[i].pos) / 64;
+				if (available) {
+					++ready;
+					blocks = MIN(blocks, available);
+				}
+			}
+
+			// The last stream is hashed on its own below
+			if (ready < 2)
+				break;
+
+			for (uint i = 0; i < lanes; ++i) {
+				if (i < used && lane[i].size - lane[i].pos >= 64) {
+					state[i] = lane[i].ctx.state;
+					data[i] = lane[i].buffer + lane[i].pos;
+				} else {
+					state[i] = idleState;
+					data[i] = idleData;
+				}
+			}
+
+			processLanes(state, data, blocks);
+
+			for (uint i = 0; i < used; ++i) {
+				if (state[i] != idleState) {
+					lane[i].pos += blocks * 64;
+					md5_add_length(&lane[i].ctx, blocks * 64);
+				}
+			}
+		}
+
+		for (uint i = 0; i < used; ++i) {
+			while (true) {
+				md5_update(&lane[i].ctx, lane[i].buffer + lane[i].pos, lane[i].size - lane[i].pos);
+				lane[i].pos = lane[i].size;
+				if (lane[i].done)
+					break;
+				md5_fill_lane(&lane[i], restricted);
+			}
+			md5_finish(&lane[i].ctx, digests[first + i]);
 		}
 	}
 
-	return md5;
+	delete[] lane;
+#endif
+}
+
+void computeStreamsMD5AsString(ReadStream *const *streams, uint count, String *md5s, uint32 length) {
+	uint8 (*digests)[16] = new uint8[count][16];
+	computeStreamsMD5(streams, count, digests, length);
+	for (uint i = 0; i < count; ++i)
+		md5s[i] = md5_to_string(digests[i]);
+	delete[] digests;
 }
 
 } // End of namespace Common
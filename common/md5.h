@@ -62,6 +62,28 @@ bool computeStreamMD5(ReadStream &stream, uint8 digest[16], uint32 length = 0);
  */
 String computeStreamMD5AsString(ReadStream &stream, uint32 length = 0);
 
+/**
+ * Compute the MD5 checksums of the contents of several ReadStreams at once.
+ * On CPUs with vector units, this hashes the streams in parallel lanes,
+ * which is faster than computing their checksums one after the other.
+ * The streams are read in turns, a few kilobytes at a time.
+ * @param[in] streams	the streams of whose data the MD5s are computed
+ * @param[in] count	the number of streams
+ * @param[out] digests	the computed MD5 checksums, one for each stream
+ * @param[in] length	the number of bytes of each stream for which to compute the checksum; 0 means all
+ */
+void computeStreamsMD5(ReadStream *const *streams, uint count, uint8 (*digests)[16], uint32 length = 0);
+
+/**
+ * Compute the MD5 checksums of the contents of several ReadStreams at once,
+ * like computeStreamsMD5(), as human readable lowercase hex strings.
+ * @param[in] streams	the streams of whose data the MD5s are computed
+ * @param[in] count	the number of streams
+ * @param[out] md5s	the MD5s as hex strings, one for each stream
+ * @param[in] length	the number of bytes of each stream for which to compute the checksum; 0 means all
+ */
+void computeStreamsMD5AsString(ReadStream *const *streams, uint count, String *md5s, uint32 length = 0);
+
 /** @} */
 
 } // End of namespace Common
@@ -0,0 +1,134 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_MD5_INTERN_H
+#define COMMON_MD5_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * Runs the MD5 block transform on several independent messages at once.
+ * For every lane i, @p blocks blocks of 64 bytes starting at data[i] are
+ * hashed into the four words at state[i].
+ */
+typedef void (*MD5ProcessLanesProc)(uint32 *const *state, const uint8 *const *data, uint blocks);
+
+/** The plain C transform, for a single lane. */
+void md5ProcessLanes_Scalar(uint32 *const *state, const uint8 *const *data, uint blocks);
+
+#ifdef SCUMMVM_SSE2
+/** The SSE2 transform, for 4 lanes. */
+void md5ProcessLanes_SSE2(uint32 *const *state, const uint8 *const *data, uint blocks);
+#endif
+
+#ifdef SCUMMVM_AVX2
+/** The AVX2 transform, for 8 lanes. */
+void md5ProcessLanes_AVX2(uint32 *const *state, const uint8 *const *data, uint blocks);
+#endif
+
+#ifdef SCUMMVM_NEON
+/** The NEON transform, for 4 lanes. */
+void md5ProcessLanes_NEON(uint32 *const *state, const uint8 *const *data, uint blocks);
+#endif
+
+/**
+ * Returns the fastest vector transform supported by the CPU we are running
+ * on and sets @p lanes to the number of lanes it hashes, or returns
+ * nullptr if there is none.
+ */
+MD5ProcessLanesProc getMD5ProcessLanes(uint &lanes);
+
+/*
+ * The steps of the block transform for the vector versions, which define
+ * MD5_STEP(f, a, b, c, d, k, s, t) as a += f(b, c, d) + X[k] + t, followed
+ * by a = (a <<< s) + b, and the functions MD5_F, MD5_G, MD5_H and MD5_I.
+ */
+#define MD5_STEPS \
+	MD5_STEP(MD5_F, A, B, C, D,  0,  7, 0xD76AA478); \
+	MD5_STEP(MD5_F, D, A, B, C,  1, 12, 0xE8C7B756); \
+	MD5_STEP(MD5_F, C, D, A, B,  2, 17, 0x242070DB); \
+	MD5_STEP(MD5_F, B, C, D, A,  3, 22, 0xC1BDCEEE); \
+	MD5_STEP(MD5_F, A, B, C, D,  4,  7, 0xF57C0FAF); \
+	MD5_STEP(MD5_F, D, A, B, C,  5, 12, 0x4787C62A); \
+	MD5_STEP(MD5_F, C, D, A, B,  6, 17, 0xA8304613); \
+	MD5_STEP(MD5_F, B, C, D, A,  7, 22, 0xFD469501); \
+	MD5_STEP(MD5_F, A, B, C, D,  8,  7, 0x698098D8); \
+	MD5_STEP(MD5_F, D, A, B, C,  9, 12, 0x8B44F7AF); \
+	MD5_STEP(MD5_F, C, D, A, B, 10, 17, 0xFFFF5BB1); \
+	MD5_STEP(MD5_F, B, C, D, A, 11, 22, 0x895CD7BE); \
+	MD5_STEP(MD5_F, A, B, C, D, 12,  7, 0x6B901122); \
+	MD5_STEP(MD5_F, D, A, B, C, 13, 12, 0xFD987193); \
+	MD5_STEP(MD5_F, C, D, A, B, 14, 17, 0xA679438E); \
+	MD5_STEP(MD5_F, B, C, D, A, 15, 22, 0x49B40821); \
+	MD5_STEP(MD5_G, A, B, C, D,  1,  5, 0xF61E2562); \
+	MD5_STEP(MD5_G, D, A, B, C,  6,  9, 0xC040B340); \
+	MD5_STEP(MD5_G, C, D, A, B, 11, 14, 0x265E5A51); \
+	MD5_STEP(MD5_G, B, C, D, A,  0, 20, 0xE9B6C7AA); \
+	MD5_STEP(MD5_G, A, B, C, D,  5,  5, 0xD62F105D); \
+	MD5_STEP(MD5_G, D, A, B, C, 10,  9, 0x02441453); \
+	MD5_STEP(MD5_G, C, D, A, B, 15, 14, 0xD8A1E681); \
+	MD5_STEP(MD5_G, B, C, D, A,  4, 20, 0xE7D3FBC8); \
+	MD5_STEP(MD5_G, A, B, C, D,  9,  5, 0x21E1CDE6); \
+	MD5_STEP(MD5_G, D, A, B, C, 14,  9, 0xC33707D6); \
+	MD5_STEP(MD5_G, C, D, A, B,  3, 14, 0xF4D50D87); \
+	MD5_STEP(MD5_G, B, C, D, A,  8, 20, 0x455A14ED); \
+	MD5_STEP(MD5_G, A, B, C, D, 13,  5, 0xA9E3E905); \
+	MD5_STEP(MD5_G, D, A, B, C,  2,  9, 0xFCEFA3F8); \
+	MD5_STEP(MD5_G, C, D, A, B,  7, 14, 0x676F02D9); \
+	MD5_STEP(MD5_G, B, C, D, A, 12, 20, 0x8D2A4C8A); \
+	MD5_STEP(MD5_H, A, B, C, D,  5,  4, 0xFFFA3942); \
+	MD5_STEP(MD5_H, D, A, B, C,  8, 11, 0x8771F681); \
+	MD5_STEP(MD5_H, C, D, A, B, 11, 16, 0x6D9D6122); \
+	MD5_STEP(MD5_H, B, C, D, A, 14, 23, 0xFDE5380C); \
+	MD5_STEP(MD5_H, A, B, C, D,  1,  4, 0xA4BEEA44); \
+	MD5_STEP(MD5_H, D, A, B, C,  4, 11, 0x4BDECFA9); \
+	MD5_STEP(MD5_H, C, D, A, B,  7, 16, 0xF6BB4B60); \
+	MD5_STEP(MD5_H, B, C, D, A, 10, 23, 0xBEBFBC70); \
+	MD5_STEP(MD5_H, A, B, C, D, 13,  4, 0x289B7EC6); \
+	MD5_STEP(MD5_H, D, A, B, C,  0, 11, 0xEAA127FA); \
+	MD5_STEP(MD5_H, C, D, A, B,  3, 16, 0xD4EF3085); \
+	MD5_STEP(MD5_H, B, C, D, A,  6, 23, 0x04881D05); \
+	MD5_STEP(MD5_H, A, B, C, D,  9,  4, 0xD9D4D039); \
+	MD5_STEP(MD5_H, D, A, B, C, 12, 11, 0xE6DB99E5); \
+	MD5_STEP(MD5_H, C, D, A, B, 15, 16, 0x1FA27CF8); \
+	MD5_STEP(MD5_H, B, C, D, A,  2, 23, 0xC4AC5665); \
+	MD5_STEP(MD5_I, A, B, C, D,  0,  6, 0xF4292244); \
+	MD5_STEP(MD5_I, D, A, B, C,  7, 10, 0x432AFF97); \
+	MD5_STEP(MD5_I, C, D, A, B, 14, 15, 0xAB9423A7); \
+	MD5_STEP(MD5_I, B, C, D, A,  5, 21, 0xFC93A039); \
+	MD5_STEP(MD5_I, A, B, C, D, 12,  6, 0x655B59C3); \
+	MD5_STEP(MD5_I, D, A, B, C,  3, 10, 0x8F0CCC92); \
+	MD5_STEP(MD5_I, C, D, A, B, 10, 15, 0xFFEFF47D); \
+	MD5_STEP(MD5_I, B, C, D, A,  1, 21, 0x85845DD1); \
+	MD5_STEP(MD5_I, A, B, C, D,  8,  6, 0x6FA87E4F); \
+	MD5_STEP(MD5_I, D, A, B, C, 15, 10, 0xFE2CE6E0); \
+	MD5_STEP(MD5_I, C, D, A, B,  6, 15, 0xA3014314); \
+	MD5_STEP(MD5_I, B, C, D, A, 13, 21, 0x4E0811A1); \
+	MD5_STEP(MD5_I, A, B, C, D,  4,  6, 0xF7537E82); \
+	MD5_STEP(MD5_I, D, A, B, C, 11, 10, 0xBD3AF235); \
+	MD5_STEP(MD5_I, C, D, A, B,  2, 15, 0x2AD7D2BB); \
+	MD5_STEP(MD5_I, B, C, D, A,  9, 21, 0xEB86D391)
+
+} // End of namespace Common
+
+#endif
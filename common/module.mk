@@ -39,8 +39,27 @@ MODULE_OBJS := \
 	unicode-bidi.o \
 	ustr.o \
 	util.o \
+	workerpool.o \
 	xpfloat.o
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	md5-sse2.o
+$(MODULE)/md5-sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	md5-avx2.o
+$(MODULE)/md5-avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	md5-neon.o
+$(MODULE)/md5-neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+endif
+
 ifdef ENABLE_EVENTRECORDER
 MODULE_OBJS += \
 	recorderfile.o
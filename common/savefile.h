@@ -120,6 +120,16 @@ public:
 	int64 size() const override;
 };
 
+/**
+ * Called when a save file opened with SaveFileManager::openForSavingAsync()
+ * has been written.
+ *
+ * @param name     Name of the save file.
+ * @param success  Whether the save file was written successfully.
+ * @param data     The data pointer passed to openForSavingAsync().
+ */
+typedef void (*SaveCompletionProc)(const String &name, bool success, void *data);
+
 /**
  * The SaveFileManager serves as a factory for InSaveFile
  * and OutSaveFile objects.
@@ -201,6 +211,42 @@ public:
 	 */
 	virtual OutSaveFile *openForSaving(const String &name, bool compress = true) = 0;
 
+	/**
+	 * Open the save file with the specified @p name for saving in the background.
+	 *
+	 * The returned file only collects the data in memory. Once it has been
+	 * finalized or deleted, the data is compressed and written without
+	 * further blocking the caller. @p proc is then called on the main
+	 * thread, from handleWrittenSaves().
+	 *
+	 * Save file managers without a background writer write the file like
+	 * openForSaving() does, and call @p proc from finalize().
+	 *
+	 * @param name      Name of the save file.
+	 * @param compress  Whether to compress the resulting save file (default) or not.
+	 * @param proc      Called once the file has been written, may be nullptr.
+	 * @param procData  Passed to @p proc.
+	 *
+	 * @return Pointer to an OutSaveFile, or NULL if an error occurred. In
+	 *         the latter case @p proc is never called.
+	 */
+	virtual OutSaveFile *openForSavingAsync(const String &name, bool compress = true, SaveCompletionProc proc = nullptr, void *procData = nullptr);
+
+	/**
+	 * Wait until all the save files opened with openForSavingAsync() have
+	 * been written, and their completion procs have returned.
+	 */
+	virtual void waitForPendingSaves() {}
+
+	/**
+	 * Report the save files written in the background since the last call,
+	 * and call their completion procs. A failed write is also reported to
+	 * the user, since the game has already considered it done.
+	 *
+	 * This is called regularly by the event manager, on the main thread.
+	 */
+	virtual void handleWrittenSaves() {}
+
 	/**
 	 * Open the file with the specified @p name in the given directory for loading.
 	 *
@@ -218,6 +264,15 @@ public:
 	*/
 	virtual InSaveFile *openRawFile(const String &name) = 0;
 
+	/**
+	 * Return the time the given save file was last modified, in seconds
+	 * since the Unix epoch.
+	 *
+	 * @param name  Name of the save file.
+	 * @return The modification time, or 0 if it is unknown.
+	 */
+	virtual int64 getSavefileModificationTime(const String &name) { return 0; }
+
 	/**
 	 * Remove the given save file from the system.
 	 *
@@ -700,6 +700,19 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Obtain the contents of the stream, if they are in memory already.
+	 *
+	 * This is the case for memory streams and for files the backend has
+	 * mapped into memory. Callers can use the returned bytes instead of
+	 * reading them into a buffer of their own.
+	 *
+	 * @return A pointer to the size() bytes of the stream, valid as long as
+	 *         the stream exists, or nullptr if the contents are not
+	 *         available in memory.
+	 */
+	virtual const byte *getMemoryView() const { return nullptr; }
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
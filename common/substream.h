@@ -85,6 +85,11 @@ public:
 	virtual int64 size() const { return _end - _begin; }
 
 	virtual bool seek(int64 offset, int whence = SEEK_SET);
+
+	virtual const byte *getMemoryView() const {
+		const byte *view = _parentStream->getMemoryView();
+		return view ? view + _begin : nullptr;
+	}
 };
 
 /**
@@ -45,6 +45,7 @@ class OptionsContainerWidget;
 }
 
 namespace Common {
+class ConditionVariableInternal;
 class EventManager;
 class MutexInternal;
 struct Rect;
@@ -58,6 +59,7 @@ class TaskbarManager;
 class UpdateManager;
 #endif
 class TextToSpeechManager;
+class ThreadInternal;
 #if defined(USE_SYSDIALOGS)
 class DialogManager;
 #endif
@@ -494,7 +496,23 @@ public:
 		/**
 		* For platforms that should not have a Quit button.
 		*/
-		kFeatureNoQuit
+		kFeatureNoQuit,
+
+		/**
+		* The CPU supports the SSE2 instruction set. Code built with
+		* SCUMMVM_SSE2 may only use its SSE2 paths if this is reported.
+		*/
+		kFeatureCpuSSE2,
+
+		/**
+		* The CPU supports the AVX2 instruction set.
+		*/
+		kFeatureCpuAVX2,
+
+		/**
+		* The CPU supports the ARM NEON instruction set.
+		*/
+		kFeatureCpuNEON
 	};
 
 	/**
@@ -1431,6 +1449,45 @@ public:
 
 	/** @} */
 
+	/**
+	 * @defgroup common_system_threads Threads
+	 * @ingroup common_system
+	 * @{
+	 *
+	 * Optional support for worker threads, used to spread expensive work
+	 * such as software rendering or decompression over several CPU cores.
+	 * Unlike the timer callbacks, nothing ever depends on these being
+	 * available: every user falls back to doing the work on the calling
+	 * thread when createThread() fails. Backends that cannot or do not want
+	 * to provide threads can simply keep the default implementations.
+	 */
+
+	/**
+	 * Create and start a new thread, which will call proc(data) and then
+	 * exit. The returned object must be joined before it gets deleted.
+	 *
+	 * @return The newly created thread, or 0 if threads are not supported
+	 *         or an error occurred.
+	 */
+	virtual Common::ThreadInternal *createThread(void (*proc)(void *data), void *data) { return nullptr; }
+
+	/**
+	 * Create a new condition variable, to be used together with the mutexes
+	 * returned by createMutex().
+	 *
+	 * @return The newly created condition variable, or 0 if threads are not
+	 *         supported or an error occurred.
+	 */
+	virtual Common::ConditionVariableInternal *createConditionVariable() { return nullptr; }
+
+	/**
+	 * Return the number of CPU cores available to ScummVM. This is only a
+	 * hint on how many worker threads are worth creating.
+	 */
+	virtual uint getCPUCount() { return 1; }
+
+	/** @} */
+
 
 
 	/** @defgroup common_system_sound Sound
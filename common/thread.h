@@ -0,0 +1,84 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+#include "common/scummsys.h"
+#include "common/mutex.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_thread Threads
+ * @ingroup common
+ *
+ * @brief Low level thread and condition variable interfaces.
+ *
+ * Backends are not required to support threads, see OSystem::createThread().
+ * Code using them must keep working when no thread can be created, which
+ * usually means doing the work on the calling thread instead. Most users
+ * want Common::WorkerPool, which takes care of that.
+ * @{
+ */
+
+/**
+ * Entry point of a thread.
+ */
+typedef void (*ThreadProc)(void *data);
+
+class ThreadInternal {
+public:
+	virtual ~ThreadInternal() {}
+
+	/**
+	 * Wait until the thread has returned from its entry point.
+	 * This has to be called before deleting the object.
+	 */
+	virtual bool join() = 0;
+};
+
+class ConditionVariableInternal {
+public:
+	virtual ~ConditionVariableInternal() {}
+
+	/**
+	 * Atomically unlock the mutex and wait until the condition variable
+	 * gets signalled, then lock the mutex again. The mutex has to be one
+	 * created by the same backend, and must be locked exactly once by the
+	 * calling thread.
+	 *
+	 * As with any condition variable, spurious wakeups are possible.
+	 */
+	virtual bool wait(MutexInternal *mutex) = 0;
+
+	/** Wake up one of the threads waiting on the condition variable. */
+	virtual bool signal() = 0;
+
+	/** Wake up all the threads waiting on the condition variable. */
+	virtual bool broadcast() = 0;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
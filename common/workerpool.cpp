@@ -0,0 +1,144 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/workerpool.h"
+#include "common/str.h"
+#include "common/system.h"
+#include "common/util.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(SharedWorkerPool);
+
+WorkerPool::WorkerPool(uint numThreads) : _mutex(nullptr), _workAvailable(nullptr), _workDone(nullptr),
+	_proc(nullptr), _data(nullptr), _count(0), _next(0), _pending(0), _busy(false), _quit(false) {
+	assert(g_system);
+
+	if (numThreads == 0)
+		numThreads = g_system->getCPUCount();
+	if (numThreads <= 1)
+		return;
+
+	_workAvailable = g_system->createConditionVariable();
+	_workDone = g_system->createConditionVariable();
+	if (!_workAvailable || !_workDone)
+		return;
+	_mutex = g_system->createMutex();
+
+	// Pools may be created before the backend is initialized
+	String::initMemoryPoolMutex();
+
+	for (uint i = 1; i < numThreads; ++i) {
+		ThreadInternal *thread = g_system->createThread(workerEntry, this);
+		if (!thread)
+			break;
+		_threads.push_back(thread);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	if (!_threads.empty()) {
+		_mutex->lock();
+		_quit = true;
+		_workAvailable->broadcast();
+		_mutex->unlock();
+
+		for (uint i = 0; i < _threads.size(); ++i) {
+			_threads[i]->join();
+			delete _threads[i];
+		}
+	}
+
+	delete _workAvailable;
+	delete _workDone;
+	delete _mutex;
+}
+
+void WorkerPool::parallelFor(uint count, TaskProc proc, void *data) {
+	if (_threads.empty() || count <= 1) {
+		for (uint i = 0; i < count; ++i)
+			proc(data, i);
+		return;
+	}
+
+	_mutex->lock();
+	if (_busy) {
+		_mutex->unlock();
+		for (uint i = 0; i < count; ++i)
+			proc(data, i);
+		return;
+	}
+	assert(_pending == 0);
+	_busy = true;
+	_proc = proc;
+	_data = data;
+	_count = count;
+	_next = 0;
+	_pending = count;
+	_workAvailable->broadcast();
+
+	while (_next < _count) {
+		uint index = _next++;
+		_mutex->unlock();
+		proc(data, index);
+		_mutex->lock();
+		--_pending;
+	}
+
+	while (_pending > 0)
+		_workDone->wait(_mutex);
+
+	_count = 0;
+	_next = 0;
+	_busy = false;
+	_mutex->unlock();
+}
+
+SharedWorkerPool::SharedWorkerPool() : WorkerPool(MIN<uint>(g_system->getCPUCount(), kMaxThreads)) {
+}
+
+void WorkerPool::workerEntry(void *data) {
+	((WorkerPool *)data)->workerLoop();
+}
+
+void WorkerPool::workerLoop() {
+	_mutex->lock();
+	while (true) {
+		while (!_quit && _next >= _count)
+			_workAvailable->wait(_mutex);
+		if (_quit)
+			break;
+
+		TaskProc proc = _proc;
+		void *data = _data;
+		uint index = _next++;
+
+		_mutex->unlock();
+		proc(data, index);
+		_mutex->lock();
+
+		if (--_pending == 0)
+			_workDone->broadcast();
+	}
+	_mutex->unlock();
+}
+
+} // End of namespace Common
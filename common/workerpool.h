@@ -0,0 +1,121 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_WORKERPOOL_H
+#define COMMON_WORKERPOOL_H
+
+#include "common/array.h"
+#include "common/noncopyable.h"
+#include "common/singleton.h"
+#include "common/thread.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_workerpool Worker pool
+ * @ingroup common
+ *
+ * @brief A set of threads used to split work in independent parts.
+ * @{
+ */
+
+/**
+ * A pool of worker threads.
+ *
+ * When the backend does not support threads, or only a single thread is
+ * requested, all the work is done on the calling thread. Users therefore
+ * never need a separate serial code path, but the work items must not
+ * depend on the order they are run in.
+ */
+class WorkerPool : NonCopyable {
+public:
+	typedef void (*TaskProc)(void *data, uint index);
+
+	/**
+	 * Create a pool.
+	 *
+	 * @param numThreads The number of threads running the tasks, including
+	 *                   the one calling parallelFor(). 0 means one thread
+	 *                   per CPU core.
+	 */
+	explicit WorkerPool(uint numThreads = 0);
+	~WorkerPool();
+
+	/**
+	 * Return the number of threads running the tasks, including the one
+	 * calling parallelFor(). This may be less than requested, if the
+	 * backend could not create that many threads.
+	 */
+	uint getThreadCount() const { return _threads.size() + 1; }
+
+	/**
+	 * Call proc(data, index) for every index in [0, count), spread over the
+	 * threads of the pool, and return once all the calls are done. The
+	 * calling thread takes part in the work.
+	 *
+	 * A call made while another one on the same pool is still running, from
+	 * another thread or from one of the tasks, does all its work on the
+	 * calling thread.
+	 */
+	void parallelFor(uint count, TaskProc proc, void *data);
+
+private:
+	static void workerEntry(void *data);
+	void workerLoop();
+
+	Array<ThreadInternal *> _threads;
+	MutexInternal *_mutex;
+	ConditionVariableInternal *_workAvailable;
+	ConditionVariableInternal *_workDone;
+
+	TaskProc _proc;
+	void *_data;
+	uint _count;
+	uint _next;
+	uint _pending;
+	bool _busy;
+	bool _quit;
+};
+
+/**
+ * The pool shared by the code which splits work over threads without owning
+ * a pool, such as the decompression of streams and archives. This keeps them
+ * from starting threads of their own for every object.
+ *
+ * It is created on first use, with one thread per CPU core but at most
+ * kMaxThreads, and destroyed on shutdown.
+ */
+class SharedWorkerPool : public WorkerPool, public Singleton<SharedWorkerPool> {
+public:
+	enum {
+		kMaxThreads = 4
+	};
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	SharedWorkerPool();
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,257 @@
+# -------- Generated by configure -----------
+
+SAVED_CONFIGFLAGS       := --backend=null --disable-all-engines --enable-engine=scumm,scumm-7-8 --disable-mt32emu
+SAVED_AR                := 
+SAVED_AS                := 
+SAVED_ASFLAGS           := 
+SAVED_CPPFLAGS          := 
+SAVED_CXX               := 
+SAVED_CXXFLAGS          := 
+SAVED_DWP               := 
+SAVED_LD                := 
+SAVED_LDFLAGS           := 
+SAVED_PKG_CONFIG_LIBDIR := unset
+SAVED_RANLIB            := 
+SAVED_SDL_CONFIG        := 
+SAVED_STRIP             := 
+SAVED_WINDRES           := 
+SAVED_WINDRESFLAGS      := 
+
+CXX := g++
+CXXFLAGS :=   -W -Wno-unused-parameter -Wno-empty-body -fno-operator-names -std=c++11 -pedantic -g -fvar-tracking-assignments -Wno-address-of-packed-member -I/usr/include/freetype2 -I/usr/include/libpng16 
+LD := g++
+LIBS += -lpthread -lm  -ljpeg -lpng16  -lz -lcurl  -lreadline -lfreetype 
+RANLIB := ranlib
+STRIP := strip
+AR := ar cr
+AS := as
+ASFLAGS := 
+DWP := dwp
+WINDRES := windres
+LDD := ldd
+WINDRESFLAGS := 
+STAGINGPATH=staging
+AMIGAOSPATH=install
+MORPHOSPATH=PROGDIR:
+STATICLIBPATH=
+XCODETOOLSPATH=
+SPARKLEPATH=
+SDLCONFIG=sdl2-config
+
+ABI := 
+
+BACKEND := null
+MODULES += backends/platform/null
+MODULE_DIRS += 
+EXEPRE := 
+EXEEXT := 
+NASM := 
+NASMFLAGS := 
+PANDOC := pandoc
+CURL := curl
+PANDOCFORMAT := plain
+PANDOCEXT := 
+MANUALVERSION := latest
+ZLIB_LIBS := -lz
+ZLIB_CFLAGS := 
+
+prefix = /usr/local
+exec_prefix = ${prefix}
+bindir = ${exec_prefix}/bin
+libdir = ${exec_prefix}/lib
+datarootdir = ${prefix}/share
+datadir = ${datarootdir}/scummvm
+mandir = ${datarootdir}/man
+docdir = ${datarootdir}/doc/scummvm
+
+
+HAVE_GCC = 1
+CXX_UPDATE_DEP_FLAG = -MMD -MF "$(*D)/$(DEPDIR)/$(*F).d" -MQ "$@" -MP
+WITHOUT_SDL = 1
+# USE_SDL_NET = 1
+POSIX = 1
+HAS_PTHREADS = 1
+# VERBOSE_BUILD = 1
+# USE_ELF_LOADER = 1
+# DYNAMIC_MODULES = 1
+DETECTION_STATIC = 1
+DETECTION_FULL = 1
+# USE_MT32EMU = 1
+USE_LUA = 1
+# DISABLE_NUKED_OPL = 1
+USE_RGB_COLOR = 1
+USE_HIGHRES = 1
+USE_SAVEGAME_TIMESTAMP = 1
+USE_SCALERS = 1
+USE_HQ_SCALERS = 1
+USE_EDGE_SCALERS = 1
+USE_ASPECT = 1
+# USE_OGG = 1
+# USE_VORBIS = 1
+# USE_TREMOR = 1
+# ENABLE_OPL2LPT = 1
+# USE_RETROWAVE = 1
+# USE_FLAC = 1
+# USE_MAD = 1
+# USE_ALSA = 1
+USE_JPEG = 1
+USE_PNG = 1
+# USE_GIF = 1
+# USE_THEORADEC = 1
+# USE_FAAD = 1
+USE_ZLIB = 1
+# USE_MPEG2 = 1
+# USE_A52 = 1
+USE_LIBCURL = 1
+USE_CLOUD = 1
+# USE_FLUIDSYNTH = 1
+USE_FREETYPE2 = 1
+# USE_OPENGL = 1
+# USE_GLAD = 1
+# USE_OPENGL_GAME = 1
+# USE_OPENGL_SHADERS = 1
+USE_LINUXCD = 1
+# USE_NASM = 1
+SCUMMVM_SSE2 = 1
+SCUMMVM_AVX2 = 1
+# SCUMMVM_NEON = 1
+NEON_CXXFLAGS := 
+# USE_PANDOC = 1
+USE_CURL = 1
+# USE_FRIBIDI = 1
+# ENABLE_TEST_CPP_11 = 1
+# USE_DISCORD = 1
+# ENABLE_VKEYBD = 1
+# ENABLE_EVENTRECORDER = 1
+USE_TRANSLATION = 1
+# USE_TASKBAR = 1
+# USE_SYSDIALOGS = 1
+# USE_TTS = 1
+USE_TINYGL = 1
+USE_BINK = 1
+# USE_UPDATES = 1
+BUILTIN_RESOURCES = 1
+# ENABLE_ACCESS
+# ENABLE_ADL
+# ENABLE_AGI
+# ENABLE_AGOS
+# ENABLE_AGOS2
+# ENABLE_AGS
+# ENABLE_ASYLUM
+# ENABLE_AVALANCHE
+# ENABLE_BBVS
+# ENABLE_BLADERUNNER
+# ENABLE_BURIED
+# ENABLE_CGE
+# ENABLE_CGE2
+# ENABLE_CHEWY
+# ENABLE_CINE
+# ENABLE_COMPOSER
+# ENABLE_CRUISE
+# ENABLE_CRYO
+# ENABLE_CRYOMNI3D
+# ENABLE_VERSAILLES
+# ENABLE_DIRECTOR
+# ENABLE_DM
+# ENABLE_DRACI
+# ENABLE_DRAGONS
+# ENABLE_DRASCULA
+# ENABLE_DREAMWEB
+# ENABLE_FREESCAPE
+# ENABLE_GLK
+# ENABLE_GNAP
+# ENABLE_GOB
+# ENABLE_GRIFFON
+# ENABLE_GRIM
+# ENABLE_MONKEY4
+# ENABLE_GROOVIE
+# ENABLE_GROOVIE2
+# ENABLE_HADESCH
+# ENABLE_HDB
+# ENABLE_HOPKINS
+# ENABLE_HPL1
+# ENABLE_HUGO
+# ENABLE_HYPNO
+# ENABLE_ICB
+# ENABLE_ILLUSIONS
+# ENABLE_KINGDOM
+# ENABLE_KYRA
+# ENABLE_LOL
+# ENABLE_EOB
+# ENABLE_LAB
+# ENABLE_LASTEXPRESS
+# ENABLE_LILLIPUT
+# ENABLE_LURE
+# ENABLE_MACVENTURE
+# ENABLE_MADE
+# ENABLE_MADS
+# ENABLE_MADSV2
+# ENABLE_MOHAWK
+# ENABLE_CSTIME
+# ENABLE_RIVEN
+# ENABLE_MYST
+# ENABLE_MYSTME
+# ENABLE_MORTEVIELLE
+# ENABLE_MTROPOLIS
+# ENABLE_MUTATIONOFJB
+# ENABLE_MYST3
+# ENABLE_NANCY
+# ENABLE_NEVERHOOD
+# ENABLE_NGI
+# ENABLE_PARALLACTION
+# ENABLE_PEGASUS
+# ENABLE_PETKA
+# ENABLE_PINK
+# ENABLE_PLAYGROUND3D
+# ENABLE_PLUMBERS
+# ENABLE_PRINCE
+# ENABLE_PRIVATE
+# ENABLE_QUEEN
+# ENABLE_SAGA
+# ENABLE_IHNM
+# ENABLE_SAGA2
+# ENABLE_SCI
+# ENABLE_SCI32
+ENABLE_SCUMM = STATIC_PLUGIN
+ENABLE_SCUMM_7_8 = 1
+# ENABLE_HE
+# ENABLE_SHERLOCK
+# ENABLE_SKY
+# ENABLE_SLUDGE
+# ENABLE_STARK
+# ENABLE_STARTREK
+# ENABLE_SUPERNOVA
+# ENABLE_SWORD1
+# ENABLE_SWORD2
+# ENABLE_SWORD25
+# ENABLE_TEENAGENT
+# ENABLE_TESTBED
+# ENABLE_TINSEL
+# ENABLE_TITANIC
+# ENABLE_TOLTECS
+# ENABLE_TONY
+# ENABLE_TOON
+# ENABLE_TOUCHE
+# ENABLE_TRECISION
+# ENABLE_TSAGE
+# ENABLE_TUCKER
+# ENABLE_TWINE
+# ENABLE_ULTIMA
+# ENABLE_VOYEUR
+# ENABLE_WAGE
+# ENABLE_WINTERMUTE
+# ENABLE_WME3D
+# ENABLE_FOXTAIL
+# ENABLE_HEROCRAFT
+# ENABLE_XEEN
+# ENABLE_ZVISION
+
+INCLUDES += -I/usr/include/libpng16    
+OBJS += 
+DEFINES += -DUSE_NULL_DRIVER -DPOSIX -DHAS_POSIX_SPAWN -DHAS_PTHREADS -DHAS_MMAP -DHAS_FSEEKO_OFFT_64 -DDATA_PATH=\"${datarootdir}/scummvm\" -DPLUGIN_DIRECTORY=\"${exec_prefix}/lib/scummvm\"
+LDFLAGS += 
+
+PLUGIN_LDFLAGS = 
+
+
+port_mk = ports.mk
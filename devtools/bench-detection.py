@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+
+# This script times "scummvm --detect --recursive" on a synthetic directory
+# tree, with the detection files hashed on one thread and prefetched on one
+# thread per core (the detection_threads setting), and checks that both give
+# the same output.
+#
+# Only files whose names the detection entries of the engines built into
+# the given binary list get hashed, so pass such names with --names. Every
+# run starts with an empty detection.cache; the files themselves are read
+# once before timing so that they are in the OS cache for all runs.
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+parser = argparse.ArgumentParser()
+parser.add_argument('scummvm', help="The ScummVM binary")
+parser.add_argument('-d', '--dirs', type=int, default=64, help="Number of game directories (default 64)")
+parser.add_argument('-s', '--size', type=int, default=1024 * 1024, help="Size of every file in bytes (default 1 MiB)")
+parser.add_argument('-n', '--names', default="resource.map,resource.000,resource.001,data.000,data.001,game.dat",
+	help="Comma separated file names created in every directory")
+parser.add_argument('-r', '--runs', type=int, default=3, help="Runs per setting, the fastest one is reported (default 3)")
+parser.add_argument('-t', '--threads', default="1,0", help="Comma separated detection_threads settings (default 1,0)")
+args = parser.parse_args()
+
+work = tempfile.mkdtemp(prefix='scummvm-bench-detection-')
+try:
+	tree = os.path.join(work, 'games')
+	names = args.names.split(',')
+	for d in range(args.dirs):
+		# Two levels, like a folder of game collections
+		path = os.path.join(tree, 'set%02d' % (d // 8), 'game%03d' % d)
+		os.makedirs(path)
+		for i, name in enumerate(names):
+			with open(os.path.join(path, name), 'wb') as f:
+				f.write(bytes([(d * 31 + i * 7 + j) & 0xFF for j in range(256)]) * (args.size // 256))
+
+	for root, dirs, files in os.walk(tree):
+		for name in files:
+			with open(os.path.join(root, name), 'rb') as f:
+				while f.read(1 << 20):
+					pass
+
+	outputs = {}
+	for threads in args.threads.split(','):
+		best = None
+		for run in range(args.runs):
+			cache = os.path.join(work, 'cache')
+			shutil.rmtree(cache, ignore_errors=True)
+			os.makedirs(cache)
+			config = os.path.join(work, 'scummvm.ini')
+			with open(config, 'w') as f:
+				f.write('[scummvm]\ncachepath=%s\ndetection_threads=%s\n' % (cache, threads))
+
+			start = time.time()
+			result = subprocess.run([args.scummvm, '--config=' + config, '--detect', '--recursive', '--path=' + tree],
+				stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+			elapsed = time.time() - start
+			if result.returncode != 0:
+				sys.exit('scummvm failed with exit code %d' % result.returncode)
+			outputs[threads] = result.stdout
+			best = elapsed if best is None else min(best, elapsed)
+
+		label = 'one thread per core' if threads == '0' else '%s thread(s)' % threads
+		print('detection %-24s %8.1f ms' % (label, best * 1000))
+
+	if len(set(outputs.values())) > 1:
+		sys.exit('The detection output differs between the thread settings')
+finally:
+	shutil.rmtree(work)
@@ -30,6 +30,7 @@
 #include "common/textconsole.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
+#include "common/workerpool.h"
 #include "gui/EventRecorder.h"
 #include "gui/gui-manager.h"
 #include "gui/message.h"
@@ -513,6 +514,162 @@ namespace Common {
 	DECLARE_SINGLETON(MD5CacheManager);
 }
 
+#define DETECTION_CACHE_VERSION 2
+
+MD5CacheManager::~MD5CacheManager() {
+	flush(true);
+	delete _hashPool;
+}
+
+bool MD5CacheManager::getPersistentNode(Common::FSNode &node) const {
+	if (!ConfMan.hasKey("cachepath") || ConfMan.get("cachepath").empty())
+		return false;
+
+	node = Common::FSNode(ConfMan.get("cachepath")).getChild("detection.cache");
+	return true;
+}
+
+void MD5CacheManager::loadPersistent() {
+	_persistentLoaded = true;
+
+	Common::FSNode node;
+	if (!getPersistentNode(node) || !node.exists())
+		return;
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream(node.createReadStream());
+	if (!stream)
+		return;
+
+	if (stream->readUint32BE() != MKTAG('A', 'D', 'M', 'D') || stream->readUint32LE() != DETECTION_CACHE_VERSION)
+		return;
+
+	const uint32 scan = stream->readUint32LE();
+	for (uint32 entries = stream->readUint32LE(); entries > 0 && !stream->eos(); --entries) {
+		const Common::String key = stream->readString(0, stream->readUint16LE());
+
+		PersistentEntry entry;
+		entry.mtime = stream->readSint64LE();
+		entry.size = stream->readSint64LE();
+		entry.md5 = stream->readString(0, stream->readUint16LE());
+		entry.lastScan = stream->readUint32LE();
+
+		// Don't use anything of a truncated file
+		if (stream->eos() || stream->err()) {
+			_persistentMap.clear();
+			return;
+		}
+		_persistentMap[key] = entry;
+	}
+
+	// This run is the next scan
+	_scan = scan + 1;
+}
+
+bool MD5CacheManager::getPersistent(const Common::String &key, int64 mtime, int64 size, FileProperties &fileProps) {
+	Common::StackLock lock(_persistentMutex);
+
+	if (!_persistentLoaded)
+		loadPersistent();
+
+	PersistentMap::iterator i = _persistentMap.find(key);
+	if (i == _persistentMap.end() || i->_value.mtime != mtime || i->_value.size != size)
+		return false;
+
+	// Keep the entry, the file still exists
+	if (i->_value.lastScan != _scan) {
+		i->_value.lastScan = _scan;
+		_persistentDirty = true;
+	}
+
+	// The entries are used on several threads, and the reference counts
+	// of strings aren't atomic, so don't let them share any storage
+	fileProps.size = i->_value.size;
+	fileProps.md5 = Common::String(i->_value.md5.c_str());
+	return true;
+}
+
+void MD5CacheManager::setPersistent(const Common::String &key, int64 mtime, const FileProperties &fileProps) {
+	Common::StackLock lock(_persistentMutex);
+
+	if (!_persistentLoaded)
+		loadPersistent();
+
+	PersistentEntry &entry = _persistentMap[Common::String(key.c_str())];
+	entry.mtime = mtime;
+	entry.size = fileProps.size;
+	entry.md5 = Common::String(fileProps.md5.c_str());
+	entry.lastScan = _scan;
+	_persistentDirty = true;
+}
+
+void MD5CacheManager::preloadPersistent() {
+	Common::StackLock lock(_persistentMutex);
+
+	if (!_persistentLoaded)
+		loadPersistent();
+}
+
+void MD5CacheManager::flush(bool force) {
+	Common::StackLock lock(_persistentMutex);
+
+	if (!_persistentDirty)
+		return;
+
+	const uint32 time = g_system->getMillis();
+	if (!force && time - _lastFlush < 10000)
+		return;
+
+	Common::FSNode node;
+	if (!getPersistentNode(node))
+		return;
+
+	// Drop the files which have not been seen for a while, they have been
+	// removed or changed, or their directory is not scanned any more
+	for (PersistentMap::iterator i = _persistentMap.begin(); i != _persistentMap.end(); ++i) {
+		if (_scan - i->_value.lastScan >= kMaxUnusedScans)
+			_persistentMap.erase(i);
+	}
+
+	// Written to a temporary file which then replaces the cache, so that
+	// other instances never read a partly written cache
+	const Common::FSNode tempNode = node.getParent().getChild(node.getName() + ".tmp");
+	Common::ScopedPtr<Common::WriteStream> stream(tempNode.createWriteStream());
+	if (!stream)
+		return;
+
+	stream->writeUint32BE(MKTAG('A', 'D', 'M', 'D'));
+	stream->writeUint32LE(DETECTION_CACHE_VERSION);
+	stream->writeUint32LE(_scan);
+	stream->writeUint32LE(_persistentMap.size());
+	for (PersistentMap::const_iterator i = _persistentMap.begin(); i != _persistentMap.end(); ++i) {
+		stream->writeUint16LE(i->_key.size());
+		stream->writeString(i->_key);
+		stream->writeSint64LE(i->_value.mtime);
+		stream->writeSint64LE(i->_value.size);
+		stream->writeUint16LE(i->_value.md5.size());
+		stream->writeString(i->_value.md5);
+		stream->writeUint32LE(i->_value.lastScan);
+	}
+	stream->finalize();
+	const bool written = !stream->err();
+	stream.reset();
+	if (!written || !tempNode.renameTo(node))
+		return;
+
+	_persistentDirty = false;
+	_lastFlush = time;
+}
+
+Common::WorkerPool *MD5CacheManager::getHashPool() {
+	if (!_hashPool) {
+		// Hashing is mostly waiting for the disk, so use one thread per
+		// core by default even if that is more than the work needs
+		const int threads = ConfMan.hasKey("detection_threads") ? MAX(ConfMan.getInt("detection_threads"), 0) : 0;
+		_hashPool = new Common::WorkerPool(threads);
+	}
+	return _hashPool;
+}
+
 // Sync with engines/game.cpp
 static char flagsToMD5Prefix(uint32 flags) {
 	if (flags & ADGF_MACRESFORK) {
@@ -528,6 +685,25 @@ static char flagsToMD5Prefix(uint32 flags) {
 
 static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, const ADGameDescription &game, const Common::String &fname, FileProperties &fileProps);
 
+/**
+ * Return the key of a plain file in the persistent MD5 cache, or an empty
+ * string if the file can't be cached persistently. The modification time
+ * and size which the cache entry has to match are returned as well.
+ */
+static Common::String getPersistentMD5Key(const AdvancedMetaEngine::FileMap &allFiles, uint32 flags, const Common::String &fname, uint md5Bytes, int64 &mtime, int64 &size) {
+	// Resource forks can come from several files, which are not tracked
+	if ((flags & ADGF_MACRESFORK) || !allFiles.contains(fname))
+		return Common::String();
+
+	const Common::FSNode &node = allFiles[fname];
+	mtime = node.getModificationTime();
+	size = node.getFileSize();
+	if (!mtime || size < 0)
+		return Common::String();
+
+	return Common::String::format("%c:%u:%s", flagsToMD5Prefix(flags), md5Bytes, node.getPath().c_str());
+}
+
 bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, const ADGameDescription &game, const Common::String &fname, FileProperties &fileProps) const {
 	Common::String hashname = Common::String::format("%c:%s:%d", flagsToMD5Prefix(game.flags), fname.c_str(), _md5Bytes);
 
@@ -537,7 +713,15 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, con
 		return true;
 	}
 
-	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, game, fname, fileProps);
+	int64 mtime = 0, size = 0;
+	const Common::String persistentKey = getPersistentMD5Key(allFiles, game.flags, fname, _md5Bytes, mtime, size);
+	bool res = !persistentKey.empty() && MD5Man.getPersistent(persistentKey, mtime, size, fileProps);
+
+	if (!res) {
+		res = getFilePropertiesIntern(_md5Bytes, allFiles, game, fname, fileProps);
+		if (res && !persistentKey.empty())
+			MD5Man.setPersistent(persistentKey, mtime, fileProps);
+	}
 
 	if (res) {
 		MD5Man.setMD5(hashname, fileProps.md5);
@@ -547,6 +731,143 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, con
 	return res;
 }
 
+enum {
+	// The most files hashed at once, as many as the widest MD5 vector lanes
+	kMaxHashBatch = 8
+};
+
+struct FileHashJob {
+	Common::FSNode node;
+	bool tail;
+	Common::String hashname;
+	Common::String persistentKey;
+	int64 mtime;
+	FileProperties fileProps;
+	bool success;
+};
+
+struct FileHashJobs {
+	Common::Array<FileHashJob> jobs;
+	uint md5Bytes;
+	uint batchSize;
+};
+
+static void hashFiles(void *data, uint batch) {
+	FileHashJobs *hashJobs = (FileHashJobs *)data;
+	const uint first = batch * hashJobs->batchSize;
+	const uint last = MIN<uint>(first + hashJobs->batchSize, hashJobs->jobs.size());
+
+	Common::Array<Common::ReadStream *> streams;
+	Common::Array<FileHashJob *> opened;
+	for (uint i = first; i < last; ++i) {
+		FileHashJob &job = hashJobs->jobs[i];
+		job.success = false;
+
+		Common::SeekableReadStream *stream = job.node.createReadStream();
+		if (!stream)
+			continue;
+
+		// Like getFilePropertiesIntern()
+		if (job.tail && stream->size() > hashJobs->md5Bytes)
+			stream->seek(-(int64)hashJobs->md5Bytes, SEEK_END);
+
+		job.fileProps.size = stream->size();
+		streams.push_back(stream);
+		opened.push_back(&job);
+	}
+
+	// All the files of a batch are hashed together in vector lanes
+	Common::Array<Common::String> md5s(streams.size());
+	Common::computeStreamsMD5AsString(streams.data(), streams.size(), md5s.data(), hashJobs->md5Bytes);
+
+	for (uint i = 0; i < streams.size(); ++i) {
+		delete streams[i];
+		opened[i]->fileProps.md5 = md5s[i];
+		opened[i]->success = true;
+	}
+}
+
+void AdvancedMetaEngineDetection::computeFileProperties(const FileMap &allFiles, bool inBackground) const {
+	FileHashJobs hashJobs;
+	hashJobs.md5Bytes = _md5Bytes;
+
+	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> queued;
+	for (const byte *descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
+		const ADGameDescription *g = (const ADGameDescription *)descPtr;
+
+		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			const Common::String fname = fileDesc->fileName;
+			const Common::String hashname = Common::String::format("%c:%s:%d", flagsToMD5Prefix(g->flags), fname.c_str(), _md5Bytes);
+			// The in-memory cache belongs to the main thread
+			if (queued.contains(hashname) || (!inBackground && MD5Man.contains(hashname)))
+				continue;
+			queued[hashname] = true;
+
+			FileHashJob job;
+			int64 size = 0;
+			job.persistentKey = getPersistentMD5Key(allFiles, g->flags, fname, _md5Bytes, job.mtime, size);
+			if (job.persistentKey.empty() || allFiles[fname].isDirectory())
+				continue;
+
+			if (MD5Man.getPersistent(job.persistentKey, job.mtime, size, job.fileProps)) {
+				if (!inBackground) {
+					MD5Man.setMD5(hashname, job.fileProps.md5);
+					MD5Man.setSize(hashname, job.fileProps.size);
+				}
+				continue;
+			}
+
+			job.node = allFiles[fname];
+			job.tail = (g->flags & ADGF_TAILMD5) != 0;
+			job.hashname = hashname;
+			hashJobs.jobs.push_back(job);
+		}
+	}
+
+	if (inBackground) {
+		hashJobs.batchSize = kMaxHashBatch;
+		for (uint i = 0; i * kMaxHashBatch < hashJobs.jobs.size(); ++i)
+			hashFiles(&hashJobs, i);
+
+		for (uint i = 0; i < hashJobs.jobs.size(); ++i) {
+			if (hashJobs.jobs[i].success)
+				MD5Man.setPersistent(hashJobs.jobs[i].persistentKey, hashJobs.jobs[i].mtime, hashJobs.jobs[i].fileProps);
+		}
+		return;
+	}
+
+	// A single file is hashed by getFileProperties() just as fast
+	if (hashJobs.jobs.size() <= 1)
+		return;
+
+	// Give every thread a batch, rather than batching on fewer threads
+	Common::WorkerPool *pool = MD5Man.getHashPool();
+	hashJobs.batchSize = CLIP<uint>(hashJobs.jobs.size() / pool->getThreadCount(), 1, kMaxHashBatch);
+	pool->parallelFor((hashJobs.jobs.size() + hashJobs.batchSize - 1) / hashJobs.batchSize, hashFiles, &hashJobs);
+
+	for (uint i = 0; i < hashJobs.jobs.size(); ++i) {
+		const FileHashJob &job = hashJobs.jobs[i];
+		if (!job.success)
+			continue;
+
+		MD5Man.setMD5(job.hashname, job.fileProps.md5);
+		MD5Man.setSize(job.hashname, job.fileProps.size);
+		MD5Man.setPersistent(job.persistentKey, job.mtime, job.fileProps);
+	}
+}
+
+void AdvancedMetaEngineDetection::prefetchDetectionFiles(const Common::FSList &fslist) {
+	// Only the first call, which is made on the main thread, changes anything
+	preprocessDescriptions();
+
+	if (fslist.empty())
+		return;
+
+	FileMap allFiles;
+	composeFileHashMap(allFiles, fslist, (_maxScanDepth == 0 ? 1 : _maxScanDepth));
+	computeFileProperties(allFiles, true);
+}
+
 bool AdvancedMetaEngine::getFilePropertiesExtern(uint md5Bytes, const FileMap &allFiles, const ADGameDescription &game, const Common::String &fname, FileProperties &fileProps) const {
 	return getFilePropertiesIntern(md5Bytes, allFiles, game, fname, fileProps);
 }
@@ -606,6 +927,9 @@ ADDetectedGames AdvancedMetaEngineDetection::detectGame(const Common::FSNode &pa
 
 	preprocessDescriptions();
 
+	// Hash the files which aren't cached at once, as far as possible
+	computeFileProperties(allFiles);
+
 	// Check which files are included in some ADGameDescription *and* whether
 	// they are present. Compute MD5s and file sizes for the available files.
 	for (descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
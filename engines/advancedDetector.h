@@ -26,12 +26,15 @@
 #include "engines/engine.h"
 
 #include "common/hash-str.h"
+#include "common/mutex.h"
 
 #include "common/gui_options.h" // FIXME: Temporary hack?
 
 namespace Common {
 class Error;
 class FSList;
+class FSNode;
+class WorkerPool;
 }
 /**
  * @defgroup engines_advdetector Advanced Detector
@@ -357,6 +360,12 @@ public:
 	 */
 	DetectedGames detectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) override;
 
+	/**
+	 * Compute the properties of the files of @p fslist which are described
+	 * by the detection entries, and store them in the persistent MD5 cache.
+	 */
+	void prefetchDetectionFiles(const Common::FSList &fslist) override;
+
 	/**
 	 * A generic createInstance.
 	 *
@@ -442,6 +451,16 @@ protected:
 	/** Get the properties (size and MD5) of this file. */
 	bool getFileProperties(const FileMap &allFiles, const ADGameDescription &game, const Common::String &fname, FileProperties &fileProps) const;
 
+	/**
+	 * Compute the properties of all the files in @p allFiles which are
+	 * described by the detection entries and aren't cached yet, on several
+	 * threads. getFileProperties() then finds them in the cache.
+	 *
+	 * With @p inBackground set, only the persistent cache is used and the
+	 * files are hashed on the calling thread, which may be any thread.
+	 */
+	void computeFileProperties(const FileMap &allFiles, bool inBackground = false) const;
+
 	/** Convert an AD game description into the shared game description format. */
 	virtual DetectedGame toDetectedGame(const ADDetectedGame &adGame, ADDetectedGameExtraInfo *extraInfo = nullptr) const;
 
@@ -542,6 +561,11 @@ protected:
 
 /**
  * Singleton Cache Storage for Computed MD5s
+ *
+ * Besides the MD5s computed during the current detection, the properties of
+ * plain files are kept across runs in the cache directory, keyed by their
+ * path. Those entries are dropped when the modification time of the file
+ * changes.
  */
 class MD5CacheManager : public Common::Singleton<MD5CacheManager> {
 public:
@@ -565,15 +589,46 @@ public:
 		return (md5HashMap.contains(fname) && sizeHashMap.contains(fname));
 	}
 
-	MD5CacheManager() {
+	MD5CacheManager() : _persistentLoaded(false), _persistentDirty(false), _lastFlush(0), _scan(0), _hashPool(nullptr) {
 		clear();
 	}
 
+	~MD5CacheManager();
+
 	void clear() {
 		md5HashMap.clear(true);
 		sizeHashMap.clear(true);
 	}
 
+	/**
+	 * Look up the properties of a file in the persistent cache.
+	 *
+	 * @param key    Identifies the file and the way it is hashed.
+	 * @param mtime  The modification time of the file.
+	 * @param size   The size of the file.
+	 */
+	bool getPersistent(const Common::String &key, int64 mtime, int64 size, FileProperties &fileProps);
+
+	/** Store the properties of a file in the persistent cache. */
+	void setPersistent(const Common::String &key, int64 mtime, const FileProperties &fileProps);
+
+	/**
+	 * Load the persistent cache if it isn't loaded yet. This has to be done
+	 * on the main thread before the cache is used by other threads.
+	 */
+	void preloadPersistent();
+
+	/**
+	 * Write the persistent cache to disk if it changed. Unless @p force is
+	 * set, this is only done every few seconds, so that mass add doesn't
+	 * rewrite it for every directory. The entries of files which were not
+	 * looked up during the last kMaxUnusedScans runs are dropped.
+	 */
+	void flush(bool force = false);
+
+	/** Return the pool used for hashing files which aren't cached. */
+	Common::WorkerPool *getHashPool();
+
 private:
 	friend class Common::Singleton<MD5CacheManager>;
 
@@ -581,6 +636,31 @@ private:
 	typedef Common::HashMap<Common::String, int64, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SizeHashMap;
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
+
+	enum {
+		/** The number of runs which used the cache an entry is kept for without being looked up. */
+		kMaxUnusedScans = 16
+	};
+
+	struct PersistentEntry {
+		int64 mtime;
+		int64 size;
+		Common::String md5;
+		uint32 lastScan;	///< The last run which looked the file up
+	};
+
+	typedef Common::HashMap<Common::String, PersistentEntry> PersistentMap;
+
+	void loadPersistent();
+	bool getPersistentNode(Common::FSNode &node) const;
+
+	PersistentMap _persistentMap;
+	Common::Mutex _persistentMutex;
+	bool _persistentLoaded;
+	bool _persistentDirty;
+	uint32 _lastFlush;
+	uint32 _scan;	///< Counts the runs which loaded the cache
+	Common::WorkerPool *_hashPool;
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
@@ -0,0 +1,177 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engines/detectionPrefetcher.h"
+#include "engines/advancedDetector.h"
+#include "engines/metaengine.h"
+
+#include "base/plugins.h"
+
+#include "common/config-manager.h"
+#include "common/system.h"
+#include "common/thread.h"
+
+enum {
+	// How many directories may be prefetched before the detection gets
+	// there. This keeps the threads from hashing a whole disk in advance
+	// when the user cancels a mass add.
+	kMaxLookahead = 32
+};
+
+DetectionPrefetcher::DetectionPrefetcher(const Common::FSNode &root) : _mutex(nullptr),
+	_workAvailable(nullptr), _directoryDone(nullptr), _prefetched(0), _quit(false) {
+	int numThreads = ConfMan.hasKey("detection_threads") ? MAX(ConfMan.getInt("detection_threads"), 0) : 0;
+	if (numThreads == 0)
+		numThreads = g_system->getCPUCount();
+	if (numThreads <= 1)
+		return;
+
+	_workAvailable = g_system->createConditionVariable();
+	_directoryDone = g_system->createConditionVariable();
+	if (!_workAvailable || !_directoryDone)
+		return;
+	_mutex = g_system->createMutex();
+
+	// Get everything the threads share ready on this thread
+	const PluginList &plugins = EngineMan.getPlugins(PLUGIN_TYPE_ENGINE_DETECTION);
+	for (PluginList::const_iterator i = plugins.begin(); i != plugins.end(); ++i) {
+		MetaEngineDetection &metaEngine = (*i)->get<MetaEngineDetection>();
+		metaEngine.prefetchDetectionFiles(Common::FSList());
+		_metaEngines.push_back(&metaEngine);
+	}
+	MD5Man.preloadPersistent();
+
+	const Common::String path = root.getPath();
+	_directories[Common::String(path.c_str())] = kQueued;
+	_queue.push_back(Common::String(path.c_str()));
+
+	// Command line detection runs before the backend is initialized
+	Common::String::initMemoryPoolMutex();
+
+	for (int i = 1; i < numThreads; ++i) {
+		Common::ThreadInternal *thread = g_system->createThread(workerEntry, this);
+		if (!thread)
+			break;
+		_threads.push_back(thread);
+	}
+}
+
+DetectionPrefetcher::~DetectionPrefetcher() {
+	if (!_threads.empty()) {
+		_mutex->lock();
+		_quit = true;
+		_workAvailable->broadcast();
+		_mutex->unlock();
+
+		for (uint i = 0; i < _threads.size(); ++i) {
+			_threads[i]->join();
+			delete _threads[i];
+		}
+	}
+
+	delete _workAvailable;
+	delete _directoryDone;
+	delete _mutex;
+}
+
+void DetectionPrefetcher::claimDirectory(const Common::FSNode &dir) {
+	if (_threads.empty())
+		return;
+
+	const Common::String path = dir.getPath();
+
+	_mutex->lock();
+	if (!_directories.contains(path)) {
+		// The threads haven't found it yet
+		_directories[Common::String(path.c_str())] = kClaimed;
+		_mutex->unlock();
+		return;
+	}
+
+	while (_directories[path] == kPrefetching)
+		_directoryDone->wait(_mutex);
+
+	if (_directories[path] == kQueued) {
+		_directories[path] = kClaimed;
+	} else if (_directories[path] == kPrefetched) {
+		_directories.erase(path);
+		--_prefetched;
+		_workAvailable->broadcast();
+	}
+	_mutex->unlock();
+}
+
+void DetectionPrefetcher::workerEntry(void *data) {
+	((DetectionPrefetcher *)data)->workerLoop();
+}
+
+void DetectionPrefetcher::workerLoop() {
+	_mutex->lock();
+	while (!_quit) {
+		if (_queue.empty() || _prefetched >= kMaxLookahead) {
+			_workAvailable->wait(_mutex);
+			continue;
+		}
+
+		const Common::String path = _queue.back();
+		_queue.pop_back();
+
+		// Claimed directories still have to be listed to find the ones below
+		const bool claimed = (_directories[path] == kClaimed);
+		if (!claimed)
+			_directories[path] = kPrefetching;
+		_mutex->unlock();
+
+		Common::FSNode dir(path);
+		Common::FSList files;
+		Common::StringArray subdirs;
+		if (dir.getChildren(files, Common::FSNode::kListAll)) {
+			for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
+				if (file->isDirectory())
+					subdirs.push_back(file->getPath());
+			}
+
+			if (!claimed) {
+				for (uint i = 0; i < _metaEngines.size(); ++i)
+					_metaEngines[i]->prefetchDetectionFiles(files);
+			}
+		}
+
+		_mutex->lock();
+		if (claimed) {
+			_directories.erase(path);
+		} else {
+			_directories[path] = kPrefetched;
+			++_prefetched;
+			_directoryDone->broadcast();
+		}
+
+		// Backwards, so that the first subdirectory is taken first
+		for (int i = (int)subdirs.size() - 1; i >= 0; --i) {
+			if (!_directories.contains(subdirs[i]))
+				_directories[Common::String(subdirs[i].c_str())] = kQueued;
+			_queue.push_back(Common::String(subdirs[i].c_str()));
+		}
+		if (!subdirs.empty())
+			_workAvailable->broadcast();
+	}
+	_mutex->unlock();
+}
@@ -0,0 +1,98 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ENGINES_DETECTION_PREFETCHER_H
+#define ENGINES_DETECTION_PREFETCHER_H
+
+#include "common/array.h"
+#include "common/fs.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+
+namespace Common {
+class ConditionVariableInternal;
+class MutexInternal;
+class ThreadInternal;
+}
+
+class MetaEngineDetection;
+
+/**
+ * Walks a directory tree on background threads ahead of a recursive game
+ * detection, and lets the detection plugins hash the files they would look
+ * at, so that the detection finds the hashes in the persistent MD5 cache.
+ *
+ * The games are still detected on the main thread, one directory after
+ * the other, because the detection code of the engines is not thread safe.
+ * That also keeps the order of the results the same as without threads.
+ *
+ * The threads visit the directories depth first, and the subdirectories
+ * in the order they are listed in, which is what the detection should do
+ * as well to get the most out of them.
+ *
+ * Uses one thread less than the detection_threads setting says, as the
+ * main thread is busy too. Without threads nothing is done.
+ */
+class DetectionPrefetcher {
+public:
+	/** Start walking the tree below @p root. Has to be called on the main thread. */
+	explicit DetectionPrefetcher(const Common::FSNode &root);
+	~DetectionPrefetcher();
+
+	/**
+	 * Tell the threads that the games in @p dir are about to be detected.
+	 *
+	 * This waits if a thread is prefetching the directory, and makes sure
+	 * none starts on it later.
+	 */
+	void claimDirectory(const Common::FSNode &dir);
+
+private:
+	enum DirectoryState {
+		kQueued,      ///< Found by the threads, and not listed yet
+		kPrefetching, ///< A thread is working on it
+		kPrefetched,  ///< Ready for the detection
+		kClaimed      ///< The detection got there first, only list it
+	};
+
+	typedef Common::HashMap<Common::String, DirectoryState> DirectoryMap;
+
+	static void workerEntry(void *data);
+	void workerLoop();
+
+	Common::Array<MetaEngineDetection *> _metaEngines;
+	Common::Array<Common::ThreadInternal *> _threads;
+	Common::MutexInternal *_mutex;
+	Common::ConditionVariableInternal *_workAvailable;
+	Common::ConditionVariableInternal *_directoryDone;
+
+	/*
+	 * Guarded by _mutex. As the reference counts of strings aren't atomic,
+	 * paths are copied with their own storage when they go to another
+	 * thread.
+	 */
+	Common::StringArray _queue;
+	DirectoryMap _directories;
+	uint _prefetched;
+	bool _quit;
+};
+
+#endif
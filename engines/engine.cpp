@@ -183,6 +183,9 @@ Engine::Engine(OSystem *syst)
 Engine::~Engine() {
 	_mixer->stopAll();
 
+	// The completion procs of the saves may use the engine
+	_saveFileMan->waitForPendingSaves();
+
 	delete _debugger;
 	delete _mainMenuDialog;
 	g_engine = NULL;
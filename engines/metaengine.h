@@ -163,6 +163,18 @@ public:
 	 */
 	virtual DetectedGames detectGames(const Common::FSList &fslist, uint32 skipADFlags = 0, bool skipIncomplete = false) = 0;
 
+	/**
+	 * Compute in advance what detectGames() would need to read from the
+	 * given files, so that detecting games in them later is fast.
+	 *
+	 * Unlike detectGames(), this may be called from any thread, and from
+	 * several threads at once. The first call has to be made on the main
+	 * thread though, and may get an empty list just to get ready.
+	 *
+	 * The default implementation does nothing.
+	 */
+	virtual void prefetchDetectionFiles(const Common::FSList &fslist) {}
+
 	/** Returns the number of bytes used for MD5-based detection, or 0 if not supported. */
 	virtual uint getMD5Bytes() const = 0;
 
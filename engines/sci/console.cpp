@@ -118,6 +118,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
+	registerCmd("resource_stats",		WRAP_METHOD(Console, cmdResourceStats));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
 	registerCmd("integrity_dump",	WRAP_METHOD(Console, cmdResourceIntegrityDump));
@@ -357,6 +358,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_types - Shows the valid resource types\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
+	debugPrintf(" resource_stats - Shows how the resources of each type have been loaded and cached\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
 	debugPrintf(" integrity_dump - Dumps integrity data about resources in the current game to disk\n");
@@ -1067,6 +1069,23 @@ bool Console::cmdAllocList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceStats(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	debugPrintf("LRU: %d of %d bytes, locked: %d bytes\n", resMan->getMemoryLRU(), resMan->getMaxMemoryLRU(), resMan->getMemoryLocked());
+	debugPrintf("%-12s %8s %8s %10s %9s %12s\n", "Type", "Hits", "Loads", "Prefetches", "Evictions", "Bytes loaded");
+	for (int i = 0; i < kResourceTypeInvalid; ++i) {
+		const ResourceManager::TypeStats &stats = resMan->getTypeStats((ResourceType)i);
+		if (!stats.hits && !stats.loads && !stats.prefetches)
+			continue;
+
+		debugPrintf("%-12s %8u %8u %10u %9u %12u\n", getResourceTypeName((ResourceType)i),
+					stats.hits, stats.loads, stats.prefetches, stats.evictions, (uint)stats.bytesLoaded);
+	}
+
+	return true;
+}
+
 bool Console::cmdDissectScript(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Examines a script\n");
@@ -271,6 +271,11 @@ reg_t kScriptID(EngineState *s, int argc, reg_t *argv) {
 	if (argv[0].getSegment())
 		return argv[0];
 
+	// The game is about to enter this room, let its resources decompress
+	// while its script gets loaded and initialized
+	if (script == s->currentRoomNumber())
+		g_sci->getResMan()->prefetchRoom(script);
+
 	SegmentId scriptSeg = s->_segMan->getScriptSegment(script, SCRIPT_GET_LOAD);
 
 	if (!scriptSeg)
@@ -72,6 +72,40 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	_instructionIndex.clear();
+	_instructions.clear();
+	for (uint i = 0; i < _sendCaches.size(); ++i)
+		delete _sendCaches[i];
+	_sendCaches.clear();
+}
+
+PMachineInstruction Script::getInstruction(uint32 offset) {
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(getBufSize());
+
+	const uint16 index = _instructionIndex[offset];
+	if (index)
+		return _instructions[index - 1];
+
+	PMachineInstruction instruction;
+	instruction.size = readPMachineInstruction(getBuf(offset), instruction.extOpcode, instruction.opparams);
+	instruction.sendCache = 0;
+
+	// The indices have to fit in 16 bits, further instructions are decoded
+	// every time they are run
+	if (_instructions.size() >= 0xFFFF)
+		return instruction;
+
+	const byte opcode = instruction.extOpcode >> 1;
+	if ((opcode == op_send || opcode == op_self || opcode == op_super) && _sendCaches.size() < 0xFFFF) {
+		_sendCaches.push_back(new SendCache());
+		instruction.sendCache = _sendCaches.size();
+	}
+
+	_instructions.push_back(instruction);
+	_instructionIndex[offset] = _instructions.size();
+	return instruction;
 }
 
 enum {
@@ -93,6 +93,15 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	/**
+	 * For every byte of the buffer, 1 + the index of the instruction decoded
+	 * at that offset in _instructions, or 0 if it hasn't been decoded yet.
+	 * Allocated when the first instruction is decoded.
+	 */
+	Common::Array<uint16> _instructionIndex;
+	Common::Array<PMachineInstruction> _instructions;
+	Common::Array<SendCache *> _sendCaches; /**< The caches of the send sites decoded so far */
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -279,6 +288,21 @@ public:
 	 */
 	int getCodeBlockOffset() { return _codeOffset; }
 
+	/**
+	 * Returns the instruction at the given offset of the buffer, like
+	 * readPMachineInstruction() decodes it. Every instruction is only
+	 * decoded once while the script stays loaded.
+	 */
+	PMachineInstruction getInstruction(uint32 offset);
+
+	/**
+	 * Returns the cache of a send, self or super instruction
+	 * returned by getInstruction(), or nullptr for other instructions.
+	 */
+	SendCache *getSendCache(const PMachineInstruction &instruction) const {
+		return instruction.sendCache ? _sendCaches[instruction.sendCache - 1] : nullptr;
+	}
+
 	/**
 	 * Get the offset array
 	 */
@@ -39,6 +39,8 @@ SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
 	_nodesSegId = 0;
 	_hunksSegId = 0;
 
+	_objectGeneration = 1;
+
 	_saveDirPtr = NULL_REG;
 	_parserPtr = NULL_REG;
 
@@ -79,6 +81,8 @@ void SegManager::resetSegMan() {
 	// Reinitialize class table
 	_classTable.clear();
 	createClassTable();
+
+	invalidateObjectCaches();
 }
 
 void SegManager::initSysStrings() {
@@ -181,6 +185,9 @@ void SegManager::deallocate(SegmentId seg) {
 
 	delete mobj;
 	_heap[actualSegment] = NULL;
+
+	// Lookups may have found objects in the segment, or the script's methods
+	invalidateObjectCaches();
 }
 
 bool SegManager::isHeapObject(reg_t pos) const {
@@ -1092,6 +1099,10 @@ int SegManager::instantiateScript(int scriptNum, bool applyScriptPatches) {
 		scr = allocateScript(scriptNum, &segmentId);
 	}
 
+	// The script may replace one marked as deleted, and its classes change
+	// the superclass chains lookups have gone through
+	invalidateObjectCaches();
+
 	scr->load(scriptNum, _resMan, _scriptPatcher, applyScriptPatches);
 	scr->initializeLocals(this);
 	scr->initializeClasses(this);
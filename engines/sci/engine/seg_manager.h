@@ -62,6 +62,22 @@ public:
 
 	void saveLoadWithSerializer(Common::Serializer &ser) override;
 
+	/**
+	 * Returns a number which changes whenever objects may have gone away or
+	 * scripts have been (re)loaded, so that selector lookups done before may
+	 * no longer hold. Never 0.
+	 */
+	uint32 getObjectGeneration() const { return _objectGeneration; }
+
+	/**
+	 * Starts a new object generation, which invalidates the contents of
+	 * all send caches.
+	 */
+	void invalidateObjectCaches() {
+		if (++_objectGeneration == 0)
+			_objectGeneration = 1;
+	}
+
 	// 1. Scripts
 
 	/**
@@ -476,6 +492,8 @@ private:
 	SegmentId _nodesSegId; ///< ID of the (a) node segment
 	SegmentId _hunksSegId; ///< ID of the (a) hunk segment
 
+	uint32 _objectGeneration; ///< See getObjectGeneration()
+
 	// Statically allocated memory for system strings
 	reg_t _saveDirPtr;
 	reg_t _parserPtr;
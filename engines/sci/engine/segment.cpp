@@ -124,6 +124,9 @@ void CloneTable::freeAtAddress(SegManager *segMan, reg_t addr) {
 #endif
 
 	freeEntry(addr.getOffset());
+
+	// A new clone may take the address of this one
+	segMan->invalidateObjectCaches();
 }
 
 
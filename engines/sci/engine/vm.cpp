@@ -232,7 +232,43 @@ static void _exec_varselectors(EngineState *s) {
 }
 
 
-ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPtr sp, int framesize, StackPtr argp) {
+/**
+ * Looks up a selector like lookupSelector() does, with the results of earlier
+ * lookups at the same send site remembered in cache.
+ */
+static SelectorType lookupSelectorCached(SegManager *segMan, SendCache *cache, reg_t obj, Selector selector, ObjVarRef *varp, reg_t *funcp) {
+	if (!cache)
+		return lookupSelector(segMan, obj, selector, varp, funcp);
+
+	const uint32 generation = segMan->getObjectGeneration();
+	for (int i = 0; i < SendCache::kEntries; ++i) {
+		const SendCache::Entry &entry = cache->entries[i];
+		if (entry.generation == generation && entry.obj == obj && entry.selector == selector) {
+			if (entry.type == kSelectorVariable)
+				*varp = entry.varp;
+			else
+				*funcp = entry.funcp;
+			return entry.type;
+		}
+	}
+
+	const SelectorType type = lookupSelector(segMan, obj, selector, varp, funcp);
+	if (type != kSelectorNone) {
+		SendCache::Entry &entry = cache->entries[cache->next];
+		cache->next = (cache->next + 1) % SendCache::kEntries;
+		entry.generation = generation;
+		entry.obj = obj;
+		entry.selector = selector;
+		entry.type = type;
+		if (type == kSelectorVariable)
+			entry.varp = *varp;
+		else
+			entry.funcp = *funcp;
+	}
+	return type;
+}
+
+ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPtr sp, int framesize, StackPtr argp, SendCache *cache) {
 	// send_obj and work_obj are equal for anything but 'super'
 	// Returns a pointer to the TOS exec_stack element
 	assert(s);
@@ -258,7 +294,7 @@ ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPt
 		g_sci->_guestAdditions->sendSelectorHook(send_obj, selector, argp);
 #endif
 
-		SelectorType selectorType = lookupSelector(s->_segMan, send_obj, selector, &varp, &funcp);
+		SelectorType selectorType = lookupSelectorCached(s->_segMan, cache, send_obj, selector, &varp, &funcp);
 		if (selectorType == kSelectorNone)
 			error("Send to invalid selector 0x%x (%s) of object at %04x:%04x", 0xffff & selector, g_sci->getKernel()->getSelectorName(0xffff & selector).c_str(), PRINT_REG(send_obj));
 
@@ -545,7 +581,6 @@ void run_vm(EngineState *s) {
 	int temp;
 	reg_t r_temp; // Temporary register
 	StackPtr s_temp; // Temporary stack pointer
-	int16 opparams[4]; // opcode parameters
 
 	s->r_rest = 0;	// &rest adjusts the parameter count by this value
 	// Current execution data:
@@ -626,8 +661,10 @@ void run_vm(EngineState *s) {
 			s->xs->addr.pc.getOffset(), scr->getBufSize());
 
 		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		const PMachineInstruction instruction = scr->getInstruction(s->xs->addr.pc.getOffset());
+		s->xs->addr.pc.incOffset(instruction.size);
+		const byte extOpcode = instruction.extOpcode;
+		const int16 *opparams = instruction.opparams; // opcode parameters
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
@@ -969,7 +1006,8 @@ void run_vm(EngineState *s) {
 
 			s->xs->sp[1].incOffset(s->r_rest);
 			xs_new = send_selector(s, s->r_acc, s->r_acc, s_temp,
-									(int)(opparams[0] >> 1) + (uint16)s->r_rest, s->xs->sp);
+									(int)(opparams[0] >> 1) + (uint16)s->r_rest, s->xs->sp,
+									scr->getSendCache(instruction));
 
 			if (xs_new && xs_new != s->xs)
 				s->_executionStackPosChanged = true;
@@ -1016,7 +1054,7 @@ void run_vm(EngineState *s) {
 			s->xs->sp[1].incOffset(s->r_rest);
 			xs_new = send_selector(s, s->xs->objp, s->xs->objp,
 									s_temp, (int)(opparams[0] >> 1) + (uint16)s->r_rest,
-									s->xs->sp);
+									s->xs->sp, scr->getSendCache(instruction));
 
 			if (xs_new && xs_new != s->xs)
 				s->_executionStackPosChanged = true;
@@ -1045,7 +1083,7 @@ void run_vm(EngineState *s) {
 				s->xs->sp[1].incOffset(s->r_rest);
 				xs_new = send_selector(s, r_temp, s->xs->objp, s_temp,
 										(int)(opparams[1] >> 1) + (uint16)s->r_rest,
-										s->xs->sp);
+										s->xs->sp, scr->getSendCache(instruction));
 
 				if (xs_new && xs_new != s->xs)
 					s->_executionStackPosChanged = true;
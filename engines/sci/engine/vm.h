@@ -70,6 +70,42 @@ struct ObjVarRef {
 	reg_t* getPointer(SegManager *segMan) const;
 };
 
+/**
+ * Remembers the results of the last few selector lookups done at one send
+ * site. Entries are only valid as long as the generation they were made in
+ * matches SegManager::getObjectGeneration().
+ */
+struct SendCache {
+	enum {
+		kEntries = 4
+	};
+
+	struct Entry {
+		uint32 generation; ///< 0 for unused entries
+		reg_t obj;
+		Selector selector;
+		SelectorType type;
+		ObjVarRef varp;
+		reg_t funcp;
+	};
+
+	Entry entries[kEntries];
+	uint next; ///< The entry to replace next
+
+	SendCache() : next(0) {
+		for (int i = 0; i < kEntries; ++i)
+			entries[i].generation = 0;
+	}
+};
+
+/** An instruction as decoded by readPMachineInstruction(). */
+struct PMachineInstruction {
+	int16 opparams[4];
+	byte extOpcode;
+	uint16 size;
+	uint16 sendCache; ///< 1 + the index of the send cache of a send site, 0 if there is none
+};
+
 enum ExecStackType {
 	EXEC_STACK_TYPE_CALL = 0,
 	EXEC_STACK_TYPE_KERNEL = 1,
@@ -360,10 +396,12 @@ ExecStack *execute_method(EngineState *s, uint16 script, uint16 pubfunct,
  * 						[selector_number][argument_counter] and then
  * 						"argument_counter" word entries with the
  * 						parameter values.
+ * @param[in] cache		The lookup cache of the send site, or nullptr
+ * 						to look up every selector
  * @return				A pointer to the new execution stack TOS entry
  */
 ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj,
-	StackPtr sp, int framesize, StackPtr argp);
+	StackPtr sp, int framesize, StackPtr argp, SendCache *cache = nullptr);
 
 
 /**
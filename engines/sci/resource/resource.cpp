@@ -25,11 +25,13 @@
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/memstream.h"
+#include "common/system.h"
 #include "common/textconsole.h"
+#include "common/thread.h"
 #include "common/translation.h"
 #ifdef ENABLE_SCI32
 #include "common/compression/installshield_cab.h"
-#include "common/memstream.h"
 #endif
 
 #include "sci/engine/workarounds.h"
@@ -119,6 +121,35 @@ static const char *const s_errorDescriptions[] = {
 	"Decompression failed: Resource too big"
 };
 
+/** Returns nullptr for unsupported compression methods. */
+static Decompressor *createDecompressor(ResourceCompression compression) {
+	switch (compression) {
+	case kCompNone:
+		return new Decompressor;
+	case kCompHuffman:
+		return new DecompressorHuffman;
+	case kCompLZW:
+	case kCompLZW1:
+	case kCompLZW1View:
+	case kCompLZW1Pic:
+		return new DecompressorLZW(compression);
+	case kCompDCL:
+		return new DecompressorDCL;
+#ifdef ENABLE_SCI32
+	case kCompSTACpack:
+		return new DecompressorLZS;
+#endif
+	default:
+		return nullptr;
+	}
+}
+
+static bool isSupportedCompression(ResourceCompression compression) {
+	Decompressor *dec = createDecompressor(compression);
+	delete dec;
+	return dec != nullptr;
+}
+
 static const char *const s_resourceTypeNames[] = {
 	"view", "pic", "script", "text", "sound",
 	"memory", "vocab", "font", "cursor",
@@ -605,18 +636,7 @@ void ResourceSource::loadResource(ResourceManager *resMan, Resource *res) {
 	if (!fileStream)
 		return;
 
-	fileStream->seek(0, SEEK_SET);
-	ResourceType type = resMan->convertResType(fileStream->readByte());
-	ResVersion volVersion = resMan->getVolVersion();
-
-	// FIXME: if resource.msg has different version from SCI, this has to be modified.
-	if (
-		(
-			(type == kResourceTypeMessage && res->getType() == kResourceTypeMessage) ||
-			(type == kResourceTypeText && res->getType() == kResourceTypeText)
-		) &&
-		g_sci && g_sci->getLanguage() == Common::KO_KOR)
-		volVersion = kResVersionSci11;
+	const ResVersion volVersion = resMan->getResourceVolVersion(res, fileStream);
 	fileStream->seek(res->_fileOffset, SEEK_SET);
 
 	int error = res->decompress(volVersion, fileStream);
@@ -630,6 +650,22 @@ void ResourceSource::loadResource(ResourceManager *resMan, Resource *res) {
 	resMan->disposeVolumeFileStream(fileStream, this);
 }
 
+ResVersion ResourceManager::getResourceVolVersion(const Resource *res, Common::SeekableReadStream *fileStream) {
+	fileStream->seek(0, SEEK_SET);
+	const ResourceType type = convertResType(fileStream->readByte());
+
+	// FIXME: if resource.msg has different version from SCI, this has to be modified.
+	if (
+		(
+			(type == kResourceTypeMessage && res->getType() == kResourceTypeMessage) ||
+			(type == kResourceTypeText && res->getType() == kResourceTypeText)
+		) &&
+		g_sci && g_sci->getLanguage() == Common::KO_KOR)
+		return kResVersionSci11;
+
+	return _volVersion;
+}
+
 Resource *ResourceManager::testResource(const ResourceId &id) const {
 	return _resMap.getValOrDefault(id, NULL);
 }
@@ -1004,13 +1040,15 @@ void ResourceManager::freeResourceSources() {
 }
 
 ResourceManager::ResourceManager(const bool detectionMode) :
-	_detectionMode(detectionMode) {}
+	_detectionMode(detectionMode), _prefetchThread(nullptr), _prefetchMutex(nullptr),
+	_prefetchQueued(nullptr), _prefetchDone(nullptr), _prefetchQuit(false), _prefetchEnabled(false) {}
 
 void ResourceManager::init() {
 	_maxMemoryLRU = 256 * 1024; // 256KiB
 	_memoryLocked = 0;
 	_memoryLRU = 0;
 	_LRU.clear();
+	memset(_typeStats, 0, sizeof(_typeStats));
 	_resMap.clear();
 	_audioMapSCI1 = nullptr;
 #ifdef ENABLE_SCI32
@@ -1084,6 +1122,12 @@ void ResourceManager::init() {
 		_maxMemoryLRU = 4096 * 1024; // 4MiB
 	}
 
+	if (!_detectionMode) {
+		if (ConfMan.hasKey("sci_resource_cache_size"))
+			_maxMemoryLRU = CLIP<int>(ConfMan.getInt("sci_resource_cache_size"), 0, INT_MAX / 1024) * 1024;
+		_prefetchEnabled = ConfMan.hasKey("sci_resource_prefetch") && ConfMan.getBool("sci_resource_prefetch");
+	}
+
 	switch (_viewType) {
 	case kViewEga:
 		debugC(1, kDebugLevelResMan, "resMan: Detected EGA graphic resources");
@@ -1110,6 +1154,8 @@ void ResourceManager::init() {
 }
 
 ResourceManager::~ResourceManager() {
+	stopPrefetchThread();
+
 	// freeing resources
 	ResourceMap::iterator itr = _resMap.begin();
 	while (itr != _resMap.end()) {
@@ -1130,7 +1176,7 @@ void ResourceManager::removeFromLRU(Resource *res) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
+	_LRU.erase(res->_lruPosition);
 	_memoryLRU -= res->size();
 	res->_status = kResStatusAllocated;
 }
@@ -1141,6 +1187,7 @@ void ResourceManager::addToLRU(Resource *res) {
 		return;
 	}
 	_LRU.push_front(res);
+	res->_lruPosition = _LRU.begin();
 	_memoryLRU += res->size();
 #ifdef SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
@@ -1170,9 +1217,12 @@ void ResourceManager::printLRU() {
 void ResourceManager::freeOldResources() {
 	while (_maxMemoryLRU < _memoryLRU) {
 		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
+		// A resource larger than the whole budget would push out everything
+		// else, so it goes first
+		Resource *goner = (_LRU.front()->size() > (uint)_maxMemoryLRU) ? _LRU.front() : _LRU.back();
 		removeFromLRU(goner);
 		goner->unalloc();
+		_typeStats[goner->getType()].evictions++;
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
 #endif
@@ -1215,15 +1265,26 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return nullptr;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (!_prefetchJobs.empty()) {
+		finishPrefetch(retval);
+		collectPrefetchedResources();
+	}
+
+	TypeStats &stats = _typeStats[retval->getType()];
+	if (retval->_status == kResStatusNoMalloc) {
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		// The resource is removed from its current position
-		// in the LRU list because it has been requested
-		// again. Below, it will either be locked, or it
-		// will be added back to the LRU list at the 'most
-		// recent' position.
-		removeFromLRU(retval);
+		stats.loads++;
+		stats.bytesLoaded += retval->size();
+	} else {
+		stats.hits++;
+		if (retval->_status == kResStatusEnqueued)
+			// The resource is removed from its current position
+			// in the LRU list because it has been requested
+			// again. Below, it will either be locked, or it
+			// will be added back to the LRU list at the 'most
+			// recent' position.
+			removeFromLRU(retval);
+	}
 
 	// Unless an error occurred, the resource is now either
 	// locked or allocated, but never queued or freed.
@@ -1267,6 +1328,246 @@ void ResourceManager::unlockResource(Resource *res) {
 	freeOldResources();
 }
 
+void ResourceManager::prefetchRoom(uint16 roomNumber) {
+	if (!_prefetchEnabled)
+		return;
+
+	// The script and heap of the room are loaded right away, these are
+	// usually needed once its init method runs
+	static const ResourceType types[] = {
+		kResourceTypePic,
+		kResourceTypePalette,
+		kResourceTypeText,
+		kResourceTypeMessage
+	};
+
+	for (int i = 0; i < ARRAYSIZE(types); ++i)
+		prefetchResource(ResourceId(types[i], roomNumber));
+}
+
+void ResourceManager::prefetchResource(const ResourceId &id) {
+	if (!_prefetchEnabled)
+		return;
+
+	// Resource::decompress() calls error() for audio resources with a bad
+	// header and for unsupported compression methods, which has to happen
+	// on the main thread. These are left to findResource().
+	Resource *res = testResource(id);
+	if (!res || res->_status != kResStatusNoMalloc || res->_source->getSourceType() != kSourceVolume ||
+		res->getType() == kResourceTypeAudio)
+		return;
+
+	for (Common::List<PrefetchJob *>::const_iterator it = _prefetchJobs.begin(); it != _prefetchJobs.end(); ++it) {
+		if ((*it)->res == res)
+			return;
+	}
+
+	if (!_prefetchThread && !startPrefetchThread()) {
+		_prefetchEnabled = false;
+		return;
+	}
+
+	// The volume files are only read on this thread, the prefetch thread
+	// gets a copy of the packed data
+	Common::SeekableReadStream *fileStream = getVolumeFile(res->_source);
+	if (!fileStream)
+		return;
+
+	const ResVersion volVersion = getResourceVolVersion(res, fileStream);
+	fileStream->seek(res->_fileOffset, SEEK_SET);
+
+	Resource *result = new Resource(this, id);
+	result->_source = res->_source;
+
+	uint32 packedSize = 0;
+	ResourceCompression compression;
+	byte *packedData = nullptr;
+	if (!result->readResourceInfo(volVersion, fileStream, packedSize, compression) && packedSize <= SCI_MAX_RESOURCE_SIZE &&
+		isSupportedCompression(compression)) {
+		packedSize += fileStream->pos() - res->_fileOffset;
+		packedData = new byte[packedSize];
+		fileStream->seek(res->_fileOffset, SEEK_SET);
+		if (fileStream->read(packedData, packedSize) != packedSize) {
+			delete[] packedData;
+			packedData = nullptr;
+		}
+	}
+	disposeVolumeFileStream(fileStream, res->_source);
+
+	if (!packedData) {
+		// Left for findResource() to report
+		result->_source = nullptr;
+		delete result;
+		return;
+	}
+
+	PrefetchJob *job = new PrefetchJob();
+	job->res = res;
+	job->result = result;
+	job->packedData = packedData;
+	job->packedSize = packedSize;
+	job->volVersion = volVersion;
+	job->errorNum = SCI_ERROR_NONE;
+	job->state = PrefetchJob::kQueued;
+
+	_prefetchMutex->lock();
+	_prefetchJobs.push_back(job);
+	_prefetchQueued->signal();
+	_prefetchMutex->unlock();
+}
+
+bool ResourceManager::startPrefetchThread() {
+	_prefetchQueued = g_system->createConditionVariable();
+	_prefetchDone = g_system->createConditionVariable();
+	if (_prefetchQueued && _prefetchDone) {
+		_prefetchMutex = g_system->createMutex();
+		_prefetchQuit = false;
+		_prefetchThread = g_system->createThread(prefetchThreadEntry, this);
+		if (_prefetchThread)
+			return true;
+	}
+
+	delete _prefetchQueued;
+	delete _prefetchDone;
+	delete _prefetchMutex;
+	_prefetchQueued = _prefetchDone = nullptr;
+	_prefetchMutex = nullptr;
+	return false;
+}
+
+void ResourceManager::stopPrefetchThread() {
+	if (!_prefetchThread)
+		return;
+
+	_prefetchMutex->lock();
+	_prefetchQuit = true;
+	_prefetchQueued->broadcast();
+	_prefetchMutex->unlock();
+
+	_prefetchThread->join();
+	delete _prefetchThread;
+	_prefetchThread = nullptr;
+
+	for (Common::List<PrefetchJob *>::iterator it = _prefetchJobs.begin(); it != _prefetchJobs.end(); ++it) {
+		PrefetchJob *job = *it;
+		job->result->_source = nullptr;
+		delete job->result;
+		delete[] job->packedData;
+		delete job;
+	}
+	_prefetchJobs.clear();
+
+	delete _prefetchQueued;
+	delete _prefetchDone;
+	delete _prefetchMutex;
+	_prefetchQueued = _prefetchDone = nullptr;
+	_prefetchMutex = nullptr;
+}
+
+void ResourceManager::prefetchThreadEntry(void *data) {
+	((ResourceManager *)data)->prefetchLoop();
+}
+
+void ResourceManager::prefetchLoop() {
+	_prefetchMutex->lock();
+	while (!_prefetchQuit) {
+		PrefetchJob *job = nullptr;
+		for (Common::List<PrefetchJob *>::iterator it = _prefetchJobs.begin(); it != _prefetchJobs.end(); ++it) {
+			if ((*it)->state == PrefetchJob::kQueued) {
+				job = *it;
+				break;
+			}
+		}
+
+		if (!job) {
+			_prefetchQueued->wait(_prefetchMutex);
+			continue;
+		}
+
+		job->state = PrefetchJob::kRunning;
+		_prefetchMutex->unlock();
+
+		// Errors are reported by adoptPrefetchedResource() on the main thread
+		Common::MemoryReadStream stream(job->packedData, job->packedSize);
+		job->errorNum = job->result->decompress(job->volVersion, &stream);
+
+		_prefetchMutex->lock();
+		job->state = PrefetchJob::kDone;
+		_prefetchDone->broadcast();
+	}
+	_prefetchMutex->unlock();
+}
+
+void ResourceManager::collectPrefetchedResources() {
+	Common::List<PrefetchJob *> done;
+
+	_prefetchMutex->lock();
+	for (Common::List<PrefetchJob *>::iterator it = _prefetchJobs.begin(); it != _prefetchJobs.end();) {
+		if ((*it)->state == PrefetchJob::kDone) {
+			done.push_back(*it);
+			it = _prefetchJobs.erase(it);
+		} else {
+			++it;
+		}
+	}
+	_prefetchMutex->unlock();
+
+	for (Common::List<PrefetchJob *>::iterator it = done.begin(); it != done.end(); ++it) {
+		Resource *res = (*it)->res;
+		adoptPrefetchedResource(*it);
+		if (res->_status == kResStatusAllocated)
+			addToLRU(res);
+	}
+}
+
+void ResourceManager::finishPrefetch(Resource *res) {
+	for (Common::List<PrefetchJob *>::iterator it = _prefetchJobs.begin(); it != _prefetchJobs.end(); ++it) {
+		PrefetchJob *job = *it;
+		if (job->res != res)
+			continue;
+
+		_prefetchMutex->lock();
+		while (job->state == PrefetchJob::kRunning)
+			_prefetchDone->wait(_prefetchMutex);
+		_prefetchJobs.erase(it);
+		_prefetchMutex->unlock();
+
+		// A job which hasn't started yet has nothing to adopt, the resource
+		// gets loaded right away instead
+		adoptPrefetchedResource(job);
+		return;
+	}
+}
+
+void ResourceManager::adoptPrefetchedResource(PrefetchJob *job) {
+	Resource *res = job->res;
+	Resource *result = job->result;
+
+	if (job->errorNum) {
+		// The resource is left unloaded, loading it again reports the
+		// error again
+		warning("Error %d occurred while prefetching %s from resource file %s: %s",
+				job->errorNum, res->_id.toString().c_str(), res->getResourceLocation().c_str(),
+				s_errorDescriptions[job->errorNum]);
+	} else if (result->_status != kResStatusNoMalloc && res->_status == kResStatusNoMalloc) {
+		res->_data = result->_data;
+		res->_size = result->_size;
+		res->_status = kResStatusAllocated;
+		result->_data = nullptr;
+		if (_patcher)
+			_patcher->applyPatch(*res);
+
+		TypeStats &stats = _typeStats[res->getType()];
+		stats.prefetches++;
+		stats.bytesLoaded += res->size();
+	}
+
+	result->_source = nullptr;
+	delete result;
+	delete[] job->packedData;
+	delete job;
+}
+
 const char *ResourceManager::versionDescription(ResVersion version) const {
 	switch (version) {
 	case kResVersionUnknown:
@@ -2385,29 +2686,8 @@ int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file
 		return errorNum;
 
 	// getting a decompressor
-	Decompressor *dec = nullptr;
-	switch (compression) {
-	case kCompNone:
-		dec = new Decompressor;
-		break;
-	case kCompHuffman:
-		dec = new DecompressorHuffman;
-		break;
-	case kCompLZW:
-	case kCompLZW1:
-	case kCompLZW1View:
-	case kCompLZW1Pic:
-		dec = new DecompressorLZW(compression);
-		break;
-	case kCompDCL:
-		dec = new DecompressorDCL;
-		break;
-#ifdef ENABLE_SCI32
-	case kCompSTACpack:
-		dec = new DecompressorLZS;
-		break;
-#endif
-	default:
+	Decompressor *dec = createDecompressor(compression);
+	if (!dec) {
 		error("Resource %s: Compression method %d not supported", _id.toString().c_str(), compression);
 		return SCI_ERROR_UNKNOWN_COMPRESSION;
 	}
@@ -37,6 +37,9 @@ class FSList;
 class FSNode;
 class WriteStream;
 class SeekableReadStream;
+class MutexInternal;
+class ThreadInternal;
+class ConditionVariableInternal;
 }
 
 namespace Sci {
@@ -297,6 +300,7 @@ protected:
 	int32 _fileOffset; /**< Offset in file */
 	ResourceStatus _status;
 	uint16 _lockers; /**< Number of places where this resource was locked */
+	Common::List<Resource *>::iterator _lruPosition; /**< Position in the LRU list, if enqueued */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
@@ -474,6 +478,35 @@ public:
 	 */
 	ResourceType convertResType(byte type);
 
+	/** How the resources of one type have been used, for the debugger. */
+	struct TypeStats {
+		uint32 hits;        ///< Requests for resources which were in memory
+		uint32 loads;       ///< Requests which had to load the resource
+		uint32 prefetches;  ///< Resources decompressed ahead of time
+		uint32 evictions;   ///< Resources freed to stay within the LRU budget
+		uint64 bytesLoaded; ///< Bytes of all loaded and prefetched resources
+	};
+
+	const TypeStats &getTypeStats(ResourceType type) const { return _typeStats[type]; }
+	int getMaxMemoryLRU() const { return _maxMemoryLRU; }
+	int getMemoryLRU() const { return _memoryLRU; }
+	int getMemoryLocked() const { return _memoryLocked; }
+
+	/**
+	 * Starts decompressing the resources a room is likely to need right
+	 * after its script has been loaded, on a background thread. Does nothing
+	 * unless enabled with the sci_resource_prefetch setting.
+	 */
+	void prefetchRoom(uint16 roomNumber);
+
+	/**
+	 * Starts decompressing a resource on the background thread, so that it
+	 * is ready when findResource() asks for it. Only resources stored in
+	 * plain resource volumes are prefetched, the call is ignored for all
+	 * others.
+	 */
+	void prefetchResource(const ResourceId &id);
+
 protected:
 	bool _detectionMode;
 
@@ -488,7 +521,8 @@ protected:
 	SourcesList _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	Common::List<Resource *> _LRU; ///< Last Resource Used list, most recent first
+	TypeStats _typeStats[kResourceTypeInvalid];
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -548,6 +582,14 @@ protected:
 	 */
 	Common::SeekableReadStream *getVolumeFile(ResourceSource *source);
 	void disposeVolumeFileStream(Common::SeekableReadStream *fileStream, ResourceSource *source);
+
+	/**
+	 * Returns the version the resource is stored in, which differs from the
+	 * volume version for the messages and texts of Korean versions. Moves
+	 * the position of the volume file stream.
+	 */
+	ResVersion getResourceVolVersion(const Resource *res, Common::SeekableReadStream *fileStream);
+
 	void loadResource(Resource *res);
 	void freeOldResources();
 	bool validateResource(const ResourceId &resourceId, const Common::String &sourceMapLocation, const Common::String &sourceName, const uint32 offset, const uint32 size, const uint32 sourceSize) const;
@@ -635,6 +677,50 @@ protected:
 	void addToLRU(Resource *res);
 	void removeFromLRU(Resource *res);
 
+	/** A resource decompressed by the prefetch thread. */
+	struct PrefetchJob {
+		enum State {
+			kQueued,
+			kRunning,
+			kDone
+		};
+
+		Resource *res;
+		Resource *result; ///< Receives the decompressed data
+		byte *packedData; ///< The resource header and compressed data from the volume
+		uint32 packedSize;
+		ResVersion volVersion;
+		int errorNum; ///< Set by the prefetch thread, reported by adoptPrefetchedResource()
+		State state; ///< Guarded by _prefetchMutex
+	};
+
+	bool startPrefetchThread();
+	void stopPrefetchThread();
+	static void prefetchThreadEntry(void *data);
+	void prefetchLoop();
+
+	/**
+	 * Moves the data of finished prefetch jobs into their resources and puts
+	 * these under LRU control.
+	 */
+	void collectPrefetchedResources();
+
+	/**
+	 * Makes sure no prefetch job is working on the resource any more, and
+	 * takes over its data if it has been decompressed.
+	 */
+	void finishPrefetch(Resource *res);
+
+	void adoptPrefetchedResource(PrefetchJob *job);
+
+	Common::List<PrefetchJob *> _prefetchJobs;
+	Common::ThreadInternal *_prefetchThread;
+	Common::MutexInternal *_prefetchMutex;
+	Common::ConditionVariableInternal *_prefetchQueued;
+	Common::ConditionVariableInternal *_prefetchDone;
+	bool _prefetchQuit; ///< Guarded by _prefetchMutex
+	bool _prefetchEnabled;
+
 	ResourceCompression getViewCompression();
 	ViewType detectViewType();
 	bool hasSci0Voc999();
@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/config-manager.h"
 #include "common/system.h"
 #include "scumm/actor.h"
 #include "scumm/charset.h"
@@ -216,9 +217,23 @@ Gdi::Gdi(ScummEngine *vm) : _vm(vm) {
 	_zbufferDisabled = false;
 	_objectMode = false;
 	_distaff = false;
+
+	_stripCacheBitmap = nullptr;
+	_stripCacheRoom = 0;
+	_stripCacheHeight = 0;
+	_stripCacheNumZBuf = 0;
+	memset(_stripCachePalette, 0, sizeof(_stripCachePalette));
+	_stripCacheSize = 0;
+	_stripCacheMaxSize = 1024 * 1024;
+	if (ConfMan.hasKey("scumm_strip_cache_size"))
+		_stripCacheMaxSize = MAX(ConfMan.getInt("scumm_strip_cache_size"), 0) * 1024;
+	_stripCacheHits = 0;
+	_stripCacheMisses = 0;
+	_stripCacheEnabled = false;
 }
 
 Gdi::~Gdi() {
+	flushStripCache();
 }
 
 GdiHE::GdiHE(ScummEngine *vm) : Gdi(vm), _tmskPtr(nullptr) {
@@ -285,6 +300,13 @@ void Gdi::init() {
 }
 
 void Gdi::roomChanged(byte *roomptr) {
+	flushStripCache();
+
+	// Only the generic strip decoder is cached. The NES, PC Engine, V1 and
+	// V2 renderers override roomChanged() and thus never enable it, and HE
+	// games are left out as they draw their backgrounds through TMSK masks
+	// and, in the 16-bit titles, through a different pixel format.
+	_stripCacheEnabled = _stripCacheMaxSize > 0 && _vm->_game.heversion == 0;
 }
 
 void GdiNES::roomChanged(byte *roomptr) {
@@ -2084,6 +2106,8 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 
 	numzbuf = getZPlanes(ptr, zplane_list, false);
 
+	const bool useStripCache = canUseStripCache(ptr, vs, y, height, numzbuf, flag);
+
 	if (y + height > vs->h) {
 		warning("Gdi::drawBitmap, strip drawn to %d below window bottom %d", y + height, vs->h);
 	}
@@ -2132,7 +2156,13 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		else
 			dstPtr = (byte *)vs->getBasePtr(x * 8, y);
 
-		transpStrip = drawStrip(dstPtr, vs, x, y, width, height, stripnr, smap_ptr);
+		const bool cached = useStripCache && restoreCachedStrip(dstPtr, vs, x, y, height, stripnr, numzbuf, zplane_list);
+		if (!cached)
+			transpStrip = drawStrip(dstPtr, vs, x, y, width, height, stripnr, smap_ptr);
+
+		// Transparent strips keep whatever was drawn below them, so they
+		// can't be replayed from the cache.
+		const bool storeStrip = useStripCache && !cached && !transpStrip;
 
 		// COMI and HE games only uses flag value
 		if (_vm->_game.version == 8 || _vm->_game.heversion >= 60)
@@ -2146,7 +2176,11 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 				clear8Col(frontBuf, vs->pitch, height, vs->format.bytesPerPixel);
 		}
 
-		decodeMask(x, y, width, height, stripnr, numzbuf, zplane_list, transpStrip, flag);
+		if (!cached)
+			decodeMask(x, y, width, height, stripnr, numzbuf, zplane_list, transpStrip, flag);
+
+		if (storeStrip)
+			storeCachedStrip(dstPtr, vs, x, y, height, stripnr, numzbuf, zplane_list);
 
 #if 0
 		// HACK: blit mask(s) onto normal screen. Useful to debug masking
@@ -2174,6 +2208,119 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	}
 }
 
+void Gdi::flushStripCache() {
+	int numCached = 0;
+	for (uint i = 0; i < _stripCache.size(); i++) {
+		if (_stripCache[i])
+			numCached++;
+		delete[] _stripCache[i];
+	}
+
+	if (_stripCacheHits || _stripCacheMisses)
+		debugC(DEBUG_RESOURCE, "Strip cache: %d strips, %u of %u KiB, %u hits, %u misses",
+			   numCached, _stripCacheSize / 1024, _stripCacheMaxSize / 1024, _stripCacheHits, _stripCacheMisses);
+
+	_stripCache.clear();
+	_stripCacheBitmap = nullptr;
+	_stripCacheSize = 0;
+	_stripCacheHits = 0;
+	_stripCacheMisses = 0;
+}
+
+/**
+ * Check whether a drawBitmap() call draws the plain room background, which
+ * can be served from and added to the strip cache. The cache is dropped
+ * whenever the room image, its height, the number of z-planes or the room
+ * palette differ from the ones the cached strips were decoded with.
+ */
+bool Gdi::canUseStripCache(const byte *ptr, VirtScreen *vs, int y, int height, int numzbuf, byte flag) {
+	if (!_stripCacheEnabled || flag != 0 || y != 0 || vs->number != kMainVirtScreen ||
+		vs->format.bytesPerPixel != 1 || !vs->hasTwoBuffers)
+		return false;
+
+	if (ptr != _stripCacheBitmap || _vm->_roomResource != _stripCacheRoom ||
+		height != _stripCacheHeight || numzbuf != _stripCacheNumZBuf ||
+		memcmp(_vm->_roomPalette, _stripCachePalette, sizeof(_stripCachePalette))) {
+		flushStripCache();
+		_stripCacheBitmap = ptr;
+		_stripCacheRoom = _vm->_roomResource;
+		_stripCacheHeight = height;
+		_stripCacheNumZBuf = numzbuf;
+		memcpy(_stripCachePalette, _vm->_roomPalette, sizeof(_stripCachePalette));
+	}
+
+	return true;
+}
+
+bool Gdi::restoreCachedStrip(byte *dstPtr, VirtScreen *vs, int x, int y, int height,
+					int stripnr, int numzbuf, const byte *zplane_list[9]) {
+	if (stripnr < 0 || stripnr >= (int)_stripCache.size() || !_stripCache[stripnr]) {
+		_stripCacheMisses++;
+		return false;
+	}
+
+	const byte *src = _stripCache[stripnr];
+	for (int h = 0; h < height; h++) {
+		memcpy(dstPtr, src, 8);
+		dstPtr += vs->pitch;
+		src += 8;
+	}
+
+	for (int i = 1; i < numzbuf; i++) {
+		if (!zplane_list[i])
+			continue;
+		byte *mask_ptr = getMaskBuffer(x, y, i);
+		for (int h = 0; h < height; h++) {
+			*mask_ptr = *src++;
+			mask_ptr += _numStrips;
+		}
+	}
+
+	_stripCacheHits++;
+	return true;
+}
+
+void Gdi::storeCachedStrip(const byte *dstPtr, VirtScreen *vs, int x, int y, int height,
+					int stripnr, int numzbuf, const byte *zplane_list[9]) {
+	if (stripnr < 0)
+		return;
+
+	int numMasks = 0;
+	for (int i = 1; i < numzbuf; i++) {
+		if (zplane_list[i])
+			numMasks++;
+	}
+
+	const uint32 size = height * (8 + numMasks);
+	if (_stripCacheSize + size > _stripCacheMaxSize)
+		return;
+
+	if (stripnr >= (int)_stripCache.size())
+		_stripCache.resize(stripnr + 1);
+	if (_stripCache[stripnr])
+		return;
+
+	byte *dst = new byte[size];
+	_stripCache[stripnr] = dst;
+	_stripCacheSize += size;
+
+	for (int h = 0; h < height; h++) {
+		memcpy(dst, dstPtr, 8);
+		dstPtr += vs->pitch;
+		dst += 8;
+	}
+
+	for (int i = 1; i < numzbuf; i++) {
+		if (!zplane_list[i])
+			continue;
+		const byte *mask_ptr = getMaskBuffer(x, y, i);
+		for (int h = 0; h < height; h++) {
+			*dst++ = *mask_ptr;
+			mask_ptr += _numStrips;
+		}
+	}
+}
+
 bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
 					int stripnr, const byte *smap_ptr) {
 	// Do some input verification and make sure the strip/strip offset
@@ -23,6 +23,7 @@
 #define SCUMM_GFX_H
 
 #include "common/system.h"
+#include "common/array.h"
 #include "common/list.h"
 
 #include "graphics/surface.h"
@@ -219,6 +220,23 @@ protected:
 	/** Flag which is true when an object is being rendered, false otherwise. */
 	bool _objectMode;
 
+	/**
+	 * Cache of decoded room background strips, indexed by strip number.
+	 * Each entry holds the 8 pixel wide strip followed by one byte per
+	 * line for every z-plane mask, or nullptr if not decoded yet.
+	 */
+	Common::Array<byte *> _stripCache;
+	const byte *_stripCacheBitmap;	///< Room image the cached strips were decoded from
+	int _stripCacheRoom;
+	int _stripCacheHeight;
+	int _stripCacheNumZBuf;
+	byte _stripCachePalette[256];	///< Room palette the cached strips were decoded with
+	uint32 _stripCacheSize;
+	uint32 _stripCacheMaxSize;
+	uint32 _stripCacheHits;
+	uint32 _stripCacheMisses;
+	bool _stripCacheEnabled;
+
 public:
 	/** Flag which is true when loading objects or titles for distaff, in PCEngine version of Loom. */
 	bool _distaff;
@@ -266,6 +284,14 @@ protected:
 					const int x, const int y, const int width, const int height,
 	                int stripnr, int numstrip);
 
+	/* Background strip cache */
+	void flushStripCache();
+	bool canUseStripCache(const byte *ptr, VirtScreen *vs, int y, int height, int numzbuf, byte flag);
+	bool restoreCachedStrip(byte *dstPtr, VirtScreen *vs, int x, int y, int height,
+	                int stripnr, int numzbuf, const byte *zplane_list[9]);
+	void storeCachedStrip(const byte *dstPtr, VirtScreen *vs, int x, int y, int height,
+	                int stripnr, int numzbuf, const byte *zplane_list[9]);
+
 public:
 	Gdi(ScummEngine *vm);
 	virtual ~Gdi();
@@ -21,6 +21,9 @@
 
 
 #include "common/scummsys.h"
+#include "common/config-manager.h"
+#include "common/system.h"
+#include "common/thread.h"
 #include "scumm/scumm.h"
 #include "scumm/util.h"
 #include "scumm/file.h"
@@ -29,6 +32,234 @@
 
 namespace Scumm {
 
+BundleBlockCache::BundleBlockCache() {
+	_numDoneBlocks = 0;
+	_hits = 0;
+	_misses = 0;
+	_prefetches = 0;
+	_mutex = g_system->createMutex();
+	_prefetchThread = nullptr;
+	_prefetchQueued = nullptr;
+	_prefetchDone = nullptr;
+	_prefetchQuit = false;
+	_prefetchEnabled = ConfMan.hasKey("dimuse_bundle_prefetch") && ConfMan.getBool("dimuse_bundle_prefetch");
+}
+
+BundleBlockCache::~BundleBlockCache() {
+	stopPrefetchThread();
+
+	if (_hits || _misses)
+		debug(5, "BundleBlockCache: %d hits, %d misses, %d blocks prefetched", _hits, _misses, _prefetches);
+
+	for (Common::List<Block *>::iterator it = _blocks.begin(); it != _blocks.end(); ++it)
+		freeBlock(*it);
+	_blocks.clear();
+
+	delete _mutex;
+}
+
+Common::List<BundleBlockCache::Block *>::iterator BundleBlockCache::findBlock(int slot, int32 index, int32 block) {
+	Common::List<Block *>::iterator it;
+	for (it = _blocks.begin(); it != _blocks.end(); ++it) {
+		if ((*it)->slot == slot && (*it)->index == index && (*it)->block == block)
+			break;
+	}
+	return it;
+}
+
+void BundleBlockCache::freeBlock(Block *entry) {
+	free(entry->compData);
+	free(entry->data);
+	delete entry;
+}
+
+void BundleBlockCache::evictBlocks() {
+	// Queued and running blocks aren't counted, there can only be a few of
+	// them for each BundleMgr
+	Common::List<Block *>::iterator it = _blocks.reverse_begin();
+	while (_numDoneBlocks > kMaxBlocks && it != _blocks.end()) {
+		Block *entry = *it;
+		if (entry->state == Block::kDone) {
+			it = _blocks.reverse_erase(it);
+			freeBlock(entry);
+			_numDoneBlocks--;
+		} else {
+			--it;
+		}
+	}
+}
+
+int32 BundleBlockCache::getBlock(int slot, int32 index, int32 block, byte *dst) {
+	Common::StackLock lock(_mutex);
+
+	Common::List<Block *>::iterator it = findBlock(slot, index, block);
+	if (it == _blocks.end()) {
+		_misses++;
+		return -1;
+	}
+
+	Block *entry = *it;
+	_blocks.erase(it);
+
+	if (entry->state == Block::kQueued) {
+		// Quicker for the caller to decompress it right away than to wait
+		freeBlock(entry);
+		_misses++;
+		return -1;
+	}
+
+	while (entry->state == Block::kRunning)
+		_prefetchDone->wait(_mutex);
+
+	if (entry->size < 0) {
+		// Left for the caller to report
+		_numDoneBlocks--;
+		freeBlock(entry);
+		_misses++;
+		return -1;
+	}
+
+	memcpy(dst, entry->data, entry->size);
+	_blocks.push_front(entry);
+	_hits++;
+	return entry->size;
+}
+
+void BundleBlockCache::addBlock(int slot, int32 index, int32 block, const byte *data, int32 size) {
+	Common::StackLock lock(_mutex);
+
+	if (findBlock(slot, index, block) != _blocks.end())
+		return;
+
+	Block *entry = new Block();
+	entry->slot = slot;
+	entry->index = index;
+	entry->block = block;
+	entry->codec = 0;
+	entry->compData = nullptr;
+	entry->compSize = 0;
+	entry->data = (byte *)malloc(size);
+	assert(entry->data);
+	memcpy(entry->data, data, size);
+	entry->size = size;
+	entry->state = Block::kDone;
+
+	_blocks.push_front(entry);
+	_numDoneBlocks++;
+	evictBlocks();
+}
+
+bool BundleBlockCache::hasBlock(int slot, int32 index, int32 block) {
+	Common::StackLock lock(_mutex);
+	return findBlock(slot, index, block) != _blocks.end();
+}
+
+void BundleBlockCache::prefetchBlock(int slot, int32 index, int32 block, int32 codec, byte *compData, int32 compSize) {
+	Common::StackLock lock(_mutex);
+
+	if (!_prefetchThread && (!_prefetchEnabled || !startPrefetchThread())) {
+		_prefetchEnabled = false;
+		free(compData);
+		return;
+	}
+
+	Block *entry = new Block();
+	entry->slot = slot;
+	entry->index = index;
+	entry->block = block;
+	entry->codec = codec;
+	entry->compData = compData;
+	entry->compSize = compSize;
+	entry->data = nullptr;
+	entry->size = -1;
+	entry->state = Block::kQueued;
+
+	_blocks.push_front(entry);
+	_prefetchQueued->signal();
+}
+
+bool BundleBlockCache::startPrefetchThread() {
+	_prefetchQueued = g_system->createConditionVariable();
+	_prefetchDone = g_system->createConditionVariable();
+	if (_prefetchQueued && _prefetchDone) {
+		_prefetchQuit = false;
+		_prefetchThread = g_system->createThread(prefetchThreadEntry, this);
+		if (_prefetchThread)
+			return true;
+	}
+
+	delete _prefetchQueued;
+	delete _prefetchDone;
+	_prefetchQueued = _prefetchDone = nullptr;
+	return false;
+}
+
+void BundleBlockCache::stopPrefetchThread() {
+	if (!_prefetchThread)
+		return;
+
+	_mutex->lock();
+	_prefetchQuit = true;
+	_prefetchQueued->broadcast();
+	_mutex->unlock();
+
+	_prefetchThread->join();
+	delete _prefetchThread;
+	_prefetchThread = nullptr;
+
+	delete _prefetchQueued;
+	delete _prefetchDone;
+	_prefetchQueued = _prefetchDone = nullptr;
+}
+
+void BundleBlockCache::prefetchThreadEntry(void *data) {
+	((BundleBlockCache *)data)->prefetchLoop();
+}
+
+void BundleBlockCache::prefetchLoop() {
+	_mutex->lock();
+	while (!_prefetchQuit) {
+		// The oldest queued block is the one needed first
+		Block *entry = nullptr;
+		for (Common::List<Block *>::iterator it = _blocks.reverse_begin(); it != _blocks.end(); --it) {
+			if ((*it)->state == Block::kQueued) {
+				entry = *it;
+				break;
+			}
+		}
+
+		if (!entry) {
+			_prefetchQueued->wait(_mutex);
+			continue;
+		}
+
+		entry->state = Block::kRunning;
+		_mutex->unlock();
+
+		// Same as in BundleMgr::readFile()
+		byte *data = (byte *)malloc(DIMUSE_BUN_CHUNK_SIZE);
+		int32 size = -1;
+		if (data) {
+			entry->compData[entry->compSize] = 0;
+			size = BundleCodecs::decompressCodec(entry->codec, entry->compData, data, entry->compSize);
+			if (size < 0 || size > DIMUSE_BUN_CHUNK_SIZE)
+				size = -1;
+		}
+		free(entry->compData);
+		entry->compData = nullptr;
+
+		_mutex->lock();
+		entry->data = data;
+		entry->size = size;
+		entry->state = Block::kDone;
+		_numDoneBlocks++;
+		_prefetches++;
+		evictBlocks();
+		_prefetchDone->broadcast();
+	}
+	_mutex->unlock();
+}
+
 BundleDirCache::BundleDirCache() {
 	for (int fileId = 0; fileId < ARRAYSIZE(_bundleDirCache); fileId++) {
 		_bundleDirCache[fileId].bundleTable = nullptr;
@@ -146,6 +377,7 @@ BundleMgr::BundleMgr(BundleDirCache *cache) {
 	_lastBlockDecompressedSize = 0;
 	_curSampleId = -1;
 	_fileBundleId = -1;
+	_slot = -1;
 	_file = new ScummFile();
 	_compInputBuff = nullptr;
 }
@@ -185,6 +417,7 @@ bool BundleMgr::open(const char *filename, bool &isCompressed, bool errorFlag) {
 
 	int slot = _cache->matchFile(filename);
 	assert(slot != -1);
+	_slot = slot;
 	isCompressed = _cache->isSndDataExtComp(slot);
 	_numFiles = _cache->getNumFiles(slot);
 	assert(_numFiles);
@@ -287,6 +520,30 @@ int32 BundleMgr::seekFile(int32 offset, int mode) {
 	return result;
 }
 
+void BundleMgr::prefetchBlocks(int32 index, int32 lastBlock) {
+	// Streams read their sounds a block or less at a time, so a couple of
+	// blocks ahead are enough to keep the decompression off the caller
+	const int32 kPrefetchBlocks = 2;
+
+	BundleBlockCache &blockCache = _cache->getBlockCache();
+	for (int32 i = lastBlock + 1; i <= lastBlock + kPrefetchBlocks && i < _numCompItems; i++) {
+		if (blockCache.hasBlock(_slot, index, i))
+			continue;
+
+		// The prefetch thread gets a copy of the compressed data, the bundle
+		// file is only read here
+		byte *compData = (byte *)malloc(_compTable[i].size + 1);
+		if (!compData)
+			return;
+		_file->seek(_bundleTable[index].offset + _compTable[i].offset, SEEK_SET);
+		if (_file->read(compData, _compTable[i].size) != (uint32)_compTable[i].size) {
+			free(compData);
+			return;
+		}
+		blockCache.prefetchBlock(_slot, index, i, _compTable[i].codec, compData, _compTable[i].size);
+	}
+}
+
 int32 BundleMgr::readFile(const char *name, int32 size, byte **comp_final, bool header_outside) {
 	int32 final_size = 0;
 
@@ -348,16 +605,22 @@ int32 BundleMgr::readFile(const char *name, int32 size, byte **comp_final, bool
 
 		skip = (_curDecompressedFilePos + headerSize) % DIMUSE_BUN_CHUNK_SIZE; // Excess length after the last block
 
+		BundleBlockCache &blockCache = _cache->getBlockCache();
+
 		for (i = firstBlock; i <= lastBlock; i++) {
 			if (_lastBlock != i) {
-				// CMI hack: one more zero byte at the end of input buffer
-				_compInputBuff[_compTable[i].size] = 0;
-				_file->seek(_bundleTable[found->index].offset + _compTable[i].offset, SEEK_SET);
-				_file->read(_compInputBuff, _compTable[i].size);
-				_outputSize = BundleCodecs::decompressCodec(_compTable[i].codec, _compInputBuff, _compOutputBuff, _compTable[i].size);
-
-				if (_outputSize > DIMUSE_BUN_CHUNK_SIZE) {
-					error("_outputSize: %d", _outputSize);
+				_outputSize = blockCache.getBlock(_slot, found->index, i, _compOutputBuff);
+				if (_outputSize < 0) {
+					// CMI hack: one more zero byte at the end of input buffer
+					_compInputBuff[_compTable[i].size] = 0;
+					_file->seek(_bundleTable[found->index].offset + _compTable[i].offset, SEEK_SET);
+					_file->read(_compInputBuff, _compTable[i].size);
+					_outputSize = BundleCodecs::decompressCodec(_compTable[i].codec, _compInputBuff, _compOutputBuff, _compTable[i].size);
+
+					if (_outputSize > DIMUSE_BUN_CHUNK_SIZE) {
+						error("_outputSize: %d", _outputSize);
+					}
+					blockCache.addBlock(_slot, found->index, i, _compOutputBuff, _outputSize);
 				}
 				_lastBlock = i;
 			}
@@ -391,6 +654,9 @@ int32 BundleMgr::readFile(const char *name, int32 size, byte **comp_final, bool
 		}
 		_curDecompressedFilePos += finalSize;
 
+		if (blockCache.isPrefetchEnabled())
+			prefetchBlocks(found->index, lastBlock);
+
 		return finalSize;
 	}
 
@@ -24,12 +24,103 @@
 
 #include "common/scummsys.h"
 #include "common/file.h"
+#include "common/list.h"
 #include "scumm/imuse_digi/dimuse_defs.h"
 
+namespace Common {
+class MutexInternal;
+class ThreadInternal;
+class ConditionVariableInternal;
+}
+
 namespace Scumm {
 
 class BaseScummFile;
 
+/**
+ * The decompressed blocks of compressed bundle files, shared by all the
+ * BundleMgr instances using the same BundleDirCache. Blocks are identified
+ * by the bundle slot in the BundleDirCache, the file index in the bundle and
+ * the block number in the file.
+ *
+ * When enabled with the dimuse_bundle_prefetch setting, the blocks which
+ * follow the ones being read are decompressed ahead of time on a background
+ * thread. The bundle files are still only read by their BundleMgr, the
+ * thread gets a copy of the compressed data.
+ */
+class BundleBlockCache {
+public:
+	BundleBlockCache();
+	~BundleBlockCache();
+
+	bool isPrefetchEnabled() const { return _prefetchEnabled; }
+
+	/**
+	 * Copies a decompressed block to dst, which must be able to hold
+	 * DIMUSE_BUN_CHUNK_SIZE bytes. Waits for the prefetch thread if it is
+	 * working on the block. Returns the size of the block, or -1 if it
+	 * isn't in the cache.
+	 */
+	int32 getBlock(int slot, int32 index, int32 block, byte *dst);
+
+	/** Adds a block which has been decompressed by the caller. */
+	void addBlock(int slot, int32 index, int32 block, const byte *data, int32 size);
+
+	/** Returns whether the block is cached or waiting to be decompressed. */
+	bool hasBlock(int slot, int32 index, int32 block);
+
+	/**
+	 * Queues a block for decompression on the prefetch thread, which takes
+	 * ownership of compData. compData must have one byte more than compSize,
+	 * see BundleMgr::loadCompTable().
+	 */
+	void prefetchBlock(int slot, int32 index, int32 block, int32 codec, byte *compData, int32 compSize);
+
+private:
+	/** The maximum number of decompressed blocks kept around. */
+	static const int kMaxBlocks = 64;
+
+	struct Block {
+		enum State {
+			kQueued,
+			kRunning,
+			kDone
+		};
+
+		int slot;
+		int32 index;
+		int32 block;
+		int32 codec;
+		byte *compData; ///< Owned by the block until it has been decompressed
+		int32 compSize;
+		byte *data;
+		int32 size;     ///< -1 if the decompression failed
+		State state;    ///< Guarded by _mutex
+	};
+
+	Common::List<Block *>::iterator findBlock(int slot, int32 index, int32 block);
+	void freeBlock(Block *entry);
+	void evictBlocks();
+
+	bool startPrefetchThread();
+	void stopPrefetchThread();
+	static void prefetchThreadEntry(void *data);
+	void prefetchLoop();
+
+	Common::List<Block *> _blocks; ///< Most recently used first, guarded by _mutex
+	int _numDoneBlocks;            ///< Guarded by _mutex
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _prefetches;
+
+	Common::MutexInternal *_mutex;
+	Common::ThreadInternal *_prefetchThread;
+	Common::ConditionVariableInternal *_prefetchQueued;
+	Common::ConditionVariableInternal *_prefetchDone;
+	bool _prefetchQuit; ///< Guarded by _mutex
+	bool _prefetchEnabled;
+};
+
 class BundleDirCache {
 public:
 	struct AudioTable {
@@ -53,6 +144,8 @@ private:
 		IndexNode *indexTable;
 	} _bundleDirCache[4];
 
+	BundleBlockCache _blockCache;
+
 public:
 	BundleDirCache();
 	~BundleDirCache();
@@ -62,6 +155,7 @@ public:
 	IndexNode *getIndexTable(int slot);
 	int32 getNumFiles(int slot);
 	bool isSndDataExtComp(int slot);
+	BundleBlockCache &getBlockCache() { return _blockCache; }
 };
 
 class BundleMgr {
@@ -88,11 +182,13 @@ private:
 	bool _compTableLoaded;
 	bool _isUncompressed;
 	int _fileBundleId;
+	int _slot;
 	byte _compOutputBuff[0x2000];
 	byte *_compInputBuff;
 	int _outputSize;
 	int _lastBlock;
 	bool loadCompTable(int32 index);
+	void prefetchBlocks(int32 index, int32 lastBlock);
 
 public:
 
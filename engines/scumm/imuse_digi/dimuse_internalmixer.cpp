@@ -22,20 +22,79 @@
 #include "common/scummsys.h"
 #include "common/mutex.h"
 #include "common/serializer.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
 #include "scumm/imuse_digi/dimuse_engine.h"
 #include "scumm/imuse_digi/dimuse_internalmixer.h"
+#include "scumm/imuse_digi/dimuse_internalmixer_intern.h"
 
 namespace Scumm {
 
+void mixBits8_Scalar(uint16 *dst, const uint8 *src, uint count, int ampA, int ampB) {
+	for (uint i = 0; i + 1 < count; i += 2) {
+		dst[i] += mixAmpSample((src[i] - 128) * 16, ampA);
+		dst[i + 1] += mixAmpSample((src[i + 1] - 128) * 16, ampB);
+	}
+	if (count & 1)
+		dst[count - 1] += mixAmpSample((src[count - 1] - 128) * 16, ampA);
+}
+
+void mixBits16_Scalar(uint16 *dst, const int16 *src, uint count, int ampA, int ampB) {
+	for (uint i = 0; i + 1 < count; i += 2) {
+		dst[i] += mixAmpSample(src[i] >> 4, ampA);
+		dst[i + 1] += mixAmpSample(src[i + 1] >> 4, ampB);
+	}
+	if (count & 1)
+		dst[count - 1] += mixAmpSample(src[count - 1] >> 4, ampA);
+}
+
+void mixBits8ToStereo_Scalar(uint16 *dst, const uint8 *src, uint count, int ampL, int ampR) {
+	for (uint i = 0; i < count; i++) {
+		dst[2 * i] += mixAmpSample((src[i] - 128) * 16, ampL);
+		dst[2 * i + 1] += mixAmpSample((src[i] - 128) * 16, ampR);
+	}
+}
+
+void mixBits16ToStereo_Scalar(uint16 *dst, const int16 *src, uint count, int ampL, int ampR) {
+	for (uint i = 0; i < count; i++) {
+		dst[2 * i] += mixAmpSample(src[i] >> 4, ampL);
+		dst[2 * i + 1] += mixAmpSample(src[i] >> 4, ampR);
+	}
+}
+
+const IMuseDigiMixKernels *getIMuseDigiMixKernels() {
+	// The scalar kernels are only there for the tails of the vector ones,
+	// the table lookups are faster than computing the samples one by one
+	if (g_system) {
+#ifdef SCUMMVM_AVX2
+		static const IMuseDigiMixKernels avx2Kernels = { mixBits8_AVX2, mixBits16_AVX2, mixBits8ToStereo_AVX2, mixBits16ToStereo_AVX2 };
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+			return &avx2Kernels;
+#endif
+#ifdef SCUMMVM_SSE2
+		static const IMuseDigiMixKernels sse2Kernels = { mixBits8_SSE2, mixBits16_SSE2, mixBits8ToStereo_SSE2, mixBits16ToStereo_SSE2 };
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			return &sse2Kernels;
+#endif
+#ifdef SCUMMVM_NEON
+		static const IMuseDigiMixKernels neonKernels = { mixBits8_NEON, mixBits16_NEON, mixBits8ToStereo_NEON, mixBits16ToStereo_NEON };
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			return &neonKernels;
+#endif
+	}
+
+	return nullptr;
+}
+
 IMuseDigiInternalMixer::IMuseDigiInternalMixer(Audio::Mixer *mixer, bool isEarlyDiMUSE) {
 	_mixer = mixer;
 	_stream = Audio::makeQueuingAudioStream(DIMUSE_SAMPLERATE, _mixer->getOutputStereo());
 	_isEarlyDiMUSE = isEarlyDiMUSE;
 	_radioChatter = 0;
 	_amp8Table = nullptr;
+	_kernels = getIMuseDigiMixKernels();
 }
 
 IMuseDigiInternalMixer::~IMuseDigiInternalMixer() {
@@ -309,6 +368,37 @@ int IMuseDigiInternalMixer::loop(uint8 **destBuffer, int len) {
 	return 0;
 }
 
+int IMuseDigiInternalMixer::getAmp8Factor(const int32 *ampTable) const {
+	return getMixAmpFactor((ampTable - _amp8Table) / 128);
+}
+
+int IMuseDigiInternalMixer::getAmp12Factor(const int32 *ampTable) const {
+	return getMixAmpFactor((ampTable - _amp12Table) / 2048);
+}
+
+void IMuseDigiInternalMixer::mixBits12Kernel(uint16 *dst, const uint8 *src, int32 count, int ampA, int ampB, bool toStereo) {
+	// The packed samples are widened to 16 bits in chunks, for the 16-bit kernels
+	int16 samples[512];
+
+	while (count > 0) {
+		const int32 chunk = MIN<int32>(count, ARRAYSIZE(samples));
+		for (int32 i = 0; i < chunk; i += 2) {
+			samples[i]     = (int16)(((src[0] | ((src[1] & 0xF)  << 8)) - 2048) * 16);
+			samples[i + 1] = (int16)(((src[2] | ((src[1] & 0xF0) << 4)) - 2048) * 16);
+			src += 3;
+		}
+
+		if (toStereo) {
+			_kernels->mix16ToStereo(dst, samples, chunk, ampA, ampB);
+			dst += chunk * 2;
+		} else {
+			_kernels->mix16(dst, samples, chunk, ampA, ampB);
+			dst += chunk;
+		}
+		count -= chunk;
+	}
+}
+
 void IMuseDigiInternalMixer::mixBits8Mono(uint8 *srcBuf, int32 inFrameCount, int feedSize, int32 mixBufStartIndex, int32 *ampTable, bool ftIs11025Hz) {
 	uint16 *mixBufCurCell;
 	uint8 *srcBuf_ptr;
@@ -331,6 +421,9 @@ void IMuseDigiInternalMixer::mixBits8Mono(uint8 *srcBuf, int32 inFrameCount, int
 
 			mixBufCurCell[0] += *((uint16 *)ampTable + srcBuf_ptr[0]);
 			mixBufCurCell[1] += *((uint16 *)ampTable + srcBuf_ptr[0]);
+		} else if (_kernels) {
+			const int amp = getAmp8Factor(ampTable);
+			_kernels->mix8(mixBufCurCell, srcBuf_ptr, inFrameCount, amp, amp);
 		} else {
 			if (inFrameCount) {
 				for (int i = 0; i < inFrameCount; i++) {
@@ -349,6 +442,9 @@ void IMuseDigiInternalMixer::mixBits8Mono(uint8 *srcBuf, int32 inFrameCount, int
 						value += ptr[i] - srcBuf_ptr[i];
 					}
 				}
+			} else if (_kernels) {
+				const int amp = getAmp8Factor(ampTable);
+				_kernels->mix8(mixBufCurCell, srcBuf_ptr, feedSize, amp, amp);
 			} else {
 				if (feedSize) {
 					for (int i = 0; i < feedSize; i++) {
@@ -401,7 +497,10 @@ void IMuseDigiInternalMixer::mixBits12Mono(uint8 *srcBuf, int32 inFrameCount, in
 	}
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[2 * mixBufStartIndex]);
-	if (feedSize == inFrameCount) {
+	if (feedSize == inFrameCount && _kernels) {
+		const int amp = getAmp12Factor(ampTable);
+		mixBits12Kernel(mixBufCurCell, srcBuf, inFrameCount, amp, amp, false);
+	} else if (feedSize == inFrameCount) {
 		if (inFrameCount / 2) {
 			srcBuf_ptr = srcBuf;
 			for (int i = 0; i < inFrameCount / 2; i++) {
@@ -476,7 +575,10 @@ void IMuseDigiInternalMixer::mixBits16Mono(uint8 *srcBuf, int32 inFrameCount, in
 	int residualLength;
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[2 * mixBufStartIndex]);
-	if (feedSize == inFrameCount) {
+	if (feedSize == inFrameCount && _kernels) {
+		const int amp = getAmp12Factor(ampTable);
+		_kernels->mix16(mixBufCurCell, (const int16 *)srcBuf, feedSize, amp, amp);
+	} else if (feedSize == inFrameCount) {
 		if (feedSize) {
 			srcBuf_ptr = (uint16 *)srcBuf;
 			for (int i = 0; i < feedSize; i++) {
@@ -719,6 +821,8 @@ void IMuseDigiInternalMixer::mixBits8ConvertToStereo(uint8 *srcBuf, int32 inFram
 			mixBufCurCell[1] += *((uint16 *)rightAmpTable + srcBuf_ptr[i]);
 			mixBufCurCell[2] += *((uint16 *)leftAmpTable  + srcBuf_ptr[i]);
 			mixBufCurCell[3] += *((uint16 *)rightAmpTable + srcBuf_ptr[i]);
+		} else if (_kernels) {
+			_kernels->mix8ToStereo(mixBufCurCell, srcBuf, inFrameCount, getAmp8Factor(leftAmpTable), getAmp8Factor(rightAmpTable));
 		} else {
 			srcBuf_ptr = srcBuf;
 			if (inFrameCount) {
@@ -743,6 +847,8 @@ void IMuseDigiInternalMixer::mixBits8ConvertToStereo(uint8 *srcBuf, int32 inFram
 						mixBufCurCell += 2;
 					}
 				}
+			} else if (_kernels) {
+				_kernels->mix8ToStereo(mixBufCurCell, srcBuf, feedSize, getAmp8Factor(leftAmpTable), getAmp8Factor(rightAmpTable));
 			} else {
 				if (feedSize) {
 					srcBuf_ptr = srcBuf;
@@ -830,7 +936,9 @@ void IMuseDigiInternalMixer::mixBits12ConvertToStereo(uint8 *srcBuf, int32 inFra
 	int residualLength;
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[4 * mixBufStartIndex]);
-	if (feedSize == inFrameCount) {
+	if (feedSize == inFrameCount && _kernels) {
+		mixBits12Kernel(mixBufCurCell, srcBuf, inFrameCount & ~1, getAmp12Factor(leftAmpTable), getAmp12Factor(rightAmpTable), true);
+	} else if (feedSize == inFrameCount) {
 		if (inFrameCount / 2) {
 			srcBuf_ptr = srcBuf;
 			for (int i = 0; i < (inFrameCount / 2); i++) {
@@ -977,7 +1085,9 @@ void IMuseDigiInternalMixer::mixBits16ConvertToStereo(uint8 *srcBuf, int32 inFra
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[2 * mixBufStartIndex]);
 
-	if (feedSize == inFrameCount) {
+	if (feedSize == inFrameCount && _kernels) {
+		_kernels->mix16ToStereo(mixBufCurCell, (const int16 *)srcBuf, feedSize, getAmp12Factor(leftAmpTable), getAmp12Factor(rightAmpTable));
+	} else if (feedSize == inFrameCount) {
 		if (feedSize) {
 			srcBuf_tmp = (uint16 *)srcBuf;
 			for (int i = 0; i < feedSize; i++) {
@@ -1065,7 +1175,10 @@ void IMuseDigiInternalMixer::mixBits8Stereo(uint8 *srcBuf, int32 inFrameCount, i
 	int residualLength;
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[4 * mixBufStartIndex]);
-	if (feedSize == inFrameCount) {
+	if (feedSize == inFrameCount && _kernels) {
+		const int amp = getAmp8Factor(ampTable);
+		_kernels->mix8(mixBufCurCell, srcBuf, feedSize * 2, amp, amp);
+	} else if (feedSize == inFrameCount) {
 		if (feedSize) {
 			srcBuf_ptr = srcBuf;
 			for (int i = 0; i < feedSize; i++) {
@@ -1149,7 +1262,10 @@ void IMuseDigiInternalMixer::mixBits12Stereo(uint8 *srcBuf, int32 inFrameCount,
 	int residualLength;
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[4 * mixBufStartIndex]);
-	if (feedSize == inFrameCount) {
+	if (feedSize == inFrameCount && _kernels) {
+		const int amp = getAmp12Factor(ampTable);
+		mixBits12Kernel(mixBufCurCell, srcBuf, feedSize * 2, amp, amp, false);
+	} else if (feedSize == inFrameCount) {
 		if (feedSize) {
 			srcBuf_ptr = srcBuf;
 
@@ -1242,7 +1358,10 @@ void IMuseDigiInternalMixer::mixBits16Stereo(uint8 *srcBuf, int32 inFrameCount,
 	int residualLength;
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[4 * mixBufStartIndex]);
-	if (feedSize == inFrameCount) {
+	if (feedSize == inFrameCount && _kernels) {
+		const int amp = getAmp12Factor(ampTable);
+		_kernels->mix16(mixBufCurCell, (const int16 *)srcBuf, feedSize * 2, amp, amp);
+	} else if (feedSize == inFrameCount) {
 		if (feedSize) {
 			srcBuf_ptr = (uint16 *)srcBuf;
 
@@ -42,6 +42,8 @@ class QueuingAudioStream;
 
 namespace Scumm {
 
+struct IMuseDigiMixKernels;
+
 class IMuseDigiInternalMixer {
 
 private:
@@ -60,6 +62,11 @@ private:
 	int _outChannelCount;
 	int _stereoReverseFlag;
 	bool _isEarlyDiMUSE;
+	const IMuseDigiMixKernels *_kernels;
+
+	int getAmp8Factor(const int32 *ampTable) const;
+	int getAmp12Factor(const int32 *ampTable) const;
+	void mixBits12Kernel(uint16 *dst, const uint8 *src, int32 count, int ampA, int ampB, bool toStereo);
 
 	void mixBits8Mono(uint8 *srcBuf, int32 inFrameCount, int feedSize, int32 mixBufStartIndex, int32 *ampTable, bool ftIs11025Hz);
 	void mixBits12Mono(uint8 *srcBuf, int32 inFrameCount, int feedSize, int32 mixBufStartIndex, int32 *ampTable);
@@ -0,0 +1,113 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "scumm/imuse_digi/dimuse_internalmixer_intern.h"
+
+#include <immintrin.h>
+
+namespace Scumm {
+
+/** See the SSE2 version. */
+static inline __m256i ampSamples(__m256i x, __m256i amp) {
+	const __m256i sign = _mm256_srai_epi16(x, 15);
+	const __m256i a = _mm256_sub_epi16(_mm256_xor_si256(x, sign), sign);
+
+	const __m256i lo = _mm256_mullo_epi16(a, amp);
+	const __m256i hi = _mm256_mulhi_epu16(a, amp);
+	const __m256i h = _mm256_or_si256(_mm256_slli_epi16(hi, 9), _mm256_srli_epi16(lo, 7));
+	const __m256i m = _mm256_add_epi16(h, _mm256_and_si256(lo, _mm256_set1_epi16(127)));
+	const __m256i q = _mm256_add_epi16(h, _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(m, _mm256_srli_epi16(m, 7)), _mm256_set1_epi16(1)), 7));
+
+	return _mm256_sub_epi16(_mm256_xor_si256(q, sign), sign);
+}
+
+static inline __m256i load8(const uint8 *src) {
+	const __m256i s = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)src));
+	return _mm256_slli_epi16(_mm256_sub_epi16(s, _mm256_set1_epi16(128)), 4);
+}
+
+static inline __m256i load16(const int16 *src) {
+	return _mm256_srai_epi16(_mm256_loadu_si256((const __m256i *)src), 4);
+}
+
+static inline void addTo(uint16 *dst, __m256i v) {
+	_mm256_storeu_si256((__m256i *)dst, _mm256_add_epi16(_mm256_loadu_si256((const __m256i *)dst), v));
+}
+
+static inline __m256i ampPattern(int ampA, int ampB) {
+	return _mm256_set_epi16(ampB, ampA, ampB, ampA, ampB, ampA, ampB, ampA,
+	                        ampB, ampA, ampB, ampA, ampB, ampA, ampB, ampA);
+}
+
+/** Doubles each sample, for mono to stereo. */
+static inline void mixToStereo(uint16 *dst, __m256i x, __m256i amp) {
+	// The unpacks work within the 128-bit lanes
+	const __m256i lo = _mm256_unpacklo_epi16(x, x);
+	const __m256i hi = _mm256_unpackhi_epi16(x, x);
+	addTo(dst, ampSamples(_mm256_permute2x128_si256(lo, hi, 0x20), amp));
+	addTo(dst + 16, ampSamples(_mm256_permute2x128_si256(lo, hi, 0x31), amp));
+}
+
+void mixBits8_AVX2(uint16 *dst, const uint8 *src, uint count, int ampA, int ampB) {
+	const __m256i amp = ampPattern(ampA, ampB);
+
+	uint i = 0;
+	for (; i + 16 <= count; i += 16)
+		addTo(dst + i, ampSamples(load8(src + i), amp));
+
+	if (i < count)
+		mixBits8_Scalar(dst + i, src + i, count - i, ampA, ampB);
+}
+
+void mixBits16_AVX2(uint16 *dst, const int16 *src, uint count, int ampA, int ampB) {
+	const __m256i amp = ampPattern(ampA, ampB);
+
+	uint i = 0;
+	for (; i + 16 <= count; i += 16)
+		addTo(dst + i, ampSamples(load16(src + i), amp));
+
+	if (i < count)
+		mixBits16_Scalar(dst + i, src + i, count - i, ampA, ampB);
+}
+
+void mixBits8ToStereo_AVX2(uint16 *dst, const uint8 *src, uint count, int ampL, int ampR) {
+	const __m256i amp = ampPattern(ampL, ampR);
+
+	uint i = 0;
+	for (; i + 16 <= count; i += 16)
+		mixToStereo(dst + i * 2, load8(src + i), amp);
+
+	if (i < count)
+		mixBits8ToStereo_Scalar(dst + i * 2, src + i, count - i, ampL, ampR);
+}
+
+void mixBits16ToStereo_AVX2(uint16 *dst, const int16 *src, uint count, int ampL, int ampR) {
+	const __m256i amp = ampPattern(ampL, ampR);
+
+	uint i = 0;
+	for (; i + 16 <= count; i += 16)
+		mixToStereo(dst + i * 2, load16(src + i), amp);
+
+	if (i < count)
+		mixBits16ToStereo_Scalar(dst + i * 2, src + i, count - i, ampL, ampR);
+}
+
+} // End of namespace Scumm
@@ -0,0 +1,111 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#if !defined(SCUMM_IMUSE_DIGI_MIXER_INTERN_H) && defined(ENABLE_SCUMM_7_8)
+#define SCUMM_IMUSE_DIGI_MIXER_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Scumm {
+
+/**
+ * The amplitude tables of IMuseDigiInternalMixer are linear: for a volume
+ * step, the entry of a sample is
+ *
+ *   (x * amp) / 127
+ *
+ * truncated towards zero, where x is the sample in the range [-2048, 2047]
+ * and amp is the factor returned by getMixAmpFactor(). 8-bit samples are
+ * 16 * (s - 128), 12-bit samples s - 2048 and 16-bit samples s >> 4.
+ *
+ * The kernels below compute the entries instead of looking them up, and
+ * add the results to the 16-bit cells of the mixing buffer, wrapping
+ * around like the table code does.
+ */
+inline int getMixAmpFactor(int volume) {
+	return volume ? volume * 8 - 1 : 0;
+}
+
+inline int16 mixAmpSample(int x, int amp) {
+	return (int16)((x * amp) / 127);
+}
+
+/**
+ * dst[i] += amp(src[i]), with ampA applied to the even and ampB to the odd
+ * samples. For interleaved stereo sources, and for mono ones with
+ * ampA == ampB.
+ */
+typedef void (*MixBits8Proc)(uint16 *dst, const uint8 *src, uint count, int ampA, int ampB);
+typedef void (*MixBits16Proc)(uint16 *dst, const int16 *src, uint count, int ampA, int ampB);
+
+/**
+ * dst[2 * i] += amp(src[i]) with ampL, dst[2 * i + 1] += amp(src[i]) with
+ * ampR. For mono sources mixed into stereo.
+ */
+typedef void (*MixBits8ToStereoProc)(uint16 *dst, const uint8 *src, uint count, int ampL, int ampR);
+typedef void (*MixBits16ToStereoProc)(uint16 *dst, const int16 *src, uint count, int ampL, int ampR);
+
+/**
+ * The inner loops of IMuseDigiInternalMixer for sources which don't need to
+ * be resampled. All implementations produce the same output as the tables.
+ */
+struct IMuseDigiMixKernels {
+	MixBits8Proc mix8;
+	MixBits16Proc mix16;
+	MixBits8ToStereoProc mix8ToStereo;
+	MixBits16ToStereoProc mix16ToStereo;
+};
+
+void mixBits8_Scalar(uint16 *dst, const uint8 *src, uint count, int ampA, int ampB);
+void mixBits16_Scalar(uint16 *dst, const int16 *src, uint count, int ampA, int ampB);
+void mixBits8ToStereo_Scalar(uint16 *dst, const uint8 *src, uint count, int ampL, int ampR);
+void mixBits16ToStereo_Scalar(uint16 *dst, const int16 *src, uint count, int ampL, int ampR);
+
+#ifdef SCUMMVM_SSE2
+void mixBits8_SSE2(uint16 *dst, const uint8 *src, uint count, int ampA, int ampB);
+void mixBits16_SSE2(uint16 *dst, const int16 *src, uint count, int ampA, int ampB);
+void mixBits8ToStereo_SSE2(uint16 *dst, const uint8 *src, uint count, int ampL, int ampR);
+void mixBits16ToStereo_SSE2(uint16 *dst, const int16 *src, uint count, int ampL, int ampR);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void mixBits8_AVX2(uint16 *dst, const uint8 *src, uint count, int ampA, int ampB);
+void mixBits16_AVX2(uint16 *dst, const int16 *src, uint count, int ampA, int ampB);
+void mixBits8ToStereo_AVX2(uint16 *dst, const uint8 *src, uint count, int ampL, int ampR);
+void mixBits16ToStereo_AVX2(uint16 *dst, const int16 *src, uint count, int ampL, int ampR);
+#endif
+
+#ifdef SCUMMVM_NEON
+void mixBits8_NEON(uint16 *dst, const uint8 *src, uint count, int ampA, int ampB);
+void mixBits16_NEON(uint16 *dst, const int16 *src, uint count, int ampA, int ampB);
+void mixBits8ToStereo_NEON(uint16 *dst, const uint8 *src, uint count, int ampL, int ampR);
+void mixBits16ToStereo_NEON(uint16 *dst, const int16 *src, uint count, int ampL, int ampR);
+#endif
+
+/**
+ * Returns the fastest set of kernels supported by the CPU we are running on,
+ * or nullptr if there is none faster than the tables.
+ */
+const IMuseDigiMixKernels *getIMuseDigiMixKernels();
+
+} // End of namespace Scumm
+
+#endif
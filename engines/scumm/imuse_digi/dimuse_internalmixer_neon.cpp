@@ -0,0 +1,122 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "scumm/imuse_digi/dimuse_internalmixer_intern.h"
+
+#include <arm_neon.h>
+
+namespace Scumm {
+
+/**
+ * Computes (x * amp) / 127 for samples in [-2048, 2047] and factors in
+ * [0, 127], truncating towards zero. See the SSE2 version for the division.
+ */
+static inline uint16x4_t divideBy127(uint32x4_t n) {
+	const uint32x4_t h = vshrq_n_u32(n, 7);
+	const uint32x4_t m = vaddq_u32(h, vandq_u32(n, vdupq_n_u32(127)));
+	return vmovn_u32(vaddq_u32(h, vshrq_n_u32(vaddq_u32(vaddq_u32(m, vshrq_n_u32(m, 7)), vdupq_n_u32(1)), 7)));
+}
+
+static inline int16x8_t ampSamples(int16x8_t x, uint16x8_t amp) {
+	const int16x8_t sign = vshrq_n_s16(x, 15);
+	const uint16x8_t a = vreinterpretq_u16_s16(vabsq_s16(x));
+
+	const uint16x4_t q0 = divideBy127(vmull_u16(vget_low_u16(a), vget_low_u16(amp)));
+	const uint16x4_t q1 = divideBy127(vmull_u16(vget_high_u16(a), vget_high_u16(amp)));
+	const int16x8_t q = vreinterpretq_s16_u16(vcombine_u16(q0, q1));
+
+	return vsubq_s16(veorq_s16(q, sign), sign);
+}
+
+static inline int16x8_t load8(const uint8 *src) {
+	const int16x8_t s = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src)));
+	return vshlq_n_s16(vsubq_s16(s, vdupq_n_s16(128)), 4);
+}
+
+static inline int16x8_t load16(const int16 *src) {
+	return vshrq_n_s16(vld1q_s16(src), 4);
+}
+
+static inline void addTo(uint16 *dst, int16x8_t v) {
+	vst1q_u16(dst, vaddq_u16(vld1q_u16(dst), vreinterpretq_u16_s16(v)));
+}
+
+static inline uint16x8_t ampPattern(int ampA, int ampB) {
+	const uint16_t pattern[8] = {
+		(uint16_t)ampA, (uint16_t)ampB, (uint16_t)ampA, (uint16_t)ampB,
+		(uint16_t)ampA, (uint16_t)ampB, (uint16_t)ampA, (uint16_t)ampB
+	};
+	return vld1q_u16(pattern);
+}
+
+void mixBits8_NEON(uint16 *dst, const uint8 *src, uint count, int ampA, int ampB) {
+	const uint16x8_t amp = ampPattern(ampA, ampB);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8)
+		addTo(dst + i, ampSamples(load8(src + i), amp));
+
+	if (i < count)
+		mixBits8_Scalar(dst + i, src + i, count - i, ampA, ampB);
+}
+
+void mixBits16_NEON(uint16 *dst, const int16 *src, uint count, int ampA, int ampB) {
+	const uint16x8_t amp = ampPattern(ampA, ampB);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8)
+		addTo(dst + i, ampSamples(load16(src + i), amp));
+
+	if (i < count)
+		mixBits16_Scalar(dst + i, src + i, count - i, ampA, ampB);
+}
+
+void mixBits8ToStereo_NEON(uint16 *dst, const uint8 *src, uint count, int ampL, int ampR) {
+	const uint16x8_t amp = ampPattern(ampL, ampR);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const int16x8_t s = load8(src + i);
+		const int16x8x2_t x = vzipq_s16(s, s);
+		addTo(dst + i * 2, ampSamples(x.val[0], amp));
+		addTo(dst + i * 2 + 8, ampSamples(x.val[1], amp));
+	}
+
+	if (i < count)
+		mixBits8ToStereo_Scalar(dst + i * 2, src + i, count - i, ampL, ampR);
+}
+
+void mixBits16ToStereo_NEON(uint16 *dst, const int16 *src, uint count, int ampL, int ampR) {
+	const uint16x8_t amp = ampPattern(ampL, ampR);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const int16x8_t s = load16(src + i);
+		const int16x8x2_t x = vzipq_s16(s, s);
+		addTo(dst + i * 2, ampSamples(x.val[0], amp));
+		addTo(dst + i * 2 + 8, ampSamples(x.val[1], amp));
+	}
+
+	if (i < count)
+		mixBits16ToStereo_Scalar(dst + i * 2, src + i, count - i, ampL, ampR);
+}
+
+} // End of namespace Scumm
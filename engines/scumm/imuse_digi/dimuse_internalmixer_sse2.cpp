@@ -0,0 +1,110 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "scumm/imuse_digi/dimuse_internalmixer_intern.h"
+
+#include <emmintrin.h>
+
+namespace Scumm {
+
+/**
+ * Computes (x * amp) / 127 for samples in [-2048, 2047] and factors in
+ * [0, 127], truncating towards zero, in 16-bit lanes. The products have
+ * up to 18 bits, so they are divided as n = 128 * h + l, for which
+ * n / 127 = h + (h + l) / 127.
+ */
+static inline __m128i ampSamples(__m128i x, __m128i amp) {
+	const __m128i sign = _mm_srai_epi16(x, 15);
+	const __m128i a = _mm_sub_epi16(_mm_xor_si128(x, sign), sign);
+
+	const __m128i lo = _mm_mullo_epi16(a, amp);
+	const __m128i hi = _mm_mulhi_epu16(a, amp);
+	const __m128i h = _mm_or_si128(_mm_slli_epi16(hi, 9), _mm_srli_epi16(lo, 7));
+	const __m128i m = _mm_add_epi16(h, _mm_and_si128(lo, _mm_set1_epi16(127)));
+	const __m128i q = _mm_add_epi16(h, _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(m, _mm_srli_epi16(m, 7)), _mm_set1_epi16(1)), 7));
+
+	return _mm_sub_epi16(_mm_xor_si128(q, sign), sign);
+}
+
+static inline __m128i load8(const uint8 *src) {
+	const __m128i s = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+	return _mm_slli_epi16(_mm_sub_epi16(s, _mm_set1_epi16(128)), 4);
+}
+
+static inline __m128i load16(const int16 *src) {
+	return _mm_srai_epi16(_mm_loadu_si128((const __m128i *)src), 4);
+}
+
+static inline void addTo(uint16 *dst, __m128i v) {
+	_mm_storeu_si128((__m128i *)dst, _mm_add_epi16(_mm_loadu_si128((const __m128i *)dst), v));
+}
+
+void mixBits8_SSE2(uint16 *dst, const uint8 *src, uint count, int ampA, int ampB) {
+	const __m128i amp = _mm_set_epi16(ampB, ampA, ampB, ampA, ampB, ampA, ampB, ampA);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8)
+		addTo(dst + i, ampSamples(load8(src + i), amp));
+
+	if (i < count)
+		mixBits8_Scalar(dst + i, src + i, count - i, ampA, ampB);
+}
+
+void mixBits16_SSE2(uint16 *dst, const int16 *src, uint count, int ampA, int ampB) {
+	const __m128i amp = _mm_set_epi16(ampB, ampA, ampB, ampA, ampB, ampA, ampB, ampA);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8)
+		addTo(dst + i, ampSamples(load16(src + i), amp));
+
+	if (i < count)
+		mixBits16_Scalar(dst + i, src + i, count - i, ampA, ampB);
+}
+
+void mixBits8ToStereo_SSE2(uint16 *dst, const uint8 *src, uint count, int ampL, int ampR) {
+	const __m128i amp = _mm_set_epi16(ampR, ampL, ampR, ampL, ampR, ampL, ampR, ampL);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i x = load8(src + i);
+		addTo(dst + i * 2, ampSamples(_mm_unpacklo_epi16(x, x), amp));
+		addTo(dst + i * 2 + 8, ampSamples(_mm_unpackhi_epi16(x, x), amp));
+	}
+
+	if (i < count)
+		mixBits8ToStereo_Scalar(dst + i * 2, src + i, count - i, ampL, ampR);
+}
+
+void mixBits16ToStereo_SSE2(uint16 *dst, const int16 *src, uint count, int ampL, int ampR) {
+	const __m128i amp = _mm_set_epi16(ampR, ampL, ampR, ampL, ampR, ampL, ampR, ampL);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i x = load16(src + i);
+		addTo(dst + i * 2, ampSamples(_mm_unpacklo_epi16(x, x), amp));
+		addTo(dst + i * 2 + 8, ampSamples(_mm_unpackhi_epi16(x, x), amp));
+	}
+
+	if (i < count)
+		mixBits16ToStereo_Scalar(dst + i * 2, src + i, count - i, ampL, ampR);
+}
+
+} // End of namespace Scumm
@@ -125,6 +125,24 @@ MODULE_OBJS += \
 	smush/codec47ARM.o
 endif
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	imuse_digi/dimuse_internalmixer_sse2.o
+$(MODULE)/imuse_digi/dimuse_internalmixer_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	imuse_digi/dimuse_internalmixer_avx2.o
+$(MODULE)/imuse_digi/dimuse_internalmixer_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	imuse_digi/dimuse_internalmixer_neon.o
+$(MODULE)/imuse_digi/dimuse_internalmixer_neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+endif
+
 endif
 
 ifdef USE_ARM_GFX_ASM
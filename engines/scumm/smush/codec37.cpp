@@ -324,6 +324,30 @@ void Codec37Decoder::maketable(int pitch, int index) {
 		dst += 4;						  \
 	} while (0)
 
+/*
+ * Copy a run of 4x4 pixel blocks from the same place in the other buffer.
+ * The blocks of a run which lie on the same block row are copied four rows
+ * at a time, so that memcpy can use its widest moves on them.
+ */
+
+#define COPY_4X4_RUN(length, next_offs, dst, pitch, i, bw, bh)		\
+	do {								\
+		while (length > 0) {					\
+			int32 run = MIN<int32>(length, i);		\
+			for (int x = 0; x < 4; x++) {			\
+				memcpy(dst + pitch * x, dst + next_offs + pitch * x, run * 4); \
+			}						\
+			dst += run * 4;					\
+			length -= run;					\
+			i -= run;					\
+			if (i == 0) {					\
+				dst += pitch * 3;			\
+				bh--;					\
+				i = bw;					\
+			}						\
+		}							\
+	} while (0)
+
 void Codec37Decoder::proc1(byte *dst, const byte *src, int32 next_offs, int bw, int bh, int pitch, int16 *offset_table) {
 	uint8 code;
 	bool filling, skipCode;
@@ -438,16 +462,7 @@ void Codec37Decoder::proc4WithFDFE(byte *dst, const byte *src, int32 next_offs,
 				LITERAL_1X1(src, dst, pitch);
 			} else if (code == 0x00) {
 				int32 length = *src++ + 1;
-				for (int32 l = 0; l < length; l++) {
-					byte *dst2 = dst + next_offs;
-					COPY_4X4(dst2, dst, pitch);
-					i--;
-					if (i == 0) {
-						dst += pitch * 3;
-						bh--;
-						i = bw;
-					}
-				}
+				COPY_4X4_RUN(length, next_offs, dst, pitch, i, bw, bh);
 				if (bh == 0) {
 					return;
 				}
@@ -470,16 +485,7 @@ void Codec37Decoder::proc4WithoutFDFE(byte *dst, const byte *src, int32 next_off
 				LITERAL_1X1(src, dst, pitch);
 			} else if (code == 0x00) {
 				int32 length = *src++ + 1;
-				for (int32 l = 0; l < length; l++) {
-					byte *dst2 = dst + next_offs;
-					COPY_4X4(dst2, dst, pitch);
-					i--;
-					if (i == 0) {
-						dst += pitch * 3;
-						bh--;
-						i = bw;
-					}
-				}
+				COPY_4X4_RUN(length, next_offs, dst, pitch, i, bw, bh);
 				if (bh == 0) {
 					return;
 				}
@@ -63,6 +63,15 @@ namespace Scumm {
 		(dst)[3] = val;	\
 	} while (0)
 
+// The rows of the 8x8 blocks are moved at once. A fixed size memcpy/memset
+// is turned into a single unaligned 64 bit load and store by the compiler,
+// which is all a SSE2 or NEON kernel would do for 8 pixels as well.
+#define COPY_8X1_LINE(dst, src)			\
+	memcpy((dst), (src), 8)
+
+#define FILL_8X1_LINE(dst, val)			\
+	memset((dst), (val), 8)
+
 #define FILL_2X1_LINE(dst, val)			\
 	do {					\
 		(dst)[0] = val;	\
@@ -463,8 +472,7 @@ void Codec47Decoder::level1(byte *d_dst) {
 	if (code < MOTION_OFFSET_TABLE_SIZE) {
 		tmp = _table[code] + _offset1;
 		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp + 4);
+			COPY_8X1_LINE(d_dst, d_dst + tmp);
 			d_dst += _d_pitch;
 		}
 	} else if (code == PROCESS_SUBBLOCKS) {
@@ -478,8 +486,7 @@ void Codec47Decoder::level1(byte *d_dst) {
 	} else if (code == FILL_SINGLE_COLOR) {
 		byte t = *_d_src++;
 		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
+			FILL_8X1_LINE(d_dst, t);
 			d_dst += _d_pitch;
 		}
 	} else if (code == DRAW_GLYPH) {
@@ -502,15 +509,13 @@ void Codec47Decoder::level1(byte *d_dst) {
 	} else if (code == COPY_PREV_BUFFER) {
 		tmp = _offset2;
 		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp + 4);
+			COPY_8X1_LINE(d_dst, d_dst + tmp);
 			d_dst += _d_pitch;
 		}
 	} else {
 		byte t = _paramPtr[code];
 		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
+			FILL_8X1_LINE(d_dst, t);
 			d_dst += _d_pitch;
 		}
 	}
@@ -55,6 +55,8 @@ public:
 	Codec47Decoder(int width, int height);
 	~Codec47Decoder();
 	bool decode(byte *dst, const byte *src);
+	/** The number of bytes decode() writes to dst. */
+	int32 getFrameSize() const { return _frameSize; }
 };
 
 } // End of namespace Scumm
@@ -22,6 +22,7 @@
 #include "common/config-manager.h"
 #include "common/file.h"
 #include "common/system.h"
+#include "common/thread.h"
 #include "common/util.h"
 #include "common/rect.h"
 
@@ -262,6 +263,20 @@ SmushPlayer::SmushPlayer(ScummEngine_v7 *scumm, IMuseDigital *imuseDigital, Insa
 	_smushAudioInitialized = false;
 	_smushAudioCallbackEnabled = false;
 
+	_decodeAhead = false;
+	_decodeThread = nullptr;
+	_decodeMutex = nullptr;
+	_decodeQueued = nullptr;
+	_decodeDone = nullptr;
+	_decodeQuit = false;
+	_decodeState = kDecodeIdle;
+	_decodeValid = false;
+	_decodeOffset = -1;
+	_decodeCodec = 0;
+	_decodeSrc = nullptr;
+	_decodeFrame = nullptr;
+	_decodeFrameSize = 0;
+
 	initAudio(DIMUSE_SAMPLERATE, 200000);
 }
 
@@ -330,6 +345,12 @@ void SmushPlayer::release() {
 	_vm->_virtscr[kMainVirtScreen].pitch = _origPitch;
 	_vm->_gdi->_numStrips = _origNumStrips;
 
+	// The decode thread may still be working with the codecs
+	stopDecodeThread();
+	free(_decodeFrame);
+	_decodeFrame = nullptr;
+	_decodeFrameSize = 0;
+
 	delete _codec37;
 	_codec37 = 0;
 	delete _codec47;
@@ -745,7 +766,7 @@ byte *SmushPlayer::getVideoPalette() {
 void smushDecodeRLE(byte *dst, const byte *src, int left, int top, int width, int height, int pitch);
 void smushDecodeUncompressed(byte *dst, const byte *src, int left, int top, int width, int height, int pitch);
 
-void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height) {
+void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height, const byte *decoded) {
 	if ((height == 242) && (width == 384)) {
 		if (_specialBuffer == 0)
 			_specialBuffer = (byte *)malloc(242 * 384);
@@ -772,12 +793,20 @@ void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int t
 		smushDecodeRLE(_dst, src, left, top, width, height, _vm->_screenWidth);
 		break;
 	case SMUSH_CODEC_37:
+		if (decoded) {
+			memcpy(_dst, decoded, _codec37->getFrameSize());
+			break;
+		}
 		if (!_codec37)
 			_codec37 = new Codec37Decoder(width, height);
 		if (_codec37)
 			_codec37->decode(_dst, src);
 		break;
 	case SMUSH_CODEC_47:
+		if (decoded) {
+			memcpy(_dst, decoded, _codec47->getFrameSize());
+			break;
+		}
 		if (!_codec47)
 			_codec47 = new Codec47Decoder(width, height);
 		if (_codec47)
@@ -825,6 +854,8 @@ void SmushPlayer::handleZlibFrameObject(int32 subSize, Common::SeekableReadStrea
 	int width = READ_LE_UINT16(ptr); ptr += 2;
 	int height = READ_LE_UINT16(ptr); ptr += 2;
 
+	if (_decodeThread)
+		finishDecodeAhead(-1);
 	decodeFrameObject(codec, fobjBuffer + 14, left, top, width, height);
 
 	free(fobjBuffer);
@@ -838,6 +869,7 @@ void SmushPlayer::handleFrameObject(int32 subSize, Common::SeekableReadStream &b
 		return;
 	}
 
+	const int32 offset = b.pos();
 	int codec = b.readUint16LE();
 	int left = b.readUint16LE();
 	int top = b.readUint16LE();
@@ -847,6 +879,12 @@ void SmushPlayer::handleFrameObject(int32 subSize, Common::SeekableReadStream &b
 	b.readUint16LE();
 	b.readUint16LE();
 
+	const byte *decoded = _decodeThread ? finishDecodeAhead(offset) : nullptr;
+	if (decoded) {
+		decodeFrameObject(codec, nullptr, left, top, width, height, decoded);
+		return;
+	}
+
 	int32 chunk_size = subSize - 14;
 	byte *chunk_buffer = (byte *)malloc(chunk_size);
 	assert(chunk_buffer);
@@ -1060,12 +1098,185 @@ void SmushPlayer::parseNextFrame() {
 
 	_base->seek(subOffset + subSize, SEEK_SET);
 
+	if (subType == MKTAG('F','R','M','E') && _decodeThread)
+		queueDecodeAhead();
+
 	if (_insanity)
 		_vm->_sound->processSound();
 
 	_vm->_imuseDigital->flushTracks();
 }
 
+bool SmushPlayer::startDecodeThread() {
+	_decodeQueued = g_system->createConditionVariable();
+	_decodeDone = g_system->createConditionVariable();
+	if (_decodeQueued && _decodeDone) {
+		_decodeMutex = g_system->createMutex();
+		_decodeQuit = false;
+		_decodeState = kDecodeIdle;
+		_decodeThread = g_system->createThread(decodeThreadEntry, this);
+		if (_decodeThread)
+			return true;
+	}
+
+	delete _decodeQueued;
+	delete _decodeDone;
+	delete _decodeMutex;
+	_decodeQueued = _decodeDone = nullptr;
+	_decodeMutex = nullptr;
+	return false;
+}
+
+void SmushPlayer::stopDecodeThread() {
+	if (!_decodeThread)
+		return;
+
+	_decodeMutex->lock();
+	_decodeQuit = true;
+	_decodeQueued->broadcast();
+	_decodeMutex->unlock();
+
+	_decodeThread->join();
+	delete _decodeThread;
+	_decodeThread = nullptr;
+
+	free(_decodeSrc);
+	_decodeSrc = nullptr;
+	_decodeState = kDecodeIdle;
+
+	delete _decodeQueued;
+	delete _decodeDone;
+	delete _decodeMutex;
+	_decodeQueued = _decodeDone = nullptr;
+	_decodeMutex = nullptr;
+}
+
+void SmushPlayer::decodeThreadEntry(void *data) {
+	((SmushPlayer *)data)->decodeLoop();
+}
+
+void SmushPlayer::decodeLoop() {
+	_decodeMutex->lock();
+	while (!_decodeQuit) {
+		if (_decodeState != kDecodeQueued) {
+			_decodeQueued->wait(_decodeMutex);
+			continue;
+		}
+		_decodeMutex->unlock();
+
+		// The engine thread leaves the codecs alone until the job is done
+		bool valid = true;
+		if (_decodeCodec == SMUSH_CODEC_37)
+			_codec37->decode(_decodeFrame, _decodeSrc);
+		else
+			valid = _codec47->decode(_decodeFrame, _decodeSrc);
+
+		_decodeMutex->lock();
+		_decodeValid = valid;
+		_decodeState = kDecodeDone;
+		_decodeDone->broadcast();
+	}
+	_decodeMutex->unlock();
+}
+
+void SmushPlayer::queueDecodeAhead() {
+	if (_insanity || _seekPos >= 0 || _endOfFile)
+		return;
+
+	_decodeMutex->lock();
+	const bool busy = (_decodeState != kDecodeIdle);
+	_decodeMutex->unlock();
+	if (busy)
+		return;
+
+	const int32 pos = _base->pos();
+	int32 offset = -1;
+	int32 size = 0;
+	int codec = 0, width = 0, height = 0;
+
+	// Only the first frame object of the frame, nothing else in the frame
+	// uses the codecs before it
+	if (pos + 8 < (int32)_baseSize && _base->readUint32BE() == MKTAG('F','R','M','E')) {
+		int32 frameSize = _base->readUint32BE();
+		while (frameSize > 0) {
+			const uint32 subType = _base->readUint32BE();
+			const int32 subSize = _base->readUint32BE();
+			const int32 subOffset = _base->pos();
+			if (_base->eos() || subSize < 0)
+				break;
+
+			if (subType == MKTAG('F','O','B','J') || subType == MKTAG('Z','F','O','B')) {
+				if (subType == MKTAG('F','O','B','J') && subSize >= 14) {
+					codec = _base->readUint16LE();
+					_base->readUint16LE();
+					_base->readUint16LE();
+					width = _base->readUint16LE();
+					height = _base->readUint16LE();
+					offset = subOffset;
+					size = subSize - 14;
+				}
+				break;
+			}
+
+			frameSize -= subSize + 8;
+			_base->seek(subOffset + subSize, SEEK_SET);
+			if (subSize & 1) {
+				_base->skip(1);
+				frameSize--;
+			}
+		}
+	}
+
+	// Smaller frame objects are skipped or drawn elsewhere by decodeFrameObject()
+	if (offset >= 0 && width == _vm->_screenWidth && height == _vm->_screenHeight &&
+		(codec == SMUSH_CODEC_37 || codec == SMUSH_CODEC_47)) {
+		int32 frameSize;
+		if (codec == SMUSH_CODEC_37) {
+			if (!_codec37)
+				_codec37 = new Codec37Decoder(width, height);
+			frameSize = _codec37->getFrameSize();
+		} else {
+			if (!_codec47)
+				_codec47 = new Codec47Decoder(width, height);
+			frameSize = _codec47->getFrameSize();
+		}
+
+		if (frameSize > _decodeFrameSize) {
+			free(_decodeFrame);
+			_decodeFrame = (byte *)malloc(frameSize);
+			assert(_decodeFrame);
+			_decodeFrameSize = frameSize;
+		}
+
+		_base->seek(offset + 14, SEEK_SET);
+		_decodeSrc = (byte *)malloc(size);
+		assert(_decodeSrc);
+		_base->read(_decodeSrc, size);
+		_decodeOffset = offset;
+		_decodeCodec = codec;
+
+		_decodeMutex->lock();
+		_decodeState = kDecodeQueued;
+		_decodeQueued->signal();
+		_decodeMutex->unlock();
+	}
+
+	_base->seek(pos, SEEK_SET);
+}
+
+const byte *SmushPlayer::finishDecodeAhead(int32 offset) {
+	_decodeMutex->lock();
+	while (_decodeState == kDecodeQueued)
+		_decodeDone->wait(_decodeMutex);
+	const bool found = (_decodeState == kDecodeDone && _decodeValid && _decodeOffset == offset);
+	_decodeState = kDecodeIdle;
+	_decodeMutex->unlock();
+
+	free(_decodeSrc);
+	_decodeSrc = nullptr;
+	return found ? _decodeFrame : nullptr;
+}
+
 void SmushPlayer::setPalette(const byte *palette) {
 	memcpy(_pal, palette, 0x300);
 	setDirtyColors(0, 255);
@@ -1188,6 +1399,11 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 	setupAnim(filename);
 	init(speed);
 
+	// FT's INSANE seeks around in the files, which the decode thread can't follow
+	_decodeAhead = !_insanity && ConfMan.hasKey("smush_decode_ahead") && ConfMan.getBool("smush_decode_ahead");
+	if (_decodeAhead && !startDecodeThread())
+		_decodeAhead = false;
+
 	_startTime = _vm->_system->getMillis();
 	_startFrame = startFrame;
 	_frame = startFrame;
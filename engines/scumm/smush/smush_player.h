@@ -29,6 +29,12 @@ class SoundHandle;
 class QueuingAudioStream;
 }
 
+namespace Common {
+class MutexInternal;
+class ThreadInternal;
+class ConditionVariableInternal;
+}
+
 namespace Scumm {
 
 #define SMUSH_MAX_TRACKS 4
@@ -172,6 +178,27 @@ private:
 	bool _smushAudioInitialized;
 	bool _smushAudioCallbackEnabled;
 
+	/** The frame object of the next frame, decoded by the decode thread. */
+	enum DecodeState {
+		kDecodeIdle,
+		kDecodeQueued,
+		kDecodeDone
+	};
+
+	bool _decodeAhead;
+	Common::ThreadInternal *_decodeThread;
+	Common::MutexInternal *_decodeMutex;
+	Common::ConditionVariableInternal *_decodeQueued;
+	Common::ConditionVariableInternal *_decodeDone;
+	bool _decodeQuit; ///< Guarded by _decodeMutex
+	DecodeState _decodeState; ///< Guarded by _decodeMutex
+	bool _decodeValid; ///< Guarded by _decodeMutex
+	int32 _decodeOffset; ///< Position of the frame object in _base
+	int _decodeCodec;
+	byte *_decodeSrc;
+	byte *_decodeFrame;
+	int32 _decodeFrameSize;
+
 public:
 	SmushPlayer(ScummEngine_v7 *scumm, IMuseDigital *_imuseDigital, Insane *insane);
 	~SmushPlayer();
@@ -212,7 +239,7 @@ private:
 	void tryCmpFile(const char *filename);
 
 	bool readString(const char *file);
-	void decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height);
+	void decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height, const byte *decoded = nullptr);
 	void handleAnimHeader(int32 subSize, Common::SeekableReadStream &);
 	void handleFrame(int32 frameSize, Common::SeekableReadStream &);
 	void handleNewPalette(int32 subSize, Common::SeekableReadStream &);
@@ -240,6 +267,25 @@ private:
 	void sendAudioToDiMUSE(uint8 *mixBuf, int32 mixStartingPoint, int32 mixFeedSize, int32 mixInFrameCount, int volume, int pan);
 
 	void timerCallback();
+
+	bool startDecodeThread();
+	void stopDecodeThread();
+	static void decodeThreadEntry(void *data);
+	void decodeLoop();
+
+	/**
+	 * Looks for a frame object coded with codec 37 or 47 in the frame which
+	 * comes next in _base, and hands it to the decode thread. The codecs
+	 * keep state from one frame to the next, so this must only be done when
+	 * the frames get decoded in the order they are stored.
+	 */
+	void queueDecodeAhead();
+
+	/**
+	 * Waits for the decode thread to be done with the codecs. Returns the
+	 * decoded frame if it was the one of the frame object at offset.
+	 */
+	const byte *finishDecodeAhead(int32 offset);
 };
 
 } // End of namespace Scumm
@@ -0,0 +1,225 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/blit-intern.h"
+
+#include <immintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+/** The shift counts and masks of a BlitConversion, ready for use. */
+struct Conversion {
+	bool expandChannel[4];
+	__m128i srcShift[4];
+	__m256i srcMask[4];
+	__m128i expandLeft[4], expandRight[4];
+	__m128i dstLoss[4], dstShift[4];
+	// The bits of the destination color which don't depend on the source
+	__m256i fixedBits;
+	__m256i key;
+
+	Conversion(const BlitConversion &conv) {
+		uint32 fixed = 0;
+		for (int i = 0; i < 4; ++i) {
+			const uint bits = conv.srcBits[i];
+			expandChannel[i] = (bits != 0);
+			if (!bits)
+				fixed |= (0xFF >> conv.dstLoss[i]) << conv.dstShift[i];
+
+			srcShift[i] = _mm_cvtsi32_si128(conv.srcShift[i]);
+			srcMask[i] = _mm256_set1_epi32((1 << bits) - 1);
+			expandLeft[i] = _mm_cvtsi32_si128(8 - bits);
+			expandRight[i] = _mm_cvtsi32_si128(2 * bits - 8);
+			dstLoss[i] = _mm_cvtsi32_si128(conv.dstLoss[i]);
+			dstShift[i] = _mm_cvtsi32_si128(conv.dstShift[i]);
+		}
+		fixedBits = _mm256_set1_epi32(fixed);
+		key = _mm256_set1_epi32(conv.key);
+	}
+
+	__m256i convert(__m256i color) const {
+		__m256i result = fixedBits;
+		for (int i = 0; i < 4; ++i) {
+			if (!expandChannel[i])
+				continue;
+
+			// Expand to 8 bits like PixelFormat::expand() and drop the bits
+			// the destination doesn't have
+			const __m256i v = _mm256_and_si256(_mm256_srl_epi32(color, srcShift[i]), srcMask[i]);
+			const __m256i c = _mm256_or_si256(_mm256_sll_epi32(v, expandLeft[i]), _mm256_srl_epi32(v, expandRight[i]));
+			result = _mm256_or_si256(result, _mm256_sll_epi32(_mm256_srl_epi32(c, dstLoss[i]), dstShift[i]));
+		}
+		return result;
+	}
+};
+
+/** Keeps the low 16 bits of every lane. */
+inline __m128i narrow(__m256i v) {
+	v = _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+	return _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+inline __m256i load(const uint16 *src) {
+	return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)src));
+}
+
+inline __m256i load(const uint32 *src) {
+	return _mm256_loadu_si256((const __m256i *)src);
+}
+
+inline void store(uint16 *dst, __m256i color, __m256i mask, bool hasKey) {
+	__m128i result = narrow(color);
+	if (hasKey)
+		result = _mm_blendv_epi8(result, _mm_loadu_si128((const __m128i *)dst), narrow(mask));
+	_mm_storeu_si128((__m128i *)dst, result);
+}
+
+inline void store(uint32 *dst, __m256i color, __m256i mask, bool hasKey) {
+	if (hasKey)
+		color = _mm256_blendv_epi8(color, _mm256_loadu_si256((const __m256i *)dst), mask);
+	_mm256_storeu_si256((__m256i *)dst, color);
+}
+
+template<typename SrcColor, typename DstColor>
+inline void convertPixels(byte *dst, const byte *src, uint x, const Conversion &conversion, bool hasKey) {
+	const __m256i color = load((const SrcColor *)src + x);
+	const __m256i mask = hasKey ? _mm256_cmpeq_epi32(color, conversion.key) : _mm256_setzero_si256();
+	store((DstColor *)dst + x, conversion.convert(color), mask, hasKey);
+}
+
+template<typename SrcColor, typename DstColor>
+void convertRow(byte *dst, const byte *src, uint w, const BlitConversion &conv) {
+	const Conversion conversion(conv);
+
+	if (sizeof(DstColor) > sizeof(SrcColor)) {
+		// Right to left, every block is read before it is written
+		uint x = w;
+		for (; x >= 8; x -= 8)
+			convertPixels<SrcColor, DstColor>(dst, src, x - 8, conversion, conv.hasKey);
+
+		if (x > 0)
+			crossBlitRow_Scalar(dst, src, x, conv);
+	} else {
+		uint x = 0;
+		for (; x + 8 <= w; x += 8)
+			convertPixels<SrcColor, DstColor>(dst, src, x, conversion, conv.hasKey);
+
+		if (x < w)
+			crossBlitRow_Scalar(dst + x * sizeof(DstColor), src + x * sizeof(SrcColor), w - x, conv);
+	}
+}
+
+/**
+ * Returns the low 16 bits of a + ((b - a) * e >> 16) in every 16-bit lane,
+ * for the unsigned 16-bit weights e.
+ */
+inline __m256i lerp(__m256i a, __m256i b, __m256i e) {
+	const __m256i d = _mm256_sub_epi16(b, a);
+	// mulhi treats weights of 0x8000 and more as negative, which takes away
+	// d from the high half of the product
+	const __m256i product = _mm256_add_epi16(_mm256_mulhi_epi16(d, e), _mm256_and_si256(d, _mm256_srai_epi16(e, 15)));
+	return _mm256_add_epi16(product, a);
+}
+
+inline __m256i interpolate(__m256i c00, __m256i c01, __m256i c10, __m256i c11, __m256i ex, __m256i ey) {
+	const __m256i byteMask = _mm256_set1_epi16(0xFF);
+	const __m256i t1 = _mm256_and_si256(lerp(c00, c01, ex), byteMask);
+	const __m256i t2 = _mm256_and_si256(lerp(c10, c11, ex), byteMask);
+	return _mm256_and_si256(lerp(t1, t2, ey), byteMask);
+}
+
+/** Loads 8 weights, with every weight repeated in both halves of its lane. */
+inline __m256i loadWeights(const uint16 *e) {
+	const __m256i e32 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)e));
+	return _mm256_or_si256(e32, _mm256_slli_epi32(e32, 16));
+}
+
+} // End of anonymous namespace
+
+void crossBlitRow_AVX2(byte *dst, const byte *src, uint w, const BlitConversion &conv) {
+	if (conv.srcFmt.bytesPerPixel == 2) {
+		if (conv.dstFmt.bytesPerPixel == 2)
+			convertRow<uint16, uint16>(dst, src, w, conv);
+		else
+			convertRow<uint16, uint32>(dst, src, w, conv);
+	} else {
+		if (conv.dstFmt.bytesPerPixel == 2)
+			convertRow<uint32, uint16>(dst, src, w, conv);
+		else
+			convertRow<uint32, uint32>(dst, src, w, conv);
+	}
+}
+
+void crossBlitMapRow_AVX2(byte *dst, const byte *src, uint w, uint bytesPerPixel, const uint32 *map, bool hasKey, uint32 key) {
+	const __m256i keys = _mm256_set1_epi32(key);
+
+	// Right to left, every block is read before it is written
+	uint x = w;
+	for (; x >= 8; x -= 8) {
+		const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + x - 8)));
+		const __m256i color = _mm256_i32gather_epi32((const int *)map, index, 4);
+		const __m256i mask = hasKey ? _mm256_cmpeq_epi32(index, keys) : _mm256_setzero_si256();
+
+		if (bytesPerPixel == 2)
+			store((uint16 *)dst + x - 8, color, mask, hasKey);
+		else
+			store((uint32 *)dst + x - 8, color, mask, hasKey);
+	}
+
+	if (x > 0)
+		crossBlitMapRow_Scalar(dst, src, x, bytesPerPixel, map, hasKey, key);
+}
+
+void interpolateBilinear_AVX2(uint32 *dst, const BilinearChunk &chunk, uint start, uint end) {
+	const __m256i zero = _mm256_setzero_si256();
+
+	uint i = start;
+	for (; i + 8 <= end; i += 8) {
+		const __m256i c00 = _mm256_loadu_si256((const __m256i *)(chunk.c00 + i));
+		const __m256i c01 = _mm256_loadu_si256((const __m256i *)(chunk.c01 + i));
+		const __m256i c10 = _mm256_loadu_si256((const __m256i *)(chunk.c10 + i));
+		const __m256i c11 = _mm256_loadu_si256((const __m256i *)(chunk.c11 + i));
+
+		// The unpacks work on each 128-bit half, lo holds the pixels 0, 1, 4
+		// and 5, hi the pixels 2, 3, 6 and 7. The final pack puts them back
+		// in order.
+		const __m256i ex = loadWeights(chunk.ex + i);
+		const __m256i ey = loadWeights(chunk.ey + i);
+
+		const __m256i lo = interpolate(
+			_mm256_unpacklo_epi8(c00, zero), _mm256_unpacklo_epi8(c01, zero),
+			_mm256_unpacklo_epi8(c10, zero), _mm256_unpacklo_epi8(c11, zero),
+			_mm256_unpacklo_epi32(ex, ex), _mm256_unpacklo_epi32(ey, ey));
+		const __m256i hi = interpolate(
+			_mm256_unpackhi_epi8(c00, zero), _mm256_unpackhi_epi8(c01, zero),
+			_mm256_unpackhi_epi8(c10, zero), _mm256_unpackhi_epi8(c11, zero),
+			_mm256_unpackhi_epi32(ex, ex), _mm256_unpackhi_epi32(ey, ey));
+
+		_mm256_storeu_si256((__m256i *)(dst + i), _mm256_packus_epi16(lo, hi));
+	}
+
+	if (i < end)
+		interpolateBilinear_Scalar(dst, chunk, i, end);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,125 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_BLIT_INTERN_H
+#define GRAPHICS_BLIT_INTERN_H
+
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+
+/**
+ * A conversion between two pixel formats, as done by crossBlit() and
+ * crossKeyBlit(). The component arrays are in the order alpha, red, green,
+ * blue.
+ *
+ * The vector kernels only handle 2 and 4 bytes per pixel formats whose
+ * source components have 4 to 8 bits, except for a missing alpha
+ * component, see initBlitConversion().
+ */
+struct BlitConversion {
+	PixelFormat srcFmt, dstFmt;
+
+	uint srcShift[4], srcBits[4];
+	uint dstShift[4], dstLoss[4];
+
+	bool hasKey;
+	uint32 key;
+};
+
+/**
+ * Fills in conv for a conversion from srcFmt to dstFmt, returns false if the
+ * vector kernels can't do that conversion.
+ */
+bool initBlitConversion(BlitConversion &conv, const PixelFormat &dstFmt, const PixelFormat &srcFmt, bool hasKey, uint32 key);
+
+/**
+ * Converts a row of w pixels. Rows that grow (2 to 4 bytes per pixel) are
+ * converted from right to left like crossBlit() does, so that a row can be
+ * converted in place.
+ */
+typedef void (*CrossBlitRowProc)(byte *dst, const byte *src, uint w, const BlitConversion &conv);
+
+/**
+ * Looks up a row of w 8-bit pixels in map and writes them with bytesPerPixel
+ * 2 or 4, from right to left like crossBlitMap() does. Pixels equal to key
+ * are skipped if hasKey is set.
+ */
+typedef void (*CrossBlitMapRowProc)(byte *dst, const byte *src, uint w, uint bytesPerPixel, const uint32 *map, bool hasKey, uint32 key);
+
+static const uint kBilinearChunkSize = 64;
+
+/**
+ * The four source pixels and the fractional position between them for up to
+ * kBilinearChunkSize destination pixels, gathered by the bilinear scalers.
+ */
+struct BilinearChunk {
+	uint32 c00[kBilinearChunkSize], c01[kBilinearChunkSize];
+	uint32 c10[kBilinearChunkSize], c11[kBilinearChunkSize];
+	uint16 ex[kBilinearChunkSize], ey[kBilinearChunkSize];
+};
+
+/**
+ * Interpolates the pixels start to end - 1 of the chunk into dst[start] to
+ * dst[end - 1], for a 4 bytes per pixel format with an 8-bit component in
+ * every byte, like scaleBlitBilinearInterpolate() does for every component.
+ */
+typedef void (*InterpolateBilinearProc)(uint32 *dst, const BilinearChunk &chunk, uint start, uint end);
+
+/**
+ * The set of blit kernels. Any of them may be nullptr when there is no
+ * vector version of it. All implementations produce bit-identical output.
+ */
+struct BlitKernels {
+	CrossBlitRowProc crossBlitRow;
+	CrossBlitMapRowProc crossBlitMapRow;
+	InterpolateBilinearProc interpolateBilinear;
+};
+
+void crossBlitRow_Scalar(byte *dst, const byte *src, uint w, const BlitConversion &conv);
+void crossBlitMapRow_Scalar(byte *dst, const byte *src, uint w, uint bytesPerPixel, const uint32 *map, bool hasKey, uint32 key);
+void interpolateBilinear_Scalar(uint32 *dst, const BilinearChunk &chunk, uint start, uint end);
+
+#ifdef SCUMMVM_SSE2
+void crossBlitRow_SSE2(byte *dst, const byte *src, uint w, const BlitConversion &conv);
+void interpolateBilinear_SSE2(uint32 *dst, const BilinearChunk &chunk, uint start, uint end);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void crossBlitRow_AVX2(byte *dst, const byte *src, uint w, const BlitConversion &conv);
+void crossBlitMapRow_AVX2(byte *dst, const byte *src, uint w, uint bytesPerPixel, const uint32 *map, bool hasKey, uint32 key);
+void interpolateBilinear_AVX2(uint32 *dst, const BilinearChunk &chunk, uint start, uint end);
+#endif
+
+#ifdef SCUMMVM_NEON
+void crossBlitRow_NEON(byte *dst, const byte *src, uint w, const BlitConversion &conv);
+void interpolateBilinear_NEON(uint32 *dst, const BilinearChunk &chunk, uint start, uint end);
+#endif
+
+/**
+ * Returns the fastest set of vector kernels supported by the CPU we are
+ * running on, or nullptr if there are none.
+ */
+const BlitKernels *getBlitKernels();
+
+} // End of namespace Graphics
+
+#endif
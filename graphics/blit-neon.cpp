@@ -0,0 +1,201 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/blit-intern.h"
+
+#include <arm_neon.h>
+
+namespace Graphics {
+
+namespace {
+
+/** The shift counts and masks of a BlitConversion, ready for use. */
+struct Conversion {
+	bool expandChannel[4];
+	// NEON only shifts left, right shifts use negative counts
+	int32x4_t srcShift[4];
+	uint32x4_t srcMask[4];
+	int32x4_t expandLeft[4], expandRight[4];
+	int32x4_t dstLoss[4], dstShift[4];
+	// The bits of the destination color which don't depend on the source
+	uint32x4_t fixedBits;
+	uint32x4_t key;
+
+	Conversion(const BlitConversion &conv) {
+		uint32 fixed = 0;
+		for (int i = 0; i < 4; ++i) {
+			const int bits = conv.srcBits[i];
+			expandChannel[i] = (bits != 0);
+			if (!bits)
+				fixed |= (0xFF >> conv.dstLoss[i]) << conv.dstShift[i];
+
+			srcShift[i] = vdupq_n_s32(-(int)conv.srcShift[i]);
+			srcMask[i] = vdupq_n_u32((1 << bits) - 1);
+			expandLeft[i] = vdupq_n_s32(8 - bits);
+			expandRight[i] = vdupq_n_s32(8 - 2 * bits);
+			dstLoss[i] = vdupq_n_s32(-(int)conv.dstLoss[i]);
+			dstShift[i] = vdupq_n_s32(conv.dstShift[i]);
+		}
+		fixedBits = vdupq_n_u32(fixed);
+		key = vdupq_n_u32(conv.key);
+	}
+
+	uint32x4_t convert(uint32x4_t color) const {
+		uint32x4_t result = fixedBits;
+		for (int i = 0; i < 4; ++i) {
+			if (!expandChannel[i])
+				continue;
+
+			// Expand to 8 bits like PixelFormat::expand() and drop the bits
+			// the destination doesn't have
+			const uint32x4_t v = vandq_u32(vshlq_u32(color, srcShift[i]), srcMask[i]);
+			const uint32x4_t c = vorrq_u32(vshlq_u32(v, expandLeft[i]), vshlq_u32(v, expandRight[i]));
+			result = vorrq_u32(result, vshlq_u32(vshlq_u32(c, dstLoss[i]), dstShift[i]));
+		}
+		return result;
+	}
+};
+
+inline uint32x4_t load(const uint16 *src) {
+	return vmovl_u16(vld1_u16(src));
+}
+
+inline uint32x4_t load(const uint32 *src) {
+	return vld1q_u32(src);
+}
+
+inline void store(uint16 *dst, uint32x4_t color, uint32x4_t mask, bool hasKey) {
+	uint16x4_t result = vmovn_u32(color);
+	if (hasKey)
+		result = vbsl_u16(vmovn_u32(mask), vld1_u16(dst), result);
+	vst1_u16(dst, result);
+}
+
+inline void store(uint32 *dst, uint32x4_t color, uint32x4_t mask, bool hasKey) {
+	if (hasKey)
+		color = vbslq_u32(mask, vld1q_u32(dst), color);
+	vst1q_u32(dst, color);
+}
+
+template<typename SrcColor, typename DstColor>
+inline void convertPixels(byte *dst, const byte *src, uint x, const Conversion &conversion, bool hasKey) {
+	const uint32x4_t color = load((const SrcColor *)src + x);
+	const uint32x4_t mask = hasKey ? vceqq_u32(color, conversion.key) : vdupq_n_u32(0);
+	store((DstColor *)dst + x, conversion.convert(color), mask, hasKey);
+}
+
+template<typename SrcColor, typename DstColor>
+void convertRow(byte *dst, const byte *src, uint w, const BlitConversion &conv) {
+	const Conversion conversion(conv);
+
+	if (sizeof(DstColor) > sizeof(SrcColor)) {
+		// Right to left, every block is read before it is written
+		uint x = w;
+		for (; x >= 4; x -= 4)
+			convertPixels<SrcColor, DstColor>(dst, src, x - 4, conversion, conv.hasKey);
+
+		if (x > 0)
+			crossBlitRow_Scalar(dst, src, x, conv);
+	} else {
+		uint x = 0;
+		for (; x + 4 <= w; x += 4)
+			convertPixels<SrcColor, DstColor>(dst, src, x, conversion, conv.hasKey);
+
+		if (x < w)
+			crossBlitRow_Scalar(dst + x * sizeof(DstColor), src + x * sizeof(SrcColor), w - x, conv);
+	}
+}
+
+/**
+ * Returns the low 16 bits of a + ((b - a) * e >> 16) in every 16-bit lane,
+ * for the 16-bit weights e.
+ */
+inline int16x8_t lerp(int16x8_t a, int16x8_t b, uint16x8_t e) {
+	const int16x8_t d = vsubq_s16(b, a);
+	const uint16x4_t eLo = vget_low_u16(e), eHi = vget_high_u16(e);
+	const int32x4_t lo = vreinterpretq_s32_u32(vmull_u16(vreinterpret_u16_s16(vget_low_s16(d)), eLo));
+	const int32x4_t hi = vreinterpretq_s32_u32(vmull_u16(vreinterpret_u16_s16(vget_high_s16(d)), eHi));
+	// The unsigned product of the 16-bit pattern of a negative d is too large
+	// by e << 16, the low 16 bits of the high half stay correct after taking
+	// away e
+	int16x8_t product = vcombine_s16(vshrn_n_s32(lo, 16), vshrn_n_s32(hi, 16));
+	const uint16x8_t negative = vcltq_s16(d, vdupq_n_s16(0));
+	product = vsubq_s16(product, vreinterpretq_s16_u16(vandq_u16(negative, e)));
+	return vaddq_s16(product, a);
+}
+
+inline int16x8_t interpolate(uint8x8_t c00, uint8x8_t c01, uint8x8_t c10, uint8x8_t c11, uint16x8_t ex, uint16x8_t ey) {
+	const int16x8_t byteMask = vdupq_n_s16(0xFF);
+	const int16x8_t t1 = vandq_s16(lerp(vreinterpretq_s16_u16(vmovl_u8(c00)), vreinterpretq_s16_u16(vmovl_u8(c01)), ex), byteMask);
+	const int16x8_t t2 = vandq_s16(lerp(vreinterpretq_s16_u16(vmovl_u8(c10)), vreinterpretq_s16_u16(vmovl_u8(c11)), ex), byteMask);
+	return vandq_s16(lerp(t1, t2, ey), byteMask);
+}
+
+} // End of anonymous namespace
+
+void crossBlitRow_NEON(byte *dst, const byte *src, uint w, const BlitConversion &conv) {
+	if (conv.srcFmt.bytesPerPixel == 2) {
+		if (conv.dstFmt.bytesPerPixel == 2)
+			convertRow<uint16, uint16>(dst, src, w, conv);
+		else
+			convertRow<uint16, uint32>(dst, src, w, conv);
+	} else {
+		if (conv.dstFmt.bytesPerPixel == 2)
+			convertRow<uint32, uint16>(dst, src, w, conv);
+		else
+			convertRow<uint32, uint32>(dst, src, w, conv);
+	}
+}
+
+void interpolateBilinear_NEON(uint32 *dst, const BilinearChunk &chunk, uint start, uint end) {
+	uint i = start;
+	for (; i + 4 <= end; i += 4) {
+		const uint8x16_t c00 = vreinterpretq_u8_u32(vld1q_u32(chunk.c00 + i));
+		const uint8x16_t c01 = vreinterpretq_u8_u32(vld1q_u32(chunk.c01 + i));
+		const uint8x16_t c10 = vreinterpretq_u8_u32(vld1q_u32(chunk.c10 + i));
+		const uint8x16_t c11 = vreinterpretq_u8_u32(vld1q_u32(chunk.c11 + i));
+
+		// Repeat the weight of every pixel for its four components
+		const uint16x4_t ex = vld1_u16(chunk.ex + i);
+		const uint16x4_t ey = vld1_u16(chunk.ey + i);
+		const uint16x4x2_t ex2 = vzip_u16(ex, ex);
+		const uint16x4x2_t ey2 = vzip_u16(ey, ey);
+		const uint16x4x2_t exLo = vzip_u16(ex2.val[0], ex2.val[0]);
+		const uint16x4x2_t exHi = vzip_u16(ex2.val[1], ex2.val[1]);
+		const uint16x4x2_t eyLo = vzip_u16(ey2.val[0], ey2.val[0]);
+		const uint16x4x2_t eyHi = vzip_u16(ey2.val[1], ey2.val[1]);
+
+		const int16x8_t lo = interpolate(
+			vget_low_u8(c00), vget_low_u8(c01), vget_low_u8(c10), vget_low_u8(c11),
+			vcombine_u16(exLo.val[0], exLo.val[1]), vcombine_u16(eyLo.val[0], eyLo.val[1]));
+		const int16x8_t hi = interpolate(
+			vget_high_u8(c00), vget_high_u8(c01), vget_high_u8(c10), vget_high_u8(c11),
+			vcombine_u16(exHi.val[0], exHi.val[1]), vcombine_u16(eyHi.val[0], eyHi.val[1]));
+
+		const uint8x16_t result = vcombine_u8(vmovn_u16(vreinterpretq_u16_s16(lo)), vmovn_u16(vreinterpretq_u16_s16(hi)));
+		vst1q_u32(dst + i, vreinterpretq_u32_u8(result));
+	}
+
+	if (i < end)
+		interpolateBilinear_Scalar(dst, chunk, i, end);
+}
+
+} // End of namespace Graphics
@@ -25,6 +25,7 @@
  */
 
 #include "graphics/blit.h"
+#include "graphics/blit-intern.h"
 #include "graphics/pixelformat.h"
 #include "graphics/transform_struct.h"
 
@@ -164,11 +165,16 @@ void scaleBlitBilinearLogic(byte *dst, const byte *src,
 							const uint dstW, const uint dstH,
 							const uint srcW, const uint srcH,
 							const Graphics::PixelFormat &fmt,
-							int *sax, int *say) {
+							int *sax, int *say,
+							InterpolateBilinearProc interpolate = nullptr) {
 
 	int spixelw = (srcW - 1);
 	int spixelh = (srcH - 1);
 
+	// With vector kernels the pixels are gathered and interpolated in chunks
+	BilinearChunk chunk;
+	uint chunkSize = 0;
+
 	const byte *sp = src;
 
 	if (flipx) {
@@ -215,7 +221,17 @@ void scaleBlitBilinearLogic(byte *dst, const byte *src,
 			/*
 			* Draw and interpolate colors
 			*/
-			*dp = scaleBlitBilinearInterpolate<ColorMask, Size>(*(const Size *)c01, *(const Size *)c00, *(const Size *)c11, *(const Size *)c10, ex, ey, fmt);
+			if (sizeof(Size) == 4 && interpolate) {
+				chunk.c00[chunkSize] = *(const uint32 *)c00;
+				chunk.c01[chunkSize] = *(const uint32 *)c01;
+				chunk.c10[chunkSize] = *(const uint32 *)c10;
+				chunk.c11[chunkSize] = *(const uint32 *)c11;
+				chunk.ex[chunkSize] = ex;
+				chunk.ey[chunkSize] = ey;
+				chunkSize++;
+			} else {
+				*dp = scaleBlitBilinearInterpolate<ColorMask, Size>(*(const Size *)c01, *(const Size *)c00, *(const Size *)c11, *(const Size *)c10, ex, ey, fmt);
+			}
 			/*
 			* Advance source pointer x
 			*/
@@ -232,6 +248,15 @@ void scaleBlitBilinearLogic(byte *dst, const byte *src,
 			* Advance destination pointer x
 			*/
 			dp++;
+
+			if (chunkSize == kBilinearChunkSize) {
+				interpolate((uint32 *)dp - chunkSize, chunk, 0, chunkSize);
+				chunkSize = 0;
+			}
+		}
+		if (chunkSize > 0) {
+			interpolate((uint32 *)dp - chunkSize, chunk, 0, chunkSize);
+			chunkSize = 0;
 		}
 		/*
 		* Advance source pointer y
@@ -255,7 +280,8 @@ void rotoscaleBlitLogic(byte *dst, const byte *src,
 						const uint srcW, const uint srcH,
 						const Graphics::PixelFormat &fmt,
 						const TransformStruct &transform,
-						const Common::Point &newHotspot) {
+						const Common::Point &newHotspot,
+						InterpolateBilinearProc interpolate = nullptr) {
 
 	assert(transform._angle != kDefaultAngle); // This would not be ideal; rotoscale() should never be called in conditional branches where angle = 0 anyway.
 
@@ -285,6 +311,13 @@ void rotoscaleBlitLogic(byte *dst, const byte *src,
 
 	Size *pc = (Size *)dst;
 
+	// With vector kernels the pixels are gathered and interpolated in
+	// chunks, and then written to the places they were gathered for
+	BilinearChunk chunk;
+	uint32 colors[kBilinearChunkSize];
+	uint32 *targets[kBilinearChunkSize];
+	uint chunkSize = 0;
+
 	for (uint y = 0; y < dstH; y++) {
 		int t = cy - y;
 		int sdx = ax + (isinx * t) + xd;
@@ -323,7 +356,18 @@ void rotoscaleBlitLogic(byte *dst, const byte *src,
 					*/
 					int ex = (sdx & 0xffff);
 					int ey = (sdy & 0xffff);
-					*pc = scaleBlitBilinearInterpolate<ColorMask, Size>(c01, c00, c11, c10, ex, ey, fmt);
+					if (sizeof(Size) == 4 && interpolate) {
+						chunk.c00[chunkSize] = c00;
+						chunk.c01[chunkSize] = c01;
+						chunk.c10[chunkSize] = c10;
+						chunk.c11[chunkSize] = c11;
+						chunk.ex[chunkSize] = ex;
+						chunk.ey[chunkSize] = ey;
+						targets[chunkSize] = (uint32 *)pc;
+						chunkSize++;
+					} else {
+						*pc = scaleBlitBilinearInterpolate<ColorMask, Size>(c01, c00, c11, c10, ex, ey, fmt);
+					}
 				}
 			} else {
 				if ((dx >= 0) && (dy >= 0) && (dx < (int)srcW) && (dy < (int)srcH)) {
@@ -334,12 +378,57 @@ void rotoscaleBlitLogic(byte *dst, const byte *src,
 			sdx += icosx;
 			sdy += isiny;
 			pc++;
+
+			if (chunkSize == kBilinearChunkSize) {
+				interpolate(colors, chunk, 0, chunkSize);
+				for (uint i = 0; i < chunkSize; i++)
+					*targets[i] = colors[i];
+				chunkSize = 0;
+			}
 		}
 	}
+
+	if (chunkSize > 0) {
+		interpolate(colors, chunk, 0, chunkSize);
+		for (uint i = 0; i < chunkSize; i++)
+			*targets[i] = colors[i];
+	}
+}
+
+/**
+ * Returns whether every byte of a 4 bytes per pixel format holds an 8-bit
+ * component, so that the bytes can be interpolated separately.
+ */
+bool hasByteComponents(const Graphics::PixelFormat &fmt) {
+	if (fmt.bytesPerPixel != 4 || fmt.aLoss != 0 || fmt.rLoss != 0 || fmt.gLoss != 0 || fmt.bLoss != 0)
+		return false;
+
+	const uint shifts = (1 << fmt.aShift) | (1 << fmt.rShift) | (1 << fmt.gShift) | (1 << fmt.bShift);
+	return shifts == ((1 << 0) | (1 << 8) | (1 << 16) | (1 << 24));
+}
+
+InterpolateBilinearProc getInterpolateBilinear(const Graphics::PixelFormat &fmt) {
+	const BlitKernels *kernels = getBlitKernels();
+	if (!kernels || !hasByteComponents(fmt))
+		return nullptr;
+	return kernels->interpolateBilinear;
 }
 
 } // End of anonymous namespace
 
+void interpolateBilinear_Scalar(uint32 *dst, const BilinearChunk &chunk, uint start, uint end) {
+	for (uint i = start; i < end; i++) {
+		uint32 result = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			const byte c = scaleBlitBilinearInterpolate((byte)(chunk.c01[i] >> shift), (byte)(chunk.c00[i] >> shift),
+														(byte)(chunk.c11[i] >> shift), (byte)(chunk.c10[i] >> shift),
+														chunk.ex[i], chunk.ey[i]);
+			result |= (uint32)c << shift;
+		}
+		dst[i] = result;
+	}
+}
+
 bool scaleBlitBilinear(byte *dst, const byte *src,
 					   const uint dstPitch, const uint srcPitch,
 					   const uint dstW, const uint dstH,
@@ -392,8 +481,10 @@ bool scaleBlitBilinear(byte *dst, const byte *src,
 		}
 	}
 
+	const InterpolateBilinearProc interpolate = getInterpolateBilinear(fmt);
+
 	if (fmt == createPixelFormat<8888>()) {
-		scaleBlitBilinearLogic<ColorMasks<8888>, uint32, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
+		scaleBlitBilinearLogic<ColorMasks<8888>, uint32, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say, interpolate);
 	} else if (fmt == createPixelFormat<888>()) {
 		scaleBlitBilinearLogic<ColorMasks<888>,  uint32, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
 	} else if (fmt == createPixelFormat<565>()) {
@@ -402,7 +493,7 @@ bool scaleBlitBilinear(byte *dst, const byte *src,
 		scaleBlitBilinearLogic<ColorMasks<555>,  uint16, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
 
 	} else if (fmt.bytesPerPixel == 4) {
-		scaleBlitBilinearLogic<ColorMasks<0>,    uint32, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
+		scaleBlitBilinearLogic<ColorMasks<0>,    uint32, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say, interpolate);
 	} else if (fmt.bytesPerPixel == 2) {
 		scaleBlitBilinearLogic<ColorMasks<0>,    uint16, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
 	} else {
@@ -445,8 +536,10 @@ bool rotoscaleBlitBilinear(byte *dst, const byte *src,
 						   const Graphics::PixelFormat &fmt,
 						   const TransformStruct &transform,
 						   const Common::Point &newHotspot) {
+	const InterpolateBilinearProc interpolate = getInterpolateBilinear(fmt);
+
 	if (fmt == createPixelFormat<8888>()) {
-		rotoscaleBlitLogic<ColorMasks<8888>, uint32, true, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
+		rotoscaleBlitLogic<ColorMasks<8888>, uint32, true, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot, interpolate);
 	} else if (fmt == createPixelFormat<888>()) {
 		rotoscaleBlitLogic<ColorMasks<888>,  uint32, true, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
 	} else if (fmt == createPixelFormat<565>()) {
@@ -455,7 +548,7 @@ bool rotoscaleBlitBilinear(byte *dst, const byte *src,
 		rotoscaleBlitLogic<ColorMasks<555>,  uint16, true, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
 
 	} else if (fmt.bytesPerPixel == 4) {
-		rotoscaleBlitLogic<ColorMasks<0>,    uint32, true, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
+		rotoscaleBlitLogic<ColorMasks<0>,    uint32, true, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot, interpolate);
 	} else if (fmt.bytesPerPixel == 2) {
 		rotoscaleBlitLogic<ColorMasks<0>,    uint16, true, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
 	} else {
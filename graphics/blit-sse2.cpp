@@ -0,0 +1,202 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/blit-intern.h"
+
+#include <emmintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+/** The shift counts and masks of a BlitConversion, ready for use. */
+struct Conversion {
+	bool expandChannel[4];
+	__m128i srcShift[4], srcMask[4];
+	__m128i expandLeft[4], expandRight[4];
+	__m128i dstLoss[4], dstShift[4];
+	// The bits of the destination color which don't depend on the source
+	__m128i fixedBits;
+	__m128i key;
+
+	Conversion(const BlitConversion &conv) {
+		uint32 fixed = 0;
+		for (int i = 0; i < 4; ++i) {
+			const uint bits = conv.srcBits[i];
+			expandChannel[i] = (bits != 0);
+			if (!bits)
+				fixed |= (0xFF >> conv.dstLoss[i]) << conv.dstShift[i];
+
+			srcShift[i] = _mm_cvtsi32_si128(conv.srcShift[i]);
+			srcMask[i] = _mm_set1_epi32((1 << bits) - 1);
+			expandLeft[i] = _mm_cvtsi32_si128(8 - bits);
+			expandRight[i] = _mm_cvtsi32_si128(2 * bits - 8);
+			dstLoss[i] = _mm_cvtsi32_si128(conv.dstLoss[i]);
+			dstShift[i] = _mm_cvtsi32_si128(conv.dstShift[i]);
+		}
+		fixedBits = _mm_set1_epi32(fixed);
+		key = _mm_set1_epi32(conv.key);
+	}
+
+	__m128i convert(__m128i color) const {
+		__m128i result = fixedBits;
+		for (int i = 0; i < 4; ++i) {
+			if (!expandChannel[i])
+				continue;
+
+			// Expand to 8 bits like PixelFormat::expand() and drop the bits
+			// the destination doesn't have
+			const __m128i v = _mm_and_si128(_mm_srl_epi32(color, srcShift[i]), srcMask[i]);
+			const __m128i c = _mm_or_si128(_mm_sll_epi32(v, expandLeft[i]), _mm_srl_epi32(v, expandRight[i]));
+			result = _mm_or_si128(result, _mm_sll_epi32(_mm_srl_epi32(c, dstLoss[i]), dstShift[i]));
+		}
+		return result;
+	}
+};
+
+inline __m128i select(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/** Keeps the low 16 bits of every lane, the lanes end up in the low half. */
+inline __m128i narrow(__m128i v) {
+	v = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+	return _mm_packs_epi32(v, v);
+}
+
+inline __m128i load(const uint16 *src) {
+	return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+}
+
+inline __m128i load(const uint32 *src) {
+	return _mm_loadu_si128((const __m128i *)src);
+}
+
+inline void store(uint16 *dst, __m128i color, __m128i mask, bool hasKey) {
+	color = narrow(color);
+	if (hasKey)
+		color = select(narrow(mask), _mm_loadl_epi64((const __m128i *)dst), color);
+	_mm_storel_epi64((__m128i *)dst, color);
+}
+
+inline void store(uint32 *dst, __m128i color, __m128i mask, bool hasKey) {
+	if (hasKey)
+		color = select(mask, _mm_loadu_si128((const __m128i *)dst), color);
+	_mm_storeu_si128((__m128i *)dst, color);
+}
+
+template<typename SrcColor, typename DstColor>
+inline void convertPixels(byte *dst, const byte *src, uint x, const Conversion &conversion, bool hasKey) {
+	const __m128i color = load((const SrcColor *)src + x);
+	const __m128i mask = hasKey ? _mm_cmpeq_epi32(color, conversion.key) : _mm_setzero_si128();
+	store((DstColor *)dst + x, conversion.convert(color), mask, hasKey);
+}
+
+template<typename SrcColor, typename DstColor>
+void convertRow(byte *dst, const byte *src, uint w, const BlitConversion &conv) {
+	const Conversion conversion(conv);
+
+	if (sizeof(DstColor) > sizeof(SrcColor)) {
+		// Right to left, every block is read before it is written
+		uint x = w;
+		for (; x >= 4; x -= 4)
+			convertPixels<SrcColor, DstColor>(dst, src, x - 4, conversion, conv.hasKey);
+
+		if (x > 0)
+			crossBlitRow_Scalar(dst, src, x, conv);
+	} else {
+		uint x = 0;
+		for (; x + 4 <= w; x += 4)
+			convertPixels<SrcColor, DstColor>(dst, src, x, conversion, conv.hasKey);
+
+		if (x < w)
+			crossBlitRow_Scalar(dst + x * sizeof(DstColor), src + x * sizeof(SrcColor), w - x, conv);
+	}
+}
+
+/**
+ * Returns the low 16 bits of a + ((b - a) * e >> 16) in every 16-bit lane,
+ * for the unsigned 16-bit weights e.
+ */
+inline __m128i lerp(__m128i a, __m128i b, __m128i e) {
+	const __m128i d = _mm_sub_epi16(b, a);
+	// mulhi treats weights of 0x8000 and more as negative, which takes away
+	// d from the high half of the product
+	const __m128i product = _mm_add_epi16(_mm_mulhi_epi16(d, e), _mm_and_si128(d, _mm_srai_epi16(e, 15)));
+	return _mm_add_epi16(product, a);
+}
+
+inline __m128i interpolate(__m128i c00, __m128i c01, __m128i c10, __m128i c11, __m128i ex, __m128i ey) {
+	const __m128i byteMask = _mm_set1_epi16(0xFF);
+	const __m128i t1 = _mm_and_si128(lerp(c00, c01, ex), byteMask);
+	const __m128i t2 = _mm_and_si128(lerp(c10, c11, ex), byteMask);
+	return _mm_and_si128(lerp(t1, t2, ey), byteMask);
+}
+
+} // End of anonymous namespace
+
+void crossBlitRow_SSE2(byte *dst, const byte *src, uint w, const BlitConversion &conv) {
+	if (conv.srcFmt.bytesPerPixel == 2) {
+		if (conv.dstFmt.bytesPerPixel == 2)
+			convertRow<uint16, uint16>(dst, src, w, conv);
+		else
+			convertRow<uint16, uint32>(dst, src, w, conv);
+	} else {
+		if (conv.dstFmt.bytesPerPixel == 2)
+			convertRow<uint32, uint16>(dst, src, w, conv);
+		else
+			convertRow<uint32, uint32>(dst, src, w, conv);
+	}
+}
+
+void interpolateBilinear_SSE2(uint32 *dst, const BilinearChunk &chunk, uint start, uint end) {
+	const __m128i zero = _mm_setzero_si128();
+
+	uint i = start;
+	for (; i + 4 <= end; i += 4) {
+		const __m128i c00 = _mm_loadu_si128((const __m128i *)(chunk.c00 + i));
+		const __m128i c01 = _mm_loadu_si128((const __m128i *)(chunk.c01 + i));
+		const __m128i c10 = _mm_loadu_si128((const __m128i *)(chunk.c10 + i));
+		const __m128i c11 = _mm_loadu_si128((const __m128i *)(chunk.c11 + i));
+
+		// Repeat the weight of every pixel for its four components
+		const __m128i ex = _mm_loadl_epi64((const __m128i *)(chunk.ex + i));
+		const __m128i ey = _mm_loadl_epi64((const __m128i *)(chunk.ey + i));
+		const __m128i ex2 = _mm_unpacklo_epi16(ex, ex);
+		const __m128i ey2 = _mm_unpacklo_epi16(ey, ey);
+
+		const __m128i lo = interpolate(
+			_mm_unpacklo_epi8(c00, zero), _mm_unpacklo_epi8(c01, zero),
+			_mm_unpacklo_epi8(c10, zero), _mm_unpacklo_epi8(c11, zero),
+			_mm_unpacklo_epi32(ex2, ex2), _mm_unpacklo_epi32(ey2, ey2));
+		const __m128i hi = interpolate(
+			_mm_unpackhi_epi8(c00, zero), _mm_unpackhi_epi8(c01, zero),
+			_mm_unpackhi_epi8(c10, zero), _mm_unpackhi_epi8(c11, zero),
+			_mm_unpackhi_epi32(ex2, ex2), _mm_unpackhi_epi32(ey2, ey2));
+
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+	}
+
+	if (i < end)
+		interpolateBilinear_Scalar(dst, chunk, i, end);
+}
+
+} // End of namespace Graphics
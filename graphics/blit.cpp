@@ -20,8 +20,11 @@
  */
 
 #include "graphics/blit.h"
+#include "graphics/blit-intern.h"
 #include "graphics/pixelformat.h"
 
+#include "common/system.h"
+
 namespace Graphics {
 
 // Function to blit a rect
@@ -192,6 +195,162 @@ inline void crossBlitLogic3BppSource(byte *dst, const byte *src, const uint w, c
 
 } // End of anonymous namespace
 
+bool initBlitConversion(BlitConversion &conv, const PixelFormat &dstFmt, const PixelFormat &srcFmt, bool hasKey, uint32 key) {
+	if ((srcFmt.bytesPerPixel != 2 && srcFmt.bytesPerPixel != 4) ||
+		(dstFmt.bytesPerPixel != 2 && dstFmt.bytesPerPixel != 4))
+		return false;
+
+	const uint srcBits[4] = { srcFmt.aBits(), srcFmt.rBits(), srcFmt.gBits(), srcFmt.bBits() };
+	for (int i = 0; i < 4; ++i) {
+		// A missing alpha component is expanded to 0xFF
+		if (i == 0 && srcBits[i] == 0)
+			continue;
+		if (srcBits[i] < 4 || srcBits[i] > 8)
+			return false;
+	}
+
+	conv.srcFmt = srcFmt;
+	conv.dstFmt = dstFmt;
+
+	conv.srcShift[0] = srcFmt.aShift;
+	conv.srcShift[1] = srcFmt.rShift;
+	conv.srcShift[2] = srcFmt.gShift;
+	conv.srcShift[3] = srcFmt.bShift;
+	for (int i = 0; i < 4; ++i) {
+		if (conv.srcShift[i] >= 32)
+			return false;
+		conv.srcBits[i] = srcBits[i];
+	}
+
+	conv.dstShift[0] = dstFmt.aShift;
+	conv.dstShift[1] = dstFmt.rShift;
+	conv.dstShift[2] = dstFmt.gShift;
+	conv.dstShift[3] = dstFmt.bShift;
+	conv.dstLoss[0] = dstFmt.aLoss;
+	conv.dstLoss[1] = dstFmt.rLoss;
+	conv.dstLoss[2] = dstFmt.gLoss;
+	conv.dstLoss[3] = dstFmt.bLoss;
+	for (int i = 0; i < 4; ++i) {
+		if (conv.dstShift[i] >= 32 || conv.dstLoss[i] > 8)
+			return false;
+	}
+
+	conv.hasKey = hasKey;
+	conv.key = key;
+	return true;
+}
+
+namespace {
+
+inline void crossBlitPixel(byte *dst, const byte *src, const BlitConversion &conv) {
+	const uint32 color = (conv.srcFmt.bytesPerPixel == 2) ? *(const uint16 *)src : *(const uint32 *)src;
+	if (conv.hasKey && color == conv.key)
+		return;
+
+	byte a, r, g, b;
+	conv.srcFmt.colorToARGB(color, a, r, g, b);
+	const uint32 result = conv.dstFmt.ARGBToColor(a, r, g, b);
+	if (conv.dstFmt.bytesPerPixel == 2)
+		*(uint16 *)dst = result;
+	else
+		*(uint32 *)dst = result;
+}
+
+} // End of anonymous namespace
+
+void crossBlitRow_Scalar(byte *dst, const byte *src, uint w, const BlitConversion &conv) {
+	const uint srcBpp = conv.srcFmt.bytesPerPixel;
+	const uint dstBpp = conv.dstFmt.bytesPerPixel;
+
+	if (dstBpp > srcBpp) {
+		for (uint x = w; x-- > 0;)
+			crossBlitPixel(dst + x * dstBpp, src + x * srcBpp, conv);
+	} else {
+		for (uint x = 0; x < w; ++x)
+			crossBlitPixel(dst + x * dstBpp, src + x * srcBpp, conv);
+	}
+}
+
+void crossBlitMapRow_Scalar(byte *dst, const byte *src, uint w, uint bytesPerPixel, const uint32 *map, bool hasKey, uint32 key) {
+	for (uint x = w; x-- > 0;) {
+		const byte color = src[x];
+		if (hasKey && color == key)
+			continue;
+
+		if (bytesPerPixel == 2)
+			*(uint16 *)(dst + x * 2) = map[color];
+		else
+			*(uint32 *)(dst + x * 4) = map[color];
+	}
+}
+
+const BlitKernels *getBlitKernels() {
+	if (!g_system)
+		return nullptr;
+
+#ifdef SCUMMVM_AVX2
+	static const BlitKernels avx2Kernels = { crossBlitRow_AVX2, crossBlitMapRow_AVX2, interpolateBilinear_AVX2 };
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		return &avx2Kernels;
+#endif
+#ifdef SCUMMVM_SSE2
+	// SSE2 has no gather, the table lookups are left to the scalar code
+	static const BlitKernels sse2Kernels = { crossBlitRow_SSE2, nullptr, interpolateBilinear_SSE2 };
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return &sse2Kernels;
+#endif
+#ifdef SCUMMVM_NEON
+	static const BlitKernels neonKernels = { crossBlitRow_NEON, nullptr, interpolateBilinear_NEON };
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return &neonKernels;
+#endif
+
+	return nullptr;
+}
+
+namespace {
+
+/**
+ * Converts the rows with the vector kernels if there are any for this
+ * conversion. The rows are visited in the same order as by the scalar code,
+ * so that in place conversions keep working.
+ */
+bool crossBlitRows(byte *dst, const byte *src,
+				   const uint dstPitch, const uint srcPitch,
+				   const uint w, const uint h,
+				   const PixelFormat &dstFmt, const PixelFormat &srcFmt,
+				   const bool hasKey, const uint32 key) {
+	const BlitKernels *kernels = getBlitKernels();
+	BlitConversion conv;
+	if (!kernels || !kernels->crossBlitRow || !initBlitConversion(conv, dstFmt, srcFmt, hasKey, key))
+		return false;
+
+	if (dstFmt.bytesPerPixel > srcFmt.bytesPerPixel) {
+		for (uint y = h; y-- > 0;)
+			kernels->crossBlitRow(dst + y * dstPitch, src + y * srcPitch, w, conv);
+	} else {
+		for (uint y = 0; y < h; ++y)
+			kernels->crossBlitRow(dst + y * dstPitch, src + y * srcPitch, w, conv);
+	}
+	return true;
+}
+
+bool crossBlitMapRows(byte *dst, const byte *src,
+					  const uint dstPitch, const uint srcPitch,
+					  const uint w, const uint h,
+					  const uint bytesPerPixel, const uint32 *map,
+					  const bool hasKey, const uint32 key) {
+	const BlitKernels *kernels = getBlitKernels();
+	if (!kernels || !kernels->crossBlitMapRow || (bytesPerPixel != 2 && bytesPerPixel != 4))
+		return false;
+
+	for (uint y = h; y-- > 0;)
+		kernels->crossBlitMapRow(dst + y * dstPitch, src + y * srcPitch, w, bytesPerPixel, map, hasKey, key);
+	return true;
+}
+
+} // End of anonymous namespace
+
 // Function to blit a rect from one color format to another
 bool crossBlit(byte *dst, const byte *src,
 			   const uint dstPitch, const uint srcPitch,
@@ -209,6 +368,9 @@ bool crossBlit(byte *dst, const byte *src,
 		return true;
 	}
 
+	if (crossBlitRows(dst, src, dstPitch, srcPitch, w, h, dstFmt, srcFmt, false, 0))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w * srcFmt.bytesPerPixel);
 	const uint dstDelta = (dstPitch - w * dstFmt.bytesPerPixel);
@@ -267,6 +429,9 @@ bool crossKeyBlit(byte *dst, const byte *src,
 		return true;
 	}
 
+	if (crossBlitRows(dst, src, dstPitch, srcPitch, w, h, dstFmt, srcFmt, true, key))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w * srcFmt.bytesPerPixel);
 	const uint dstDelta = (dstPitch - w * dstFmt.bytesPerPixel);
@@ -317,6 +482,9 @@ bool crossBlitMap(byte *dst, const byte *src,
 	if ((bytesPerPixel == 3) || (!bytesPerPixel))
 		return false;
 
+	if (crossBlitMapRows(dst, src, dstPitch, srcPitch, w, h, bytesPerPixel, map, false, 0))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w);
 	const uint dstDelta = (dstPitch - w * bytesPerPixel);
@@ -356,6 +524,9 @@ bool crossKeyBlitMap(byte *dst, const byte *src,
 	if ((bytesPerPixel == 3) || (!bytesPerPixel))
 		return false;
 
+	if (crossBlitMapRows(dst, src, dstPitch, srcPitch, w, h, bytesPerPixel, map, true, key))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w);
 	const uint dstDelta = (dstPitch - w * bytesPerPixel);
@@ -56,6 +56,30 @@ MODULE_OBJS := \
 	wincursor.o \
 	yuv_to_rgb.o
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	blit-sse2.o \
+	yuv_to_rgb_sse2.o
+$(MODULE)/blit-sse2.o: CXXFLAGS += -msse2
+$(MODULE)/yuv_to_rgb_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	blit-avx2.o \
+	yuv_to_rgb_avx2.o
+$(MODULE)/blit-avx2.o: CXXFLAGS += -mavx2
+$(MODULE)/yuv_to_rgb_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	blit-neon.o \
+	yuv_to_rgb_neon.o
+$(MODULE)/blit-neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+$(MODULE)/yuv_to_rgb_neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+endif
+
 ifdef USE_TINYGL
 MODULE_OBJS += \
 	tinygl/api.o \
@@ -80,9 +104,28 @@ MODULE_OBJS += \
 	tinygl/zbuffer.o \
 	tinygl/zline.o \
 	tinygl/zmath.o \
+	tinygl/zspan.o \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
 	tinygl/zdirtyrect.o
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	tinygl/zspan_sse2.o
+$(MODULE)/tinygl/zspan_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	tinygl/zspan_avx2.o
+$(MODULE)/tinygl/zspan_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	tinygl/zspan_neon.o
+$(MODULE)/tinygl/zspan_neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+endif
 endif
 
 ifdef USE_ASPECT
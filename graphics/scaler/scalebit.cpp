@@ -166,8 +166,9 @@ static void scale3x(void* void_dst, unsigned dst_slice, const void* void_src, un
  * The destination bitmap must be manually allocated before calling the function,
  * note that the resulting size is exactly 4x4 times the size of the source bitmap.
  * \note This function requires also a small buffer bitmap used internally to store
- * intermediate results. This bitmap must have at least an horizontal size in bytes of 2*width*pixel,
- * and a vertical size of 6 rows. The memory of this buffer must not be allocated
+ * intermediate results. This bitmap must have at least an horizontal size in bytes of 2*(width+4)*pixel,
+ * and a vertical size of 6 rows. The intermediate rows are computed for two more source pixels on
+ * each side, so that the second stage finds the pixels beside the rect there. The memory of this buffer must not be allocated
  * in video memory because it's also read and not only written. Generally
  * a heap (malloc) or a stack (alloca) buffer is the best choices.
  * @param void_dst Pointer at the first pixel of the destination bitmap.
@@ -198,13 +199,13 @@ static void scale4x_buf(void* void_dst, unsigned dst_slice, void* void_mid, unsi
 	mid[4] = mid[3] + mid_slice;
 	mid[5] = mid[4] + mid_slice;
 
-	stage_scale2x(SCMID(0), SCMID(1), SCSRC(0), SCSRC(1), SCSRC(2), pixel, width);
-	stage_scale2x(SCMID(2), SCMID(3), SCSRC(1), SCSRC(2), SCSRC(3), pixel, width);
+	stage_scale2x(SCMID(0), SCMID(1), SCSRC(0) - 2 * pixel, SCSRC(1) - 2 * pixel, SCSRC(2) - 2 * pixel, pixel, width + 4);
+	stage_scale2x(SCMID(2), SCMID(3), SCSRC(1) - 2 * pixel, SCSRC(2) - 2 * pixel, SCSRC(3) - 2 * pixel, pixel, width + 4);
 	while (count) {
 		unsigned char* tmp;
 
-		stage_scale2x(SCMID(4), SCMID(5), SCSRC(2), SCSRC(3), SCSRC(4), pixel, width);
-		stage_scale4x(SCDST(0), SCDST(1), SCDST(2), SCDST(3), SCMID(1), SCMID(2), SCMID(3), SCMID(4), pixel, width);
+		stage_scale2x(SCMID(4), SCMID(5), SCSRC(2) - 2 * pixel, SCSRC(3) - 2 * pixel, SCSRC(4) - 2 * pixel, pixel, width + 4);
+		stage_scale4x(SCDST(0), SCDST(1), SCDST(2), SCDST(3), SCMID(1) + 4 * pixel, SCMID(2) + 4 * pixel, SCMID(3) + 4 * pixel, SCMID(4) + 4 * pixel, pixel, width);
 
 		dst = SCDST(4);
 		src = SCSRC(1);
@@ -246,7 +247,7 @@ static void scale4x(void* void_dst, unsigned dst_slice, const void* void_src, un
 	unsigned mid_slice;
 	void* mid;
 
-	mid_slice = 2 * pixel * width; /* required space for 1 row buffer */
+	mid_slice = 2 * pixel * (width + 4); /* required space for 1 row buffer */
 
 	mid_slice = (mid_slice + 0x7) & ~0x7; /* align to 8 bytes */
 
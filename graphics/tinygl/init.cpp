@@ -25,6 +25,8 @@
  * It also has modifications by the ResidualVM-team, which are covered under the GPLv2 (or later).
  */
 
+#include "common/config-manager.h"
+
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/zblit.h"
 #include "graphics/tinygl/zdirtyrect.h"
@@ -58,6 +60,10 @@ void createContext(int screenW, int screenH, Graphics::PixelFormat pixelFormat,
 	assert(gl_ctx == nullptr);
 	gl_ctx = new GLContext();
 	gl_ctx->init(screenW, screenH, pixelFormat, textureSize, enableStencilBuffer, dirtyRectsEnable);
+
+	// Rasterizing in parallel relies on the dirty regions of the draw calls
+	if (dirtyRectsEnable && ConfMan.hasKey("tinygl_threads"))
+		gl_ctx->setRasterizerThreadCount(MAX(ConfMan.getInt("tinygl_threads"), 0));
 }
 
 void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat, int textureSize, bool enableStencilBuffer, bool dirtyRectsEnable) {
@@ -268,6 +274,7 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_drawCallAllocator[1].initialize(kDrawCallMemory);
 	_debugRectsEnabled = false;
 	_profilingEnabled = false;
+	_rasterizerPool = nullptr;
 
 	TinyGL::Internal::tglBlitResetScissorRect();
 }
@@ -285,6 +292,7 @@ void destroyContext() {
 }
 
 void GLContext::deinit() {
+	disposeRasterizerTiles();
 	disposeDrawCallLists();
 	disposeResources();
 
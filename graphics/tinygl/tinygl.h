@@ -34,6 +34,15 @@ void createContext(int screenW, int screenH, Graphics::PixelFormat pixelFormat,
 void destroyContext();
 void presentBuffer();
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas);
+/**
+ * Set the number of threads used to rasterize the frames, 0 meaning one per
+ * CPU core and 1 disabling multithreaded rasterization. This only has an
+ * effect on contexts created with dirty rectangles enabled. The output is
+ * the same whatever the number of threads.
+ *
+ * The default is read from the "tinygl_threads" configuration key.
+ */
+void setRasterizerThreadCount(uint numThreads);
 void getSurfaceRef(Graphics::Surface &surface);
 Graphics::Surface *copyToBuffer(const Graphics::PixelFormat &dstFormat);
 
@@ -32,6 +32,7 @@
 
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
 
 namespace TinyGL {
 
@@ -96,12 +97,39 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_offscreenBuffer.pbuf = _pbuf.getRawBuffer();
 	_offscreenBuffer.zbuf = _zbuf;
 
+	_sharedBuffers = false;
+
+	if (_pbufBpp == 4 && _pbufFormat.rLoss == 0 && _pbufFormat.gLoss == 0 && _pbufFormat.bLoss == 0 &&
+	    (_pbufFormat.aLoss == 0 || _pbufFormat.aLoss == 8))
+		_spanKernels = getSpanKernels();
+	else
+		_spanKernels = nullptr;
+
+	_currentTexture = nullptr;
+
+	_enableScissor = false;
+}
+
+FrameBuffer::FrameBuffer() {
+	_pbufWidth = 0;
+	_pbufHeight = 0;
+	_pbufBpp = 0;
+	_pbufPitch = 0;
+
+	_zbuf = nullptr;
+	_sbuf = nullptr;
+	_sharedBuffers = true;
+	_spanKernels = nullptr;
+
 	_currentTexture = nullptr;
 
 	_enableScissor = false;
 }
 
 FrameBuffer::~FrameBuffer() {
+	if (_sharedBuffers)
+		return;
+
 	_pbuf.free();
 	gl_free(_zbuf);
 	if (_sbuf)
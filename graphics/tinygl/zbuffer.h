@@ -76,6 +76,9 @@ static const int DRAW_DEPTH_ONLY = 0;
 static const int DRAW_FLAT = 1;
 static const int DRAW_SMOOTH = 2;
 
+struct ShadeSpan;
+struct SpanKernels;
+
 struct Buffer {
 	byte *pbuf;
 	uint *zbuf;
@@ -105,8 +108,17 @@ struct ZBufferPoint {
 
 struct FrameBuffer {
 	FrameBuffer(int width, int height, const Graphics::PixelFormat &format, bool enableStencilBuffer);
+	// Creates a frame buffer without buffers of its own, see shareBuffers().
+	FrameBuffer();
 	~FrameBuffer();
 
+	// Draws to the buffers of another frame buffer, starting with a copy of its
+	// rendering state. Used to rasterize several parts of a frame in parallel.
+	void shareBuffers(const FrameBuffer &other) {
+		*this = other;
+		_sharedBuffers = true;
+	}
+
 	Graphics::PixelFormat getPixelFormat() {
 		return _pbufFormat;
 	}
@@ -597,6 +609,12 @@ public:
 		_wrapT = wrapt;
 	}
 
+	// Replaces the span kernels selected for the CPU, nullptr rasterizes pixel
+	// by pixel. Only for formats which the kernels were selected for.
+	void setSpanKernels(const SpanKernels *kernels) {
+		_spanKernels = kernels;
+	}
+
 	void setTextureSizeAndMask(int textureSize, int textureSizeMask) {
 		_textureSize = textureSize;
 		_textureSizeMask = textureSizeMask;
@@ -658,6 +676,9 @@ private:
 	template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, bool kSmoothMode>
 	void fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2);
 
+	bool initShadeSpan(ShadeSpan &span, bool depthTestEnabled, bool depthWrite) const;
+	void drawTexturedSpan(ShadeSpan &span, const TexelBuffer *texture, float sz, float tz, float fdzdx, float dszdx, float dtzdx);
+
 public:
 
 	void fillTriangleTextureMappingPerspectiveSmooth(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2);
@@ -702,6 +723,7 @@ private:
 
 	uint *_zbuf;
 	byte *_sbuf;
+	bool _sharedBuffers;
 
 	bool _enableStencil;
 	int _textureSize;
@@ -710,6 +732,9 @@ private:
 	Common::Rect _clipRectangle;
 	bool _enableScissor;
 
+	// Vector kernels for the common kinds of spans, nullptr if they cannot be used
+	const SpanKernels *_spanKernels;
+
 	const TexelBuffer *_currentTexture;
 	uint _wrapS, _wrapT;
 	bool _blendingEnabled;
@@ -25,6 +25,7 @@
 
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/workerpool.h"
 
 namespace TinyGL {
 
@@ -193,12 +194,20 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 		}
 
 		// Execute draw calls.
-		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		if (_rasterizerPool && render_mode == TGL_RENDER && !_profilingEnabled) {
 			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+				_rasterizerDirtyRects.push_back((*itRect).rectangle);
+			}
+			executeDrawCallsTiled();
+			_rasterizerDirtyRects.clear();
+		} else {
+			for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+					Common::Rect dirtyRegion = (*itRect).rectangle;
+					if (dirtyRegion.intersects(drawCallRegion)) {
+						(*it)->execute(dirtyRegion, true);
+					}
 				}
 			}
 		}
@@ -235,6 +244,107 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 	_drawCallAllocator[_currentAllocatorIndex].reset();
 }
 
+void GLContext::setRasterizerThreadCount(uint numThreads) {
+	disposeRasterizerTiles();
+
+	if (numThreads == 1)
+		return;
+
+	_rasterizerPool = new Common::WorkerPool(numThreads);
+	if (_rasterizerPool->getThreadCount() <= 1) {
+		delete _rasterizerPool;
+		_rasterizerPool = nullptr;
+		return;
+	}
+
+	// The screen is split into full width bands of 32 rows, whatever the
+	// number of threads. The threads take the bands from the pool as they
+	// become idle, so there are usually several bands for each thread.
+	const int kTileHeight = 32;
+	int width = fb->getPixelBufferWidth();
+	int height = fb->getPixelBufferHeight();
+	for (int y = 0; y < height; y += kTileHeight) {
+		RasterizerTile *tile = new RasterizerTile();
+		tile->rect = Common::Rect(0, y, width, MIN(y + kTileHeight, height));
+		tile->context = new GLContext();
+		tile->context->fb = &tile->fb;
+		_rasterizerTiles.push_back(tile);
+	}
+}
+
+void GLContext::disposeRasterizerTiles() {
+	for (uint i = 0; i < _rasterizerTiles.size(); i++) {
+		delete _rasterizerTiles[i]->context;
+		delete _rasterizerTiles[i];
+	}
+	_rasterizerTiles.clear();
+
+	delete _rasterizerPool;
+	_rasterizerPool = nullptr;
+}
+
+void GLContext::executeDrawCallsTiled() {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+
+	for (uint i = 0; i < _rasterizerTiles.size(); i++) {
+		GLContext *c = _rasterizerTiles[i]->context;
+		c->fb->shareBuffers(*fb);
+		c->render_mode = render_mode;
+		c->current_cull_face = current_cull_face;
+		c->vertex_n = vertex_n;
+		c->_textureSize = _textureSize;
+	}
+
+	// Tiles only ever touch their own pixels, so they can be rasterized in
+	// any order and still give the same result as the serial path, as long as
+	// the draw calls are executed in order inside each tile. Blitting goes
+	// through global state, so blits are executed on this thread, in between
+	// batches of tiled draw calls.
+	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+		if ((*it)->getType() != DrawCall::DrawCall_Blitting) {
+			_rasterizerDrawCalls.push_back(*it);
+			continue;
+		}
+
+		flushTiledDrawCalls();
+
+		Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		for (uint i = 0; i < _rasterizerDirtyRects.size(); i++) {
+			if (_rasterizerDirtyRects[i].intersects(drawCallRegion)) {
+				(*it)->execute(_rasterizerDirtyRects[i], true);
+			}
+		}
+	}
+
+	flushTiledDrawCalls();
+}
+
+void GLContext::flushTiledDrawCalls() {
+	if (_rasterizerDrawCalls.empty())
+		return;
+
+	_rasterizerPool->parallelFor(_rasterizerTiles.size(), rasterizeTile, this);
+	_rasterizerDrawCalls.clear();
+}
+
+void GLContext::rasterizeTile(void *data, uint index) {
+	const GLContext *c = (const GLContext *)data;
+	RasterizerTile &tile = *c->_rasterizerTiles[index];
+
+	for (uint i = 0; i < c->_rasterizerDirtyRects.size(); i++) {
+		Common::Rect clippingRectangle = c->_rasterizerDirtyRects[i].findIntersectingRect(tile.rect);
+		if (clippingRectangle.isEmpty())
+			continue;
+
+		for (uint j = 0; j < c->_rasterizerDrawCalls.size(); j++) {
+			const DrawCall *drawCall = c->_rasterizerDrawCalls[j];
+			if (clippingRectangle.intersects(drawCall->getDirtyRegion())) {
+				drawCall->executeOnTile(tile, clippingRectangle);
+			}
+		}
+	}
+}
+
 void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
 
@@ -266,6 +376,15 @@ void presentBuffer() {
 	presentBuffer(dirtyAreas);
 }
 
+void setRasterizerThreadCount(uint numThreads) {
+	GLContext *c = gl_get_context();
+	c->setRasterizerThreadCount(numThreads);
+}
+
+void DrawCall::executeOnTile(RasterizerTile &tile, const Common::Rect &clippingRectangle) const {
+	error("DrawCall type %d cannot be executed on a tile", _type);
+}
+
 bool DrawCall::operator==(const DrawCall &other) const {
 	if (_type == other._type) {
 		switch (_type) {
@@ -340,7 +459,7 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	if (restoreState) {
 		backupState = captureState();
 	}
-	applyState(_state);
+	applyState(c, _state);
 
 	GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
@@ -350,6 +469,35 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
 
+	rasterize(c);
+
+	c->vertex = prevVertex;
+	c->vertex_cnt = prevVertexCount;
+
+	if (restoreState) {
+		applyState(c, backupState);
+	}
+}
+
+void RasterizationDrawCall::executeOnTile(RasterizerTile &tile, const Common::Rect &clippingRectangle) const {
+	GLContext *c = tile.context;
+
+	// Rasterizing modifies some of the vertex data, so every tile needs its own copy
+	tile.vertices.resize(_vertexCount);
+	memcpy(tile.vertices.data(), _vertex, sizeof(GLVertex) * _vertexCount);
+
+	applyState(c, _state);
+	c->vertex = tile.vertices.data();
+	c->vertex_cnt = _vertexCount;
+	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
+	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
+
+	c->fb->setScissorRectangle(clippingRectangle);
+	rasterize(c);
+	c->fb->resetScissorRectangle();
+}
+
+void RasterizationDrawCall::rasterize(GLContext *c) const {
 	int n = c->vertex_n;
 	int cnt = c->vertex_cnt;
 
@@ -424,13 +572,6 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	default:
 		error("glBegin: type %x not handled", c->begin_type);
 	}
-
-	c->vertex = prevVertex;
-	c->vertex_cnt = prevVertexCount;
-
-	if (restoreState) {
-		applyState(backupState);
-	}
 }
 
 RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
@@ -484,8 +625,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
-	GLContext *c = gl_get_context();
+void RasterizationDrawCall::applyState(GLContext *c, const RasterizationDrawCall::RasterizationState &state) const {
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableAlphaTest(state.alphaTestEnabled);
@@ -711,6 +851,13 @@ void ClearBufferDrawCall::execute(const Common::Rect &clippingRectangle, bool re
 	                   _clearStencilBuffer, _stencilValue);
 }
 
+void ClearBufferDrawCall::executeOnTile(RasterizerTile &tile, const Common::Rect &clippingRectangle) const {
+	Common::Rect clearRect = clippingRectangle.findIntersectingRect(getDirtyRegion());
+	tile.context->fb->clearRegion(clearRect.left, clearRect.top, clearRect.width(), clearRect.height(),
+	                              _clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue,
+	                              _clearStencilBuffer, _stencilValue);
+}
+
 bool ClearBufferDrawCall::operator==(const ClearBufferDrawCall &other) const {
 	return
 		_clearZBuffer == other._clearZBuffer &&
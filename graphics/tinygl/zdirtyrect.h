@@ -37,6 +37,7 @@ void *allocateFrame(int size);
 struct GLContext;
 struct GLVertex;
 struct GLTexture;
+struct RasterizerTile;
 
 class DrawCall {
 public:
@@ -55,6 +56,9 @@ public:
 	}
 	virtual void execute(bool restoreState) const = 0;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const = 0;
+	// Executes the draw call on one tile of a frame rasterized by several threads.
+	// Blitting draw calls rely on global state and are never executed this way.
+	virtual void executeOnTile(RasterizerTile &tile, const Common::Rect &clippingRectangle) const;
 	DrawCallType getType() const { return _type; }
 	virtual const Common::Rect getDirtyRegion() const { return _dirtyRegion; }
 protected:
@@ -70,6 +74,7 @@ public:
 	bool operator==(const ClearBufferDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	virtual void executeOnTile(RasterizerTile &tile, const Common::Rect &clippingRectangle) const;
 
 	void *operator new(size_t size) {
 		return Internal::allocateFrame(size);
@@ -89,6 +94,7 @@ public:
 	bool operator==(const RasterizationDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	virtual void executeOnTile(RasterizerTile &tile, const Common::Rect &clippingRectangle) const;
 
 	void *operator new(size_t size) {
 		return Internal::allocateFrame(size);
@@ -97,6 +103,7 @@ public:
 	void operator delete(void *p) { }
 private:
 	void computeDirtyRegion();
+	void rasterize(GLContext *c) const;
 	typedef void (*gl_draw_triangle_func_ptr)(GLContext *c, TinyGL::GLVertex *p0, TinyGL::GLVertex *p1, TinyGL::GLVertex *p2);
 	int _vertexCount;
 	GLVertex *_vertex;
@@ -151,7 +158,7 @@ private:
 	RasterizationState _state;
 
 	RasterizationState captureState() const;
-	void applyState(const RasterizationState &state) const;
+	void applyState(GLContext *c, const RasterizationState &state) const;
 };
 
 // Encapsulate a blit call: it might execute either a color buffer or z buffer blit.
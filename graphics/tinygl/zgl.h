@@ -43,6 +43,10 @@
 #include "graphics/tinygl/zdirtyrect.h"
 #include "graphics/tinygl/texelbuffer.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 namespace TinyGL {
 
 enum {
@@ -443,6 +447,12 @@ struct GLContext {
 	bool _debugRectsEnabled;
 	bool _profilingEnabled;
 
+	// Multithreaded rasterization
+	Common::WorkerPool *_rasterizerPool;
+	Common::Array<RasterizerTile *> _rasterizerTiles;
+	Common::Array<DrawCall *> _rasterizerDrawCalls;
+	Common::Array<Common::Rect> _rasterizerDirtyRects;
+
 	void gl_vertex_transform(GLVertex *v);
 	void gl_calc_fog_factor(GLVertex *v);
 
@@ -493,6 +503,12 @@ public:
 	void presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas);
 	void presentBufferSimple(Common::List<Common::Rect> &dirtyAreas);
 
+	void setRasterizerThreadCount(uint numThreads);
+	void disposeRasterizerTiles();
+	void executeDrawCallsTiled();
+	void flushTiledDrawCalls();
+	static void rasterizeTile(void *data, uint index);
+
 	void debugDrawRectangle(Common::Rect rect, int r, int g, int b);
 
 	GLSpecBuf *specbuf_get_buffer(const int shininess_i, const float shininess);
@@ -521,6 +537,16 @@ public:
 	}
 };
 
+// A horizontal band of the screen, rasterized by one of the threads of the
+// worker pool. Every tile has its own context holding the rasterization state,
+// and its own copy of the vertices being drawn.
+struct RasterizerTile {
+	Common::Rect rect;
+	GLContext *context;
+	FrameBuffer fb;
+	Common::Array<GLVertex> vertices;
+};
+
 extern GLContext *gl_ctx;
 GLContext *gl_get_context();
 
@@ -0,0 +1,111 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/tinygl/zspan.h"
+
+namespace TinyGL {
+
+static inline bool testDepth(SpanDepthTest depthTest, uint z, uint zDst) {
+	switch (depthTest) {
+	case kSpanDepthLess:
+		return zDst < z;
+	case kSpanDepthLequal:
+		return zDst <= z;
+	default:
+		return true;
+	}
+}
+
+static inline uint32 packPixel(const ShadeSpan &span, uint a, uint r, uint g, uint b) {
+	return ((a & span.alphaMask) << span.aShift) | (r << span.rShift) | (g << span.gShift) | (b << span.bShift);
+}
+
+void depthTestSpan_Scalar(const ShadeSpan &span, byte *mask) {
+	uint z = span.z;
+	for (int i = 0; i < span.count; i++) {
+		mask[i] = testDepth(span.depthTest, z, span.zbuf[i]) ? 0xFF : 0;
+		z += span.dzdx;
+	}
+}
+
+void shadeSpan_Scalar(const ShadeSpan &span) {
+	uint z = span.z, r = span.r, g = span.g, b = span.b, a = span.a;
+	for (int i = 0; i < span.count; i++) {
+		if (testDepth(span.depthTest, z, span.zbuf[i])) {
+			if (span.depthWrite)
+				span.zbuf[i] = (uint)(float)z;
+			span.pixels[i] = packPixel(span, (a >> 8) & 0xFF, (r >> 8) & 0xFF, (g >> 8) & 0xFF, (b >> 8) & 0xFF);
+		}
+		z += span.dzdx;
+		r += span.drdx;
+		g += span.dgdx;
+		b += span.dbdx;
+		a += span.dadx;
+	}
+}
+
+void shadeTexturedSpan_Scalar(const ShadeSpan &span, const byte *mask, const uint32 *texels) {
+	uint z = span.z, r = span.r, g = span.g, b = span.b, a = span.a;
+	for (int i = 0; i < span.count; i++) {
+		if (mask[i]) {
+			if (span.depthWrite)
+				span.zbuf[i] = (uint)(float)z;
+			const uint32 texel = texels[i];
+			const byte c_a = (((texel >> 24) & 0xFF) * (a >> 8)) >> 8;
+			const byte c_r = (((texel >> 16) & 0xFF) * (r >> 8)) >> 8;
+			const byte c_g = (((texel >> 8) & 0xFF) * (g >> 8)) >> 8;
+			const byte c_b = ((texel & 0xFF) * (b >> 8)) >> 8;
+			span.pixels[i] = packPixel(span, c_a, c_r, c_g, c_b);
+		}
+		z += span.dzdx;
+		r += span.drdx;
+		g += span.dgdx;
+		b += span.dbdx;
+		a += span.dadx;
+	}
+}
+
+const SpanKernels *getSpanKernels() {
+	if (!g_system)
+		return nullptr;
+
+#ifdef SCUMMVM_AVX2
+	static const SpanKernels avx2Kernels = { depthTestSpan_AVX2, shadeSpan_AVX2, shadeTexturedSpan_AVX2 };
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		return &avx2Kernels;
+#endif
+#ifdef SCUMMVM_SSE2
+	static const SpanKernels sse2Kernels = { depthTestSpan_SSE2, shadeSpan_SSE2, shadeTexturedSpan_SSE2 };
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return &sse2Kernels;
+#endif
+#ifdef SCUMMVM_NEON
+	static const SpanKernels neonKernels = { depthTestSpan_NEON, shadeSpan_NEON, shadeTexturedSpan_NEON };
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return &neonKernels;
+#endif
+
+	return nullptr;
+}
+
+} // end of namespace TinyGL
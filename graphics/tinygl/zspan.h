@@ -0,0 +1,135 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H
+#define GRAPHICS_TINYGL_ZSPAN_H
+
+#include "common/scummsys.h"
+
+namespace TinyGL {
+
+enum SpanDepthTest {
+	kSpanDepthAlways,
+	kSpanDepthLess,
+	kSpanDepthLequal
+};
+
+/**
+ * A horizontal run of pixels of a triangle, for a 32 bits per pixel
+ * framebuffer without blending, alpha test, fog or stencil.
+ *
+ * For the pixel i of the span the interpolated values are z + i * dzdx,
+ * r + i * drdx and so on, wrapping around like the unsigned interpolants
+ * of the rasterizer do. z must stay in [0, kSpanMaxZ] over the whole span.
+ */
+struct ShadeSpan {
+	uint32 *pixels;
+	uint *zbuf;
+	int count;
+
+	uint z, r, g, b, a;
+	int dzdx, drdx, dgdx, dbdx, dadx;
+
+	SpanDepthTest depthTest;
+	bool depthWrite;
+
+	// Component shifts of the framebuffer format, alphaMask is 0 for formats
+	// without alpha and 0xFF otherwise.
+	uint aShift, rShift, gShift, bShift;
+	uint alphaMask;
+};
+
+/** The largest depth value the vector kernels convert exactly like the scalar code. */
+static const uint kSpanMaxZ = 0x7FFFFF00;
+
+/**
+ * Sets mask[i] to 0xFF for every pixel of the span which passes the depth
+ * test, and to 0 otherwise.
+ */
+typedef void (*DepthTestSpanProc)(const ShadeSpan &span, byte *mask);
+
+/**
+ * Depth tests and draws a Gouraud shaded span, like the rasterizer's
+ * putPixelNoTexture() does for every pixel.
+ */
+typedef void (*ShadeSpanProc)(const ShadeSpan &span);
+
+/**
+ * Draws the pixels of the span for which mask[i] is set, modulating the
+ * texel colors (stored as 0xAARRGGBB) with the interpolated color, like the
+ * rasterizer's putPixelTexture() does.
+ */
+typedef void (*ShadeTexturedSpanProc)(const ShadeSpan &span, const byte *mask, const uint32 *texels);
+
+/**
+ * The set of span kernels used by the rasterizer. All implementations
+ * produce bit-identical output.
+ */
+struct SpanKernels {
+	DepthTestSpanProc depthTestSpan;
+	ShadeSpanProc shadeSpan;
+	ShadeTexturedSpanProc shadeTexturedSpan;
+};
+
+/** Moves the start of the span n pixels to the right. */
+inline void skipSpanPixels(ShadeSpan &span, int n) {
+	span.pixels += n;
+	span.zbuf += n;
+	span.count -= n;
+	span.z += (uint)span.dzdx * n;
+	span.r += (uint)span.drdx * n;
+	span.g += (uint)span.dgdx * n;
+	span.b += (uint)span.dbdx * n;
+	span.a += (uint)span.dadx * n;
+}
+
+void depthTestSpan_Scalar(const ShadeSpan &span, byte *mask);
+void shadeSpan_Scalar(const ShadeSpan &span);
+void shadeTexturedSpan_Scalar(const ShadeSpan &span, const byte *mask, const uint32 *texels);
+
+#ifdef SCUMMVM_SSE2
+void depthTestSpan_SSE2(const ShadeSpan &span, byte *mask);
+void shadeSpan_SSE2(const ShadeSpan &span);
+void shadeTexturedSpan_SSE2(const ShadeSpan &span, const byte *mask, const uint32 *texels);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void depthTestSpan_AVX2(const ShadeSpan &span, byte *mask);
+void shadeSpan_AVX2(const ShadeSpan &span);
+void shadeTexturedSpan_AVX2(const ShadeSpan &span, const byte *mask, const uint32 *texels);
+#endif
+
+#ifdef SCUMMVM_NEON
+void depthTestSpan_NEON(const ShadeSpan &span, byte *mask);
+void shadeSpan_NEON(const ShadeSpan &span);
+void shadeTexturedSpan_NEON(const ShadeSpan &span, const byte *mask, const uint32 *texels);
+#endif
+
+/**
+ * Returns the fastest set of vector kernels supported by the CPU we are
+ * running on, or nullptr if there are none. The scalar kernels are only a
+ * reference, the rasterizer's own loops are used instead of them.
+ */
+const SpanKernels *getSpanKernels();
+
+} // end of namespace TinyGL
+
+#endif
@@ -0,0 +1,179 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/tinygl/zspan.h"
+
+#include <immintrin.h>
+
+namespace TinyGL {
+
+/** Returns start + i * step for the lanes i = 0 to 7. */
+static inline __m256i ramp(uint start, int step) {
+	return _mm256_add_epi32(_mm256_set1_epi32(start),
+		_mm256_mullo_epi32(_mm256_set1_epi32(step), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+}
+
+static inline __m256i testDepth(SpanDepthTest depthTest, __m256i z, __m256i zDst) {
+	// There is no unsigned compare, flipping the sign bits gives the same order
+	const __m256i sign = _mm256_set1_epi32((int)0x80000000);
+	switch (depthTest) {
+	case kSpanDepthLess:
+		return _mm256_cmpgt_epi32(_mm256_xor_si256(z, sign), _mm256_xor_si256(zDst, sign));
+	case kSpanDepthLequal:
+		return _mm256_xor_si256(_mm256_cmpgt_epi32(_mm256_xor_si256(zDst, sign), _mm256_xor_si256(z, sign)), _mm256_set1_epi32(-1));
+	default:
+		return _mm256_set1_epi32(-1);
+	}
+}
+
+/** Writes the pixels and depth values of the lanes set in mask. */
+static inline void store(const ShadeSpan &span, int i, __m256i mask, __m256i pixels, __m256i z) {
+	__m256i *dst = (__m256i *)(span.pixels + i);
+	_mm256_storeu_si256(dst, _mm256_blendv_epi8(_mm256_loadu_si256(dst), pixels, mask));
+
+	if (span.depthWrite) {
+		// The scalar code stores the depth through a float as well
+		__m256i *zDst = (__m256i *)(span.zbuf + i);
+		const __m256i zStored = _mm256_cvttps_epi32(_mm256_cvtepi32_ps(z));
+		_mm256_storeu_si256(zDst, _mm256_blendv_epi8(_mm256_loadu_si256(zDst), zStored, mask));
+	}
+}
+
+static inline __m256i pack(const ShadeSpan &span, __m256i a, __m256i r, __m256i g, __m256i b) {
+	a = _mm256_and_si256(a, _mm256_set1_epi32(span.alphaMask));
+	return _mm256_or_si256(
+		_mm256_or_si256(_mm256_sll_epi32(a, _mm_cvtsi32_si128(span.aShift)), _mm256_sll_epi32(r, _mm_cvtsi32_si128(span.rShift))),
+		_mm256_or_si256(_mm256_sll_epi32(g, _mm_cvtsi32_si128(span.gShift)), _mm256_sll_epi32(b, _mm_cvtsi32_si128(span.bShift))));
+}
+
+static inline __m256i loadMask(const byte *mask) {
+	return _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)mask));
+}
+
+void depthTestSpan_AVX2(const ShadeSpan &span, byte *mask) {
+	__m256i z = ramp(span.z, span.dzdx);
+	const __m256i dz = _mm256_set1_epi32((uint)span.dzdx * 8);
+
+	int i = 0;
+	for (; i + 16 <= span.count; i += 16) {
+		const __m256i m0 = testDepth(span.depthTest, z, _mm256_loadu_si256((const __m256i *)(span.zbuf + i)));
+		z = _mm256_add_epi32(z, dz);
+		const __m256i m1 = testDepth(span.depthTest, z, _mm256_loadu_si256((const __m256i *)(span.zbuf + i + 8)));
+		z = _mm256_add_epi32(z, dz);
+
+		// The packs work on each 128-bit half, so the two halves are interleaved
+		const __m256i m16 = _mm256_permute4x64_epi64(_mm256_packs_epi32(m0, m1), 0xD8);
+		const __m128i m = _mm_packs_epi16(_mm256_castsi256_si128(m16), _mm256_extracti128_si256(m16, 1));
+		_mm_storeu_si128((__m128i *)(mask + i), m);
+	}
+
+	if (i < span.count) {
+		ShadeSpan tail = span;
+		skipSpanPixels(tail, i);
+		depthTestSpan_Scalar(tail, mask + i);
+	}
+}
+
+void shadeSpan_AVX2(const ShadeSpan &span) {
+	__m256i z = ramp(span.z, span.dzdx);
+	__m256i r = ramp(span.r, span.drdx);
+	__m256i g = ramp(span.g, span.dgdx);
+	__m256i b = ramp(span.b, span.dbdx);
+	__m256i a = ramp(span.a, span.dadx);
+	const __m256i dz = _mm256_set1_epi32((uint)span.dzdx * 8);
+	const __m256i dr = _mm256_set1_epi32((uint)span.drdx * 8);
+	const __m256i dg = _mm256_set1_epi32((uint)span.dgdx * 8);
+	const __m256i db = _mm256_set1_epi32((uint)span.dbdx * 8);
+	const __m256i da = _mm256_set1_epi32((uint)span.dadx * 8);
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+
+	int i = 0;
+	for (; i + 8 <= span.count; i += 8) {
+		const __m256i mask = testDepth(span.depthTest, z, _mm256_loadu_si256((const __m256i *)(span.zbuf + i)));
+		const __m256i pixels = pack(span,
+			_mm256_and_si256(_mm256_srli_epi32(a, 8), byteMask),
+			_mm256_and_si256(_mm256_srli_epi32(r, 8), byteMask),
+			_mm256_and_si256(_mm256_srli_epi32(g, 8), byteMask),
+			_mm256_and_si256(_mm256_srli_epi32(b, 8), byteMask));
+		store(span, i, mask, pixels, z);
+
+		z = _mm256_add_epi32(z, dz);
+		r = _mm256_add_epi32(r, dr);
+		g = _mm256_add_epi32(g, dg);
+		b = _mm256_add_epi32(b, db);
+		a = _mm256_add_epi32(a, da);
+	}
+
+	if (i < span.count) {
+		ShadeSpan tail = span;
+		skipSpanPixels(tail, i);
+		shadeSpan_Scalar(tail);
+	}
+}
+
+/**
+ * Returns bits 8 to 15 of texel * (color >> 8), for a texel component in
+ * the low byte of every lane. Only the low 16 bits of the factors matter
+ * for those bits of the product.
+ */
+static inline __m256i modulate(__m256i texel, __m256i color) {
+	const __m256i light = _mm256_and_si256(_mm256_srli_epi32(color, 8), _mm256_set1_epi32(0xFFFF));
+	return _mm256_srli_epi32(_mm256_mullo_epi16(texel, light), 8);
+}
+
+void shadeTexturedSpan_AVX2(const ShadeSpan &span, const byte *mask, const uint32 *texels) {
+	__m256i z = ramp(span.z, span.dzdx);
+	__m256i r = ramp(span.r, span.drdx);
+	__m256i g = ramp(span.g, span.dgdx);
+	__m256i b = ramp(span.b, span.dbdx);
+	__m256i a = ramp(span.a, span.dadx);
+	const __m256i dz = _mm256_set1_epi32((uint)span.dzdx * 8);
+	const __m256i dr = _mm256_set1_epi32((uint)span.drdx * 8);
+	const __m256i dg = _mm256_set1_epi32((uint)span.dgdx * 8);
+	const __m256i db = _mm256_set1_epi32((uint)span.dbdx * 8);
+	const __m256i da = _mm256_set1_epi32((uint)span.dadx * 8);
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+
+	int i = 0;
+	for (; i + 8 <= span.count; i += 8) {
+		const __m256i texel = _mm256_loadu_si256((const __m256i *)(texels + i));
+		const __m256i pixels = pack(span,
+			modulate(_mm256_srli_epi32(texel, 24), a),
+			modulate(_mm256_and_si256(_mm256_srli_epi32(texel, 16), byteMask), r),
+			modulate(_mm256_and_si256(_mm256_srli_epi32(texel, 8), byteMask), g),
+			modulate(_mm256_and_si256(texel, byteMask), b));
+		store(span, i, loadMask(mask + i), pixels, z);
+
+		z = _mm256_add_epi32(z, dz);
+		r = _mm256_add_epi32(r, dr);
+		g = _mm256_add_epi32(g, dg);
+		b = _mm256_add_epi32(b, db);
+		a = _mm256_add_epi32(a, da);
+	}
+
+	if (i < span.count) {
+		ShadeSpan tail = span;
+		skipSpanPixels(tail, i);
+		shadeTexturedSpan_Scalar(tail, mask + i, texels + i);
+	}
+}
+
+} // end of namespace TinyGL
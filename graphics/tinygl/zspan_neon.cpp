@@ -0,0 +1,178 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/tinygl/zspan.h"
+
+#include <arm_neon.h>
+
+namespace TinyGL {
+
+/** Returns start + i * step for the lanes i = 0 to 3. */
+static inline uint32x4_t ramp(uint start, int step) {
+	static const uint32 lanes[4] = { 0, 1, 2, 3 };
+	return vmlaq_n_u32(vdupq_n_u32(start), vld1q_u32(lanes), (uint)step);
+}
+
+static inline uint32x4_t testDepth(SpanDepthTest depthTest, uint32x4_t z, uint32x4_t zDst) {
+	switch (depthTest) {
+	case kSpanDepthLess:
+		return vcltq_u32(zDst, z);
+	case kSpanDepthLequal:
+		return vcleq_u32(zDst, z);
+	default:
+		return vdupq_n_u32(0xFFFFFFFF);
+	}
+}
+
+/** Writes the pixels and depth values of the lanes set in mask. */
+static inline void store(const ShadeSpan &span, int i, uint32x4_t mask, uint32x4_t pixels, uint32x4_t z) {
+	uint32 *dst = span.pixels + i;
+	vst1q_u32(dst, vbslq_u32(mask, pixels, vld1q_u32(dst)));
+
+	if (span.depthWrite) {
+		// The scalar code stores the depth through a float as well
+		uint32 *zDst = span.zbuf + i;
+		const uint32x4_t zStored = vreinterpretq_u32_s32(vcvtq_s32_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(z))));
+		vst1q_u32(zDst, vbslq_u32(mask, zStored, vld1q_u32(zDst)));
+	}
+}
+
+static inline uint32x4_t pack(const ShadeSpan &span, uint32x4_t a, uint32x4_t r, uint32x4_t g, uint32x4_t b) {
+	a = vandq_u32(a, vdupq_n_u32(span.alphaMask));
+	return vorrq_u32(
+		vorrq_u32(vshlq_u32(a, vdupq_n_s32(span.aShift)), vshlq_u32(r, vdupq_n_s32(span.rShift))),
+		vorrq_u32(vshlq_u32(g, vdupq_n_s32(span.gShift)), vshlq_u32(b, vdupq_n_s32(span.bShift))));
+}
+
+static inline uint32x4_t loadMask(const byte *mask) {
+	uint32 bytes;
+	memcpy(&bytes, mask, sizeof(bytes));
+	const int8x8_t m = vreinterpret_s8_u32(vdup_n_u32(bytes));
+	return vreinterpretq_u32_s32(vmovl_s16(vget_low_s16(vmovl_s8(m))));
+}
+
+void depthTestSpan_NEON(const ShadeSpan &span, byte *mask) {
+	uint32x4_t z = ramp(span.z, span.dzdx);
+	const uint32x4_t dz = vdupq_n_u32((uint)span.dzdx * 4);
+
+	int i = 0;
+	for (; i + 8 <= span.count; i += 8) {
+		const uint32x4_t m0 = testDepth(span.depthTest, z, vld1q_u32(span.zbuf + i));
+		z = vaddq_u32(z, dz);
+		const uint32x4_t m1 = testDepth(span.depthTest, z, vld1q_u32(span.zbuf + i + 4));
+		z = vaddq_u32(z, dz);
+
+		const uint16x8_t m16 = vcombine_u16(vmovn_u32(m0), vmovn_u32(m1));
+		vst1_u8(mask + i, vmovn_u16(m16));
+	}
+
+	if (i < span.count) {
+		ShadeSpan tail = span;
+		skipSpanPixels(tail, i);
+		depthTestSpan_Scalar(tail, mask + i);
+	}
+}
+
+void shadeSpan_NEON(const ShadeSpan &span) {
+	uint32x4_t z = ramp(span.z, span.dzdx);
+	uint32x4_t r = ramp(span.r, span.drdx);
+	uint32x4_t g = ramp(span.g, span.dgdx);
+	uint32x4_t b = ramp(span.b, span.dbdx);
+	uint32x4_t a = ramp(span.a, span.dadx);
+	const uint32x4_t dz = vdupq_n_u32((uint)span.dzdx * 4);
+	const uint32x4_t dr = vdupq_n_u32((uint)span.drdx * 4);
+	const uint32x4_t dg = vdupq_n_u32((uint)span.dgdx * 4);
+	const uint32x4_t db = vdupq_n_u32((uint)span.dbdx * 4);
+	const uint32x4_t da = vdupq_n_u32((uint)span.dadx * 4);
+	const uint32x4_t byteMask = vdupq_n_u32(0xFF);
+
+	int i = 0;
+	for (; i + 4 <= span.count; i += 4) {
+		const uint32x4_t mask = testDepth(span.depthTest, z, vld1q_u32(span.zbuf + i));
+		const uint32x4_t pixels = pack(span,
+			vandq_u32(vshrq_n_u32(a, 8), byteMask),
+			vandq_u32(vshrq_n_u32(r, 8), byteMask),
+			vandq_u32(vshrq_n_u32(g, 8), byteMask),
+			vandq_u32(vshrq_n_u32(b, 8), byteMask));
+		store(span, i, mask, pixels, z);
+
+		z = vaddq_u32(z, dz);
+		r = vaddq_u32(r, dr);
+		g = vaddq_u32(g, dg);
+		b = vaddq_u32(b, db);
+		a = vaddq_u32(a, da);
+	}
+
+	if (i < span.count) {
+		ShadeSpan tail = span;
+		skipSpanPixels(tail, i);
+		shadeSpan_Scalar(tail);
+	}
+}
+
+/**
+ * Returns bits 8 to 15 of texel * (color >> 8), for a texel component in
+ * the low byte of every lane. Only the low 16 bits of the factors matter
+ * for those bits of the product.
+ */
+static inline uint32x4_t modulate(uint32x4_t texel, uint32x4_t color) {
+	const uint32x4_t light = vandq_u32(vshrq_n_u32(color, 8), vdupq_n_u32(0xFFFF));
+	return vandq_u32(vshrq_n_u32(vmulq_u32(texel, light), 8), vdupq_n_u32(0xFF));
+}
+
+void shadeTexturedSpan_NEON(const ShadeSpan &span, const byte *mask, const uint32 *texels) {
+	uint32x4_t z = ramp(span.z, span.dzdx);
+	uint32x4_t r = ramp(span.r, span.drdx);
+	uint32x4_t g = ramp(span.g, span.dgdx);
+	uint32x4_t b = ramp(span.b, span.dbdx);
+	uint32x4_t a = ramp(span.a, span.dadx);
+	const uint32x4_t dz = vdupq_n_u32((uint)span.dzdx * 4);
+	const uint32x4_t dr = vdupq_n_u32((uint)span.drdx * 4);
+	const uint32x4_t dg = vdupq_n_u32((uint)span.dgdx * 4);
+	const uint32x4_t db = vdupq_n_u32((uint)span.dbdx * 4);
+	const uint32x4_t da = vdupq_n_u32((uint)span.dadx * 4);
+	const uint32x4_t byteMask = vdupq_n_u32(0xFF);
+
+	int i = 0;
+	for (; i + 4 <= span.count; i += 4) {
+		const uint32x4_t texel = vld1q_u32(texels + i);
+		const uint32x4_t pixels = pack(span,
+			modulate(vshrq_n_u32(texel, 24), a),
+			modulate(vandq_u32(vshrq_n_u32(texel, 16), byteMask), r),
+			modulate(vandq_u32(vshrq_n_u32(texel, 8), byteMask), g),
+			modulate(vandq_u32(texel, byteMask), b));
+		store(span, i, loadMask(mask + i), pixels, z);
+
+		z = vaddq_u32(z, dz);
+		r = vaddq_u32(r, dr);
+		g = vaddq_u32(g, dg);
+		b = vaddq_u32(b, db);
+		a = vaddq_u32(a, da);
+	}
+
+	if (i < span.count) {
+		ShadeSpan tail = span;
+		skipSpanPixels(tail, i);
+		shadeTexturedSpan_Scalar(tail, mask + i, texels + i);
+	}
+}
+
+} // end of namespace TinyGL
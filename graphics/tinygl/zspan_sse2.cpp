@@ -0,0 +1,183 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/tinygl/zspan.h"
+
+#include <emmintrin.h>
+
+namespace TinyGL {
+
+/** Returns start, start + step, start + 2 * step and start + 3 * step. */
+static inline __m128i ramp(uint start, int step) {
+	return _mm_set_epi32(start + 3 * (uint)step, start + 2 * (uint)step, start + step, start);
+}
+
+static inline __m128i testDepth(SpanDepthTest depthTest, __m128i z, __m128i zDst) {
+	// There is no unsigned compare, flipping the sign bits gives the same order
+	const __m128i sign = _mm_set1_epi32((int)0x80000000);
+	switch (depthTest) {
+	case kSpanDepthLess:
+		return _mm_cmpgt_epi32(_mm_xor_si128(z, sign), _mm_xor_si128(zDst, sign));
+	case kSpanDepthLequal:
+		return _mm_xor_si128(_mm_cmpgt_epi32(_mm_xor_si128(zDst, sign), _mm_xor_si128(z, sign)), _mm_set1_epi32(-1));
+	default:
+		return _mm_set1_epi32(-1);
+	}
+}
+
+static inline __m128i select(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/** Writes the pixels and depth values of the lanes set in mask. */
+static inline void store(const ShadeSpan &span, int i, __m128i mask, __m128i pixels, __m128i z) {
+	__m128i *dst = (__m128i *)(span.pixels + i);
+	_mm_storeu_si128(dst, select(mask, pixels, _mm_loadu_si128(dst)));
+
+	if (span.depthWrite) {
+		// The scalar code stores the depth through a float as well
+		__m128i *zDst = (__m128i *)(span.zbuf + i);
+		const __m128i zStored = _mm_cvttps_epi32(_mm_cvtepi32_ps(z));
+		_mm_storeu_si128(zDst, select(mask, zStored, _mm_loadu_si128(zDst)));
+	}
+}
+
+static inline __m128i pack(const ShadeSpan &span, __m128i a, __m128i r, __m128i g, __m128i b) {
+	a = _mm_and_si128(a, _mm_set1_epi32(span.alphaMask));
+	return _mm_or_si128(
+		_mm_or_si128(_mm_sll_epi32(a, _mm_cvtsi32_si128(span.aShift)), _mm_sll_epi32(r, _mm_cvtsi32_si128(span.rShift))),
+		_mm_or_si128(_mm_sll_epi32(g, _mm_cvtsi32_si128(span.gShift)), _mm_sll_epi32(b, _mm_cvtsi32_si128(span.bShift))));
+}
+
+static inline __m128i loadMask(const byte *mask) {
+	int bytes;
+	memcpy(&bytes, mask, sizeof(bytes));
+	const __m128i m = _mm_cvtsi32_si128(bytes);
+	return _mm_unpacklo_epi16(_mm_unpacklo_epi8(m, m), _mm_unpacklo_epi8(m, m));
+}
+
+void depthTestSpan_SSE2(const ShadeSpan &span, byte *mask) {
+	__m128i z = ramp(span.z, span.dzdx);
+	const __m128i dz = _mm_set1_epi32((uint)span.dzdx * 4);
+
+	int i = 0;
+	for (; i + 8 <= span.count; i += 8) {
+		const __m128i m0 = testDepth(span.depthTest, z, _mm_loadu_si128((const __m128i *)(span.zbuf + i)));
+		z = _mm_add_epi32(z, dz);
+		const __m128i m1 = testDepth(span.depthTest, z, _mm_loadu_si128((const __m128i *)(span.zbuf + i + 4)));
+		z = _mm_add_epi32(z, dz);
+
+		const __m128i m = _mm_packs_epi16(_mm_packs_epi32(m0, m1), _mm_setzero_si128());
+		_mm_storel_epi64((__m128i *)(mask + i), m);
+	}
+
+	if (i < span.count) {
+		ShadeSpan tail = span;
+		skipSpanPixels(tail, i);
+		depthTestSpan_Scalar(tail, mask + i);
+	}
+}
+
+void shadeSpan_SSE2(const ShadeSpan &span) {
+	__m128i z = ramp(span.z, span.dzdx);
+	__m128i r = ramp(span.r, span.drdx);
+	__m128i g = ramp(span.g, span.dgdx);
+	__m128i b = ramp(span.b, span.dbdx);
+	__m128i a = ramp(span.a, span.dadx);
+	const __m128i dz = _mm_set1_epi32((uint)span.dzdx * 4);
+	const __m128i dr = _mm_set1_epi32((uint)span.drdx * 4);
+	const __m128i dg = _mm_set1_epi32((uint)span.dgdx * 4);
+	const __m128i db = _mm_set1_epi32((uint)span.dbdx * 4);
+	const __m128i da = _mm_set1_epi32((uint)span.dadx * 4);
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+
+	int i = 0;
+	for (; i + 4 <= span.count; i += 4) {
+		const __m128i mask = testDepth(span.depthTest, z, _mm_loadu_si128((const __m128i *)(span.zbuf + i)));
+		const __m128i pixels = pack(span,
+			_mm_and_si128(_mm_srli_epi32(a, 8), byteMask),
+			_mm_and_si128(_mm_srli_epi32(r, 8), byteMask),
+			_mm_and_si128(_mm_srli_epi32(g, 8), byteMask),
+			_mm_and_si128(_mm_srli_epi32(b, 8), byteMask));
+		store(span, i, mask, pixels, z);
+
+		z = _mm_add_epi32(z, dz);
+		r = _mm_add_epi32(r, dr);
+		g = _mm_add_epi32(g, dg);
+		b = _mm_add_epi32(b, db);
+		a = _mm_add_epi32(a, da);
+	}
+
+	if (i < span.count) {
+		ShadeSpan tail = span;
+		skipSpanPixels(tail, i);
+		shadeSpan_Scalar(tail);
+	}
+}
+
+/**
+ * Returns bits 8 to 15 of texel * (color >> 8), for a texel component in
+ * the low byte of every lane. Only the low 16 bits of the factors matter
+ * for those bits of the product.
+ */
+static inline __m128i modulate(__m128i texel, __m128i color) {
+	const __m128i light = _mm_and_si128(_mm_srli_epi32(color, 8), _mm_set1_epi32(0xFFFF));
+	return _mm_srli_epi32(_mm_mullo_epi16(texel, light), 8);
+}
+
+void shadeTexturedSpan_SSE2(const ShadeSpan &span, const byte *mask, const uint32 *texels) {
+	__m128i z = ramp(span.z, span.dzdx);
+	__m128i r = ramp(span.r, span.drdx);
+	__m128i g = ramp(span.g, span.dgdx);
+	__m128i b = ramp(span.b, span.dbdx);
+	__m128i a = ramp(span.a, span.dadx);
+	const __m128i dz = _mm_set1_epi32((uint)span.dzdx * 4);
+	const __m128i dr = _mm_set1_epi32((uint)span.drdx * 4);
+	const __m128i dg = _mm_set1_epi32((uint)span.dgdx * 4);
+	const __m128i db = _mm_set1_epi32((uint)span.dbdx * 4);
+	const __m128i da = _mm_set1_epi32((uint)span.dadx * 4);
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+
+	int i = 0;
+	for (; i + 4 <= span.count; i += 4) {
+		const __m128i texel = _mm_loadu_si128((const __m128i *)(texels + i));
+		const __m128i pixels = pack(span,
+			modulate(_mm_srli_epi32(texel, 24), a),
+			modulate(_mm_and_si128(_mm_srli_epi32(texel, 16), byteMask), r),
+			modulate(_mm_and_si128(_mm_srli_epi32(texel, 8), byteMask), g),
+			modulate(_mm_and_si128(texel, byteMask), b));
+		store(span, i, loadMask(mask + i), pixels, z);
+
+		z = _mm_add_epi32(z, dz);
+		r = _mm_add_epi32(r, dr);
+		g = _mm_add_epi32(g, dg);
+		b = _mm_add_epi32(b, db);
+		a = _mm_add_epi32(a, da);
+	}
+
+	if (i < span.count) {
+		ShadeSpan tail = span;
+		skipSpanPixels(tail, i);
+		shadeTexturedSpan_Scalar(tail, mask + i, texels + i);
+	}
+}
+
+} // end of namespace TinyGL
@@ -29,6 +29,7 @@
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
 
 namespace TinyGL {
 
@@ -157,6 +158,99 @@ void FrameBuffer::putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &
 	z += dzdx;
 }
 
+// Spans are processed in chunks of this many pixels when texturing with the span kernels
+static const int kSpanChunkSize = 32 * NB_INTERP;
+
+// The span kernels store the depth through a float exactly like writePixel()
+// only as long as it fits into a signed int.
+static inline bool isSpanDepthInRange(int z, int dzdx, int n) {
+	const int64 zEnd = (int64)z + (int64)dzdx * MAX(n, 0);
+	return z >= 0 && (uint)z <= kSpanMaxZ && zEnd >= 0 && zEnd <= kSpanMaxZ;
+}
+
+bool FrameBuffer::initShadeSpan(ShadeSpan &span, bool depthTestEnabled, bool depthWrite) const {
+	if (!_spanKernels)
+		return false;
+
+	if (!depthTestEnabled || !_depthTestEnabled) {
+		span.depthTest = kSpanDepthAlways;
+	} else {
+		switch (_depthFunc) {
+		case TGL_LESS:
+			span.depthTest = kSpanDepthLess;
+			break;
+		case TGL_LEQUAL:
+			span.depthTest = kSpanDepthLequal;
+			break;
+		case TGL_ALWAYS:
+			span.depthTest = kSpanDepthAlways;
+			break;
+		default:
+			return false;
+		}
+	}
+
+	span.depthWrite = depthWrite;
+	span.aShift = _pbufFormat.aShift;
+	span.rShift = _pbufFormat.rShift;
+	span.gShift = _pbufFormat.gShift;
+	span.bShift = _pbufFormat.bShift;
+	span.alphaMask = _pbufFormat.aLoss == 0 ? 0xFF : 0;
+	return true;
+}
+
+// Does the same as the putPixelTexture() loop of fillTriangle(): the depth
+// test and shading run in the span kernels, only the texture lookups are
+// done per pixel, and only for the pixels passing the depth test.
+void FrameBuffer::drawTexturedSpan(ShadeSpan &span, const TexelBuffer *texture, float sz, float tz, float fdzdx, float dszdx, float dtzdx) {
+	const float fndzdx = NB_INTERP * fdzdx;
+	const float ndszdx = NB_INTERP * dszdx;
+	const float ndtzdx = NB_INTERP * dtzdx;
+	const int count = span.count;
+
+	byte mask[kSpanChunkSize];
+	uint32 texels[kSpanChunkSize];
+
+	float fz = (float)span.z;
+	float zinv = (float)(1.0 / fz);
+	int s = 0, t = 0, dsdx = 0, dtdx = 0;
+
+	for (int first = 0; first < count; first += kSpanChunkSize) {
+		span.count = MIN(count - first, kSpanChunkSize);
+		_spanKernels->depthTestSpan(span, mask);
+
+		for (int j = 0; j < span.count; j++) {
+			const int i = first + j;
+			if ((i % NB_INTERP) == 0) {
+				float ss, tt;
+				ss = sz * zinv;
+				tt = tz * zinv;
+				s = (int)ss;
+				t = (int)tt;
+				dsdx = (int)((dszdx - ss * fdzdx) * zinv);
+				dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
+				// the perspective is only corrected for complete blocks
+				if (count - i >= NB_INTERP) {
+					fz += fndzdx;
+					zinv = (float)(1.0 / fz);
+					sz += ndszdx;
+					tz += ndtzdx;
+				}
+			}
+			if (mask[j]) {
+				uint8 c_a, c_r, c_g, c_b;
+				texture->getARGBAt(_wrapS, _wrapT, s, t, c_a, c_r, c_g, c_b);
+				texels[j] = (c_a << 24) | (c_r << 16) | (c_g << 8) | c_b;
+			}
+			s += dsdx;
+			t += dtdx;
+		}
+
+		_spanKernels->shadeTexturedSpan(span, mask, texels);
+		skipSpanPixels(span, span.count);
+	}
+}
+
 template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, bool kSmoothMode,
           bool kDepthWrite, bool kFogMode, bool kAlphaTestEnabled, bool kEnableScissor,
           bool kBlendingEnabled, bool kStencilEnabled, bool kDepthTestEnabled>
@@ -325,6 +419,18 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		ndtzdx = NB_INTERP * dtzdx;
 	}
 
+	// The common kinds of spans are drawn several pixels at a time by the span kernels
+	ShadeSpan span;
+	const bool useSpanKernels = kInterpRGB && kInterpZ && !kFogMode && !kAlphaTestEnabled && !kBlendingEnabled && !kStencilEnabled &&
+	                            initShadeSpan(span, kDepthTestEnabled, kDepthWrite);
+	if (useSpanKernels) {
+		span.dzdx = dzdx;
+		span.drdx = kSmoothMode ? drdx : 0;
+		span.dgdx = kSmoothMode ? dgdx : 0;
+		span.dbdx = kSmoothMode ? dbdx : 0;
+		span.dadx = kSmoothMode ? dadx : 0;
+	}
+
 	if (fz0 > 0) {
 		l1 = p0;
 		l2 = p2;
@@ -423,8 +529,29 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
+			// nothing left to draw below the scissor rectangle
+			if (kEnableScissor && y >= _clipRectangle.bottom)
+				return;
+
 			int x = x1;
-			if (!kInterpRGB) {
+			if (kEnableScissor && y < _clipRectangle.top) {
+				// skip the span, only the edges need to be updated
+			} else if (useSpanKernels && (!kEnableScissor || (x1 >= _clipRectangle.left && (x2 >> 16) < _clipRectangle.right)) &&
+			           isSpanDepthInRange(z1, dzdx, (x2 >> 16) - x1)) {
+				span.pixels = (uint32 *)_pbuf.getRawBuffer(pp1 + x1);
+				span.zbuf = pz1 + x1;
+				span.count = (x2 >> 16) - x1 + 1;
+				span.z = z1;
+				span.r = r1;
+				span.g = g1;
+				span.b = b1;
+				span.a = a1;
+				if (kInterpST || kInterpSTZ) {
+					drawTexturedSpan(span, texture, sz1, tz1, fdzdx, dszdx, dtzdx);
+				} else {
+					_spanKernels->shadeSpan(span);
+				}
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
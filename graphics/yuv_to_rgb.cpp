@@ -82,8 +82,13 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/config-manager.h"
+#include "common/system.h"
+#include "common/workerpool.h"
+
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -168,6 +173,7 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
 	_alphaMode = false;
+	_pool = nullptr;
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -186,10 +192,28 @@ YUVToRGBManager::YUVToRGBManager() {
 		Cb_g_tab[i] = (int16) (-(0.114 / 0.331) * CB);
 		Cb_b_tab[i] = (int16) ( (0.587 / 0.331) * CB) + 2 * 768 + 256;
 	}
+
+	if (ConfMan.hasKey("video_threads"))
+		setThreadCount(MAX(ConfMan.getInt("video_threads"), 0));
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
 	delete _lookup;
+	delete _pool;
+}
+
+void YUVToRGBManager::setThreadCount(uint numThreads) {
+	delete _pool;
+	_pool = nullptr;
+
+	if (numThreads == 1)
+		return;
+
+	_pool = new Common::WorkerPool(numThreads);
+	if (_pool->getThreadCount() <= 1) {
+		delete _pool;
+		_pool = nullptr;
+	}
 }
 
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale, bool alphaMode) {
@@ -202,18 +226,180 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+/** The parameters of a conversion, or of a band of rows of one. */
+struct YUVFrame {
+	byte *dst;
+	int dstPitch;
+	const YUVToRGBLookup *lookup;
+	const int16 *colorTab;
+	const byte *ySrc, *uSrc, *vSrc, *aSrc;
+	int yWidth, yHeight, yPitch, uvPitch;
+	ConvertYUVSpanProc convertSpan;
+};
+
+typedef void (*ConvertYUVFrameProc)(const YUVFrame &frame);
+
+struct YUVBandTask {
+	ConvertYUVFrameProc convert;
+	const YUVFrame *frame;
+	// A unit is the group of rows sharing a row of chroma values
+	int rowsPerUnit;
+	int units;
+	int bands;
+};
+
+static void convertYUVBand(void *data, uint index) {
+	const YUVBandTask &task = *(const YUVBandTask *)data;
+	const int first = task.units * index / task.bands;
+	const int last = task.units * (index + 1) / task.bands;
+	const int firstRow = first * task.rowsPerUnit;
+
+	YUVFrame band = *task.frame;
+	band.dst += firstRow * band.dstPitch;
+	band.ySrc += firstRow * band.yPitch;
+	if (band.aSrc)
+		band.aSrc += firstRow * band.yPitch;
+	band.uSrc += first * band.uvPitch;
+	band.vSrc += first * band.uvPitch;
+	band.yHeight = (last - first) * task.rowsPerUnit;
+	task.convert(band);
+}
+
+/**
+ * Converts the frame, split in bands of rows converted by the threads of
+ * the pool if there is one.
+ */
+static void convertYUVFrame(Common::WorkerPool *pool, ConvertYUVFrameProc convert, const YUVFrame &frame, int rowsPerUnit) {
+	const int units = frame.yHeight / rowsPerUnit;
+	if (!pool || units < 2) {
+		convert(frame);
+		return;
+	}
+
+	YUVBandTask task;
+	task.convert = convert;
+	task.frame = &frame;
+	task.rowsPerUnit = rowsPerUnit;
+	task.units = units;
+	task.bands = MIN<int>(units, pool->getThreadCount());
+	pool->parallelFor(task.bands, convertYUVBand, &task);
+}
+
+/** Sets the chroma contributions of a pair of chroma values, see YUVSpan. */
+static inline void setChromaOffsets(int16 *rOffset, int16 *gOffset, int16 *bOffset, const int16 *colorTab, byte u, byte v) {
+	// Take away the positions of the tables in YUVToRGBLookup
+	*rOffset = colorTab[0 * 256 + v] - (0 * 768 + 256);
+	*gOffset = colorTab[1 * 256 + v] + colorTab[2 * 256 + u] - (1 * 768 + 256);
+	*bOffset = colorTab[3 * 256 + u] - (2 * 768 + 256);
+}
+
+static void convertYUV444Spans(const YUVFrame &frame) {
+	const Graphics::PixelFormat format = frame.lookup->getFormat();
+	const bool ituScale = frame.lookup->getScale() == YUVToRGBManager::kScaleITU;
+	int16 rOffset[kYUVSpanSize], gOffset[kYUVSpanSize], bOffset[kYUVSpanSize];
+
+	for (int h = 0; h < frame.yHeight; h++) {
+		byte *dstRow = frame.dst + h * frame.dstPitch;
+		const byte *yRow = frame.ySrc + h * frame.yPitch;
+		const byte *uRow = frame.uSrc + h * frame.uvPitch;
+		const byte *vRow = frame.vSrc + h * frame.uvPitch;
+
+		for (int x = 0; x < frame.yWidth; x += kYUVSpanSize) {
+			const uint count = MIN<int>(kYUVSpanSize, frame.yWidth - x);
+			for (uint i = 0; i < count; i++)
+				setChromaOffsets(rOffset + i, gOffset + i, bOffset + i, frame.colorTab, uRow[x + i], vRow[x + i]);
+
+			const YUVSpan span = { dstRow + x * format.bytesPerPixel, yRow + x, nullptr, rOffset, gOffset, bOffset, count };
+			frame.convertSpan(span, format, ituScale);
+		}
+	}
+}
+
+/** Converts 4:2:0 data, with alpha if frame.aSrc is set. */
+static void convertYUV420Spans(const YUVFrame &frame) {
+	const Graphics::PixelFormat format = frame.lookup->getFormat();
+	const bool ituScale = frame.lookup->getScale() == YUVToRGBManager::kScaleITU;
+	int16 rOffset[kYUVSpanSize], gOffset[kYUVSpanSize], bOffset[kYUVSpanSize];
+
+	for (int h = 0; h < frame.yHeight; h += 2) {
+		const byte *uRow = frame.uSrc + (h >> 1) * frame.uvPitch;
+		const byte *vRow = frame.vSrc + (h >> 1) * frame.uvPitch;
+
+		// The width is even, so are the spans
+		for (int x = 0; x < frame.yWidth; x += kYUVSpanSize) {
+			const uint count = MIN<int>(kYUVSpanSize, frame.yWidth - x);
+			for (uint i = 0; i < count; i += 2) {
+				const int uvIndex = (x + i) >> 1;
+				setChromaOffsets(rOffset + i, gOffset + i, bOffset + i, frame.colorTab, uRow[uvIndex], vRow[uvIndex]);
+				rOffset[i + 1] = rOffset[i];
+				gOffset[i + 1] = gOffset[i];
+				bOffset[i + 1] = bOffset[i];
+			}
+
+			// Both rows use the same chroma values
+			for (int row = h; row < h + 2; row++) {
+				const byte *aRow = frame.aSrc ? frame.aSrc + row * frame.yPitch + x : nullptr;
+				const YUVSpan span = {
+					frame.dst + row * frame.dstPitch + x * format.bytesPerPixel,
+					frame.ySrc + row * frame.yPitch + x, aRow,
+					rOffset, gOffset, bOffset, count
+				};
+				frame.convertSpan(span, format, ituScale);
+			}
+		}
+	}
+}
+
+static void convertYUV410Spans(const YUVFrame &frame) {
+	const Graphics::PixelFormat format = frame.lookup->getFormat();
+	const bool ituScale = frame.lookup->getScale() == YUVToRGBManager::kScaleITU;
+	const int uvPitch = frame.uvPitch;
+	int16 rOffset[kYUVSpanSize], gOffset[kYUVSpanSize], bOffset[kYUVSpanSize];
+
+	for (int h = 0; h < frame.yHeight; h++) {
+		// Interpolate the chroma values bilinearly like convertYUV410ToRGB()
+		const int yDiff = h & 3;
+		const byte *uRow = frame.uSrc + (h >> 2) * uvPitch;
+		const byte *vRow = frame.vSrc + (h >> 2) * uvPitch;
+
+		for (int x = 0; x < frame.yWidth; x += kYUVSpanSize) {
+			const uint count = MIN<int>(kYUVSpanSize, frame.yWidth - x);
+			for (uint i = 0; i < count; i++) {
+				const int index = (x + i) >> 2;
+				const int xDiff = (x + i) & 3;
+				const int wA = (4 - xDiff) * (4 - yDiff), wB = xDiff * (4 - yDiff);
+				const int wC = yDiff * (4 - xDiff), wD = xDiff * yDiff;
+				const byte u = (uRow[index] * wA + uRow[index + 1] * wB + uRow[index + uvPitch] * wC + uRow[index + uvPitch + 1] * wD) >> 4;
+				const byte v = (vRow[index] * wA + vRow[index + 1] * wB + vRow[index + uvPitch] * wC + vRow[index + uvPitch + 1] * wD) >> 4;
+				setChromaOffsets(rOffset + i, gOffset + i, bOffset + i, frame.colorTab, u, v);
+			}
+
+			const YUVSpan span = {
+				frame.dst + h * frame.dstPitch + x * format.bytesPerPixel,
+				frame.ySrc + h * frame.yPitch + x, nullptr,
+				rOffset, gOffset, bOffset, count
+			};
+			frame.convertSpan(span, format, ituScale);
+		}
+	}
+}
+
 #define PUT_PIXEL(s, d) \
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
 
 template<typename PixelInt>
-void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV444ToRGB(const YUVFrame &frame) {
+	byte *dstPtr = frame.dst;
+	const byte *ySrc = frame.ySrc, *uSrc = frame.uSrc, *vSrc = frame.vSrc;
+	const int dstPitch = frame.dstPitch, yPitch = frame.yPitch, uvPitch = frame.uvPitch;
+	const int yWidth = frame.yWidth, yHeight = frame.yHeight;
 	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_r_tab = frame.colorTab;
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
-	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const uint32 *rgbToPix = frame.lookup->getRGBToPix();
 
 	for (int h = 0; h < yHeight; h++) {
 		for (int w = 0; w < yWidth; w++) {
@@ -243,26 +429,35 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 
-	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	const YUVFrame frame = {
+		(byte *)dst->getPixels(), dst->pitch, getLookup(dst->format, scale), _colorTab,
+		ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, getConvertYUVSpan()
+	};
 
 	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	if (frame.convertSpan)
+		convertYUVFrame(_pool, convertYUV444Spans, frame, 1);
+	else if (dst->format.bytesPerPixel == 2)
+		convertYUVFrame(_pool, convertYUV444ToRGB<uint16>, frame, 1);
 	else
-		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUVFrame(_pool, convertYUV444ToRGB<uint32>, frame, 1);
 }
 
 template<typename PixelInt>
-void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV420ToRGB(const YUVFrame &frame) {
+	byte *dstPtr = frame.dst;
+	const byte *ySrc = frame.ySrc, *uSrc = frame.uSrc, *vSrc = frame.vSrc;
+	const int dstPitch = frame.dstPitch, yPitch = frame.yPitch, uvPitch = frame.uvPitch;
+	const int yWidth = frame.yWidth, yHeight = frame.yHeight;
 	int halfHeight = yHeight >> 1;
 	int halfWidth = yWidth >> 1;
 
 	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_r_tab = frame.colorTab;
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
-	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const uint32 *rgbToPix = frame.lookup->getRGBToPix();
 
 	for (int h = 0; h < halfHeight; h++) {
 		for (int w = 0; w < halfWidth; w++) {
@@ -299,13 +494,18 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
-	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	const YUVFrame frame = {
+		(byte *)dst->getPixels(), dst->pitch, getLookup(dst->format, scale), _colorTab,
+		ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, getConvertYUVSpan()
+	};
 
 	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	if (frame.convertSpan)
+		convertYUVFrame(_pool, convertYUV420Spans, frame, 2);
+	else if (dst->format.bytesPerPixel == 2)
+		convertYUVFrame(_pool, convertYUV420ToRGB<uint16>, frame, 2);
 	else
-		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUVFrame(_pool, convertYUV420ToRGB<uint32>, frame, 2);
 }
 
 #define PUT_PIXELA(s, a, d) \
@@ -313,17 +513,22 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b] | aToPix[a])
 
 template<typename PixelInt>
-void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUVA420ToRGBA(const YUVFrame &frame) {
+	byte *dstPtr = frame.dst;
+	const byte *ySrc = frame.ySrc, *uSrc = frame.uSrc, *vSrc = frame.vSrc;
+	const int dstPitch = frame.dstPitch, yPitch = frame.yPitch, uvPitch = frame.uvPitch;
+	const int yWidth = frame.yWidth, yHeight = frame.yHeight;
+	const byte *aSrc = frame.aSrc;
 	int halfHeight = yHeight >> 1;
 	int halfWidth = yWidth >> 1;
 
 	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_r_tab = frame.colorTab;
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
-	const uint32 *rgbToPix = lookup->getRGBToPix();
-	const uint32 *aToPix = lookup->getAlphaToPix();
+	const uint32 *rgbToPix = frame.lookup->getRGBToPix();
+	const uint32 *aToPix = frame.lookup->getAlphaToPix();
 
 	for (int h = 0; h < halfHeight; h++) {
 		for (int w = 0; w < halfWidth; w++) {
@@ -363,13 +568,18 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
-	const YUVToRGBLookup *lookup = getLookup(dst->format, scale, true);
+	const YUVFrame frame = {
+		(byte *)dst->getPixels(), dst->pitch, getLookup(dst->format, scale, true), _colorTab,
+		ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch, getConvertYUVSpan()
+	};
 
 	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+	if (frame.convertSpan)
+		convertYUVFrame(_pool, convertYUV420Spans, frame, 2);
+	else if (dst->format.bytesPerPixel == 2)
+		convertYUVFrame(_pool, convertYUVA420ToRGBA<uint16>, frame, 2);
 	else
-		convertYUVA420ToRGBA<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUVFrame(_pool, convertYUVA420ToRGBA<uint32>, frame, 2);
 }
 
 #define READ_QUAD(ptr, prefix) \
@@ -397,13 +607,17 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 	xDiff++
 
 template<typename PixelInt>
-void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV410ToRGB(const YUVFrame &frame) {
+	byte *dstPtr = frame.dst;
+	const byte *ySrc = frame.ySrc, *uSrc = frame.uSrc, *vSrc = frame.vSrc;
+	const int dstPitch = frame.dstPitch, yPitch = frame.yPitch, uvPitch = frame.uvPitch;
+	const int yWidth = frame.yWidth, yHeight = frame.yHeight;
 	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_r_tab = frame.colorTab;
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
-	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const uint32 *rgbToPix = frame.lookup->getRGBToPix();
 
 	int quarterWidth = yWidth >> 2;
 
@@ -448,13 +662,61 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 3) == 0);
 	assert((yHeight & 3) == 0);
 
-	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	const YUVFrame frame = {
+		(byte *)dst->getPixels(), dst->pitch, getLookup(dst->format, scale), _colorTab,
+		ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, getConvertYUVSpan()
+	};
 
 	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	if (frame.convertSpan)
+		convertYUVFrame(_pool, convertYUV410Spans, frame, 4);
+	else if (dst->format.bytesPerPixel == 2)
+		convertYUVFrame(_pool, convertYUV410ToRGB<uint16>, frame, 4);
 	else
-		convertYUV410ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUVFrame(_pool, convertYUV410ToRGB<uint32>, frame, 4);
+}
+
+/** Returns the component value the lookup tables hold for a luma plus chroma sum. */
+static inline uint getYUVComponent(int value, bool ituScale) {
+	if (ituScale)
+		return (CLIP(value, 16, 235) - 16) * 255 / 219;
+	return CLIP(value, 0, 255);
+}
+
+void convertYUVSpan_Scalar(const YUVSpan &span, const Graphics::PixelFormat &format, bool ituScale) {
+	for (uint i = 0; i < span.count; i++) {
+		const int y = span.ySrc[i];
+		const byte a = span.aSrc ? span.aSrc[i] : 255;
+		const uint32 color = format.ARGBToColor(a,
+			getYUVComponent(y + span.rOffset[i], ituScale),
+			getYUVComponent(y + span.gOffset[i], ituScale),
+			getYUVComponent(y + span.bOffset[i], ituScale));
+
+		if (format.bytesPerPixel == 2)
+			((uint16 *)span.dst)[i] = color;
+		else
+			((uint32 *)span.dst)[i] = color;
+	}
+}
+
+ConvertYUVSpanProc getConvertYUVSpan() {
+	if (!g_system)
+		return nullptr;
+
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		return convertYUVSpan_AVX2;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return convertYUVSpan_SSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return convertYUVSpan_NEON;
+#endif
+
+	return nullptr;
 }
 
 } // End of namespace Graphics
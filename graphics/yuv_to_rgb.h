@@ -41,6 +41,10 @@
 #include "common/singleton.h"
 #include "graphics/surface.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 namespace Graphics {
 
 class YUVToRGBLookup;
@@ -120,6 +124,16 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Set the number of threads the conversions split their rows across.
+	 *
+	 * The default is taken from the "video_threads" config key, and is one
+	 * thread if it isn't set.
+	 *
+	 * @param numThreads the number of threads, or 0 for one per CPU core
+	 */
+	void setThreadCount(uint numThreads);
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -130,6 +144,7 @@ private:
 	YUVToRGBLookup *_lookup;
 	int16 _colorTab[4 * 256]; // 2048 bytes
 	bool _alphaMode;
+	Common::WorkerPool *_pool;
 };
  /** @} */
 } // End of namespace Graphics
@@ -0,0 +1,111 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <immintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+/** The shift counts of a pixel format, ready for use. */
+struct Packing {
+	__m128i loss[4], shift[4];
+
+	Packing(const PixelFormat &format) {
+		loss[0] = _mm_cvtsi32_si128(format.aLoss);
+		loss[1] = _mm_cvtsi32_si128(format.rLoss);
+		loss[2] = _mm_cvtsi32_si128(format.gLoss);
+		loss[3] = _mm_cvtsi32_si128(format.bLoss);
+		shift[0] = _mm_cvtsi32_si128(format.aShift);
+		shift[1] = _mm_cvtsi32_si128(format.rShift);
+		shift[2] = _mm_cvtsi32_si128(format.gShift);
+		shift[3] = _mm_cvtsi32_si128(format.bShift);
+	}
+};
+
+/** Adds the luma values to the chroma offsets and clamps like the lookup tables. */
+inline __m256i component(__m256i y, const int16 *offset, bool ituScale) {
+	__m256i c = _mm256_add_epi16(y, _mm256_loadu_si256((const __m256i *)offset));
+	if (!ituScale)
+		return _mm256_min_epi16(_mm256_max_epi16(c, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+
+	// (c - 16) * 255 / 219, the division is a multiplication by 2^23 / 219
+	// rounded up, which is exact for the 220 possible values
+	c = _mm256_min_epi16(_mm256_max_epi16(c, _mm256_set1_epi16(16)), _mm256_set1_epi16(235));
+	c = _mm256_mullo_epi16(_mm256_sub_epi16(c, _mm256_set1_epi16(16)), _mm256_set1_epi16(255));
+	return _mm256_srli_epi16(_mm256_mulhi_epu16(c, _mm256_set1_epi16((int16)38305)), 7);
+}
+
+inline __m256i pack16(const __m256i *c, const Packing &packing) {
+	__m256i result = _mm256_setzero_si256();
+	for (int i = 0; i < 4; ++i)
+		result = _mm256_or_si256(result, _mm256_sll_epi16(_mm256_srl_epi16(c[i], packing.loss[i]), packing.shift[i]));
+	return result;
+}
+
+inline __m256i pack32(const __m256i *c, const Packing &packing) {
+	__m256i result = _mm256_setzero_si256();
+	for (int i = 0; i < 4; ++i)
+		result = _mm256_or_si256(result, _mm256_sll_epi32(_mm256_srl_epi32(c[i], packing.loss[i]), packing.shift[i]));
+	return result;
+}
+
+} // End of anonymous namespace
+
+void convertYUVSpan_AVX2(const YUVSpan &span, const PixelFormat &format, bool ituScale) {
+	const Packing packing(format);
+
+	uint i = 0;
+	for (; i + 16 <= span.count; i += 16) {
+		const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(span.ySrc + i)));
+
+		// Alpha, red, green and blue in 16-bit lanes
+		__m256i c[4];
+		c[0] = span.aSrc ? _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(span.aSrc + i))) : _mm256_set1_epi16(255);
+		c[1] = component(y, span.rOffset + i, ituScale);
+		c[2] = component(y, span.gOffset + i, ituScale);
+		c[3] = component(y, span.bOffset + i, ituScale);
+
+		if (format.bytesPerPixel == 2) {
+			_mm256_storeu_si256((__m256i *)(span.dst + i * 2), pack16(c, packing));
+		} else {
+			__m256i lo[4], hi[4];
+			for (int j = 0; j < 4; ++j) {
+				lo[j] = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(c[j]));
+				hi[j] = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(c[j], 1));
+			}
+			_mm256_storeu_si256((__m256i *)(span.dst + i * 4), pack32(lo, packing));
+			_mm256_storeu_si256((__m256i *)(span.dst + i * 4 + 32), pack32(hi, packing));
+		}
+	}
+
+	if (i < span.count) {
+		const YUVSpan tail = {
+			span.dst + i * format.bytesPerPixel, span.ySrc + i, span.aSrc ? span.aSrc + i : nullptr,
+			span.rOffset + i, span.gOffset + i, span.bOffset + i, span.count - i
+		};
+		convertYUVSpan_Scalar(tail, format, ituScale);
+	}
+}
+
+} // End of namespace Graphics
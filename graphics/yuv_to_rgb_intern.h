@@ -0,0 +1,76 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_INTERN_H
+#define GRAPHICS_YUV_TO_RGB_INTERN_H
+
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+
+/**
+ * A run of pixels converted by the YUV span kernels.
+ *
+ * The offsets are the chroma contributions to the red, green and blue
+ * components of every pixel, which are added to the luma value and then
+ * clamped like the lookup tables of YUVToRGBManager do. Without an alpha
+ * source the pixels are opaque.
+ */
+struct YUVSpan {
+	byte *dst;
+	const byte *ySrc;
+	const byte *aSrc;
+	const int16 *rOffset, *gOffset, *bOffset;
+	uint count;
+};
+
+/** The largest number of pixels YUVToRGBManager passes in a span. */
+static const uint kYUVSpanSize = 256;
+
+/**
+ * Converts a span to a 2 or 4 bytes per pixel format, with luminance
+ * values in [16, 235] if ituScale is set and in [0, 255] otherwise.
+ */
+typedef void (*ConvertYUVSpanProc)(const YUVSpan &span, const PixelFormat &format, bool ituScale);
+
+void convertYUVSpan_Scalar(const YUVSpan &span, const PixelFormat &format, bool ituScale);
+
+#ifdef SCUMMVM_SSE2
+void convertYUVSpan_SSE2(const YUVSpan &span, const PixelFormat &format, bool ituScale);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void convertYUVSpan_AVX2(const YUVSpan &span, const PixelFormat &format, bool ituScale);
+#endif
+
+#ifdef SCUMMVM_NEON
+void convertYUVSpan_NEON(const YUVSpan &span, const PixelFormat &format, bool ituScale);
+#endif
+
+/**
+ * Returns the fastest vector span kernel supported by the CPU we are
+ * running on, or nullptr if there is none.
+ */
+ConvertYUVSpanProc getConvertYUVSpan();
+
+} // End of namespace Graphics
+
+#endif
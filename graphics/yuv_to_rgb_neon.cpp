@@ -0,0 +1,114 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <arm_neon.h>
+
+namespace Graphics {
+
+namespace {
+
+/** The shift counts of a pixel format, ready for use. */
+struct Packing {
+	// NEON only shifts left, right shifts use negative counts
+	int loss[4], shift[4];
+
+	Packing(const PixelFormat &format) {
+		loss[0] = -(int)format.aLoss;
+		loss[1] = -(int)format.rLoss;
+		loss[2] = -(int)format.gLoss;
+		loss[3] = -(int)format.bLoss;
+		shift[0] = format.aShift;
+		shift[1] = format.rShift;
+		shift[2] = format.gShift;
+		shift[3] = format.bShift;
+	}
+};
+
+/** Adds the luma values to the chroma offsets and clamps like the lookup tables. */
+inline uint16x8_t component(int16x8_t y, const int16 *offset, bool ituScale) {
+	int16x8_t c = vaddq_s16(y, vld1q_s16(offset));
+	if (!ituScale)
+		return vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(c, vdupq_n_s16(0)), vdupq_n_s16(255)));
+
+	// (c - 16) * 255 / 219, the division is a multiplication by 2^23 / 219
+	// rounded up, which is exact for the 220 possible values
+	c = vminq_s16(vmaxq_s16(c, vdupq_n_s16(16)), vdupq_n_s16(235));
+	const uint16x8_t scaled = vmulq_n_u16(vreinterpretq_u16_s16(vsubq_s16(c, vdupq_n_s16(16))), 255);
+	const uint32x4_t lo = vmull_n_u16(vget_low_u16(scaled), 38305);
+	const uint32x4_t hi = vmull_n_u16(vget_high_u16(scaled), 38305);
+	return vshrq_n_u16(vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16)), 7);
+}
+
+inline uint16x8_t pack16(const uint16x8_t *c, const Packing &packing) {
+	uint16x8_t result = vdupq_n_u16(0);
+	for (int i = 0; i < 4; ++i)
+		result = vorrq_u16(result, vshlq_u16(vshlq_u16(c[i], vdupq_n_s16(packing.loss[i])), vdupq_n_s16(packing.shift[i])));
+	return result;
+}
+
+inline uint32x4_t pack32(const uint32x4_t *c, const Packing &packing) {
+	uint32x4_t result = vdupq_n_u32(0);
+	for (int i = 0; i < 4; ++i)
+		result = vorrq_u32(result, vshlq_u32(vshlq_u32(c[i], vdupq_n_s32(packing.loss[i])), vdupq_n_s32(packing.shift[i])));
+	return result;
+}
+
+} // End of anonymous namespace
+
+void convertYUVSpan_NEON(const YUVSpan &span, const PixelFormat &format, bool ituScale) {
+	const Packing packing(format);
+
+	uint i = 0;
+	for (; i + 8 <= span.count; i += 8) {
+		const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(span.ySrc + i)));
+
+		// Alpha, red, green and blue in 16-bit lanes
+		uint16x8_t c[4];
+		c[0] = span.aSrc ? vmovl_u8(vld1_u8(span.aSrc + i)) : vdupq_n_u16(255);
+		c[1] = component(y, span.rOffset + i, ituScale);
+		c[2] = component(y, span.gOffset + i, ituScale);
+		c[3] = component(y, span.bOffset + i, ituScale);
+
+		if (format.bytesPerPixel == 2) {
+			vst1q_u16((uint16 *)(span.dst + i * 2), pack16(c, packing));
+		} else {
+			uint32x4_t lo[4], hi[4];
+			for (int j = 0; j < 4; ++j) {
+				lo[j] = vmovl_u16(vget_low_u16(c[j]));
+				hi[j] = vmovl_u16(vget_high_u16(c[j]));
+			}
+			vst1q_u32((uint32 *)(span.dst + i * 4), pack32(lo, packing));
+			vst1q_u32((uint32 *)(span.dst + i * 4 + 16), pack32(hi, packing));
+		}
+	}
+
+	if (i < span.count) {
+		const YUVSpan tail = {
+			span.dst + i * format.bytesPerPixel, span.ySrc + i, span.aSrc ? span.aSrc + i : nullptr,
+			span.rOffset + i, span.gOffset + i, span.bOffset + i, span.count - i
+		};
+		convertYUVSpan_Scalar(tail, format, ituScale);
+	}
+}
+
+} // End of namespace Graphics
@@ -887,26 +887,40 @@ bool ThemeEngine::loadThemeXML(const Common::String &themeId) {
 	}
 
 	//
-	// Loop over all STX files, load and parse them
+	// Load all STX files at once, so that a zipped theme can decompress
+	// them in parallel, then parse them
 	//
+	Common::Array<Common::Path> paths;
 	for (Common::ArchiveMemberList::iterator i = members.begin(); i != members.end(); ++i) {
 		assert((*i)->getName().hasSuffix(".stx"));
+		paths.push_back((*i)->getName());
+	}
 
-		if (_parser->loadStream((*i)->createReadStream()) == false) {
-			warning("Failed to load STX file '%s'", (*i)->getName().c_str());
-			_parser->close();
-			return false;
+	Common::Array<Common::SeekableReadStream *> streams;
+	_themeArchive->createReadStreamsForMembers(paths, streams);
+
+	bool success = true;
+	for (uint i = 0; i < paths.size(); ++i) {
+		// The streams of the remaining files are deleted after a failure
+		if (!success) {
+			delete streams[i];
+			continue;
 		}
 
-		if (_parser->parse() == false) {
-			warning("Failed to parse STX file '%s'", (*i)->getName().c_str());
-			_parser->close();
-			return false;
+		if (_parser->loadStream(streams[i]) == false) {
+			warning("Failed to load STX file '%s'", paths[i].toString().c_str());
+			success = false;
+		} else if (_parser->parse() == false) {
+			warning("Failed to parse STX file '%s'", paths[i].toString().c_str());
+			success = false;
 		}
 
 		_parser->close();
 	}
 
+	if (!success)
+		return false;
+
 	assert(!_themeName.empty());
 	return true;
 }
@@ -28,6 +28,7 @@
 #include "common/translation.h"
 
 #include "engines/advancedDetector.h"
+#include "engines/detectionPrefetcher.h"
 
 #include "gui/massadd.h"
 
@@ -69,6 +70,7 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 
 	// The dir we start our scan at
 	_scanStack.push(startDir);
+	_prefetcher.reset(new DetectionPrefetcher(startDir));
 
 	// Removed for now... Why would you put a title on mass add dialog called "Mass Add Dialog"?
 	// new StaticTextWidget(this, "massadddialog_caption", "Mass Add Dialog");
@@ -108,6 +110,9 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	}
 }
 
+MassAddDialog::~MassAddDialog() {
+}
+
 struct GameTargetLess {
 	bool operator()(const DetectedGame &x, const DetectedGame &y) const {
 		return x.preferredTarget.compareToIgnoreCase(y.preferredTarget) < 0;
@@ -154,6 +159,8 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 	} else if (cmd == kCancelCmd) {
 		// User cancelled, so we don't do anything and just leave.
 		_games.clear();
+		_scanStack.clear();
+		_prefetcher.reset();
 		close();
 	} else {
 		Dialog::handleCommand(sender, cmd, data);
@@ -166,9 +173,11 @@ void MassAddDialog::handleTickle() {
 
 	uint32 t = g_system->getMillis();
 
-	// Perform a breadth-first scan of the filesystem.
+	// Perform a depth-first scan of the filesystem, in the order the
+	// prefetcher expects
 	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
 		Common::FSNode dir = _scanStack.pop();
+		_prefetcher->claimDirectory(dir);
 
 		Common::FSList files;
 		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
@@ -230,10 +239,10 @@ void MassAddDialog::handleTickle() {
 		}
 
 
-		// Recurse into all subdirs
-		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			if (file->isDirectory()) {
-				_scanStack.push(*file);
+		// Recurse into all subdirs, backwards so that the first one is scanned first
+		for (int i = (int)files.size() - 1; i >= 0; --i) {
+			if (files[i].isDirectory()) {
+				_scanStack.push(files[i]);
 
 				_dirTotal++;
 			}
@@ -252,6 +261,8 @@ void MassAddDialog::handleTickle() {
 	Common::U32String buf;
 
 	if (_scanStack.empty()) {
+		_prefetcher.reset();
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
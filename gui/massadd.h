@@ -26,9 +26,12 @@
 #include "gui/widgets/list.h"
 #include "common/fs.h"
 #include "common/hashmap.h"
+#include "common/ptr.h"
 #include "common/stack.h"
 #include "common/str.h"
 
+class DetectionPrefetcher;
+
 namespace GUI {
 
 class StaticTextWidget;
@@ -36,6 +39,7 @@ class StaticTextWidget;
 class MassAddDialog : public Dialog {
 public:
 	MassAddDialog(const Common::FSNode &startDir);
+	~MassAddDialog() override;
 
 	//void open();
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
@@ -49,6 +53,7 @@ public:
 
 private:
 	Common::Stack<Common::FSNode>  _scanStack;
+	Common::ScopedPtr<DetectionPrefetcher> _prefetcher;
 	DetectedGames _games;
 
 	/**
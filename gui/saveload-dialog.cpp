@@ -29,6 +29,9 @@
 
 #include "common/translation.h"
 #include "common/config-manager.h"
+#include "common/crc.h"
+#include "common/list.h"
+#include "common/ptr.h"
 
 #include "gui/message.h"
 #include "gui/gui-manager.h"
@@ -815,6 +818,104 @@ enum {
 	kNewSaveCmd = 'SAVE'
 };
 
+enum {
+	// Number of save states kept by SaveStateCache
+	kSaveStateCacheSize = 64,
+	// Time spent loading meta infos per tickle, in milliseconds
+	kMetaInfoLoadTime = 10
+};
+
+/**
+ * Tells whether a save file changed. Compressed save files end with the
+ * CRC of their data or with the index of their blocks, so their end
+ * changes along with their contents. Uncompressed ones often keep their
+ * size, so the modification time is compared as well where the save file
+ * manager knows it.
+ */
+struct SaveFileStamp {
+	int64 size;
+	int64 mtime;
+	uint32 tailCrc;
+
+	bool operator==(const SaveFileStamp &other) const {
+		return size == other.size && mtime == other.mtime && tailCrc == other.tailCrc;
+	}
+};
+
+static bool getSaveFileStamp(const MetaEngine *metaEngine, const Common::String &target, int slot, SaveFileStamp &stamp) {
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	const Common::String filename = metaEngine->getSavegameFile(slot, target.c_str());
+	Common::ScopedPtr<Common::InSaveFile> file(saveFileMan->openRawFile(filename));
+	if (!file)
+		return false;
+
+	stamp.mtime = saveFileMan->getSavefileModificationTime(filename);
+
+	byte tail[64];
+	stamp.size = file->size();
+	const uint32 length = MIN<int64>(stamp.size, sizeof(tail));
+	if (!file->seek(-(int64)length, SEEK_END) || file->read(tail, length) != length)
+		return false;
+	stamp.tailCrc = Common::CRC32().crcFast(tail, length);
+	return true;
+}
+
+/**
+ * The save states loaded by the grid chooser, along with their thumbnails.
+ * They are kept while the dialog is closed, so that they don't have to be
+ * loaded again the next time, unless their save file changed. The least
+ * recently used ones are dropped first.
+ */
+class SaveStateCache {
+public:
+	bool find(const Common::String &target, int slot, const SaveFileStamp &stamp, SaveStateDescriptor &desc) {
+		for (EntryList::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+			if (i->slot != slot || i->target != target)
+				continue;
+			if (!(i->stamp == stamp)) {
+				_entries.erase(i);
+				return false;
+			}
+
+			// Move it to the front
+			_entries.push_front(*i);
+			_entries.erase(i);
+			desc = _entries.front().desc;
+			return true;
+		}
+		return false;
+	}
+
+	void insert(const Common::String &target, int slot, const SaveFileStamp &stamp, const SaveStateDescriptor &desc) {
+		Entry entry;
+		entry.target = target;
+		entry.slot = slot;
+		entry.stamp = stamp;
+		entry.desc = desc;
+		_entries.push_front(entry);
+
+		if (_entries.size() > kSaveStateCacheSize)
+			_entries.pop_back();
+	}
+
+private:
+	struct Entry {
+		Common::String target;
+		int slot;
+		SaveFileStamp stamp;
+		SaveStateDescriptor desc;
+	};
+	typedef Common::List<Entry> EntryList;
+
+	EntryList _entries;
+};
+
+/** Created when first used, rather than with the other globals at startup. */
+static SaveStateCache &getSaveStateCache() {
+	static SaveStateCache cache;
+	return cache;
+}
+
 SaveLoadChooserGrid::SaveLoadChooserGrid(const Common::U32String &title, bool saveMode)
 	: SaveLoadChooserDialog("SaveLoadChooser", saveMode), _lines(0), _columns(0), _entriesPerPage(0),
 	_curPage(0), _newSaveContainer(nullptr), _nextFreeSaveSlot(0), _buttons() {
@@ -899,8 +1000,33 @@ void SaveLoadChooserGrid::handleMouseWheel(int x, int y, int direction) {
 	}
 }
 
+void SaveLoadChooserGrid::handleTickle() {
+	// Load a few meta infos at a time, so that the dialog stays responsive
+	const uint32 start = g_system->getMillis();
+	bool updated = false;
+	while (!_pendingMetaInfos.empty() && g_system->getMillis() - start < kMetaInfoLoadTime) {
+		const uint index = _pendingMetaInfos.front();
+		_pendingMetaInfos.remove_at(0);
+		if (_metaInfoLoaded[index])
+			continue;
+
+		loadMetaInfo(index);
+		if (index >= _curPage * _entriesPerPage && index < (_curPage + 1) * _entriesPerPage) {
+			updateSlotButton(index);
+			updated = true;
+		}
+	}
+
+	// Setting the thumbnails doesn't mark the buttons dirty
+	if (updated)
+		g_gui.scheduleTopDialogRedraw();
+
+	SaveLoadChooserDialog::handleTickle();
+}
+
 void SaveLoadChooserGrid::updateSaveList() {
 	SaveLoadChooserDialog::updateSaveList();
+	_metaInfoLoaded.clear();
 	updateSaves();
 	g_gui.scheduleTopDialogRedraw();
 }
@@ -962,6 +1088,7 @@ void SaveLoadChooserGrid::open() {
 		}
 	}
 
+	_metaInfoLoaded.clear();
 	updateSaves();
 }
 
@@ -1148,58 +1275,22 @@ void SaveLoadChooserGrid::hideButtons() {
 void SaveLoadChooserGrid::updateSaves() {
 	hideButtons();
 
-	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
-		const uint saveSlot = _saveList[i].getSaveSlot();
-
-		SaveStateDescriptor desc =  (_saveList[i].getLocked() ? _saveList[i] : _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot));
-		if (!_saveList[i].getLocked() && desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
-			_saveList[i] = desc;
-		SlotButton &curButton = _buttons[curNum];
-		curButton.setVisible(true);
-		const Graphics::Surface *thumbnail = desc.getThumbnail();
-		if (thumbnail) {
-			curButton.button->setGfx(desc.getThumbnail());
-		} else {
-			curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
-		}
-		curButton.description->setLabel(Common::U32String(Common::String::format("%d. ", saveSlot)) + desc.getDescription());
-
-		Common::U32String tooltip(_("Name: "));
-		tooltip += desc.getDescription();
-
-		if (_saveDateSupport) {
-			const Common::U32String &saveDate = desc.getSaveDate();
-			if (!saveDate.empty()) {
-				tooltip += Common::U32String("\n");
-				tooltip +=  _("Date: ") + saveDate;
-			}
-
-			const Common::U32String &saveTime = desc.getSaveTime();
-			if (!saveTime.empty()) {
-				tooltip += Common::U32String("\n");
-				tooltip += _("Time: ") + saveTime;
-			}
-		}
-
-		if (_playTimeSupport) {
-			const Common::U32String &playTime = desc.getPlayTime();
-			if (!playTime.empty()) {
-				tooltip += Common::U32String("\n");
-				tooltip += _("Playtime: ") + playTime;
-			}
-		}
-
-		curButton.button->setTooltip(tooltip);
+	// The entries show placeholders until handleTickle() loads them. Even
+	// the cached ones are only checked there, since that opens their save
+	// file as well.
+	_metaInfoLoaded.resize(_saveList.size());
+	_pendingMetaInfos.clear();
+	const uint first = _curPage * _entriesPerPage;
+	for (uint i = first; i < _saveList.size() && i < first + _entriesPerPage; ++i) {
+		if (!_metaInfoLoaded[i])
+			_pendingMetaInfos.push_back(i);
+		updateSlotButton(i);
+	}
 
-		// In save mode we disable the button, when it's write protected.
-		// TODO: Maybe we should not display it at all then?
-		// We also disable and description the button if slot is locked
-		if ((_saveMode && desc.getWriteProtectedFlag()) || desc.getLocked()) {
-			curButton.button->setEnabled(false);
-		} else {
-			curButton.button->setEnabled(true);
-		}
-		curButton.description->setEnabled(!desc.getLocked());
+	// Followed by the next page, which the user is likely to turn to
+	for (uint i = first + _entriesPerPage; i < _saveList.size() && i < first + 2 * _entriesPerPage; ++i) {
+		if (!_metaInfoLoaded[i])
+			_pendingMetaInfos.push_back(i);
 	}
 
 	const uint numPages = (_entriesPerPage != 0 && !_saveList.empty()) ? ((_saveList.size() + _entriesPerPage - 1) / _entriesPerPage) : 1;
@@ -1216,6 +1307,76 @@ void SaveLoadChooserGrid::updateSaves() {
 		_nextButton->setEnabled(false);
 }
 
+void SaveLoadChooserGrid::updateSlotButton(uint index) {
+	const SaveStateDescriptor &desc = _saveList[index];
+	SlotButton &curButton = _buttons[index - _curPage * _entriesPerPage];
+	curButton.setVisible(true);
+	const Graphics::Surface *thumbnail = desc.getThumbnail();
+	if (thumbnail) {
+		curButton.button->setGfx(thumbnail);
+	} else {
+		curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
+	}
+	curButton.description->setLabel(Common::U32String(Common::String::format("%d. ", desc.getSaveSlot())) + desc.getDescription());
+
+	Common::U32String tooltip(_("Name: "));
+	tooltip += desc.getDescription();
+
+	if (_saveDateSupport) {
+		const Common::U32String &saveDate = desc.getSaveDate();
+		if (!saveDate.empty()) {
+			tooltip += Common::U32String("\n");
+			tooltip +=  _("Date: ") + saveDate;
+		}
+
+		const Common::U32String &saveTime = desc.getSaveTime();
+		if (!saveTime.empty()) {
+			tooltip += Common::U32String("\n");
+			tooltip += _("Time: ") + saveTime;
+		}
+	}
+
+	if (_playTimeSupport) {
+		const Common::U32String &playTime = desc.getPlayTime();
+		if (!playTime.empty()) {
+			tooltip += Common::U32String("\n");
+			tooltip += _("Playtime: ") + playTime;
+		}
+	}
+
+	curButton.button->setTooltip(tooltip);
+
+	// In save mode we disable the button, when it's write protected.
+	// TODO: Maybe we should not display it at all then?
+	// We also disable and description the button if slot is locked
+	if ((_saveMode && desc.getWriteProtectedFlag()) || desc.getLocked()) {
+		curButton.button->setEnabled(false);
+	} else {
+		curButton.button->setEnabled(true);
+	}
+	curButton.description->setEnabled(!desc.getLocked());
+}
+
+void SaveLoadChooserGrid::loadMetaInfo(uint index) {
+	_metaInfoLoaded[index] = true;
+	if (_saveList[index].getLocked())
+		return;
+
+	const int slot = _saveList[index].getSaveSlot();
+	SaveFileStamp stamp;
+	const bool hasStamp = getSaveFileStamp(_metaEngine, _target, slot, stamp);
+	SaveStateCache &cache = getSaveStateCache();
+	SaveStateDescriptor desc;
+	if (!hasStamp || !cache.find(_target, slot, stamp, desc)) {
+		desc = _metaEngine->querySaveMetaInfos(_target.c_str(), slot);
+		if (hasStamp)
+			cache.insert(_target, slot, stamp, desc);
+	}
+
+	if (desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
+		_saveList[index] = desc;
+}
+
 SavenameDialog::SavenameDialog()
 	: Dialog("SavenameDialog") {
 	_title = new StaticTextWidget(this, "SavenameDialog.DescriptionText", Common::String());
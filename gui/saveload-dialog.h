@@ -219,6 +219,7 @@ public:
 protected:
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
 	void handleMouseWheel(int x, int y, int direction) override;
+	void handleTickle() override;
 	void updateSaveList() override;
 private:
 	int runIntern() override;
@@ -256,6 +257,18 @@ private:
 	void destroyButtons();
 	void hideButtons();
 	void updateSaves();
+	void updateSlotButton(uint index);
+
+	/** Whether the meta info of each entry of _saveList has been loaded. */
+	Common::Array<bool> _metaInfoLoaded;
+	/** Entries of _saveList whose meta info handleTickle() loads, visible ones first. */
+	Common::Array<uint> _pendingMetaInfos;
+
+	/**
+	 * Loads the meta info of an entry of _saveList, from the cache of the
+	 * previously loaded ones if its save file didn't change.
+	 */
+	void loadMetaInfo(uint index);
 };
 
 #endif // !DISABLE_SAVELOADCHOOSER_GRID
@@ -0,0 +1,209 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate_intern.h"
+#include "../test_helper.h"
+
+/** A stereo stream with a constant value in each channel. */
+class ConstantAudioStream : public Audio::AudioStream {
+	const int16 _left, _right;
+	const int _rate;
+public:
+	ConstantAudioStream(int16 left, int16 right, int rate) : _left(left), _right(right), _rate(rate) {}
+
+	int readBuffer(int16 *buffer, const int numSamples) override {
+		for (int i = 0; i < numSamples; i += 2) {
+			buffer[i] = _left;
+			buffer[i + 1] = _right;
+		}
+		return numSamples;
+	}
+	bool isStereo() const override { return true; }
+	int getRate() const override { return _rate; }
+	bool endOfData() const override { return false; }
+};
+
+/** A stereo stream with the same sine tone in both channels. */
+class SineAudioStream : public Audio::AudioStream {
+	const double _step;
+	const int _rate;
+	const int16 _amplitude;
+	double _phase;
+public:
+	SineAudioStream(double frequency, int16 amplitude, int rate) : _step(2.0 * M_PI * frequency / rate), _rate(rate), _amplitude(amplitude), _phase(0.0) {}
+
+	int readBuffer(int16 *buffer, const int numSamples) override {
+		for (int i = 0; i < numSamples; i += 2) {
+			buffer[i] = buffer[i + 1] = (int16)(_amplitude * sin(_phase));
+			_phase += _step;
+		}
+		return numSamples;
+	}
+	bool isStereo() const override { return true; }
+	int getRate() const override { return _rate; }
+	bool endOfData() const override { return false; }
+};
+
+/*
+ * The vector kernels used by the rate converters have to produce the
+ * exact same output as the scalar reference implementation.
+ */
+class RateTestSuite : public CxxTest::TestSuite {
+	// Odd sizes, so the scalar tail handling is exercised as well
+	static const int kFrames = 1027;
+
+	int16 _in[kFrames * 2];
+	int16 _out[kFrames * 2];
+	uint16 _frac[kFrames];
+	TestRandom _random;
+
+	int16 nextSample() {
+		const uint32 state = _random.nextState();
+		switch ((state >> 8) & 15) {
+		case 0:
+			return -32768;
+		case 1:
+			return 32767;
+		default:
+			return (int16)(state >> 16);
+		}
+	}
+
+	void fill() {
+		for (int i = 0; i < kFrames * 2; ++i) {
+			_in[i] = nextSample();
+			_out[i] = nextSample();
+		}
+		for (int i = 0; i < kFrames; ++i)
+			_frac[i] = (uint16)nextSample() & 0x7FFF;
+		_frac[0] = 0;
+		_frac[1] = 0x7FFF;
+	}
+
+	void checkMixStereo(Audio::MixStereoProc proc) {
+		static const Audio::st_volume_t volumes[] = { 0, 1, 127, 255, 256 };
+
+		_random.setSeed(1);
+		for (uint a = 0; a < ARRAYSIZE(volumes); ++a) {
+			for (uint b = 0; b < ARRAYSIZE(volumes); ++b) {
+				fill();
+
+				int16 expected[kFrames * 2];
+				memcpy(expected, _out, sizeof(_out));
+				Audio::mixStereo_Scalar(expected, _in, kFrames, volumes[a], volumes[b]);
+				proc(_out, _in, kFrames, volumes[a], volumes[b]);
+
+				TS_ASSERT_SAME_DATA(expected, _out, sizeof(_out));
+			}
+		}
+	}
+
+	void checkInterpolate(Audio::InterpolateProc proc) {
+		_random.setSeed(2);
+		fill();
+
+		int16 expected[kFrames];
+		Audio::interpolate_Scalar(expected, _in, _frac, kFrames);
+		proc(_out, _in, _frac, kFrames);
+
+		TS_ASSERT_SAME_DATA(expected, _out, sizeof(expected));
+	}
+
+	void checkFIRUnityGain(Audio::st_rate_t inRate, Audio::st_rate_t outRate) {
+		static const Audio::ResamplerQuality qualities[] = {
+			Audio::kResamplerFIRFast, Audio::kResamplerFIRBalanced, Audio::kResamplerFIRBest
+		};
+
+		for (uint q = 0; q < ARRAYSIZE(qualities); ++q) {
+			ConstantAudioStream stream(12345, -23456, inRate);
+			Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, true, true, false, qualities[q]);
+
+			memset(_out, 0, sizeof(_out));
+			TS_ASSERT_EQUALS(converter->flow(stream, _out, kFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), kFrames);
+
+			// Once the filter window is filled, DC has to pass unchanged
+			for (int i = kFrames / 2; i < kFrames; ++i) {
+				TS_ASSERT_EQUALS(_out[i * 2], 12345);
+				TS_ASSERT_EQUALS(_out[i * 2 + 1], -23456);
+			}
+
+			delete converter;
+		}
+	}
+
+	/** Returns the output level of a tone relative to its input level, in dB. */
+	double getToneGain(Audio::ResamplerQuality quality, double frequency, Audio::st_rate_t inRate, Audio::st_rate_t outRate) {
+		const int16 amplitude = 16000;
+		SineAudioStream stream(frequency, amplitude, inRate);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, true, true, false, quality);
+
+		memset(_out, 0, sizeof(_out));
+		TS_ASSERT_EQUALS(converter->flow(stream, _out, kFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), kFrames);
+		delete converter;
+
+		// Skip the samples before the filter window is filled
+		double sum = 0.0;
+		for (int i = kFrames / 2; i < kFrames; ++i)
+			sum += (double)_out[i * 2] * _out[i * 2];
+		const double rms = sqrt(sum / (kFrames - kFrames / 2));
+		return 20.0 * log10(MAX(rms, 1.0) / (amplitude / M_SQRT2));
+	}
+
+public:
+	void test_fir_upsample() {
+		checkFIRUnityGain(11025, 48000);
+		checkFIRUnityGain(22050, 44100);
+	}
+
+	void test_fir_downsample() {
+		checkFIRUnityGain(48000, 22050);
+	}
+
+	void test_fir_frequency_response() {
+		static const Audio::ResamplerQuality qualities[] = {
+			Audio::kResamplerFIRFast, Audio::kResamplerFIRBalanced, Audio::kResamplerFIRBest
+		};
+
+		for (uint q = 0; q < ARRAYSIZE(qualities); ++q) {
+			// Tones well below the output Nyquist frequency pass
+			const double passGain = getToneGain(qualities[q], 1000.0, 48000, 22050);
+			TS_ASSERT_LESS_THAN(-1.0, passGain);
+			TS_ASSERT_LESS_THAN(passGain, 1.0);
+
+			// Tones above it are filtered out instead of aliasing
+			TS_ASSERT_LESS_THAN(getToneGain(qualities[q], 16000.0, 48000, 22050), -40.0);
+			TS_ASSERT_LESS_THAN(getToneGain(qualities[q], 20000.0, 44100, 11025), -40.0);
+		}
+
+		// Linear interpolation does not filter
+		TS_ASSERT_LESS_THAN(-40.0, getToneGain(Audio::kResamplerLinear, 16000.0, 48000, 22050));
+	}
+
+	void test_sse2() {
+#ifdef SCUMMVM_SSE2
+		if (hasCpuFeature(OSystem::kFeatureCpuSSE2)) {
+			checkMixStereo(Audio::mixStereo_SSE2);
+			checkInterpolate(Audio::interpolate_SSE2);
+		}
+#endif
+	}
+
+	void test_avx2() {
+#ifdef SCUMMVM_AVX2
+		if (hasCpuFeature(OSystem::kFeatureCpuAVX2)) {
+			checkMixStereo(Audio::mixStereo_AVX2);
+			checkInterpolate(Audio::interpolate_AVX2);
+		}
+#endif
+	}
+
+	void test_neon() {
+#ifdef SCUMMVM_NEON
+		if (hasCpuFeature(OSystem::kFeatureCpuNEON)) {
+			checkMixStereo(Audio::mixStereo_NEON);
+			checkInterpolate(Audio::interpolate_NEON);
+		}
+#endif
+	}
+};
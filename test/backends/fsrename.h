@@ -0,0 +1,91 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+#include "../test_helper.h"
+
+#if defined(POSIX) && NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_FS_RENAME 1
+#include "common/ptr.h"
+#include "common/stream.h"
+#else
+#define TEST_FS_RENAME 0
+#endif
+
+/*
+ * Caches and saves are updated by writing a temporary file and renaming it
+ * over the old one, which has to be replaced.
+ */
+class FSRenameTestSuite : public CxxTest::TestSuite {
+#if TEST_FS_RENAME
+	Common::FSNode _dir;
+
+	void writeFile(const Common::FSNode &node, const char *contents) {
+		Common::ScopedPtr<Common::SeekableWriteStream> file(node.createWriteStream());
+		TS_ASSERT(file);
+		if (file) {
+			file->writeString(contents);
+			file->finalize();
+		}
+	}
+
+	Common::String readFile(const Common::FSNode &node) {
+		Common::ScopedPtr<Common::SeekableReadStream> file(node.createReadStream());
+		if (!file)
+			return Common::String();
+		return file->readString(0, file->size());
+	}
+
+	void removeFile(const Common::FSNode &node) {
+		remove(node.getPath().c_str());
+	}
+#endif
+
+public:
+	void setUp() {
+#if TEST_FS_RENAME
+		_dir = getTestDirectory();
+#endif
+	}
+
+	void test_rename_to_new_file() {
+#if TEST_FS_RENAME
+		const Common::FSNode source = _dir.getChild("rename-source");
+		const Common::FSNode target = _dir.getChild("rename-target");
+		writeFile(source, "contents");
+
+		TS_ASSERT(source.renameTo(target));
+		TS_ASSERT(!Common::FSNode(source.getPath()).exists());
+		TS_ASSERT_EQUALS(readFile(target), "contents");
+
+		removeFile(target);
+#endif
+	}
+
+	void test_rename_replaces_file() {
+#if TEST_FS_RENAME
+		const Common::FSNode source = _dir.getChild("rename-source");
+		const Common::FSNode target = _dir.getChild("rename-target");
+		writeFile(target, "old contents");
+		writeFile(source, "new contents");
+
+		TS_ASSERT(source.renameTo(target));
+		TS_ASSERT(!Common::FSNode(source.getPath()).exists());
+		TS_ASSERT_EQUALS(readFile(target), "new contents");
+
+		removeFile(target);
+#endif
+	}
+
+	void test_rename_missing_file() {
+#if TEST_FS_RENAME
+		const Common::FSNode source = _dir.getChild("rename-missing");
+		const Common::FSNode target = _dir.getChild("rename-target");
+		writeFile(target, "contents");
+
+		TS_ASSERT(!source.renameTo(target));
+		TS_ASSERT_EQUALS(readFile(target), "contents");
+
+		removeFile(target);
+#endif
+	}
+};
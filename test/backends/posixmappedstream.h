@@ -0,0 +1,135 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+#include "../test_helper.h"
+
+#if defined(POSIX) && defined(HAS_MMAP) && NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_MAPPED_STREAMS 1
+#include "backends/fs/posix/posix-iostream.h"
+#include "common/array.h"
+#include "common/ptr.h"
+#else
+#define TEST_MAPPED_STREAMS 0
+#endif
+
+/*
+ * Large game data files are mapped into memory, and have to read the same
+ * as the small ones read through stdio.
+ */
+class PosixMappedStreamTestSuite : public CxxTest::TestSuite {
+#if TEST_MAPPED_STREAMS
+	Common::FSNode _dir;
+	TestRandom _random;
+
+	Common::FSNode createFile(const Common::String &name, Common::Array<byte> &data, uint32 size) {
+		_random.setSeed(1);
+		data.resize(size);
+		for (uint32 i = 0; i < size; ++i)
+			data[i] = (byte)_random.nextUint32();
+
+		Common::FSNode node = _dir.getChild(name);
+		Common::ScopedPtr<Common::SeekableWriteStream> file(node.createWriteStream());
+		TS_ASSERT(file);
+		if (file) {
+			file->write(data.data(), size);
+			file->finalize();
+		}
+		return node;
+	}
+
+	void removeFile(const Common::FSNode &node) {
+		remove(node.getPath().c_str());
+	}
+
+	/** Reads at a few positions, also past the end of the file. */
+	void checkSeekAndRead(Common::SeekableReadStream &stream, const Common::Array<byte> &data) {
+		const int64 size = data.size();
+		TS_ASSERT_EQUALS(stream.size(), size);
+
+		byte buffer[4096];
+		const int64 positions[] = { 0, 1, size / 2, size - 4096, size - 1 };
+		for (uint i = 0; i < ARRAYSIZE(positions); ++i) {
+			TS_ASSERT(stream.seek(positions[i]));
+			TS_ASSERT_EQUALS(stream.pos(), positions[i]);
+
+			const uint32 expected = (uint32)MIN<int64>(sizeof(buffer), size - positions[i]);
+			TS_ASSERT_EQUALS(stream.read(buffer, sizeof(buffer)), expected);
+			TS_ASSERT_SAME_DATA(buffer, &data[positions[i]], expected);
+			TS_ASSERT_EQUALS(stream.pos(), positions[i] + expected);
+		}
+
+		TS_ASSERT(stream.seek(-16, SEEK_END));
+		TS_ASSERT_EQUALS(stream.read(buffer, sizeof(buffer)), 16U);
+		TS_ASSERT_SAME_DATA(buffer, &data[size - 16], 16);
+		TS_ASSERT(stream.eos());
+	}
+#endif
+
+public:
+	void setUp() {
+#if TEST_MAPPED_STREAMS
+		_dir = getTestDirectory();
+#endif
+	}
+
+	void test_mapped_file() {
+#if TEST_MAPPED_STREAMS
+		Common::Array<byte> data;
+		Common::FSNode node = createFile("mapped.dat", data, PosixMappedReadStream::kMinMappedSize + 12345);
+
+		// Game data is read through FSDirectory
+		Common::FSDirectory dir(_dir);
+		Common::ScopedPtr<Common::SeekableReadStream> stream(dir.createReadStreamForMember("mapped.dat"));
+		TS_ASSERT(stream);
+		if (stream) {
+			const byte *view = stream->getMemoryView();
+			TS_ASSERT(view);
+			if (view)
+				TS_ASSERT_SAME_DATA(view, data.data(), data.size());
+			checkSeekAndRead(*stream, data);
+		}
+
+		stream.reset();
+		removeFile(node);
+#endif
+	}
+
+	void test_small_file() {
+#if TEST_MAPPED_STREAMS
+		Common::Array<byte> data;
+		Common::FSNode node = createFile("small.dat", data, PosixMappedReadStream::kMinMappedSize - 1);
+
+		// Read through stdio instead
+		TS_ASSERT(!Common::ScopedPtr<Common::SeekableReadStream>(node.createMappedReadStream()));
+		Common::FSDirectory dir(_dir);
+		Common::ScopedPtr<Common::SeekableReadStream> stream(dir.createReadStreamForMember("small.dat"));
+		TS_ASSERT(stream);
+		if (stream) {
+			TS_ASSERT(!stream->getMemoryView());
+			checkSeekAndRead(*stream, data);
+		}
+
+		stream.reset();
+		removeFile(node);
+#endif
+	}
+
+	void test_unmapped_file() {
+#if TEST_MAPPED_STREAMS
+		Common::Array<byte> data;
+		Common::FSNode node = createFile("unmapped.dat", data, PosixMappedReadStream::kMinMappedSize + 12345);
+
+		// Files which may be written, like saves, are opened through FSNode
+		// and read through stdio
+		Common::ScopedPtr<Common::SeekableReadStream> stream(node.createReadStream());
+		TS_ASSERT(stream);
+		if (stream) {
+			TS_ASSERT(!stream->getMemoryView());
+			checkSeekAndRead(*stream, data);
+		}
+
+		stream.reset();
+		removeFile(node);
+#endif
+	}
+};
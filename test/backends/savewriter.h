@@ -0,0 +1,165 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+#include "../test_helper.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#include "backends/saves/default/save-writer.h"
+#include "common/compression/zlib.h"
+#include "common/ptr.h"
+#endif
+
+/*
+ * The save files written in the background have to end up on disk in the
+ * order they were queued, and a failed write must not leave anything
+ * behind.
+ */
+class SaveWriterTestSuite : public CxxTest::TestSuite {
+#if NULL_OSYSTEM_IS_AVAILABLE
+	Common::FSNode _dir;
+
+	SaveFileWriter::PendingSave *createSave(const Common::String &name, const Common::String &contents, bool compress) {
+		SaveFileWriter::PendingSave *save = new SaveFileWriter::PendingSave();
+		save->name = name;
+		save->path = _dir.getChild(name).getPath();
+		save->size = contents.size();
+		save->data = (byte *)malloc(save->size);
+		memcpy(save->data, contents.c_str(), save->size);
+		save->compress = compress;
+		save->blockCompress = false;
+		save->proc = nullptr;
+		save->procData = nullptr;
+		save->success = false;
+		return save;
+	}
+
+	Common::String readFile(const Common::String &name) {
+		Common::SeekableReadStream *stream = _dir.getChild(name).createReadStream();
+		if (!stream)
+			return Common::String();
+		Common::ScopedPtr<Common::SeekableReadStream> file(Common::wrapCompressedReadStream(stream));
+		if (!file)
+			return Common::String();
+		return file->readString(0, file->size());
+	}
+
+	void removeFile(const Common::String &name) {
+		remove(_dir.getChild(name).getPath().c_str());
+	}
+
+	/**
+	 * Takes the written saves, checks their names and results, and deletes
+	 * them. Without names, all of them have to be successful.
+	 */
+	void checkWrittenSaves(SaveFileWriter &writer, const char *const *names, const bool *success, uint count) {
+		Common::List<SaveFileWriter::PendingSave *> saves;
+		writer.takeWrittenSaves(saves);
+		TS_ASSERT_EQUALS(saves.size(), count);
+
+		uint i = 0;
+		for (Common::List<SaveFileWriter::PendingSave *>::iterator it = saves.begin(); it != saves.end(); ++it, ++i) {
+			if (names && i < count) {
+				TS_ASSERT_EQUALS((*it)->name, names[i]);
+				TS_ASSERT_EQUALS((*it)->success, success[i]);
+			} else {
+				TS_ASSERT((*it)->success);
+			}
+			TS_ASSERT(!(*it)->data);
+			delete *it;
+		}
+	}
+#endif
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		_dir = getTestDirectory();
+#endif
+	}
+
+	void test_queued_saves() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		SaveFileWriter writer;
+		writer.queueSave(createSave("writer1.sav", "first save", false));
+		writer.queueSave(createSave("writer2.sav", "second save", true));
+		writer.waitForPendingSaves();
+
+		static const char *const names[] = { "writer1.sav", "writer2.sav" };
+		static const bool success[] = { true, true };
+		checkWrittenSaves(writer, names, success, ARRAYSIZE(names));
+
+		TS_ASSERT_EQUALS(readFile("writer1.sav"), "first save");
+		TS_ASSERT_EQUALS(readFile("writer2.sav"), "second save");
+		TS_ASSERT(!_dir.getChild("writer1.sav.tmp").exists());
+		TS_ASSERT(!_dir.getChild("writer2.sav.tmp").exists());
+
+		// Nothing is reported twice
+		checkWrittenSaves(writer, nullptr, nullptr, 0);
+
+		removeFile("writer1.sav");
+		removeFile("writer2.sav");
+#endif
+	}
+
+	void test_replace_in_order() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		SaveFileWriter writer;
+		writer.queueSave(createSave("writer3.sav", "old", true));
+		writer.waitForPendingSaves();
+		checkWrittenSaves(writer, nullptr, nullptr, 1);
+		TS_ASSERT_EQUALS(readFile("writer3.sav"), "old");
+
+		// The last one queued replaces the previous ones
+		for (int i = 0; i < 8; ++i)
+			writer.queueSave(createSave("writer3.sav", Common::String::format("save %d", i), (i % 2) == 0));
+		writer.waitForPendingSaves();
+		checkWrittenSaves(writer, nullptr, nullptr, 8);
+
+		TS_ASSERT_EQUALS(readFile("writer3.sav"), "save 7");
+		TS_ASSERT(!_dir.getChild("writer3.sav.tmp").exists());
+
+		removeFile("writer3.sav");
+#endif
+	}
+
+	void test_destructor_writes_queued_saves() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		{
+			SaveFileWriter writer;
+			writer.queueSave(createSave("writer4.sav", "written on exit", false));
+		}
+
+		TS_ASSERT_EQUALS(readFile("writer4.sav"), "written on exit");
+		removeFile("writer4.sav");
+#endif
+	}
+
+	void test_failed_saves() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		SaveFileWriter writer;
+
+		// The temporary file can't be created in a missing directory
+		SaveFileWriter::PendingSave *save = createSave("writer5.sav", "lost", false);
+		save->path = _dir.getChild("missing").getPath() + "/writer5.sav";
+		writer.queueSave(save);
+
+		// A directory can't be replaced by the temporary file
+		_dir.getChild("writer6.sav").createDirectory();
+		writer.queueSave(createSave("writer6.sav", "lost", false));
+
+		writer.queueSave(createSave("writer7.sav", "kept", false));
+		writer.waitForPendingSaves();
+
+		static const char *const names[] = { "writer5.sav", "writer6.sav", "writer7.sav" };
+		static const bool success[] = { false, false, true };
+		checkWrittenSaves(writer, names, success, ARRAYSIZE(names));
+
+		TS_ASSERT(_dir.getChild("writer6.sav").isDirectory());
+		TS_ASSERT(!_dir.getChild("writer6.sav.tmp").exists());
+		TS_ASSERT_EQUALS(readFile("writer7.sav"), "kept");
+
+		removeFile("writer6.sav");
+		removeFile("writer7.sav");
+#endif
+	}
+};
@@ -0,0 +1,76 @@
+// The results are written to stdout
+#define FORBIDDEN_SYMBOL_EXCEPTION_printf
+
+#include "benchmark.h"
+
+namespace Benchmark {
+
+void runGZip();
+void runMD5();
+void runMT32();
+void runOPL();
+void runRate();
+void runTinyGL();
+void runYUV();
+
+void report(const char *group, const char *name, double value, const char *unit) {
+	printf("%-8s %-40s %12.2f %s\n", group, name, value, unit);
+}
+
+void skip(const char *group, const char *name, const char *reason) {
+	printf("%-8s %-40s %12s (%s)\n", group, name, "skipped", reason);
+}
+
+} // End of namespace Benchmark
+
+struct BenchmarkGroup {
+	const char *name;
+	const char *description;
+	void (*run)();
+};
+
+static const BenchmarkGroup benchmarkGroups[] = {
+	{ "gzip", "Random seeks in gzip streams, without and with checkpoints", Benchmark::runGZip },
+	{ "md5", "MD5 block transforms per kernel, and hashing several streams", Benchmark::runMD5 },
+	{ "mt32", "MT-32 emulation speed, with the ROMs in the working directory", Benchmark::runMT32 },
+	{ "opl", "OPL emulators, in samples per second", Benchmark::runOPL },
+	{ "rate", "Audio rate converters, per output sample", Benchmark::runRate },
+	{ "tinygl", "TinyGL triangle fills per span kernel, and frames serial and tiled", Benchmark::runTinyGL },
+	{ "yuv", "YUV to RGB conversions per span kernel, and video frames", Benchmark::runYUV }
+};
+
+int main(int argc, char *argv[]) {
+	if (argc > 1 && !strcmp(argv[1], "--list")) {
+		for (uint i = 0; i < ARRAYSIZE(benchmarkGroups); ++i)
+			printf("%-8s %s\n", benchmarkGroups[i].name, benchmarkGroups[i].description);
+		return 0;
+	}
+
+	if (!installTestSystem()) {
+		printf("No OSystem is available on this platform\n");
+		return 1;
+	}
+
+	// Without arguments, all the groups are run
+	int found = 0;
+	for (int arg = 1; arg < argc; ++arg) {
+		bool known = false;
+		for (uint i = 0; i < ARRAYSIZE(benchmarkGroups); ++i)
+			known |= !strcmp(argv[arg], benchmarkGroups[i].name);
+		if (!known) {
+			printf("Unknown benchmark group '%s', see --list\n", argv[arg]);
+			return 1;
+		}
+		++found;
+	}
+
+	for (uint i = 0; i < ARRAYSIZE(benchmarkGroups); ++i) {
+		bool selected = !found;
+		for (int arg = 1; arg < argc; ++arg)
+			selected |= !strcmp(argv[arg], benchmarkGroups[i].name);
+		if (selected)
+			benchmarkGroups[i].run();
+	}
+
+	return 0;
+}
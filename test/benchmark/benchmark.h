@@ -0,0 +1,44 @@
+#ifndef TEST_BENCHMARK_BENCHMARK_H
+#define TEST_BENCHMARK_BENCHMARK_H
+
+#include "common/scummsys.h"
+#include "common/system.h"
+
+#include "../test_helper.h"
+
+namespace Benchmark {
+
+enum {
+	/** The minimum time spent measuring each benchmark, in milliseconds. */
+	kMinMillis = 250
+};
+
+/**
+ * Calls @p proc repeatedly for at least kMinMillis, after one call which
+ * is not timed, and returns the average time of a call in nanoseconds.
+ */
+template<typename T>
+double timeCalls(T proc) {
+	proc();
+
+	uint32 calls = 0;
+	uint32 elapsed;
+	const uint32 start = g_system->getMillis();
+	do {
+		proc();
+		++calls;
+		elapsed = g_system->getMillis() - start;
+	} while (elapsed < kMinMillis);
+
+	return elapsed * 1000000.0 / calls;
+}
+
+/** Prints the result of a benchmark, in the given unit. */
+void report(const char *group, const char *name, double value, const char *unit);
+
+/** Prints why a benchmark was not run. */
+void skip(const char *group, const char *name, const char *reason);
+
+} // End of namespace Benchmark
+
+#endif
@@ -0,0 +1,82 @@
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/compression/zlib.h"
+
+#include "benchmark.h"
+
+namespace Benchmark {
+
+#ifdef USE_ZLIB
+
+/**
+ * Times seeking to random positions of a gzip stream and reading a little
+ * there. Fresh streams have to decompress everything up to the position,
+ * like before GZipReadStream had checkpoints; a stream which was read once
+ * resumes from the closest checkpoint.
+ */
+void runGZip() {
+	enum { kSize = 16 * 1024 * 1024, kSeeks = 16 };
+
+	TestRandom random;
+	byte *data = new byte[kSize];
+	// Compressible, but not so much that inflating is only copying
+	for (uint32 i = 0; i < kSize; ) {
+		const byte value = 'a' + random.nextUint32() % 16;
+		for (uint32 run = 1 + random.nextUint32() % 5; run > 0 && i < kSize; --run)
+			data[i++] = value;
+	}
+
+	Common::MemoryWriteStreamDynamic *compressed = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+	Common::WriteStream *gzip = Common::wrapCompressedWriteStream(compressed);
+	gzip->write(data, kSize);
+	gzip->finalize();
+	byte *compressedData = compressed->getData();
+	const uint32 compressedSize = compressed->size();
+	delete gzip;
+	delete[] data;
+
+	uint32 positions[kSeeks];
+	for (int i = 0; i < kSeeks; ++i)
+		positions[i] = random.nextUint32() % (kSize - 4096);
+
+	byte buffer[4096];
+	const double coldNs = timeCalls([&]() {
+		for (int i = 0; i < kSeeks; ++i) {
+			Common::ScopedPtr<Common::SeekableReadStream> stream(Common::wrapCompressedReadStream(
+				new Common::MemoryReadStream(compressedData, compressedSize, DisposeAfterUse::NO)));
+			stream->seek(positions[i]);
+			stream->read(buffer, sizeof(buffer));
+		}
+	});
+	report("gzip", "random seek, fresh stream", coldNs / kSeeks / 1000.0, "us/seek");
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream(Common::wrapCompressedReadStream(
+		new Common::MemoryReadStream(compressedData, compressedSize, DisposeAfterUse::NO)));
+	stream->seek(0, SEEK_END);
+	stream->readByte();
+	const double warmNs = timeCalls([&]() {
+		for (int i = 0; i < kSeeks; ++i) {
+			stream->seek(positions[i]);
+			stream->read(buffer, sizeof(buffer));
+		}
+	});
+	report("gzip", "random seek, checkpoints", warmNs / kSeeks / 1000.0, "us/seek");
+	report("gzip", "checkpoint speedup", coldNs / warmNs, "x");
+
+	stream.reset();
+	free(compressedData);
+}
+
+#else
+
+void runGZip() {
+	skip("gzip", "all", "zlib is disabled");
+}
+
+#endif
+
+} // End of namespace Benchmark
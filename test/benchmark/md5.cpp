@@ -0,0 +1,91 @@
+#include "common/md5.h"
+#include "common/md5_intern.h"
+#include "common/memstream.h"
+#include "common/str.h"
+
+#include "benchmark.h"
+
+namespace Benchmark {
+
+enum {
+	kMD5Streams = 8,
+	kMD5StreamSize = 1024 * 1024
+};
+
+/** Times the block transform of the given kernel on all its lanes. */
+static void benchMD5Lanes(const char *kernelName, Common::MD5ProcessLanesProc processLanes, uint lanes, const byte *data) {
+	enum { kBlocks = 256 };
+
+	uint32 states[kMD5Streams][4] = {};
+	uint32 *state[kMD5Streams];
+	const uint8 *lanesData[kMD5Streams];
+	for (uint i = 0; i < lanes; ++i) {
+		state[i] = states[i];
+		lanesData[i] = data + i * kBlocks * 64;
+	}
+
+	const double ns = timeCalls([&]() {
+		processLanes(state, lanesData, kBlocks);
+	});
+
+	const Common::String name = Common::String::format("block transform, %s", kernelName);
+	report("md5", name.c_str(), lanes * kBlocks * 64 * 1000.0 / ns, "MB/s");
+}
+
+/** Times hashing several streams, one after the other or all at once. */
+static void benchMD5Streams(const byte *data, bool together) {
+	Common::MemoryReadStream *streams[kMD5Streams];
+	for (int i = 0; i < kMD5Streams; ++i)
+		streams[i] = new Common::MemoryReadStream(data + i * kMD5StreamSize, kMD5StreamSize);
+
+	uint8 digests[kMD5Streams][16];
+	const double ns = timeCalls([&]() {
+		for (int i = 0; i < kMD5Streams; ++i)
+			streams[i]->seek(0);
+		if (together) {
+			Common::computeStreamsMD5((Common::ReadStream *const *)streams, kMD5Streams, digests);
+		} else {
+			for (int i = 0; i < kMD5Streams; ++i)
+				Common::computeStreamMD5(*streams[i], digests[i]);
+		}
+	});
+
+	report("md5", together ? "8 streams, computeStreamsMD5" : "8 streams, computeStreamMD5 each", kMD5Streams * kMD5StreamSize * 1000.0 / ns, "MB/s");
+
+	for (int i = 0; i < kMD5Streams; ++i)
+		delete streams[i];
+}
+
+void runMD5() {
+	TestRandom random;
+	byte *data = new byte[kMD5Streams * kMD5StreamSize];
+	for (uint i = 0; i < kMD5Streams * kMD5StreamSize; ++i)
+		data[i] = (byte)random.nextUint32();
+
+	benchMD5Lanes("scalar", Common::md5ProcessLanes_Scalar, 1, data);
+#ifdef SCUMMVM_SSE2
+	if (hasCpuFeature(OSystem::kFeatureCpuSSE2))
+		benchMD5Lanes("SSE2", Common::md5ProcessLanes_SSE2, 4, data);
+	else
+		skip("md5", "block transform, SSE2", "no SSE2");
+#endif
+#ifdef SCUMMVM_AVX2
+	if (hasCpuFeature(OSystem::kFeatureCpuAVX2))
+		benchMD5Lanes("AVX2", Common::md5ProcessLanes_AVX2, 8, data);
+	else
+		skip("md5", "block transform, AVX2", "no AVX2");
+#endif
+#ifdef SCUMMVM_NEON
+	if (hasCpuFeature(OSystem::kFeatureCpuNEON))
+		benchMD5Lanes("NEON", Common::md5ProcessLanes_NEON, 4, data);
+	else
+		skip("md5", "block transform, NEON", "no NEON");
+#endif
+
+	benchMD5Streams(data, false);
+	benchMD5Streams(data, true);
+
+	delete[] data;
+}
+
+} // End of namespace Benchmark
@@ -0,0 +1,116 @@
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/fs.h"
+#include "common/ptr.h"
+#include "common/stream.h"
+
+#include "benchmark.h"
+
+#ifdef USE_MT32EMU
+// Like in the driver, keeps out the FileStream API and its standard library include
+#define MT32EMU_FILE_STREAM_H
+#include "audio/softsynth/mt32/c_interface/cpp_interface.h"
+#endif
+
+namespace Benchmark {
+
+#ifdef USE_MT32EMU
+
+/** Reads the first of the given ROM files found in the working directory. */
+static byte *readMT32ROM(const char *const *names, uint32 &size) {
+	for (; *names; ++names) {
+		Common::ScopedPtr<Common::SeekableReadStream> file(Common::FSNode(*names).createReadStream());
+		if (!file)
+			continue;
+
+		size = file->size();
+		byte *data = new byte[size];
+		if (file->read(data, size) == size)
+			return data;
+		delete[] data;
+	}
+	return nullptr;
+}
+
+/**
+ * Sends the MIDI messages of a synthetic score due in the given frames: a
+ * note every @p interval frames, held for @p length frames, going round the
+ * eight melodic parts and the rhythm part.
+ */
+static void playMT32Score(MT32Emu::Service &service, uint32 start, uint32 frames, uint32 interval, uint32 length) {
+	const uint32 end = start + frames;
+	for (uint32 n = (start >= length ? (start - length) / interval : 0); n * interval < end; ++n) {
+		const uint32 on = n * interval;
+		const byte channel = (n % 9 == 8) ? 9 : 1 + n % 8;
+		const byte note = (channel == 9) ? 35 + n % 47 : 36 + (n * 7) % 48;
+		if (on >= start)
+			service.playMsg(0x90 | channel | (note << 8) | (100 << 16));
+		if (on + length >= start && on + length < end)
+			service.playMsg(0x80 | channel | (note << 8));
+	}
+}
+
+/** Reports how many times faster than real time the emulator renders a score. */
+static void benchMT32Score(const char *name, const byte *controlData, uint32 controlSize, const byte *pcmData, uint32 pcmSize, uint32 interval, uint32 length) {
+	MT32Emu::Service service;
+	service.createContext();
+	if (service.addROMData(controlData, controlSize) != MT32EMU_RC_ADDED_CONTROL_ROM ||
+	    service.addROMData(pcmData, pcmSize) != MT32EMU_RC_ADDED_PCM_ROM ||
+	    service.openSynth() != MT32EMU_RC_OK) {
+		skip("mt32", name, "the ROMs are not valid");
+		return;
+	}
+	service.setMIDIDelayMode(MT32Emu::MIDIDelayMode_IMMEDIATE);
+
+	for (byte channel = 1; channel <= 8; ++channel)
+		service.playMsg(0xC0 | channel | (((channel * 13) & 0x7F) << 8));
+
+	// Renders a second at a time, in blocks like the ones the mixer asks for
+	enum { kBlockFrames = 256 };
+	const uint32 rate = service.getActualStereoOutputSamplerate();
+	int16 buffer[kBlockFrames * 2];
+	uint32 frame = 0;
+	const double ns = timeCalls([&]() {
+		for (uint32 done = 0; done < rate; done += kBlockFrames) {
+			playMT32Score(service, frame, kBlockFrames, interval, length);
+			service.renderBit16s(buffer, kBlockFrames);
+			frame += kBlockFrames;
+		}
+	});
+	report("mt32", name, 1000000000.0 / ns, "x real time");
+
+	service.closeSynth();
+	service.freeContext();
+}
+
+void runMT32() {
+	static const char *const controlNames[] = { "CM32L_CONTROL.ROM", "MT32_CONTROL.ROM", nullptr };
+	static const char *const pcmNames[] = { "CM32L_PCM.ROM", "MT32_PCM.ROM", nullptr };
+
+	uint32 controlSize, pcmSize;
+	byte *controlData = readMT32ROM(controlNames, controlSize);
+	byte *pcmData = readMT32ROM(pcmNames, pcmSize);
+	if (controlData && pcmData) {
+		// At 32 kHz: a note every 250 ms, and a note every 10 ms, which
+		// uses up all the partials
+		benchMT32Score("sparse score", controlData, controlSize, pcmData, pcmSize, 8000, 8000);
+		benchMT32Score("dense score", controlData, controlSize, pcmData, pcmSize, 320, 16000);
+	} else {
+		skip("mt32", "all", "no MT-32 or CM-32L ROMs in the working directory");
+	}
+
+	delete[] controlData;
+	delete[] pcmData;
+}
+
+#else
+
+void runMT32() {
+	skip("mt32", "all", "the MT-32 emulator is disabled");
+}
+
+#endif
+
+} // End of namespace Benchmark
@@ -0,0 +1,150 @@
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/ptr.h"
+#include "common/str.h"
+#include "audio/softsynth/opl/dbopl.h"
+#include "audio/softsynth/opl/nuked.h"
+
+#include "benchmark.h"
+
+namespace Benchmark {
+
+enum {
+	kOPLRate = 44100,
+	kOPLBlockFrames = 512,
+	// About a second of audio per call
+	kOPLBlocks = 86
+};
+
+enum OPLScore {
+	kOPLScoreOPL2,
+	kOPLScoreRhythm,
+	kOPLScoreOPL3
+};
+
+static const byte oplOperatorOffsets[9] = { 0, 1, 2, 8, 9, 10, 16, 17, 18 };
+
+/**
+ * Sets up an instrument on every channel. The OPL3 score also has two four
+ * operator channels in each bank, the rhythm score plays the drums too.
+ */
+template<typename T>
+static void setUpOPLScore(T writeReg, OPLScore score) {
+	writeReg(0x01, 0x20);
+	if (score == kOPLScoreOPL3) {
+		writeReg(0x105, 0x01);
+		writeReg(0x104, 0x09);
+	}
+	writeReg(0xBD, score == kOPLScoreRhythm ? 0xE0 : 0xC0);
+
+	const int banks = (score == kOPLScoreOPL3) ? 2 : 1;
+	for (int bank = 0; bank < banks; ++bank) {
+		for (int channel = 0; channel < 9; ++channel) {
+			const int op = bank * 0x100 + oplOperatorOffsets[channel];
+			writeReg(op + 0x20, 0xA1);
+			writeReg(op + 0x23, 0x21);
+			writeReg(op + 0x40, 0x10);
+			writeReg(op + 0x43, 0x00);
+			writeReg(op + 0x60, 0xF3);
+			writeReg(op + 0x63, 0xF2);
+			writeReg(op + 0x80, 0x35);
+			writeReg(op + 0x83, 0x45);
+			writeReg(op + 0xE0, channel & 3);
+			writeReg(bank * 0x100 + 0xC0 + channel, 0x3E | (channel & 1));
+		}
+	}
+}
+
+/** Starts the next note of the score, on the channel which has played the longest. */
+template<typename T>
+static void playOPLScore(T writeReg, OPLScore score, uint32 note) {
+	const int channels = (score == kOPLScoreOPL3) ? 18 : (score == kOPLScoreRhythm) ? 6 : 9;
+	const int channel = note % channels;
+	const int reg = (channel / 9) * 0x100 + channel % 9;
+	const int fnum = 0x157 + (note * 37) % 0x100;
+
+	writeReg(reg + 0xB0, 0);
+	writeReg(reg + 0xA0, fnum & 0xFF);
+	writeReg(reg + 0xB0, 0x20 | (3 + note % 3) << 2 | fnum >> 8);
+
+	if (score == kOPLScoreRhythm) {
+		writeReg(0xBD, 0xE0);
+		writeReg(0xBD, 0xE0 | (1 << (note % 5)));
+	}
+}
+
+/** Times rendering the score, a note every block, and returns the samples per second. */
+template<typename T, typename G>
+static double timeOPLScore(T writeReg, G generate, OPLScore score) {
+	setUpOPLScore(writeReg, score);
+
+	uint32 note = 0;
+	const double ns = timeCalls([&]() {
+		for (int i = 0; i < kOPLBlocks; ++i) {
+			playOPLScore(writeReg, score, note++);
+			generate(kOPLBlockFrames);
+		}
+	});
+	return kOPLBlocks * kOPLBlockFrames * 1000000000.0 / ns;
+}
+
+static const char *const oplScoreNames[] = { "OPL2", "OPL2 rhythm", "OPL3" };
+
+#ifndef DISABLE_DOSBOX_OPL
+static void benchDOSBoxOPL(OPLScore score) {
+	OPL::DOSBox::DBOPL::InitTables();
+	Common::ScopedPtr<OPL::DOSBox::DBOPL::Chip> chip(new OPL::DOSBox::DBOPL::Chip());
+	chip->Setup(kOPLRate);
+
+	static int32 buffer[kOPLBlockFrames * 2];
+	const double samples = timeOPLScore([&](int reg, int val) {
+		chip->WriteReg(reg, val);
+	}, [&](uint frames) {
+		if (chip->opl3Active)
+			chip->GenerateBlock3(frames, buffer);
+		else
+			chip->GenerateBlock2(frames, buffer);
+	}, score);
+
+	const Common::String name = Common::String::format("DOSBox, %s", oplScoreNames[score]);
+	report("opl", name.c_str(), samples, "samples/s");
+}
+#endif
+
+#ifndef DISABLE_NUKED_OPL
+static void benchNukedOPL(OPLScore score) {
+	Common::ScopedPtr<OPL::NUKED::opl3_chip> chip(new OPL::NUKED::opl3_chip());
+	OPL::NUKED::OPL3_Reset(chip.get(), kOPLRate);
+
+	static int16 buffer[kOPLBlockFrames * 2];
+	const double samples = timeOPLScore([&](int reg, int val) {
+		OPL::NUKED::OPL3_WriteRegBuffered(chip.get(), reg, val);
+	}, [&](uint frames) {
+		OPL::NUKED::OPL3_GenerateStream(chip.get(), buffer, frames);
+	}, score);
+
+	const Common::String name = Common::String::format("Nuked, %s", oplScoreNames[score]);
+	report("opl", name.c_str(), samples, "samples/s");
+}
+#endif
+
+void runOPL() {
+	static const OPLScore scores[] = { kOPLScoreOPL2, kOPLScoreRhythm, kOPLScoreOPL3 };
+
+	for (uint i = 0; i < ARRAYSIZE(scores); ++i) {
+#ifndef DISABLE_DOSBOX_OPL
+		benchDOSBoxOPL(scores[i]);
+#else
+		skip("opl", "DOSBox", "the DOSBox emulator is disabled");
+#endif
+#ifndef DISABLE_NUKED_OPL
+		benchNukedOPL(scores[i]);
+#else
+		skip("opl", "Nuked", "the Nuked emulator is disabled");
+#endif
+	}
+}
+
+} // End of namespace Benchmark
@@ -0,0 +1,75 @@
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "common/str.h"
+
+#include "benchmark.h"
+
+namespace Benchmark {
+
+/** An endless stereo stream repeating a block of noise. */
+class NoiseAudioStream : public Audio::AudioStream {
+	enum { kBlockSamples = 4096 };
+
+	int16 _block[kBlockSamples];
+	int _pos;
+	const int _rate;
+
+public:
+	NoiseAudioStream(int rate) : _pos(0), _rate(rate) {
+		TestRandom random;
+		for (int i = 0; i < kBlockSamples; ++i)
+			_block[i] = (int16)random.nextUint32();
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) override {
+		for (int done = 0; done < numSamples;) {
+			const int n = MIN<int>(numSamples - done, kBlockSamples - _pos);
+			memcpy(buffer + done, _block + _pos, n * sizeof(int16));
+			_pos = (_pos + n) % kBlockSamples;
+			done += n;
+		}
+		return numSamples;
+	}
+	bool isStereo() const override { return true; }
+	int getRate() const override { return _rate; }
+	bool endOfData() const override { return false; }
+};
+
+void runRate() {
+	static const struct {
+		Audio::ResamplerQuality quality;
+		const char *name;
+	} qualities[] = {
+		{ Audio::kResamplerLinear, "linear" },
+		{ Audio::kResamplerFIRFast, "fast" },
+		{ Audio::kResamplerFIRBalanced, "balanced" },
+		{ Audio::kResamplerFIRBest, "best" }
+	};
+	static const struct {
+		Audio::st_rate_t inRate, outRate;
+	} conversions[] = {
+		{ 11025, 44100 },
+		{ 22050, 48000 },
+		{ 48000, 22050 }
+	};
+	enum { kFrames = 4096 };
+
+	static Audio::st_sample_t out[kFrames * 2];
+	for (uint c = 0; c < ARRAYSIZE(conversions); ++c) {
+		for (uint q = 0; q < ARRAYSIZE(qualities); ++q) {
+			NoiseAudioStream stream(conversions[c].inRate);
+			Audio::RateConverter *converter = Audio::makeRateConverter(conversions[c].inRate, conversions[c].outRate, true, true, false, qualities[q].quality);
+
+			const double ns = timeCalls([&]() {
+				converter->flow(stream, out, kFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+			});
+			const Common::String name = Common::String::format("%s %u -> %u", qualities[q].name, conversions[c].inRate, conversions[c].outRate);
+			report("rate", name.c_str(), ns / kFrames, "ns/sample");
+
+			delete converter;
+		}
+	}
+}
+
+} // End of namespace Benchmark
@@ -0,0 +1,207 @@
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/str.h"
+
+#include "benchmark.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
+#endif
+
+namespace Benchmark {
+
+#ifdef USE_TINYGL
+
+static const int kTinyGLWidth = 640;
+static const int kTinyGLHeight = 480;
+
+static void drawTinyGLScene(TestRandom &random, uint frame, TGLuint texture) {
+	tglViewport(0, 0, kTinyGLWidth, kTinyGLHeight);
+	tglMatrixMode(TGL_PROJECTION);
+	tglLoadIdentity();
+	tglOrtho(0, kTinyGLWidth, kTinyGLHeight, 0, -1, 1);
+	tglMatrixMode(TGL_MODELVIEW);
+	tglLoadIdentity();
+
+	tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+	tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+	tglEnable(TGL_DEPTH_TEST);
+	tglShadeModel(TGL_SMOOTH);
+	tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+	tglBindTexture(TGL_TEXTURE_2D, texture);
+
+	random.setSeed(1);
+	for (int i = 0; i < 200; ++i) {
+		// Like in a game, most of the scene stays the same between frames
+		if (i % 50 == 0)
+			random.setSeed(random.getSeed() + frame);
+
+		if (i % 3 == 0)
+			tglEnable(TGL_BLEND);
+		else
+			tglDisable(TGL_BLEND);
+		if (i % 2 == 0)
+			tglEnable(TGL_TEXTURE_2D);
+		else
+			tglDisable(TGL_TEXTURE_2D);
+
+		const float x = random.nextFloat(0, kTinyGLWidth), y = random.nextFloat(0, kTinyGLHeight);
+		tglBegin(TGL_TRIANGLES);
+		for (int j = 0; j < 3; ++j) {
+			tglColor4f(random.nextFloat(0, 1), random.nextFloat(0, 1), random.nextFloat(0, 1), random.nextFloat(0.5f, 1));
+			tglTexCoord2f(random.nextFloat(0, 2), random.nextFloat(0, 2));
+			tglVertex3f(x + random.nextFloat(-120, 120), y + random.nextFloat(-120, 120), random.nextFloat(-1, 1));
+		}
+		tglEnd();
+	}
+}
+
+static TGLuint createTinyGLTexture(TestRandom &random) {
+	enum { kTextureSize = 64 };
+	static byte texels[kTextureSize * kTextureSize * 4];
+	for (int i = 0; i < ARRAYSIZE(texels); ++i)
+		texels[i] = (byte)random.nextUint32();
+
+	TGLuint texture;
+	tglGenTextures(1, &texture);
+	tglBindTexture(TGL_TEXTURE_2D, texture);
+	tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, kTextureSize, kTextureSize, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+	return texture;
+}
+
+/** Times a whole frame with dirty rectangles, rasterized with the given thread count. */
+static void benchTinyGLFrames(uint threads) {
+	const Graphics::PixelFormat format(4, 8, 8, 8, 8, 0, 8, 16, 24);
+	TinyGL::createContext(kTinyGLWidth, kTinyGLHeight, format, 256, false, true);
+	TinyGL::setRasterizerThreadCount(threads);
+
+	TestRandom random;
+	const TGLuint texture = createTinyGLTexture(random);
+
+	uint frame = 0;
+	const double ns = timeCalls([&]() {
+		drawTinyGLScene(random, frame++, texture);
+		TinyGL::presentBuffer();
+	});
+
+	const Common::String name = threads ? Common::String::format("frame, %u thread(s)", threads) : Common::String("frame, one thread per core");
+	report("tinygl", name.c_str(), ns / 1000000.0, "ms/frame");
+
+	tglDeleteTextures(1, &texture);
+	TinyGL::destroyContext();
+}
+
+/**
+ * Times filling triangles with the given span kernels, in a context without
+ * dirty rectangles so that the triangles are rasterized right away.
+ */
+static void benchTinyGLFill(const char *kernelName, const TinyGL::SpanKernels *kernels, bool textured) {
+	const Graphics::PixelFormat format(4, 8, 8, 8, 8, 0, 8, 16, 24);
+	TinyGL::createContext(kTinyGLWidth, kTinyGLHeight, format, 256, false, false);
+	TinyGL::gl_get_context()->fb->setSpanKernels(kernels);
+
+	TestRandom random;
+	const TGLuint texture = createTinyGLTexture(random);
+
+	tglViewport(0, 0, kTinyGLWidth, kTinyGLHeight);
+	tglMatrixMode(TGL_PROJECTION);
+	tglLoadIdentity();
+	tglOrtho(0, kTinyGLWidth, kTinyGLHeight, 0, -1, 1);
+	tglMatrixMode(TGL_MODELVIEW);
+	tglLoadIdentity();
+
+	// All the pixels pass the depth test, which is still done
+	tglEnable(TGL_DEPTH_TEST);
+	tglDepthFunc(TGL_LEQUAL);
+	tglShadeModel(TGL_SMOOTH);
+	if (textured)
+		tglEnable(TGL_TEXTURE_2D);
+
+	// The triangles are all on screen, so their area is the number of pixels drawn
+	enum { kTriangles = 100 };
+	float vertices[kTriangles * 3][8];
+	double pixels = 0.0;
+	for (int i = 0; i < kTriangles; ++i) {
+		const float x = random.nextFloat(100, kTinyGLWidth - 100), y = random.nextFloat(100, kTinyGLHeight - 100);
+		float *v[3] = { vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2] };
+		for (int j = 0; j < 3; ++j) {
+			v[j][0] = x + random.nextFloat(-100, 100);
+			v[j][1] = y + random.nextFloat(-100, 100);
+			for (int k = 2; k < 6; ++k)
+				v[j][k] = random.nextFloat(0, 1);
+			v[j][6] = random.nextFloat(0, 2);
+			v[j][7] = random.nextFloat(0, 2);
+		}
+		pixels += fabs((v[1][0] - v[0][0]) * (v[2][1] - v[0][1]) - (v[2][0] - v[0][0]) * (v[1][1] - v[0][1])) / 2.0;
+	}
+
+	const double ns = timeCalls([&]() {
+		tglBegin(TGL_TRIANGLES);
+		for (int i = 0; i < kTriangles * 3; ++i) {
+			tglColor4f(vertices[i][2], vertices[i][3], vertices[i][4], vertices[i][5]);
+			tglTexCoord2f(vertices[i][6], vertices[i][7]);
+			tglVertex3f(vertices[i][0], vertices[i][1], 0.0f);
+		}
+		tglEnd();
+		// Frees the vertex data of the frame
+		TinyGL::presentBuffer();
+	});
+
+	const Common::String name = Common::String::format("fill %s, %s", textured ? "textured" : "smooth", kernelName);
+	report("tinygl", name.c_str(), ns / pixels, "ns/pixel");
+
+	tglDeleteTextures(1, &texture);
+	TinyGL::destroyContext();
+}
+
+static void benchTinyGLFill(const char *kernelName, const TinyGL::SpanKernels *kernels) {
+	benchTinyGLFill(kernelName, kernels, false);
+	benchTinyGLFill(kernelName, kernels, true);
+}
+
+void runTinyGL() {
+	static const TinyGL::SpanKernels scalarKernels = { TinyGL::depthTestSpan_Scalar, TinyGL::shadeSpan_Scalar, TinyGL::shadeTexturedSpan_Scalar };
+	benchTinyGLFill("per pixel", nullptr);
+	benchTinyGLFill("scalar spans", &scalarKernels);
+#ifdef SCUMMVM_SSE2
+	static const TinyGL::SpanKernels sse2Kernels = { TinyGL::depthTestSpan_SSE2, TinyGL::shadeSpan_SSE2, TinyGL::shadeTexturedSpan_SSE2 };
+	if (hasCpuFeature(OSystem::kFeatureCpuSSE2))
+		benchTinyGLFill("SSE2 spans", &sse2Kernels);
+	else
+		skip("tinygl", "fill, SSE2 spans", "no SSE2");
+#endif
+#ifdef SCUMMVM_AVX2
+	static const TinyGL::SpanKernels avx2Kernels = { TinyGL::depthTestSpan_AVX2, TinyGL::shadeSpan_AVX2, TinyGL::shadeTexturedSpan_AVX2 };
+	if (hasCpuFeature(OSystem::kFeatureCpuAVX2))
+		benchTinyGLFill("AVX2 spans", &avx2Kernels);
+	else
+		skip("tinygl", "fill, AVX2 spans", "no AVX2");
+#endif
+#ifdef SCUMMVM_NEON
+	static const TinyGL::SpanKernels neonKernels = { TinyGL::depthTestSpan_NEON, TinyGL::shadeSpan_NEON, TinyGL::shadeTexturedSpan_NEON };
+	if (hasCpuFeature(OSystem::kFeatureCpuNEON))
+		benchTinyGLFill("NEON spans", &neonKernels);
+	else
+		skip("tinygl", "fill, NEON spans", "no NEON");
+#endif
+
+	benchTinyGLFrames(1);
+	benchTinyGLFrames(2);
+	benchTinyGLFrames(4);
+	benchTinyGLFrames(0);
+}
+
+#else
+
+void runTinyGL() {
+	skip("tinygl", "all", "TinyGL is disabled");
+}
+
+#endif
+
+} // End of namespace Benchmark
@@ -0,0 +1,109 @@
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/str.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include "benchmark.h"
+
+namespace Benchmark {
+
+static void randomFillYUV(TestRandom &random, byte *buffer, uint size) {
+	for (uint i = 0; i < size; ++i)
+		buffer[i] = (byte)random.nextUint32();
+}
+
+static void benchConvertYUVSpan(const char *kernelName, Graphics::ConvertYUVSpanProc convertSpan) {
+	static const struct {
+		Graphics::PixelFormat format;
+		const char *name;
+	} formats[] = {
+		{ Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), "RGB565" },
+		{ Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), "RGBA8888" }
+	};
+
+	TestRandom random;
+	static byte y[Graphics::kYUVSpanSize], a[Graphics::kYUVSpanSize];
+	static int16 offsets[3][Graphics::kYUVSpanSize];
+	static byte dst[Graphics::kYUVSpanSize * 4];
+	randomFillYUV(random, y, sizeof(y));
+	randomFillYUV(random, a, sizeof(a));
+	for (uint i = 0; i < Graphics::kYUVSpanSize; ++i) {
+		offsets[0][i] = (int16)(random.nextUint32() % 401) - 200;
+		offsets[1][i] = (int16)(random.nextUint32() % 401) - 200;
+		offsets[2][i] = (int16)(random.nextUint32() % 401) - 200;
+	}
+
+	for (uint f = 0; f < ARRAYSIZE(formats); ++f) {
+		for (int alpha = 0; alpha < 2; ++alpha) {
+			const Graphics::YUVSpan span = { dst, y, alpha ? a : nullptr, offsets[0], offsets[1], offsets[2], Graphics::kYUVSpanSize };
+			const Graphics::PixelFormat &format = formats[f].format;
+			const double ns = timeCalls([&]() {
+				for (int i = 0; i < 64; ++i)
+					convertSpan(span, format, true);
+			});
+
+			const Common::String name = Common::String::format("span %s%s, %s", formats[f].name, alpha ? " alpha" : "", kernelName);
+			report("yuv", name.c_str(), ns / (64 * Graphics::kYUVSpanSize), "ns/pixel");
+		}
+	}
+}
+
+/** Times converting a 640x480 4:2:0 video frame with the given thread count. */
+static void benchConvertYUVFrames(const Graphics::PixelFormat &format, const char *formatName, uint threads) {
+	enum { kWidth = 640, kHeight = 480 };
+
+	TestRandom random;
+	static byte y[kWidth * kHeight], u[kWidth * kHeight / 4], v[kWidth * kHeight / 4];
+	randomFillYUV(random, y, sizeof(y));
+	randomFillYUV(random, u, sizeof(u));
+	randomFillYUV(random, v, sizeof(v));
+
+	Graphics::Surface surface;
+	surface.create(kWidth, kHeight, format);
+	YUVToRGBMan.setThreadCount(threads);
+
+	const double ns = timeCalls([&]() {
+		YUVToRGBMan.convert420(&surface, Graphics::YUVToRGBManager::kScaleITU, y, u, v, kWidth, kHeight, kWidth, kWidth / 2);
+	});
+
+	const Common::String name = threads ? Common::String::format("frame 4:2:0 %s, %u thread(s)", formatName, threads) : Common::String::format("frame 4:2:0 %s, one thread per core", formatName);
+	report("yuv", name.c_str(), ns / 1000000.0, "ms/frame");
+
+	YUVToRGBMan.setThreadCount(1);
+	surface.free();
+}
+
+void runYUV() {
+	benchConvertYUVSpan("scalar", Graphics::convertYUVSpan_Scalar);
+#ifdef SCUMMVM_SSE2
+	if (hasCpuFeature(OSystem::kFeatureCpuSSE2))
+		benchConvertYUVSpan("SSE2", Graphics::convertYUVSpan_SSE2);
+	else
+		skip("yuv", "span, SSE2", "no SSE2");
+#endif
+#ifdef SCUMMVM_AVX2
+	if (hasCpuFeature(OSystem::kFeatureCpuAVX2))
+		benchConvertYUVSpan("AVX2", Graphics::convertYUVSpan_AVX2);
+	else
+		skip("yuv", "span, AVX2", "no AVX2");
+#endif
+#ifdef SCUMMVM_NEON
+	if (hasCpuFeature(OSystem::kFeatureCpuNEON))
+		benchConvertYUVSpan("NEON", Graphics::convertYUVSpan_NEON);
+	else
+		skip("yuv", "span, NEON", "no NEON");
+#endif
+
+	const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+	const Graphics::PixelFormat rgba8888(4, 8, 8, 8, 8, 24, 16, 8, 0);
+	benchConvertYUVFrames(rgb565, "RGB565", 1);
+	benchConvertYUVFrames(rgb565, "RGB565", 0);
+	benchConvertYUVFrames(rgba8888, "RGBA8888", 1);
+	benchConvertYUVFrames(rgba8888, "RGBA8888", 0);
+}
+
+} // End of namespace Benchmark
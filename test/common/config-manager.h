@@ -0,0 +1,117 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+#include "common/ptr.h"
+#include "common/stream.h"
+#include "../test_helper.h"
+
+/*
+ * ConfigManager::get() remembers the values it found, these have to change
+ * along with the domains. The snapshot of the parsed config file has to
+ * change along with its text.
+ */
+class ConfigManagerTestSuite : public CxxTest::TestSuite {
+#if NULL_OSYSTEM_IS_AVAILABLE
+	void writeFile(const Common::FSNode &node, const char *contents) {
+		Common::ScopedPtr<Common::SeekableWriteStream> file(node.createWriteStream());
+		TS_ASSERT(file);
+		if (file) {
+			file->writeString(contents);
+			file->finalize();
+		}
+	}
+#endif
+
+public:
+	void tearDown() {
+		ConfMan.removeKey("test_lookup", Common::ConfigManager::kApplicationDomain);
+		ConfMan.removeKey("test_lookup", Common::ConfigManager::kTransientDomain);
+		ConfMan.removeGameDomain("test-game");
+		ConfMan.setActiveDomain("");
+	}
+
+	void test_domain_generation() {
+		Common::ConfigManager::Domain domain;
+		const uint32 created = domain.getGeneration();
+		domain.setVal("key", "value");
+		TS_ASSERT_DIFFERS(domain.getGeneration(), created);
+
+		const uint32 set = domain.getGeneration();
+		TS_ASSERT_EQUALS(domain["key"], "value");
+		TS_ASSERT_EQUALS(domain.getGeneration(), set);
+
+		const Common::ConfigManager::Domain copy(domain);
+		TS_ASSERT_DIFFERS(copy.getGeneration(), domain.getGeneration());
+
+		domain.erase("key");
+		TS_ASSERT_DIFFERS(domain.getGeneration(), set);
+	}
+
+	void test_lookup_follows_domains() {
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "");
+
+		ConfMan.registerDefault("test_lookup", "default");
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "default");
+
+		ConfMan.set("test_lookup", "app", Common::ConfigManager::kApplicationDomain);
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "app");
+
+		ConfMan.set("test_lookup", "transient", Common::ConfigManager::kTransientDomain);
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "transient");
+
+		ConfMan.removeKey("test_lookup", Common::ConfigManager::kTransientDomain);
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "app");
+
+		ConfMan.removeKey("test_lookup", Common::ConfigManager::kApplicationDomain);
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "default");
+	}
+
+	void test_lookup_follows_active_domain() {
+		ConfMan.set("test_lookup", "app", Common::ConfigManager::kApplicationDomain);
+		ConfMan.addGameDomain("test-game");
+		ConfMan.set("test_lookup", "game", "test-game");
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "app");
+
+		ConfMan.setActiveDomain("test-game");
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "game");
+
+		ConfMan.getActiveDomain()->setVal("test_lookup", "changed");
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "changed");
+
+		ConfMan.setActiveDomain("");
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "app");
+	}
+
+	void test_snapshot_follows_text() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		const Common::FSNode dir = getTestDirectory().getChild("config-snapshot");
+		dir.createDirectory();
+		const Common::FSNode config = dir.getChild("scummvm.ini");
+		ConfMan.registerDefault("cachepath", dir.getPath());
+
+		writeFile(config, "[scummvm]\ntest_lookup=one\n\n");
+		ConfMan.loadConfigFile(config.getPath());
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "one");
+
+		Common::FSList snapshots;
+		TS_ASSERT(dir.getChildren(snapshots, Common::FSNode::kListFilesOnly));
+		TS_ASSERT_EQUALS(snapshots.size(), 2U);
+
+		// Loaded from the snapshot
+		ConfMan.loadConfigFile(config.getPath());
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "one");
+
+		// The same size, and likely the same modification time
+		writeFile(config, "[scummvm]\ntest_lookup=two\n\n");
+		ConfMan.loadConfigFile(config.getPath());
+		TS_ASSERT_EQUALS(ConfMan.get("test_lookup"), "two");
+
+		ConfMan.registerDefault("cachepath", "");
+		snapshots.clear();
+		dir.getChildren(snapshots, Common::FSNode::kListFilesOnly);
+		for (uint i = 0; i < snapshots.size(); ++i)
+			remove(snapshots[i].getPath().c_str());
+		remove(dir.getPath().c_str());
+#endif
+	}
+};
@@ -0,0 +1,72 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/memstream.h"
+#include "common/compression/zlib.h"
+#include "../test_helper.h"
+
+/*
+ * GZipReadStream resumes decompressing from checkpoints when seeking.
+ * Reading after any seek has to give the same data as reading the
+ * uncompressed data directly.
+ */
+class GZipReadStreamTestSuite : public CxxTest::TestSuite {
+	// Large enough for several checkpoints
+	static const uint32 kSize = 3 * 1024 * 1024 + 12345;
+
+	TestRandom _random;
+
+public:
+	void test_random_access() {
+#ifdef USE_ZLIB
+		_random.setSeed(1);
+		byte *data = new byte[kSize];
+		// Few symbols in runs, so that it compresses into many blocks
+		for (uint32 i = 0; i < kSize; ) {
+			const byte value = 'a' + _random.nextUint32() % 8;
+			for (uint32 run = 1 + _random.nextUint32() % 5; run > 0 && i < kSize; --run)
+				data[i++] = value;
+		}
+
+		// The gzip stream takes over the stream it writes to
+		Common::MemoryWriteStreamDynamic *compressed = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(compressed);
+		gzip->write(data, kSize);
+		gzip->finalize();
+		byte *compressedData = compressed->getData();
+		const uint32 compressedSize = compressed->size();
+		delete gzip;
+
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(
+			new Common::MemoryReadStream(compressedData, compressedSize, DisposeAfterUse::YES));
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), (int64)kSize);
+
+		// Read everything once, to get the checkpoints, and then jump around
+		byte buffer[4096];
+		for (int i = 0; i < 40; ++i) {
+			const uint32 pos = (i == 0) ? 0 : _random.nextUint32() % kSize;
+			const uint32 length = (i == 0) ? kSize : MIN<uint32>(_random.nextUint32() % sizeof(buffer), kSize - pos);
+
+			TS_ASSERT(stream->seek(pos));
+			TS_ASSERT_EQUALS(stream->pos(), (int64)pos);
+			for (uint32 done = 0; done < length; ) {
+				const uint32 chunk = MIN<uint32>(length - done, sizeof(buffer));
+				TS_ASSERT_EQUALS(stream->read(buffer, chunk), chunk);
+				TS_ASSERT_SAME_DATA(buffer, data + pos + done, chunk);
+				done += chunk;
+			}
+		}
+
+		TS_ASSERT(stream->seek(0, SEEK_END));
+		stream->readByte();
+		TS_ASSERT(stream->eos());
+
+		delete stream;
+		delete[] data;
+#endif
+	}
+};
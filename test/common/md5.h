@@ -1,7 +1,10 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/md5.h"
+#include "common/md5_intern.h"
+#include "common/memstream.h"
 #include "common/stream.h"
+#include "../test_helper.h"
 
 /*
  * those are the standard RFC 1321 test vectors
@@ -28,6 +31,36 @@ static const char *md5_test_digest[] = {
 };
 
 class MD5TestSuite : public CxxTest::TestSuite {
+	TestRandom _random;
+
+	/** The vector transforms have to give the same states as the plain one in every lane. */
+	void checkProcessLanes(Common::MD5ProcessLanesProc processLanes, uint lanes) {
+		_random.setSeed(1);
+		for (uint blocks = 1; blocks <= 3; ++blocks) {
+			uint32 state[8][4], expected[8][4];
+			uint8 data[8][3 * 64];
+			uint32 *statePtr[8];
+			const uint8 *dataPtr[8];
+
+			for (uint i = 0; i < lanes; ++i) {
+				for (int j = 0; j < 4; ++j)
+					state[i][j] = expected[i][j] = _random.nextUint32();
+				for (uint j = 0; j < sizeof(data[i]); ++j)
+					data[i][j] = (uint8)_random.nextUint32();
+				statePtr[i] = state[i];
+				dataPtr[i] = data[i];
+			}
+
+			processLanes(statePtr, dataPtr, blocks);
+
+			for (uint i = 0; i < lanes; ++i) {
+				uint32 *expectedPtr = expected[i];
+				Common::md5ProcessLanes_Scalar(&expectedPtr, &dataPtr[i], blocks);
+				TS_ASSERT_SAME_DATA(state[i], expected[i], sizeof(expected[i]));
+			}
+		}
+	}
+
 	public:
 	void test_computeStreamMD5() {
 		int i, j;
@@ -47,4 +80,62 @@ class MD5TestSuite : public CxxTest::TestSuite {
 		}
 	}
 
+	void test_md5_lanes_sse2() {
+#ifdef SCUMMVM_SSE2
+		if (hasCpuFeature(OSystem::kFeatureCpuSSE2))
+			checkProcessLanes(Common::md5ProcessLanes_SSE2, 4);
+#endif
+	}
+
+	void test_md5_lanes_avx2() {
+#ifdef SCUMMVM_AVX2
+		if (hasCpuFeature(OSystem::kFeatureCpuAVX2))
+			checkProcessLanes(Common::md5ProcessLanes_AVX2, 8);
+#endif
+	}
+
+	void test_md5_lanes_neon() {
+#ifdef SCUMMVM_NEON
+		if (hasCpuFeature(OSystem::kFeatureCpuNEON))
+			checkProcessLanes(Common::md5ProcessLanes_NEON, 4);
+#endif
+	}
+
+	void test_computeStreamsMD5() {
+		// Around the block and chunk sizes, in an order which lets the
+		// streams of a group end at different times
+		static const uint32 sizes[] = { 0, 4097, 1, 63, 64, 65, 120, 4096, 10000, 56, 55, 8192, 3 };
+		static const uint kCount = ARRAYSIZE(sizes);
+		static const uint32 limits[] = { 0, 1, 64, 5000 };
+
+		_random.setSeed(2);
+		byte *data[kCount];
+		for (uint i = 0; i < kCount; ++i) {
+			data[i] = new byte[sizes[i] + 1];
+			for (uint32 j = 0; j < sizes[i]; ++j)
+				data[i][j] = (byte)_random.nextUint32();
+		}
+
+		for (uint i = 0; i < ARRAYSIZE(limits); ++i) {
+			// Every number of streams, to get all the ways of filling the lanes
+			for (uint count = 0; count <= kCount; ++count) {
+				Common::ReadStream *streams[kCount];
+				for (uint j = 0; j < count; ++j)
+					streams[j] = new Common::MemoryReadStream(data[j], sizes[j]);
+
+				Common::String md5s[kCount];
+				Common::computeStreamsMD5AsString(streams, count, md5s, limits[i]);
+
+				for (uint j = 0; j < count; ++j) {
+					Common::MemoryReadStream stream(data[j], sizes[j]);
+					TS_ASSERT_EQUALS(md5s[j], Common::computeStreamMD5AsString(stream, limits[i]));
+					delete streams[j];
+				}
+			}
+		}
+
+		for (uint i = 0; i < kCount; ++i)
+			delete[] data[i];
+	}
+
 };
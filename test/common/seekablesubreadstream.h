@@ -70,4 +70,18 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_memory_view() {
+		byte contents[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		TS_ASSERT_EQUALS(ms.getMemoryView(), contents);
+
+		Common::SeekableSubReadStream ssrs(&ms, 3, 8);
+		ssrs.seek(2, SEEK_SET);
+		// The view covers the whole substream, wherever it is positioned
+		TS_ASSERT_EQUALS(ssrs.getMemoryView(), contents + 3);
+
+		Common::SeekableSubReadStream nested(&ssrs, 1, 4);
+		TS_ASSERT_EQUALS(nested.getMemoryView(), contents + 4);
+	}
 };
@@ -0,0 +1,256 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/archive.h"
+#include "common/crc.h"
+#include "common/ptr.h"
+#include "common/memstream.h"
+#include "common/compression/unzip.h"
+#include "common/compression/zlib.h"
+#include "../test_helper.h"
+
+/*
+ * ZIP archives decompress the members requested together on several
+ * threads. That has to give the same data as reading the members one by
+ * one.
+ */
+class ZipArchiveTestSuite : public CxxTest::TestSuite {
+	static const uint kMemberCount = 12;
+
+	TestRandom _random;
+
+	static Common::String memberName(uint i) {
+		return Common::String::format("dir/member%u.dat", i);
+	}
+
+	/** Returns the raw deflate data of a gzip stream written by ScummVM. */
+	static Common::Array<byte> deflate(const Common::Array<byte> &data) {
+		Common::MemoryWriteStreamDynamic *compressed = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(compressed);
+		gzip->write(data.data(), data.size());
+		gzip->finalize();
+
+		// Without the gzip header and the CRC and size trailer
+		Common::Array<byte> result(compressed->getData() + 10, compressed->size() - 18);
+		delete gzip;
+		return result;
+	}
+
+	/** Writes a ZIP archive holding the members, every other one deflated if possible. */
+	Common::SeekableReadStream *createArchive(const Common::Array<byte> *members) {
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+		Common::MemoryWriteStreamDynamic centralDir(DisposeAfterUse::YES);
+		const Common::CRC32 crc;
+
+		for (uint i = 0; i < kMemberCount; ++i) {
+#ifdef USE_ZLIB
+			const bool deflated = (i % 2) == 1;
+#else
+			const bool deflated = false;
+#endif
+			const Common::Array<byte> data = deflated ? deflate(members[i]) : members[i];
+			const Common::String name = memberName(i);
+			const uint32 memberCrc = crc.crcFast(members[i].data(), members[i].size());
+			const uint32 offset = zip.pos();
+
+			zip.writeUint32LE(0x04034b50);
+			zip.writeUint16LE(20);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(deflated ? 8 : 0);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(memberCrc);
+			zip.writeUint32LE(data.size());
+			zip.writeUint32LE(members[i].size());
+			zip.writeUint16LE(name.size());
+			zip.writeUint16LE(0);
+			zip.writeString(name);
+			zip.write(data.data(), data.size());
+
+			centralDir.writeUint32LE(0x02014b50);
+			centralDir.writeUint16LE(20);
+			centralDir.writeUint16LE(20);
+			centralDir.writeUint16LE(0);
+			centralDir.writeUint16LE(deflated ? 8 : 0);
+			centralDir.writeUint32LE(0);
+			centralDir.writeUint32LE(memberCrc);
+			centralDir.writeUint32LE(data.size());
+			centralDir.writeUint32LE(members[i].size());
+			centralDir.writeUint16LE(name.size());
+			centralDir.writeUint16LE(0);
+			centralDir.writeUint16LE(0);
+			centralDir.writeUint16LE(0);
+			centralDir.writeUint16LE(0);
+			centralDir.writeUint32LE(0);
+			centralDir.writeUint32LE(offset);
+			centralDir.writeString(name);
+		}
+
+		const uint32 centralDirOffset = zip.pos();
+		zip.write(centralDir.getData(), centralDir.size());
+		zip.writeUint32LE(0x06054b50);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(kMemberCount);
+		zip.writeUint16LE(kMemberCount);
+		zip.writeUint32LE(centralDir.size());
+		zip.writeUint32LE(centralDirOffset);
+		zip.writeUint16LE(0);
+
+		return new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES);
+	}
+
+	void checkStream(Common::SeekableReadStream *stream, const Common::Array<byte> &expected) {
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+		TS_ASSERT_EQUALS(stream->size(), (int64)expected.size());
+		Common::Array<byte> data(stream->size());
+		TS_ASSERT_EQUALS(stream->read(data.data(), data.size()), expected.size());
+		TS_ASSERT_SAME_DATA(data.data(), expected.data(), expected.size());
+		delete stream;
+	}
+
+	void createMembers(Common::Array<byte> *members) {
+		_random.setSeed(1);
+		for (uint i = 0; i < kMemberCount; ++i) {
+			// Small and large members, compressible but not trivially
+			members[i].resize(i * i * 1000 + _random.nextUint32() % 100);
+			for (uint j = 0; j < members[i].size(); ++j)
+				members[i][j] = 'a' + _random.nextUint32() % 4;
+		}
+	}
+
+	static Common::Array<byte> readAll(Common::SeekableReadStream *stream) {
+		Common::Array<byte> data(stream->size());
+		stream->read(data.data(), data.size());
+		delete stream;
+		return data;
+	}
+
+	static Common::SeekableReadStream *createStream(const byte *data, uint32 size) {
+		byte *copy = (byte *)malloc(size);
+		memcpy(copy, data, size);
+		return new Common::MemoryReadStream(copy, size, DisposeAfterUse::YES);
+	}
+
+	static Common::SeekableReadStream *createStream(const Common::Array<byte> &data) {
+		return createStream(data.data(), data.size());
+	}
+
+	/** Returns a copy of the archive which can only be opened through an index. */
+	static Common::Array<byte> removeCentralDirEnd(const Common::Array<byte> &zip) {
+		Common::Array<byte> result = zip;
+		memset(&result[result.size() - 22], 0, 22);
+		return result;
+	}
+
+	/**
+	 * Opens an archive with an index, and returns the new index written, if
+	 * any. Returns whether the archive could be opened.
+	 */
+	bool openIndexed(const Common::Array<byte> &zip, const Common::String &path, int64 mtime, const Common::Array<byte> *index, Common::Array<byte> &newIndex, const Common::Array<byte> *members) {
+		Common::ScopedPtr<Common::SeekableReadStream> indexStream(index ? createStream(*index) : nullptr);
+		Common::MemoryWriteStreamDynamic newIndexStream(DisposeAfterUse::YES);
+		Common::Archive *archive = Common::makeZipArchive(createStream(zip), path, mtime, indexStream.get(), &newIndexStream);
+		newIndex = Common::Array<byte>(newIndexStream.getData(), newIndexStream.size());
+		if (!archive)
+			return false;
+
+		for (uint i = 0; i < kMemberCount; ++i)
+			checkStream(archive->createReadStreamForMember(memberName(i)), members[i]);
+		delete archive;
+		return true;
+	}
+
+public:
+	void test_read_members_at_once() {
+		Common::Array<byte> members[kMemberCount];
+		createMembers(members);
+
+		Common::Archive *archive = Common::makeZipArchive(createArchive(members));
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+
+		// Including a missing member and one member twice
+		Common::Array<Common::Path> paths;
+		for (uint i = 0; i < kMemberCount; ++i)
+			paths.push_back(memberName((i * 7) % kMemberCount));
+		paths.push_back("dir/missing.dat");
+		paths.push_back(memberName(3));
+
+		// The second time the small members come from the cache
+		for (int pass = 0; pass < 2; ++pass) {
+			Common::Array<Common::SeekableReadStream *> streams;
+			TS_ASSERT_EQUALS(archive->createReadStreamsForMembers(paths, streams), (int)kMemberCount + 1);
+			TS_ASSERT_EQUALS(streams.size(), paths.size());
+			for (uint i = 0; i < kMemberCount; ++i)
+				checkStream(streams[i], members[(i * 7) % kMemberCount]);
+			TS_ASSERT(!streams[kMemberCount]);
+			checkStream(streams[kMemberCount + 1], members[3]);
+		}
+
+		for (uint i = 0; i < kMemberCount; ++i)
+			checkStream(archive->createReadStreamForMember(memberName(i)), members[i]);
+
+		delete archive;
+	}
+
+	void test_index_round_trip() {
+		Common::Array<byte> members[kMemberCount];
+		createMembers(members);
+		const Common::Array<byte> zip = readAll(createArchive(members));
+
+		Common::Array<byte> index, newIndex;
+		TS_ASSERT(openIndexed(zip, "game/data.zip", 1234, nullptr, index, members));
+		TS_ASSERT(!index.empty());
+
+		// The central dir is not read when there is an index
+		TS_ASSERT(openIndexed(removeCentralDirEnd(zip), "game/data.zip", 1234, &index, newIndex, members));
+		TS_ASSERT(newIndex.empty());
+	}
+
+	void test_index_mismatch() {
+		Common::Array<byte> members[kMemberCount];
+		createMembers(members);
+		const Common::Array<byte> zip = readAll(createArchive(members));
+
+		Common::Array<byte> index, newIndex;
+		TS_ASSERT(openIndexed(zip, "game/data.zip", 1234, nullptr, index, members));
+
+		const Common::Array<byte> withoutEnd = removeCentralDirEnd(zip);
+		Common::Array<byte> resized = withoutEnd;
+		resized.push_back(0);
+
+		// The index of another archive, or of another version of it
+		TS_ASSERT(!openIndexed(withoutEnd, "game/other.zip", 1234, &index, newIndex, members));
+		TS_ASSERT(!openIndexed(withoutEnd, "game/data.zip", 1235, &index, newIndex, members));
+		TS_ASSERT(!openIndexed(resized, "game/data.zip", 1234, &index, newIndex, members));
+
+		// The central dir is read again, and a new index written
+		TS_ASSERT(openIndexed(zip, "game/data.zip", 1235, &index, newIndex, members));
+		TS_ASSERT(!newIndex.empty());
+		TS_ASSERT(newIndex != index);
+	}
+
+	void test_truncated_index() {
+		Common::Array<byte> members[kMemberCount];
+		createMembers(members);
+		const Common::Array<byte> zip = readAll(createArchive(members));
+		const Common::Array<byte> withoutEnd = removeCentralDirEnd(zip);
+
+		Common::Array<byte> index, newIndex;
+		TS_ASSERT(openIndexed(zip, "game/data.zip", 1234, nullptr, index, members));
+
+		for (uint size = 0; size < index.size(); size += 7) {
+			const Common::Array<byte> truncated(index.data(), size);
+			TS_ASSERT(!openIndexed(withoutEnd, "game/data.zip", 1234, &truncated, newIndex, members));
+
+			TS_ASSERT(openIndexed(zip, "game/data.zip", 1234, &truncated, newIndex, members));
+			TS_ASSERT(newIndex == index);
+		}
+	}
+};
@@ -0,0 +1,113 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/memstream.h"
+#include "common/compression/zlib.h"
+#include "../test_helper.h"
+
+/*
+ * Block compressed streams are read back through wrapCompressedReadStream(),
+ * which decompresses only the blocks it needs. Reading after any seek has
+ * to give the same data as reading the uncompressed data directly.
+ */
+class ZlibBlockStreamTestSuite : public CxxTest::TestSuite {
+	// Enough blocks for several batches, and a partial last block
+	static const uint32 kSize = 2 * 1024 * 1024 + 4321;
+
+	TestRandom _random;
+
+public:
+	void test_random_access() {
+#ifdef USE_ZLIB
+		_random.setSeed(1);
+		byte *data = new byte[kSize];
+		// Runs of few symbols, with a stretch of noise which is stored as it is
+		for (uint32 i = 0; i < kSize; ) {
+			const byte value = 'a' + _random.nextUint32() % 8;
+			for (uint32 run = 1 + _random.nextUint32() % 5; run > 0 && i < kSize; --run)
+				data[i++] = value;
+		}
+		for (uint32 i = 300000; i < 500000; ++i)
+			data[i] = _random.nextUint32();
+
+		// Written in pieces of all sizes, across the block boundaries
+		Common::MemoryWriteStreamDynamic *compressed = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *blocks = Common::wrapBlockCompressedWriteStream(compressed);
+		for (uint32 done = 0; done < kSize; ) {
+			const uint32 chunk = MIN<uint32>(kSize - done, _random.nextUint32() % 100000);
+			TS_ASSERT_EQUALS(blocks->write(data + done, chunk), chunk);
+			done += chunk;
+		}
+		blocks->finalize();
+		TS_ASSERT(!blocks->err());
+		TS_ASSERT_EQUALS(blocks->pos(), (int64)kSize);
+		byte *compressedData = compressed->getData();
+		const uint32 compressedSize = compressed->size();
+		delete blocks;
+		TS_ASSERT_LESS_THAN(compressedSize, kSize);
+
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(
+			new Common::MemoryReadStream(compressedData, compressedSize, DisposeAfterUse::YES));
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), (int64)kSize);
+
+		// Read everything once, and then jump around
+		byte buffer[4096];
+		for (int i = 0; i < 40; ++i) {
+			const uint32 pos = (i == 0) ? 0 : _random.nextUint32() % kSize;
+			const uint32 length = (i == 0) ? kSize : MIN<uint32>(_random.nextUint32() % sizeof(buffer), kSize - pos);
+
+			TS_ASSERT(stream->seek(pos));
+			TS_ASSERT_EQUALS(stream->pos(), (int64)pos);
+			for (uint32 done = 0; done < length; ) {
+				const uint32 chunk = MIN<uint32>(length - done, sizeof(buffer));
+				TS_ASSERT_EQUALS(stream->read(buffer, chunk), chunk);
+				TS_ASSERT_SAME_DATA(buffer, data + pos + done, chunk);
+				done += chunk;
+			}
+		}
+
+		TS_ASSERT(stream->seek(-4, SEEK_END));
+		TS_ASSERT_EQUALS(stream->readUint32BE(), READ_BE_UINT32(data + kSize - 4));
+		TS_ASSERT(!stream->eos());
+		stream->readByte();
+		TS_ASSERT(stream->eos());
+		TS_ASSERT(!stream->err());
+
+		delete stream;
+		delete[] data;
+#endif
+	}
+
+	void test_empty_stream() {
+#ifdef USE_ZLIB
+		Common::MemoryWriteStreamDynamic *compressed = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *blocks = Common::wrapBlockCompressedWriteStream(compressed);
+		blocks->finalize();
+		byte *compressedData = compressed->getData();
+		const uint32 compressedSize = compressed->size();
+		delete blocks;
+
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(
+			new Common::MemoryReadStream(compressedData, compressedSize, DisposeAfterUse::YES));
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), 0);
+		stream->readByte();
+		TS_ASSERT(stream->eos());
+		delete stream;
+#endif
+	}
+
+	void test_not_a_block_stream() {
+		// Uncompressed data which only starts like a block compressed stream
+		static const byte data[] = "ZBLK is not followed by a block index";
+		Common::SeekableReadStream *raw = new Common::MemoryReadStream(data, sizeof(data));
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(raw);
+		TS_ASSERT_EQUALS(stream, raw);
+		TS_ASSERT_EQUALS(stream->pos(), 0);
+		delete stream;
+	}
+};
@@ -0,0 +1,177 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "graphics/blit-intern.h"
+#include "../test_helper.h"
+
+/*
+ * The vector blit kernels have to give the same pixels as the scalar ones,
+ * also when converting in place.
+ */
+class BlitTestSuite : public CxxTest::TestSuite {
+	// Odd sizes, so the scalar tail handling is exercised as well
+	static const uint kWidth = 37;
+	static const uint kHeight = 5;
+	static const uint kPitch = kWidth * 4 + 12;
+
+	TestRandom _random;
+
+	void randomFill(byte *buffer, uint size) {
+		for (uint i = 0; i < size; ++i)
+			buffer[i] = (byte)_random.nextUint32();
+	}
+
+	static Graphics::PixelFormat testFormat(uint i) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(2, 4, 4, 4, 4, 8, 4, 0, 12),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 0, 5, 11, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24)
+		};
+		return formats[i % ARRAYSIZE(formats)];
+	}
+
+	static const uint kFormatCount = 9;
+
+	/** Converts a rectangle row by row, in the order crossBlit() uses. */
+	static void convertRows(Graphics::CrossBlitRowProc convertRow, byte *dst, const byte *src, uint dstPitch, uint srcPitch, const Graphics::BlitConversion &conv) {
+		if (conv.dstFmt.bytesPerPixel > conv.srcFmt.bytesPerPixel) {
+			for (uint y = kHeight; y-- > 0;)
+				convertRow(dst + y * dstPitch, src + y * srcPitch, kWidth, conv);
+		} else {
+			for (uint y = 0; y < kHeight; ++y)
+				convertRow(dst + y * dstPitch, src + y * srcPitch, kWidth, conv);
+		}
+	}
+
+	void checkCrossBlitRow(Graphics::CrossBlitRowProc convertRow) {
+		_random.setSeed(1);
+		byte src[kPitch * kHeight];
+		byte dst[2][kPitch * kHeight];
+
+		for (uint i = 0; i < kFormatCount; ++i) {
+			for (uint j = 0; j < kFormatCount; ++j) {
+				const Graphics::PixelFormat srcFmt = testFormat(i);
+				const Graphics::PixelFormat dstFmt = testFormat(j);
+
+				for (int hasKey = 0; hasKey < 2; ++hasKey) {
+					randomFill(src, sizeof(src));
+					randomFill(dst[0], sizeof(dst[0]));
+					memcpy(dst[1], dst[0], sizeof(dst[0]));
+
+					// Use the color of a pixel as the key, so that it is found
+					const uint32 key = (srcFmt.bytesPerPixel == 2) ? *(const uint16 *)(src + 8) : *(const uint32 *)(src + 8);
+					Graphics::BlitConversion conv;
+					if (!Graphics::initBlitConversion(conv, dstFmt, srcFmt, hasKey != 0, key)) {
+						// Only sources with 1-bit alpha are left to the scalar code
+						TS_ASSERT_EQUALS(srcFmt.aBits(), 1);
+						continue;
+					}
+
+					convertRows(Graphics::crossBlitRow_Scalar, dst[0], src, kPitch, kPitch, conv);
+					convertRows(convertRow, dst[1], src, kPitch, kPitch, conv);
+					TS_ASSERT_SAME_DATA(dst[0], dst[1], sizeof(dst[0]));
+
+					// Convert in place, with the source at the start of the
+					// destination like Surface::convertToInPlace() does
+					const uint srcPitch = kWidth * srcFmt.bytesPerPixel;
+					const uint dstPitch = kWidth * dstFmt.bytesPerPixel;
+					memcpy(dst[0], src, srcPitch * kHeight);
+					memcpy(dst[1], src, srcPitch * kHeight);
+					convertRows(Graphics::crossBlitRow_Scalar, dst[0], dst[0], dstPitch, srcPitch, conv);
+					convertRows(convertRow, dst[1], dst[1], dstPitch, srcPitch, conv);
+					TS_ASSERT_SAME_DATA(dst[0], dst[1], sizeof(dst[0]));
+				}
+			}
+		}
+	}
+
+	void checkCrossBlitMapRow(Graphics::CrossBlitMapRowProc mapRow) {
+		_random.setSeed(2);
+		uint32 map[256];
+		byte src[kWidth];
+		byte dst[2][kWidth * 4];
+		for (int i = 0; i < 256; ++i)
+			map[i] = _random.nextUint32();
+
+		for (uint bytesPerPixel = 2; bytesPerPixel <= 4; bytesPerPixel += 2) {
+			for (int hasKey = 0; hasKey < 2; ++hasKey) {
+				randomFill(src, sizeof(src));
+				randomFill(dst[0], sizeof(dst[0]));
+				memcpy(dst[1], dst[0], sizeof(dst[0]));
+
+				Graphics::crossBlitMapRow_Scalar(dst[0], src, kWidth, bytesPerPixel, map, hasKey != 0, src[3]);
+				mapRow(dst[1], src, kWidth, bytesPerPixel, map, hasKey != 0, src[3]);
+				TS_ASSERT_SAME_DATA(dst[0], dst[1], sizeof(dst[0]));
+
+				// In place
+				memcpy(dst[0], src, kWidth);
+				memcpy(dst[1], src, kWidth);
+				Graphics::crossBlitMapRow_Scalar(dst[0], dst[0], kWidth, bytesPerPixel, map, hasKey != 0, src[3]);
+				mapRow(dst[1], dst[1], kWidth, bytesPerPixel, map, hasKey != 0, src[3]);
+				TS_ASSERT_SAME_DATA(dst[0], dst[1], sizeof(dst[0]));
+			}
+		}
+	}
+
+	void checkInterpolateBilinear(Graphics::InterpolateBilinearProc interpolate) {
+		_random.setSeed(3);
+		Graphics::BilinearChunk chunk;
+		for (uint test = 0; test < 10; ++test) {
+			for (uint i = 0; i < Graphics::kBilinearChunkSize; ++i) {
+				chunk.c00[i] = _random.nextUint32();
+				chunk.c01[i] = _random.nextUint32();
+				chunk.c10[i] = _random.nextUint32();
+				chunk.c11[i] = _random.nextUint32();
+				// Include the extreme weights
+				chunk.ex[i] = (i % 9 == 0) ? 0 : (i % 11 == 0) ? 0xFFFF : (uint16)_random.nextUint32();
+				chunk.ey[i] = (i % 7 == 0) ? 0 : (i % 13 == 0) ? 0xFFFF : (uint16)_random.nextUint32();
+			}
+
+			uint32 dst[2][Graphics::kBilinearChunkSize];
+			memset(dst, 0, sizeof(dst));
+			const uint start = test % 3;
+			const uint end = Graphics::kBilinearChunkSize - test;
+			Graphics::interpolateBilinear_Scalar(dst[0], chunk, start, end);
+			interpolate(dst[1], chunk, start, end);
+			TS_ASSERT_SAME_DATA(dst[0], dst[1], sizeof(dst[0]));
+		}
+	}
+
+public:
+	void test_blit_kernels_sse2() {
+#ifdef SCUMMVM_SSE2
+		if (hasCpuFeature(OSystem::kFeatureCpuSSE2)) {
+			checkCrossBlitRow(Graphics::crossBlitRow_SSE2);
+			checkInterpolateBilinear(Graphics::interpolateBilinear_SSE2);
+		}
+#endif
+	}
+
+	void test_blit_kernels_avx2() {
+#ifdef SCUMMVM_AVX2
+		if (hasCpuFeature(OSystem::kFeatureCpuAVX2)) {
+			checkCrossBlitRow(Graphics::crossBlitRow_AVX2);
+			checkCrossBlitMapRow(Graphics::crossBlitMapRow_AVX2);
+			checkInterpolateBilinear(Graphics::interpolateBilinear_AVX2);
+		}
+#endif
+	}
+
+	void test_blit_kernels_neon() {
+#ifdef SCUMMVM_NEON
+		if (hasCpuFeature(OSystem::kFeatureCpuNEON)) {
+			checkCrossBlitRow(Graphics::crossBlitRow_NEON);
+			checkInterpolateBilinear(Graphics::interpolateBilinear_NEON);
+		}
+#endif
+	}
+};
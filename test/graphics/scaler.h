@@ -0,0 +1,104 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "graphics/scalerplugin.h"
+#include "graphics/scaler/normal.h"
+#include "../test_helper.h"
+
+#ifdef USE_SCALERS
+#include "graphics/scaler/dotmatrix.h"
+#include "graphics/scaler/pm.h"
+#include "graphics/scaler/sai.h"
+#include "graphics/scaler/scalebit.h"
+#include "graphics/scaler/tv.h"
+#endif
+
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+
+/*
+ * The SDL surface backend may scale a dirty rect in bands of rows on
+ * several threads. Scaling the bands one after another has to give the
+ * same picture as scaling the rect at once.
+ */
+class ScalerTestSuite : public CxxTest::TestSuite {
+	static const int kWidth = 40;
+	static const int kHeight = 37;
+	// Room around the rect for the pixels the scalers look at
+	static const int kPadding = 4;
+	static const int kMaxFactor = 5;
+
+	TestRandom _random;
+
+	void checkBands(Scaler *scaler, uint bpp, uint factor) {
+		const uint32 srcPitch = (kWidth + 2 * kPadding) * bpp;
+		const uint32 dstPitch = kWidth * kMaxFactor * bpp;
+
+		byte *src = new byte[srcPitch * (kHeight + 2 * kPadding)];
+		byte *dst[2];
+		dst[0] = new byte[dstPitch * kHeight * kMaxFactor]();
+		dst[1] = new byte[dstPitch * kHeight * kMaxFactor]();
+
+		// Few colors, so that the scalers find edges to work on
+		for (uint32 i = 0; i < srcPitch * (kHeight + 2 * kPadding) / bpp; ++i) {
+			const uint32 color = (_random.nextUint32() % 3 == 0) ? 0xFFFFFFFF : (_random.nextUint32() & 0xFF00FF00);
+			if (bpp == 2)
+				((uint16 *)src)[i] = color;
+			else
+				((uint32 *)src)[i] = color;
+		}
+
+		scaler->setFactor(factor);
+		const byte *srcRect = src + kPadding * srcPitch + kPadding * bpp;
+		scaler->scale(srcRect, srcPitch, dst[0], dstPitch, kWidth, kHeight, 8, 3);
+
+		// Uneven bands, as the backend gets with heights which don't divide
+		static const int bands[] = { 0, 16, 33, kHeight };
+		for (int i = 0; i < 3; ++i) {
+			scaler->scale(srcRect + bands[i] * srcPitch, srcPitch, dst[1] + bands[i] * factor * dstPitch, dstPitch,
+				kWidth, bands[i + 1] - bands[i], 8, 3 + bands[i]);
+		}
+
+		TS_ASSERT_SAME_DATA(dst[0], dst[1], dstPitch * kHeight * kMaxFactor);
+
+		delete[] src;
+		delete[] dst[0];
+		delete[] dst[1];
+	}
+
+	void checkScaler(Scaler *scaler, uint bpp, uint minFactor, uint maxFactor) {
+		for (uint factor = minFactor; factor <= maxFactor; ++factor)
+			checkBands(scaler, bpp, factor);
+		delete scaler;
+	}
+
+public:
+	void test_scaler_bands() {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		_random.setSeed(1);
+		for (uint i = 0; i < ARRAYSIZE(formats); ++i) {
+			checkScaler(new NormalScaler(formats[i]), formats[i].bytesPerPixel, 2, 4);
+#ifdef USE_SCALERS
+			checkScaler(new AdvMameScaler(formats[i]), formats[i].bytesPerPixel, 2, 4);
+			checkScaler(new SAIScaler(formats[i]), formats[i].bytesPerPixel, 2, 2);
+			checkScaler(new SuperSAIScaler(formats[i]), formats[i].bytesPerPixel, 2, 2);
+			checkScaler(new SuperEagleScaler(formats[i]), formats[i].bytesPerPixel, 2, 2);
+			checkScaler(new PMScaler(formats[i]), formats[i].bytesPerPixel, 2, 2);
+			checkScaler(new DotMatrixScaler(formats[i]), formats[i].bytesPerPixel, 2, 2);
+			checkScaler(new TVScaler(formats[i]), formats[i].bytesPerPixel, 2, 2);
+#endif
+#ifdef USE_HQ_SCALERS
+			checkScaler(new HQScaler(formats[i]), formats[i].bytesPerPixel, 2, 3);
+#endif
+		}
+	}
+};
@@ -0,0 +1,239 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/array.h"
+#include "graphics/surface.h"
+#include "../test_helper.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zspan.h"
+#endif
+
+/*
+ * Rasterizing a frame with several threads has to give the exact same
+ * picture as rasterizing it on a single thread, and the vector span kernels
+ * have to give the same pixels as the scalar ones.
+ */
+class TinyGLTestSuite : public CxxTest::TestSuite {
+#ifdef USE_TINYGL
+	static const int kWidth = 320;
+	static const int kHeight = 240;
+	static const int kTextureSize = 16;
+	static const int kFrames = 3;
+
+	TestRandom _random;
+
+	void randomVertex() {
+		tglColor4f(_random.nextFloat(0, 1), _random.nextFloat(0, 1), _random.nextFloat(0, 1), _random.nextFloat(0, 1));
+		tglTexCoord2f(_random.nextFloat(-1, 2), _random.nextFloat(-1, 2));
+		// Some of the vertices are off screen, to have clipped triangles as well
+		tglVertex3f(_random.nextFloat(-40, kWidth + 40), _random.nextFloat(-40, kHeight + 40), _random.nextFloat(-1, 1));
+	}
+
+	void drawScene(int frame, TinyGL::BlitImage *blitImage, TGLuint texture) {
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrtho(0, kWidth, kHeight, 0, -1, 1);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+
+		_random.setSeed(1);
+		for (int i = 0; i < 60; ++i) {
+			// Move a few triangles in every frame, so that only parts of
+			// the screen get redrawn
+			if (i % 10 == 0)
+				_random.setSeed(_random.getSeed() + frame);
+
+			if (i % 3 == 0)
+				tglEnable(TGL_BLEND);
+			else
+				tglDisable(TGL_BLEND);
+
+			if (i % 4 == 0) {
+				tglEnable(TGL_TEXTURE_2D);
+				tglBindTexture(TGL_TEXTURE_2D, texture);
+			} else {
+				tglDisable(TGL_TEXTURE_2D);
+			}
+
+			tglBegin(i % 5 == 0 ? TGL_QUADS : TGL_TRIANGLES);
+			for (int j = 0; j < 12; ++j)
+				randomVertex();
+			tglEnd();
+
+			// Blits split the frame in several batches of tiled draw calls
+			if (i % 20 == 10)
+				tglBlit(blitImage, (frame * 13 + i) % kWidth, i * 3);
+		}
+
+		tglDisable(TGL_TEXTURE_2D);
+		tglDisable(TGL_BLEND);
+		tglBegin(TGL_LINE_STRIP);
+		for (int j = 0; j < 20; ++j)
+			randomVertex();
+		tglEnd();
+	}
+
+	void render(uint threads, Common::Array<byte> &frames) {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 0, 8, 16, 24);
+		TinyGL::createContext(kWidth, kHeight, format, 256, false, true);
+		TinyGL::setRasterizerThreadCount(threads);
+
+		Graphics::Surface image;
+		image.create(24, 24, format);
+		for (int y = 0; y < image.h; ++y)
+			for (int x = 0; x < image.w; ++x)
+				image.setPixel(x, y, format.ARGBToColor(((x ^ y) & 4) ? 255 : 128, x * 10, y * 10, 200));
+		TinyGL::BlitImage *blitImage = tglGenBlitImage();
+		tglUploadBlitImage(blitImage, image, 0, false);
+		image.free();
+
+		byte texels[kTextureSize * kTextureSize * 4];
+		_random.setSeed(2);
+		for (int i = 0; i < ARRAYSIZE(texels); ++i)
+			texels[i] = (byte)_random.nextFloat(0, 255);
+		TGLuint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, kTextureSize, kTextureSize, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+
+		for (int frame = 0; frame < kFrames; ++frame) {
+			drawScene(frame, blitImage, texture);
+			TinyGL::presentBuffer();
+
+			Graphics::Surface surface;
+			TinyGL::getSurfaceRef(surface);
+			for (int y = 0; y < surface.h; ++y) {
+				const byte *row = (const byte *)surface.getBasePtr(0, y);
+				for (int x = 0; x < surface.w * 4; ++x)
+					frames.push_back(row[x]);
+			}
+		}
+
+		tglDeleteTextures(1, &texture);
+		tglDeleteBlitImage(blitImage);
+		TinyGL::destroyContext();
+	}
+
+	// Odd sizes, so the scalar tail handling is exercised as well
+	static const int kSpanSize = 203;
+
+	uint32 _pixels[2][kSpanSize];
+	uint _zbuf[2][kSpanSize];
+	byte _mask[2][kSpanSize];
+	uint32 _texels[kSpanSize];
+
+	void randomSpan(TinyGL::ShadeSpan &span, uint test) {
+		for (int i = 0; i < kSpanSize; ++i) {
+			_pixels[0][i] = _pixels[1][i] = _random.nextUint32();
+			// Some of the depth values are equal to the ones of the span
+			_zbuf[0][i] = _zbuf[1][i] = (i % 7 == 0) ? 0x20000000 + i * 0x1000 : _random.nextUint32() >> 1;
+			_texels[i] = _random.nextUint32();
+			_mask[0][i] = _mask[1][i] = (_random.nextUint32() & 1) ? 0xFF : 0;
+		}
+
+		static const TinyGL::SpanDepthTest depthTests[] = {
+			TinyGL::kSpanDepthAlways, TinyGL::kSpanDepthLess, TinyGL::kSpanDepthLequal
+		};
+		span.count = kSpanSize - (test % 5);
+		span.depthTest = depthTests[test % ARRAYSIZE(depthTests)];
+		span.depthWrite = (test & 1) != 0;
+		span.z = 0x20000000;
+		span.dzdx = 0x1000;
+		// Colors slightly out of range wrap around like in the rasterizer
+		span.r = _random.nextUint32() & 0x1FFFF;
+		span.g = _random.nextUint32() & 0xFFFF;
+		span.b = _random.nextUint32() & 0xFFFF;
+		span.a = _random.nextUint32() & 0xFFFF;
+		span.drdx = (int)(_random.nextUint32() & 0x3FF) - 0x200;
+		span.dgdx = (int)(_random.nextUint32() & 0x3FF) - 0x200;
+		span.dbdx = (int)(_random.nextUint32() & 0x3FF) - 0x200;
+		span.dadx = (int)(_random.nextUint32() & 0x3FF) - 0x200;
+		span.aShift = (test & 2) ? 24 : 0;
+		span.rShift = (test & 2) ? 16 : 24;
+		span.gShift = (test & 2) ? 8 : 16;
+		span.bShift = (test & 2) ? 0 : 8;
+		span.alphaMask = (test & 4) ? 0xFF : 0;
+	}
+
+	void checkSpanKernels(const TinyGL::SpanKernels &kernels) {
+		_random.setSeed(3);
+		for (uint test = 0; test < 30; ++test) {
+			TinyGL::ShadeSpan spans[2];
+			randomSpan(spans[0], test);
+			for (int k = 0; k < 2; ++k) {
+				spans[k] = spans[0];
+				spans[k].pixels = _pixels[k];
+				spans[k].zbuf = _zbuf[k];
+			}
+
+			TinyGL::depthTestSpan_Scalar(spans[0], _mask[0]);
+			kernels.depthTestSpan(spans[1], _mask[1]);
+			TS_ASSERT_SAME_DATA(_mask[0], _mask[1], spans[0].count);
+
+			TinyGL::shadeSpan_Scalar(spans[0]);
+			kernels.shadeSpan(spans[1]);
+			TS_ASSERT_SAME_DATA(_pixels[0], _pixels[1], sizeof(_pixels[0]));
+			TS_ASSERT_SAME_DATA(_zbuf[0], _zbuf[1], sizeof(_zbuf[0]));
+
+			TinyGL::shadeTexturedSpan_Scalar(spans[0], _mask[0], _texels);
+			kernels.shadeTexturedSpan(spans[1], _mask[1], _texels);
+			TS_ASSERT_SAME_DATA(_pixels[0], _pixels[1], sizeof(_pixels[0]));
+			TS_ASSERT_SAME_DATA(_zbuf[0], _zbuf[1], sizeof(_zbuf[0]));
+		}
+	}
+#endif
+
+public:
+	void test_tiled_rasterizer() {
+#ifdef USE_TINYGL
+		Common::Array<byte> serial, tiled;
+		render(1, serial);
+		render(4, tiled);
+
+		TS_ASSERT_EQUALS(serial.size(), (uint)(kWidth * kHeight * 4 * kFrames));
+		TS_ASSERT_EQUALS(tiled.size(), serial.size());
+		if (tiled.size() == serial.size())
+			TS_ASSERT_SAME_DATA(tiled.data(), serial.data(), serial.size());
+#endif
+	}
+
+	void test_span_kernels_sse2() {
+#if defined(USE_TINYGL) && defined(SCUMMVM_SSE2)
+		if (hasCpuFeature(OSystem::kFeatureCpuSSE2)) {
+			const TinyGL::SpanKernels kernels = { TinyGL::depthTestSpan_SSE2, TinyGL::shadeSpan_SSE2, TinyGL::shadeTexturedSpan_SSE2 };
+			checkSpanKernels(kernels);
+		}
+#endif
+	}
+
+	void test_span_kernels_avx2() {
+#if defined(USE_TINYGL) && defined(SCUMMVM_AVX2)
+		if (hasCpuFeature(OSystem::kFeatureCpuAVX2)) {
+			const TinyGL::SpanKernels kernels = { TinyGL::depthTestSpan_AVX2, TinyGL::shadeSpan_AVX2, TinyGL::shadeTexturedSpan_AVX2 };
+			checkSpanKernels(kernels);
+		}
+#endif
+	}
+
+	void test_span_kernels_neon() {
+#if defined(USE_TINYGL) && defined(SCUMMVM_NEON)
+		if (hasCpuFeature(OSystem::kFeatureCpuNEON)) {
+			const TinyGL::SpanKernels kernels = { TinyGL::depthTestSpan_NEON, TinyGL::shadeSpan_NEON, TinyGL::shadeTexturedSpan_NEON };
+			checkSpanKernels(kernels);
+		}
+#endif
+	}
+};
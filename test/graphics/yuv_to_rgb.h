@@ -0,0 +1,201 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
+#include "../test_helper.h"
+
+/*
+ * The vector span kernels have to give the same pixels as the scalar one,
+ * and the conversions have to give the same pictures as the lookup tables
+ * they replace, whatever the number of threads.
+ */
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	// Sizes which aren't multiples of the vector widths
+	static const int kWidth = 44;
+	static const int kHeight = 12;
+	static const int kPitch = kWidth + 5;
+
+	TestRandom _random;
+
+	void randomFill(byte *buffer, uint size) {
+		for (uint i = 0; i < size; ++i)
+			buffer[i] = (byte)_random.nextUint32();
+	}
+
+	static Graphics::PixelFormat testFormat(uint i) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(2, 4, 4, 4, 4, 8, 4, 0, 12),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0)
+		};
+		return formats[i % ARRAYSIZE(formats)];
+	}
+
+	static const uint kFormatCount = 7;
+
+	void checkConvertYUVSpan(Graphics::ConvertYUVSpanProc convertSpan) {
+		static const uint counts[] = { 1, 7, 8, 15, 16, 17, 37, Graphics::kYUVSpanSize };
+
+		_random.setSeed(1);
+		byte y[Graphics::kYUVSpanSize], a[Graphics::kYUVSpanSize];
+		int16 offsets[3][Graphics::kYUVSpanSize];
+		// Room behind the span, to catch writes past its end
+		byte dst[2][Graphics::kYUVSpanSize * 4 + 64];
+
+		for (uint i = 0; i < kFormatCount; ++i) {
+			const Graphics::PixelFormat format = testFormat(i);
+			for (uint j = 0; j < ARRAYSIZE(counts); ++j) {
+				for (int flags = 0; flags < 4; ++flags) {
+					randomFill(y, sizeof(y));
+					randomFill(a, sizeof(a));
+					for (uint k = 0; k < Graphics::kYUVSpanSize; ++k) {
+						// Beyond the offsets the chroma tables give
+						offsets[0][k] = (int16)(_random.nextUint32() % 601) - 300;
+						offsets[1][k] = (int16)(_random.nextUint32() % 601) - 300;
+						offsets[2][k] = (int16)(_random.nextUint32() % 601) - 300;
+					}
+					randomFill(dst[0], sizeof(dst[0]));
+					memcpy(dst[1], dst[0], sizeof(dst[0]));
+
+					const bool ituScale = (flags & 1) != 0;
+					const Graphics::YUVSpan span0 = { dst[0], y, (flags & 2) ? a : nullptr, offsets[0], offsets[1], offsets[2], counts[j] };
+					const Graphics::YUVSpan span1 = { dst[1], y, (flags & 2) ? a : nullptr, offsets[0], offsets[1], offsets[2], counts[j] };
+					Graphics::convertYUVSpan_Scalar(span0, format, ituScale);
+					convertSpan(span1, format, ituScale);
+					TS_ASSERT_SAME_DATA(dst[0], dst[1], sizeof(dst[0]));
+				}
+			}
+		}
+	}
+
+	/** The component value for the sum of luma and chroma, like the lookup tables hold it. */
+	static int referenceComponent(int value, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		if (scale == Graphics::YUVToRGBManager::kScaleITU)
+			return (CLIP(value, 16, 235) - 16) * 255 / 219;
+		return CLIP(value, 0, 255);
+	}
+
+	/** Converts one pixel with the chroma formulas of YUVToRGBManager. */
+	static uint32 referencePixel(const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, byte y, byte u, byte v, byte a) {
+		const int16 cr = v - 128, cb = u - 128;
+		const int r = y + (int16)((0.419 / 0.299) * cr);
+		const int g = y + (int16)(-(0.299 / 0.419) * cr) + (int16)(-(0.114 / 0.331) * cb);
+		const int b = y + (int16)((0.587 / 0.331) * cb);
+		return format.ARGBToColor(a, referenceComponent(r, scale), referenceComponent(g, scale), referenceComponent(b, scale));
+	}
+
+	static uint32 getPixel(const Graphics::Surface &surface, int x, int y) {
+		const byte *pixel = (const byte *)surface.getBasePtr(x, y);
+		return (surface.format.bytesPerPixel == 2) ? *(const uint16 *)pixel : *(const uint32 *)pixel;
+	}
+
+	enum Subsampling {
+		k444,
+		k420,
+		k420Alpha,
+		k410
+	};
+
+	/** Returns the chroma value for a pixel, interpolated for 4:1:0 like convert410() does. */
+	static byte chroma(const byte *src, Subsampling subsampling, int x, int y) {
+		switch (subsampling) {
+		case k444:
+			return src[y * kPitch + x];
+		case k410: {
+			const byte *quad = src + (y >> 2) * kPitch + (x >> 2);
+			const int xDiff = x & 3, yDiff = y & 3;
+			return (quad[0] * (4 - xDiff) * (4 - yDiff) + quad[1] * xDiff * (4 - yDiff) +
+					quad[kPitch] * yDiff * (4 - xDiff) + quad[kPitch + 1] * xDiff * yDiff) >> 4;
+		}
+		default:
+			return src[(y >> 1) * kPitch + (x >> 1)];
+		}
+	}
+
+	void checkConvert(Subsampling subsampling, const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		// The 4:1:0 chroma planes need an extra row and column
+		byte y[kPitch * kHeight], u[kPitch * (kHeight + 1)], v[kPitch * (kHeight + 1)], a[kPitch * kHeight];
+		randomFill(y, sizeof(y));
+		randomFill(u, sizeof(u));
+		randomFill(v, sizeof(v));
+		randomFill(a, sizeof(a));
+
+		Graphics::Surface surface;
+		surface.create(kWidth, kHeight, format);
+
+		for (int threads = 1; threads <= 3; threads += 2) {
+			YUVToRGBMan.setThreadCount(threads);
+			memset(surface.getPixels(), 0, surface.pitch * surface.h);
+
+			switch (subsampling) {
+			case k444:
+				YUVToRGBMan.convert444(&surface, scale, y, u, v, kWidth, kHeight, kPitch, kPitch);
+				break;
+			case k420:
+				YUVToRGBMan.convert420(&surface, scale, y, u, v, kWidth, kHeight, kPitch, kPitch);
+				break;
+			case k420Alpha:
+				YUVToRGBMan.convert420Alpha(&surface, scale, y, u, v, a, kWidth, kHeight, kPitch, kPitch);
+				break;
+			case k410:
+				YUVToRGBMan.convert410(&surface, scale, y, u, v, kWidth, kHeight, kPitch, kPitch);
+				break;
+			}
+
+			for (int row = 0; row < kHeight; ++row) {
+				for (int x = 0; x < kWidth; ++x) {
+					const byte alpha = (subsampling == k420Alpha) ? a[row * kPitch + x] : 255;
+					const uint32 expected = referencePixel(format, scale, y[row * kPitch + x],
+						chroma(u, subsampling, x, row), chroma(v, subsampling, x, row), alpha);
+					TS_ASSERT_EQUALS(getPixel(surface, x, row), expected);
+				}
+			}
+		}
+
+		YUVToRGBMan.setThreadCount(1);
+		surface.free();
+	}
+
+public:
+	void test_yuv_span_kernels_sse2() {
+#ifdef SCUMMVM_SSE2
+		if (hasCpuFeature(OSystem::kFeatureCpuSSE2))
+			checkConvertYUVSpan(Graphics::convertYUVSpan_SSE2);
+#endif
+	}
+
+	void test_yuv_span_kernels_avx2() {
+#ifdef SCUMMVM_AVX2
+		if (hasCpuFeature(OSystem::kFeatureCpuAVX2))
+			checkConvertYUVSpan(Graphics::convertYUVSpan_AVX2);
+#endif
+	}
+
+	void test_yuv_span_kernels_neon() {
+#ifdef SCUMMVM_NEON
+		if (hasCpuFeature(OSystem::kFeatureCpuNEON))
+			checkConvertYUVSpan(Graphics::convertYUVSpan_NEON);
+#endif
+	}
+
+	void test_yuv_conversions() {
+		_random.setSeed(2);
+		for (uint i = 0; i < kFormatCount; ++i) {
+			for (int scale = 0; scale < 2; ++scale) {
+				const Graphics::YUVToRGBManager::LuminanceScale luminanceScale = scale ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+				checkConvert(k444, testFormat(i), luminanceScale);
+				checkConvert(k420, testFormat(i), luminanceScale);
+				checkConvert(k420Alpha, testFormat(i), luminanceScale);
+				checkConvert(k410, testFormat(i), luminanceScale);
+			}
+		}
+	}
+};
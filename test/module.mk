@@ -3,9 +3,13 @@
 # Use the 'test' target to run them.
 # Edit TESTS and TESTLIBS to add more tests.
 #
+# The 'bench' target builds and runs the benchmarks in test/benchmark,
+# BENCH_GROUPS selects some of their groups. 'opl-bench' only runs the
+# OPL emulator group.
+#
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/backends/*.h
 TEST_LIBS    :=
 
 ifdef POSIX
@@ -15,7 +19,11 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/posix/posix-iostream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
-	backends/modular-backend.o
+	backends/modular-backend.o \
+	backends/saves/default/save-writer.o
+ifdef HAS_PTHREADS
+TEST_LIBS += backends/mutex/pthread/pthread-mutex.o
+endif
 endif
 
 ifdef WIN32
@@ -25,10 +33,11 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
 	backends/modular-backend.o \
+	backends/saves/default/save-writer.o \
 	backends/platform/sdl/win32/win32_wrapper.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
+TEST_LIBS +=	audio/libaudio.a math/libmath.a image/libimage.a graphics/libgraphics.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -74,10 +83,26 @@ test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+BENCH_OBJS := $(patsubst $(srcdir)/%.cpp,%.o,$(wildcard $(srcdir)/test/benchmark/*.cpp))
+BENCH_LIBS :=
+ifdef USE_MT32EMU
+BENCH_LIBS += audio/softsynth/mt32/libmt32.a
+endif
+DEPDIRS += test/benchmark/$(DEPDIR)
+
+bench: test/benchmark/bench
+	./test/benchmark/bench $(BENCH_GROUPS)
+opl-bench: test/benchmark/bench
+	./test/benchmark/bench opl
+test/benchmark/bench: $(BENCH_OBJS) $(BENCH_LIBS) $(TEST_LIBS)
+	+$(QUIET_LINK)$(LD) $(TEST_CXXFLAGS) -o $@ $(BENCH_OBJS) $(BENCH_LIBS) $(TEST_LIBS) $(TEST_LDFLAGS)
+
 clean: clean-test
 clean-test:
 	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/null_osystem.o
+	-$(RM) test/benchmark/bench $(BENCH_OBJS)
 	-rmdir test/engine-data
+	-rmdir test_files
 
 test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 	$(MKDIR) test/engine-data
@@ -85,4 +110,4 @@ test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 
 copy-dat: test/engine-data/encoding.dat
 
-.PHONY: test clean-test copy-dat
+.PHONY: test bench opl-bench clean-test copy-dat
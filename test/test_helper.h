@@ -0,0 +1,72 @@
+#ifndef TEST_TEST_HELPER_H
+#define TEST_TEST_HELPER_H
+
+#include "common/fs.h"
+#include "common/system.h"
+
+#include "null_osystem.h"
+
+/**
+ * Installs the null OSystem if no OSystem has been set up yet. Returns
+ * false if there is none for this platform.
+ */
+static inline bool installTestSystem() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+	if (!g_system)
+		Common::install_null_g_system();
+#endif
+	return g_system != nullptr;
+}
+
+/**
+ * Returns the directory for the files written by tests, in the working
+ * directory. The tests remove their files again.
+ */
+static inline Common::FSNode getTestDirectory() {
+	installTestSystem();
+	Common::FSNode dir("test_files");
+	if (!dir.exists())
+		dir.createDirectory();
+	return dir;
+}
+
+/**
+ * Returns whether the CPU running the tests has the given feature, for
+ * the vector code paths.
+ */
+static inline bool hasCpuFeature(OSystem::Feature f) {
+	return installTestSystem() && g_system->hasFeature(f);
+}
+
+/**
+ * Generates the test data. Unlike Common::RandomSource, it is seeded by the
+ * tests, so that the same data is generated in every run.
+ */
+class TestRandom {
+public:
+	TestRandom() : _seed(1) {}
+
+	void setSeed(uint32 seed) { _seed = seed; }
+	uint32 getSeed() const { return _seed; }
+
+	/** Advances the generator and returns its state, whose low bits are not very random. */
+	uint32 nextState() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed;
+	}
+
+	uint32 nextUint32() {
+		const uint32 state = nextState();
+		return (state >> 16) ^ (state << 13);
+	}
+
+	/** Returns a number between @p min and @p max. */
+	float nextFloat(float min, float max) {
+		return min + (max - min) * ((nextState() >> 8) & 0xFFFF) / 65535.0f;
+	}
+
+private:
+	uint32 _seed;
+};
+
+#endif